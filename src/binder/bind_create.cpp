@@ -68,6 +68,23 @@ auto Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Colum
     return {colname, TypeId::INTEGER};
   }
 
+  // The parser turns the SQL type names into the Postgres ones.
+  if (name == "bool") {
+    return {colname, TypeId::BOOLEAN};
+  }
+  if (name == "int2") {
+    return {colname, TypeId::SMALLINT};
+  }
+  if (name == "int8") {
+    return {colname, TypeId::BIGINT};
+  }
+  if (name == "numeric" || name == "float8") {
+    return {colname, TypeId::DECIMAL};
+  }
+  if (name == "timestamp") {
+    return {colname, TypeId::TIMESTAMP};
+  }
+
   if (name == "varchar") {
     auto exprs = BindExpressionList(cdef->typeName->typmods);
     if (exprs.size() != 1) {
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames)
+    : num_frames_(num_frames), frames_(num_frames), b1_(num_frames), b2_(2 * num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // REPLACE from the paper. The page being brought in is not known yet, so ties go to T2.
+  List first = (!t1_.empty() && t1_.size() > p_) || t2_.empty() ? List::T1 : List::T2;
+  List second = first == List::T1 ? List::T2 : List::T1;
+  return EvictFrom(first, frame_id) || EvictFrom(second, frame_id);
+}
+
+auto ARCReplacer::EvictFrom(List list, frame_id_t *frame_id) -> bool {
+  auto &resident = list == List::T1 ? t1_ : t2_;
+  for (auto it = resident.rbegin(); it != resident.rend(); ++it) {
+    auto &frame = frames_[*it];
+    if (!frame.evictable_) {
+      continue;
+    }
+    *frame_id = *it;
+    (list == List::T1 ? b1_ : b2_).Push(frame.page_id_);
+    resident.erase(std::next(it).base());
+    frame = FrameInfo{};
+    curr_size_--;
+    return true;
+  }
+  return false;
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (t1_.size() + b1_.Size() > num_frames_ && b1_.Size() > 0) {
+    b1_.PopOldest();
+  }
+  while (t1_.size() + t2_.size() + b1_.Size() + b2_.Size() > 2 * num_frames_ && b2_.Size() > 0) {
+    b2_.PopOldest();
+  }
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.list_ != List::None) {
+    // A hit on a resident page moves it to the MRU end of T2.
+    (frame.list_ == List::T1 ? t1_ : t2_).erase(frame.pos_);
+    frame.list_ = List::T2;
+    t2_.push_front(frame_id);
+    frame.pos_ = t2_.begin();
+    return;
+  }
+
+  size_t b1_size = b1_.Size();
+  size_t b2_size = b2_.Size();
+  if (b1_.Erase(frame.page_id_)) {
+    p_ = std::min(num_frames_, p_ + std::max<size_t>(b2_size / b1_size, 1));
+    frame.list_ = List::T2;
+  } else if (b2_.Erase(frame.page_id_)) {
+    size_t delta = std::max<size_t>(b1_size / b2_size, 1);
+    p_ = p_ > delta ? p_ - delta : 0;
+    frame.list_ = List::T2;
+  } else {
+    frame.list_ = List::T1;
+  }
+  auto &resident = frame.list_ == List::T1 ? t1_ : t2_;
+  resident.push_front(frame_id);
+  frame.pos_ = resident.begin();
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == List::None || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == List::None) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "cannot remove a non-evictable frame");
+  (frame.list_ == List::T1 ? t1_ : t2_).erase(frame.pos_);
+  frame = FrameInfo{};
+  curr_size_--;
+}
+
+auto ARCReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  bool t1_first = (!t1_.empty() && t1_.size() > p_) || t2_.empty();
+  for (const auto *resident : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_}) {
+    for (auto it = resident->rbegin(); it != resident->rend() && candidates.size() < max_frames; ++it) {
+      if (frames_[*it].evictable_) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void ARCReplacer::AssignPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  frames_[frame_id].page_id_ = page_id;
+}
+
+}  // namespace bustub
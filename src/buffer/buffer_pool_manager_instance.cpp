@@ -12,153 +12,616 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <new>
+#include <utility>
+
 #include "common/exception.h"
 #include "common/macros.h"
 
 namespace bustub {
 
+/** @return the nanoseconds since start */
+static auto NanosSince(std::chrono::steady_clock::time_point start) -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
-
-  // Initially, every page is in the free list.
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_policy) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
+  // we allocate a consecutive, page-aligned memory space for the buffer pool, and point every frame into it. The
+  // instances of a parallel buffer pool are spread over the NUMA nodes.
+  int numa_nodes = FrameArena::NumaNodeCount();
+  int numa_node = num_instances_ > 1 && numa_nodes > 1 ? static_cast<int>(instance_index_) % numa_nodes : -1;
+  frame_arena_ = std::make_unique<FrameArena>(pool_size_, enable_huge_pages.load(), numa_node);
+  pages_ = static_cast<Page *>(operator new[](pool_size_ * sizeof(Page)));
   for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+    new (&pages_[i]) Page(frame_arena_->GetFrame(i));
   }
+  page_table_ = new ShardedHashTable<page_id_t, frame_id_t>(page_table_shards_);
+  replacer_ = MakeReplacer(replacer_policy, pool_size, replacer_k);
 
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-/*  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager_instance.cpp`.");*/
+  // Initially, every page is in the free list, and owned by the buffer pool.
+  ring_slot_ = std::make_unique<std::atomic<int>[]>(pool_size_);
+  read_state_ = std::make_unique<std::atomic<int>[]>(pool_size_);
+  read_ahead_ = std::make_unique<std::atomic<bool>[]>(pool_size_);
+  cleaning_ = std::make_unique<std::atomic<bool>[]>(pool_size_);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = -1;
+    ring_slot_[i] = NOT_IN_RING;
+    read_state_[i] = READ_DONE;
+    read_ahead_[i] = false;
+    cleaning_[i] = false;
+    free_list_.emplace_back(static_cast<int>(i));
+  }
+  // Keep the ring small relative to the pool, so that scans can never take over a large part of it.
+  scan_ring_.assign(std::clamp<size_t>(pool_size_ / 8, 1, SCAN_RING_SIZE), NOT_IN_RING);
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  StopCleaner();
+  {
+    std::unique_lock<std::mutex> lock(read_latch_);
+    read_cv_.wait(lock, [&] { return reads_in_flight_ == 0; });
+  }
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  operator delete[](pages_);
   delete page_table_;
-  delete replacer_;
+}
+
+auto BufferPoolManagerInstance::TryPin(frame_id_t frame_id, bool *was_unpinned) -> bool {
+  auto &pin_count = pages_[frame_id].pin_count_;
+  int current = pin_count.load();
+  while (current >= 0) {
+    if (pin_count.compare_exchange_weak(current, current + 1)) {
+      *was_unpinned = current == 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::SyncEvictable(frame_id_t frame_id) {
+  const auto &pin_count = pages_[frame_id].pin_count_;
+  int current = pin_count.load();
+  while (current >= 0) {
+    replacer_->SetEvictable(frame_id, current == 0);
+    int now = pin_count.load();
+    if ((now == 0) == (current == 0)) {
+      return;
+    }
+    current = now;
+  }
+}
+
+auto BufferPoolManagerInstance::PinResidentPage(page_id_t page_id, AccessType access_type) -> Page * {
+  frame_id_t frame_id;
+  bool was_unpinned = false;
+  if (!page_table_->FindAndApply(page_id, &frame_id,
+                                 [&](frame_id_t frame) { return TryPin(frame, &was_unpinned); })) {
+    return nullptr;
+  }
+  // Scans do not count as accesses, so they cannot make a page look hot to the replacer.
+  if (access_type != AccessType::Scan) {
+    if (ring_slot_[frame_id].load() != NOT_IN_RING && ring_slot_[frame_id].exchange(NOT_IN_RING) != NOT_IN_RING) {
+      // A lookup wants a page that a scan brought in: move the frame from the ring into the main pool.
+      replacer_->AssignPage(frame_id, page_id);
+    }
+    if (!read_ahead_[frame_id].exchange(false)) {
+      replacer_->RecordAccess(frame_id);
+    }
+  }
+  if (was_unpinned) {
+    SyncEvictable(frame_id);
+  }
+  WaitForRead(frame_id);
+  return &pages_[frame_id];
+}
+
+void BufferPoolManagerInstance::WaitForRead(frame_id_t frame_id) {
+  if (read_state_[frame_id].load() == READ_DONE) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(read_latch_);
+  read_cv_.wait(lock, [&] { return read_state_[frame_id].load() != READ_PENDING; });
+  stats_.CountPinWait(NanosSince(start));
+  if (read_state_[frame_id].load() == READ_DONE) {
+    return;
+  }
+  // The read-ahead failed. Read the page again; other fetches wait for this read as they did for the read-ahead.
+  read_state_[frame_id] = READ_PENDING;
+  lock.unlock();
+  ReadFrame(frame_id);
+}
+
+void BufferPoolManagerInstance::ReadFrame(frame_id_t frame_id) {
+  stats_.CountReads(1);
+  try {
+    disk_manager_->ReadPage(pages_[frame_id].page_id_, pages_[frame_id].GetData());
+  } catch (const Exception &e) {
+    // The page is corrupt or unreadable on disk. Leave the frame failed for the next fetch to try again, and give up
+    // our pin.
+    {
+      std::scoped_lock<std::mutex> lock(read_latch_);
+      read_state_[frame_id] = READ_FAILED;
+    }
+    read_cv_.notify_all();
+    if (pages_[frame_id].pin_count_.fetch_sub(1) == 1) {
+      SyncEvictable(frame_id);
+    }
+    throw;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(read_latch_);
+    read_state_[frame_id] = READ_DONE;
+  }
+  read_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FinishRead(frame_id_t frame_id, bool ok) {
+  {
+    std::scoped_lock<std::mutex> lock(read_latch_);
+    read_state_[frame_id] = ok ? READ_DONE : READ_FAILED;
+  }
+  read_cv_.notify_all();
+  // The state is final before the pin goes, so a frame can never be reused while this read may still change it.
+  if (pages_[frame_id].pin_count_.fetch_sub(1) == 1) {
+    SyncEvictable(frame_id);
+  }
+  std::scoped_lock<std::mutex> lock(read_latch_);
+  reads_in_flight_--;
+  read_cv_.notify_all();
+}
+
+auto BufferPoolManagerInstance::GetVictimFrame(frame_id_t *frame_id, bool reclaim_scan_ring) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  // The oldest page a scan brought in is a better victim than anything the replacer tracks. Taking it also hands the
+  // ring's frames back to the pool once scans stop.
+  if (reclaim_scan_ring && RecycleScanRingSlot(scan_ring_next_, frame_id)) {
+    scan_ring_[scan_ring_next_] = NOT_IN_RING;
+    ring_slot_[*frame_id] = NOT_IN_RING;
+    scan_ring_next_ = (scan_ring_next_ + 1) % scan_ring_.size();
+    return true;
+  }
+  while (replacer_->Evict(frame_id)) {
+    Page *victim = &pages_[*frame_id];
+    int expected = 0;
+    if (!victim->pin_count_.compare_exchange_strong(expected, -1)) {
+      // A latch-free hit pinned the frame after the replacer picked it. Hand it back and try the next candidate.
+      replacer_->AssignPage(*frame_id, victim->page_id_);
+      replacer_->RecordAccess(*frame_id);
+      SyncEvictable(*frame_id);
+      continue;
+    }
+    // No one can pin the frame any more, and once the mapping is gone no one can find it either.
+    page_table_->Remove(victim->page_id_);
+    stats_.CountEviction(victim->is_dirty_);
+    if (victim->is_dirty_) {
+      disk_manager_->WritePage(victim->page_id_, victim->GetData());
+      // The cleaner, if there is one, fell behind.
+      cleaner_cv_.notify_all();
+    }
+    CacheEvictedPage(*frame_id);
+    victim->ResetMemory();
+    victim->page_id_ = INVALID_PAGE_ID;
+    victim->is_dirty_ = false;
+    return true;
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::StartCleaner(size_t num_threads, size_t clean_target) {
+  std::scoped_lock<std::mutex> lock(cleaner_latch_);
+  if (!cleaner_threads_.empty()) {
+    return;
+  }
+  cleaner_stop_ = false;
+  clean_target_ = clean_target;
+  for (size_t i = 0; i < num_threads; i++) {
+    cleaner_threads_.emplace_back(&BufferPoolManagerInstance::RunCleaner, this, i, num_threads);
+  }
+}
+
+void BufferPoolManagerInstance::StopCleaner() {
+  {
+    std::scoped_lock<std::mutex> lock(cleaner_latch_);
+    cleaner_stop_ = true;
+  }
+  cleaner_cv_.notify_all();
+  for (auto &thread : cleaner_threads_) {
+    thread.join();
+  }
+  cleaner_threads_.clear();
+}
+
+void BufferPoolManagerInstance::RunCleaner(size_t thread_index, size_t num_threads) {
+  // The page images this thread writes from, one per victim it can get in a pass. Page-aligned for direct I/O.
+  size_t max_writes = (clean_target_ + num_threads - 1) / num_threads;
+  auto free_images = [](char *images) { operator delete[](images, std::align_val_t(BUSTUB_PAGE_SIZE)); };
+  std::unique_ptr<char[], decltype(free_images)> images(
+      new (std::align_val_t(BUSTUB_PAGE_SIZE)) char[std::max<size_t>(max_writes, 1) * BUSTUB_PAGE_SIZE], free_images);
+  std::unique_lock<std::mutex> lock(cleaner_latch_);
+  while (!cleaner_stop_) {
+    lock.unlock();
+    // Start every write of the pass before waiting for any, so that the disk gets them all at once.
+    std::vector<std::pair<frame_id_t, std::future<bool>>> writes;
+    auto candidates = replacer_->EvictionCandidates(clean_target_);
+    for (size_t i = thread_index; i < candidates.size() && writes.size() < max_writes; i += num_threads) {
+      std::future<bool> write;
+      if (StartCleaning(candidates[i], images.get() + writes.size() * BUSTUB_PAGE_SIZE, &write)) {
+        writes.emplace_back(candidates[i], std::move(write));
+      }
+    }
+    for (auto &[frame_id, write] : writes) {
+      FinishCleaning(frame_id, write.get());
+    }
+    lock.lock();
+    // Go again right away only while there is work; pages held back by the WAL or by a writer do not count.
+    if (writes.empty() && !cleaner_stop_) {
+      cleaner_cv_.wait_for(lock, cleaner_interval);
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::StartCleaning(frame_id_t frame_id, char *image, std::future<bool> *write) -> bool {
+  Page *page = &pages_[frame_id];
+  bool was_unpinned = false;
+  // Pinning through the frame rather than the page table is enough here: a pinned frame cannot be handed to another
+  // page, and its page id is only read once the pin is held.
+  if (!page->is_dirty_ || !TryPin(frame_id, &was_unpinned)) {
+    return false;
+  }
+  if (was_unpinned) {
+    SyncEvictable(frame_id);
+  }
+  // Never wait for a page latch: the cleaner does not follow the latch order of the tree and the table heap. Writers
+  // hold the write latch while they modify the page, so the image copied under the read latch is consistent. A writer
+  // that finished but has not unpinned yet sets the dirty bit again, which costs a second write but loses nothing.
+  bool started = false;
+  if (!cleaning_[frame_id].exchange(true)) {
+    if (page->TryRLatch()) {
+      bool log_persisted =
+          !enable_logging || log_manager_ == nullptr || page->GetLSN() <= log_manager_->GetPersistentLSN();
+      if (page->is_dirty_ && log_persisted) {
+        page->is_dirty_ = false;
+        memcpy(image, page->GetData(), BUSTUB_PAGE_SIZE);
+        started = true;
+      }
+      page->RUnlatch();
+    }
+    if (started) {
+      stats_.CountWrite();
+      *write = disk_manager_->WritePageAsync(page->page_id_, image, nullptr);
+      return true;
+    }
+    cleaning_[frame_id] = false;
+  }
+  if (page->pin_count_.fetch_sub(1) == 1) {
+    SyncEvictable(frame_id);
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::FinishCleaning(frame_id_t frame_id, bool written) {
+  Page *page = &pages_[frame_id];
+  if (!written) {
+    page->is_dirty_ = true;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(cleaner_latch_);
+    cleaning_[frame_id] = false;
+  }
+  cleaner_cv_.notify_all();
+  if (page->pin_count_.fetch_sub(1) == 1) {
+    SyncEvictable(frame_id);
+  }
+}
+
+void BufferPoolManagerInstance::WaitForCleaning(frame_id_t frame_id) {
+  if (!cleaning_[frame_id].load()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(cleaner_latch_);
+  cleaner_cv_.wait(lock, [&] { return !cleaning_[frame_id].load(); });
+}
+
+void BufferPoolManagerInstance::CacheEvictedPage(frame_id_t frame_id) {
+  // A frame whose read-ahead failed holds no valid data.
+  if (compressed_cache_ != nullptr && read_state_[frame_id].load() == READ_DONE) {
+    compressed_cache_->Put(pages_[frame_id].page_id_, pages_[frame_id].GetData());
+  }
+}
+
+void BufferPoolManagerInstance::EnableCompressedCache(size_t capacity) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  compressed_cache_ = capacity == 0 ? nullptr : std::make_unique<CompressedPageCache>(capacity);
+}
+
+auto BufferPoolManagerInstance::GetCompressedCacheStats() -> CompressedPageCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return compressed_cache_ == nullptr ? CompressedPageCacheStats{} : compressed_cache_->GetStats();
+}
+
+auto BufferPoolManagerInstance::RecycleScanRingSlot(size_t slot, frame_id_t *frame_id) -> bool {
+  frame_id_t current = scan_ring_[slot];
+  if (current == NOT_IN_RING) {
+    return false;
+  }
+  Page *page = &pages_[current];
+  int expected = 0;
+  if (page->pin_count_.compare_exchange_strong(expected, -1)) {
+    if (ring_slot_[current].load() == static_cast<int>(slot)) {
+      page_table_->Remove(page->page_id_);
+      stats_.CountEviction(page->is_dirty_);
+      if (page->is_dirty_) {
+        disk_manager_->WritePage(page->page_id_, page->GetData());
+      }
+      CacheEvictedPage(current);
+      page->ResetMemory();
+      page->page_id_ = INVALID_PAGE_ID;
+      page->is_dirty_ = false;
+      *frame_id = current;
+      return true;
+    }
+    // A lookup adopted the frame since the slot was filled; it belongs to the main pool now.
+    page->pin_count_ = 0;
+  } else if (ring_slot_[current].exchange(NOT_IN_RING) == static_cast<int>(slot)) {
+    // Someone is still reading the page. Let the replacer have the frame.
+    replacer_->AssignPage(current, page->page_id_);
+    replacer_->RecordAccess(current);
+    SyncEvictable(current);
+  }
+  scan_ring_[slot] = NOT_IN_RING;
+  return false;
+}
+
+auto BufferPoolManagerInstance::GetScanRingFrame(frame_id_t *frame_id) -> bool {
+  size_t slot = scan_ring_next_;
+  scan_ring_next_ = (scan_ring_next_ + 1) % scan_ring_.size();
+  if (RecycleScanRingSlot(slot, frame_id)) {
+    return true;
+  }
+  if (!GetVictimFrame(frame_id, false)) {
+    return false;
+  }
+  scan_ring_[slot] = *frame_id;
+  ring_slot_[*frame_id] = static_cast<int>(slot);
+  return true;
 }
 
 auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-       std::scoped_lock<std::mutex> lock(latch_);
-
-	frame_id_t frame_id;
-
-	if(!free_list_.empty()){
-		frame_id=free_list_.back();
-		free_list_.pop_back();
-		*page_id=AllocatePage();
-	}	
-	else if(replacer_->Evict(&frame_id)){
-		*page_id=AllocatePage();
-	}
-	else{
-		return nullptr;
-	}
-	
-	if(pages_[frame_id].is_dirty_)
-              disk_manager_->WritePage(*page_id,pages_[frame_id].GetData());
-
-	replacer_->SetEvictable(frame_id, false);
-	pages_[frame_id].ResetMemory();
-	pages_[frame_id].page_id_=*page_id;
-	pages_[frame_id].pin_count_++;
-	replacer_->RecordAccess(frame_id);
-	page_table_->Insert(*page_id,frame_id);
-	return &pages_[frame_id]; 
-}
-
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-	std::scoped_lock<std::mutex> lock(latch_);
-
-	frame_id_t frame_id;
-       	if(!page_table_->Find(page_id,frame_id)){
-      		frame_id_t frame_id;
-
-   	        if(!free_list_.empty()){
-                	frame_id=free_list_.back();
-               	        free_list_.pop_back();
-               	        page_id=AllocatePage();
-       		 }
-       		 else if(replacer_->Evict(&frame_id)){
-                	page_id=AllocatePage();
-       		 }
-		else{
-		 	return nullptr;
-		 }
-
-       		 if(pages_[frame_id].is_dirty_)
-             		 disk_manager_->WritePage(page_id,pages_[frame_id].GetData());
-
-   		 replacer_->SetEvictable(frame_id, false);
-       		 pages_[frame_id].ResetMemory();
-		 pages_[frame_id].page_id_=page_id;
-       		 pages_[frame_id].pin_count_++;
-     		 replacer_->RecordAccess(frame_id);
-       		 page_table_->Insert(page_id,frame_id);
-		 return &pages_[frame_id];
-	}
-	return &pages_[page_id];
-}
-auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool { 
-	std::scoped_lock<std::mutex> lock(latch_);
-
-	frame_id_t frame_id;
-	if(page_table_->Find(page_id,frame_id))
-		return false;
-	if(pages_[frame_id].pin_count_<=0)
-		return false;
-
-	if(!(--pages_[frame_id].pin_count_))
-		replacer_->SetEvictable(frame_id,true);
-
-	pages_[frame_id].is_dirty_=is_dirty;
-	return true;
-}
-
-auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool { 
-	std::scoped_lock<std::mutex> lock(latch_);
-
-	if(page_id==INVALID_PAGE_ID)
-		return false;
-	frame_id_t frame_id;
-	if(page_table_->Find(page_id,frame_id)){
-		disk_manager_->WritePage(page_id,pages_[frame_id].data_);
-		return true;
-	}
-	else{
-		return false;
-	}
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!GetVictimFrame(&frame_id)) {
+    return nullptr;
+  }
+  *page_id = AllocatePage();
+
+  Page *page = &pages_[frame_id];
+  page->page_id_ = *page_id;
+  page->is_dirty_ = false;
+  read_state_[frame_id] = READ_DONE;
+  read_ahead_[frame_id] = false;
+  page->pin_count_ = 1;
+  page_table_->Insert(*page_id, frame_id);
+  replacer_->AssignPage(frame_id, *page_id);
+  replacer_->RecordAccess(frame_id);
+  replacer_->SetEvictable(frame_id, false);
+  return page;
+}
+
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  ValidatePageId(page_id);
+  auto start = std::chrono::steady_clock::now();
+  // Fast path: the page is resident, so only a shard read latch and the pin count are touched.
+  if (Page *page = PinResidentPage(page_id, access_type); page != nullptr) {
+    stats_.CountHit(NanosSince(start));
+    return page;
+  }
+
+  auto wait_start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(latch_);
+  stats_.CountPinWait(NanosSince(wait_start));
+  // Another thread may have brought the page in, or finished replacing its frame, while we waited for the latch.
+  if (Page *page = PinResidentPage(page_id, access_type); page != nullptr) {
+    stats_.CountHit(NanosSince(start));
+    return page;
+  }
+
+  bool use_ring = access_type == AccessType::Scan;
+  frame_id_t frame_id;
+  if (!(use_ring ? GetScanRingFrame(&frame_id) : GetVictimFrame(&frame_id))) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  read_ahead_[frame_id] = false;
+  bool cached = compressed_cache_ != nullptr && compressed_cache_->Get(page_id, page->GetData());
+  // Publish the frame before reading into it, so the latch is not held across the disk read. Fetches of the page that
+  // come in meanwhile pin the frame and wait for the read in WaitForRead, and the pin keeps the frame from being
+  // replaced.
+  read_state_[frame_id] = cached ? READ_DONE : READ_PENDING;
+  page->pin_count_ = 1;
+  page_table_->Insert(page_id, frame_id);
+  if (!use_ring) {
+    replacer_->AssignPage(frame_id, page_id);
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+  }
+  lock.unlock();
+  if (!cached) {
+    ReadFrame(frame_id);
+  }
+  stats_.CountMiss(NanosSince(start));
+  return page;
+}
+
+auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  frame_id_t frame_id;
+  bool now_unpinned = false;
+  bool found = page_table_->FindAndApply(page_id, &frame_id, [&](frame_id_t frame) {
+    Page *page = &pages_[frame];
+    int current = page->pin_count_.load();
+    while (current > 0) {
+      // Publish the dirty bit before the pin is dropped, so whoever evicts the frame sees it.
+      if (is_dirty) {
+        page->is_dirty_ = true;
+      }
+      if (page->pin_count_.compare_exchange_weak(current, current - 1)) {
+        now_unpinned = current == 1;
+        return true;
+      }
+    }
+    return false;
+  });
+  if (!found) {
+    return false;
+  }
+  if (now_unpinned) {
+    SyncEvictable(frame_id);
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, frame_id)) {
+    return false;
+  }
+  // A page that is still being read ahead is clean, and its frame does not hold it yet.
+  if (read_state_[frame_id].load() != READ_DONE) {
+    return true;
+  }
+  WaitForCleaning(frame_id);
+  // Clear the flag first: a concurrent writer that unpins dirty during the write will set it again.
+  pages_[frame_id].is_dirty_ = false;
+  stats_.CountWrite();
+  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+  return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-	std::scoped_lock<std::mutex> lock(latch_);
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].page_id_ == INVALID_PAGE_ID || read_state_[i].load() != READ_DONE) {
+      continue;
+    }
+    WaitForCleaning(static_cast<frame_id_t>(i));
+    pages_[i].is_dirty_ = false;
+    stats_.CountWrite();
+    disk_manager_->WritePage(pages_[i].page_id_, pages_[i].GetData());
+  }
+}
 
-	frame_id_t frame_id;
-	for(size_t i=0;i<pool_size_;i++){
-		page_table_->Find(pages_[i].page_id_,frame_id);
-		disk_manager_->WritePage(pages_[i].page_id_,pages_[i].data_);
-	}
-	
+void BufferPoolManagerInstance::PrefetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool use_ring = access_type == AccessType::Scan;
+  size_t budget = use_ring ? scan_ring_.size() / 2 : page_ids.size();
+  for (page_id_t page_id : page_ids) {
+    ValidatePageId(page_id);
+    frame_id_t frame_id;
+    if (budget == 0) {
+      break;
+    }
+    // Read-ahead may guess page ids that were never allocated or have been freed. NewPgImp assumes the id it allocates
+    // is not in the page table, so those are never brought in.
+    if (!disk_manager_->IsAllocated(page_id) || page_table_->Find(page_id, frame_id)) {
+      continue;
+    }
+    if (!(use_ring ? GetScanRingFrame(&frame_id) : GetVictimFrame(&frame_id))) {
+      break;
+    }
+    budget--;
+    Page *page = &pages_[frame_id];
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    // The read holds a pin until it completes.
+    page->pin_count_ = 1;
+    read_state_[frame_id] = READ_PENDING;
+    {
+      std::scoped_lock<std::mutex> read_lock(read_latch_);
+      reads_in_flight_++;
+    }
+    page_table_->Insert(page_id, frame_id);
+    if (!use_ring) {
+      replacer_->AssignPage(frame_id, page_id);
+      replacer_->RecordAccess(frame_id);
+      replacer_->SetEvictable(frame_id, false);
+    }
+    read_ahead_[frame_id] = !use_ring;
+    if (compressed_cache_ != nullptr && compressed_cache_->Get(page_id, page->GetData())) {
+      FinishRead(frame_id, true);
+      continue;
+    }
+    stats_.CountReads(1);
+    disk_manager_->ReadPageAsync(page_id, page->GetData(), [this, frame_id](bool ok) { FinishRead(frame_id, ok); });
+  }
 }
 
-auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool { 
-	std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, frame_id)) {
+    if (compressed_cache_ != nullptr) {
+      compressed_cache_->Erase(page_id);
+    }
+    DeallocatePage(page_id);
+    return true;
+  }
+  Page *page = &pages_[frame_id];
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, -1)) {
+    return false;
+  }
+  page_table_->Remove(page_id);
+  if (int slot = ring_slot_[frame_id].exchange(NOT_IN_RING); slot != NOT_IN_RING) {
+    scan_ring_[slot] = NOT_IN_RING;
+  }
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  free_list_.push_back(frame_id);
+  DeallocatePage(page_id);
+  return true;
+}
 
-	if(pages_[page_id].pin_count_>0)
-		return false;
-	frame_id_t frame_id;
-	if(!page_table_->Find(page_id,frame_id)){
-		return true;	
-	}
-	page_table_->Remove(frame_id);
-	free_list_.emplace_back(frame_id);
-	return true;
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  const page_id_t page_id = disk_manager_->AllocatePage(num_instances_, instance_index_);
+  ValidatePageId(page_id);
+  return page_id;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
+}
 
 }  // namespace bustub
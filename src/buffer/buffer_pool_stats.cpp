@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+namespace bustub {
+
+/** @return the latency bucket of a duration */
+static auto LatencyBucket(uint64_t ns) -> size_t {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < FETCH_LATENCY_BUCKETS) {
+    ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+auto BufferPoolStats::operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  pages_read_ += other.pages_read_;
+  pages_written_ += other.pages_written_;
+  evictions_ += other.evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  pin_wait_ns_ += other.pin_wait_ns_;
+  for (size_t i = 0; i < FETCH_LATENCY_BUCKETS; i++) {
+    fetch_latency_[i] += other.fetch_latency_[i];
+  }
+  return *this;
+}
+
+auto IoStats::operator+=(const IoStats &other) -> IoStats & {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  pages_read_ += other.pages_read_;
+  pages_written_ += other.pages_written_;
+  return *this;
+}
+
+auto BufferPoolStats::HitRatio() const -> double {
+  uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+auto BufferPoolStats::FetchLatencyPercentile(double fraction) const -> uint64_t {
+  uint64_t total = 0;
+  for (auto count : fetch_latency_) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  auto target = static_cast<uint64_t>(fraction * static_cast<double>(total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < FETCH_LATENCY_BUCKETS; i++) {
+    seen += fetch_latency_[i];
+    if (seen > target || seen == total) {
+      return uint64_t{2} << i;
+    }
+  }
+  return uint64_t{2} << (FETCH_LATENCY_BUCKETS - 1);
+}
+
+auto BufferPoolCounters::LocalSlot() -> Slot & {
+  static std::atomic<size_t> next_slot{0};
+  thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % NUM_SLOTS;
+  return slots_[slot];
+}
+
+void BufferPoolCounters::CountHit(uint64_t latency_ns) {
+  Slot &slot = LocalSlot();
+  slot.hits_.fetch_add(1, std::memory_order_relaxed);
+  slot.fetch_latency_[LatencyBucket(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+  if (IoStats *stats = IoStatsScope::Current(); stats != nullptr) {
+    stats->hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::CountMiss(uint64_t latency_ns) {
+  Slot &slot = LocalSlot();
+  slot.misses_.fetch_add(1, std::memory_order_relaxed);
+  slot.fetch_latency_[LatencyBucket(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+  if (IoStats *stats = IoStatsScope::Current(); stats != nullptr) {
+    stats->misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::CountReads(uint64_t pages) {
+  LocalSlot().pages_read_.fetch_add(pages, std::memory_order_relaxed);
+  if (IoStats *stats = IoStatsScope::Current(); stats != nullptr) {
+    stats->pages_read_.fetch_add(pages, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::CountWrite() {
+  LocalSlot().pages_written_.fetch_add(1, std::memory_order_relaxed);
+  if (IoStats *stats = IoStatsScope::Current(); stats != nullptr) {
+    stats->pages_written_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::CountEviction(bool dirty) {
+  Slot &slot = LocalSlot();
+  slot.evictions_.fetch_add(1, std::memory_order_relaxed);
+  if (dirty) {
+    slot.dirty_evictions_.fetch_add(1, std::memory_order_relaxed);
+    CountWrite();
+  }
+}
+
+void BufferPoolCounters::CountPinWait(uint64_t wait_ns) {
+  LocalSlot().pin_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+}
+
+auto BufferPoolCounters::Snapshot() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (const auto &slot : slots_) {
+    stats.hits_ += slot.hits_.load(std::memory_order_relaxed);
+    stats.misses_ += slot.misses_.load(std::memory_order_relaxed);
+    stats.pages_read_ += slot.pages_read_.load(std::memory_order_relaxed);
+    stats.pages_written_ += slot.pages_written_.load(std::memory_order_relaxed);
+    stats.evictions_ += slot.evictions_.load(std::memory_order_relaxed);
+    stats.dirty_evictions_ += slot.dirty_evictions_.load(std::memory_order_relaxed);
+    stats.pin_wait_ns_ += slot.pin_wait_ns_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < FETCH_LATENCY_BUCKETS; i++) {
+      stats.fetch_latency_[i] += slot.fetch_latency_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return stats;
+}
+
+void BufferPoolCounters::Reset() {
+  for (auto &slot : slots_) {
+    slot.hits_ = 0;
+    slot.misses_ = 0;
+    slot.pages_read_ = 0;
+    slot.pages_written_ = 0;
+    slot.evictions_ = 0;
+    slot.dirty_evictions_ = 0;
+    slot.pin_wait_ns_ = 0;
+    for (auto &count : slot.fetch_latency_) {
+      count = 0;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.cpp
+//
+// Identification: src/buffer/clock_pro_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ClockProReplacer::ClockProReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      cold_target_(std::max<size_t>(num_frames / 4, 1)),
+      frames_(num_frames),
+      non_resident_(num_frames) {}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // Every full sweep of the cold hand without a victim demotes a hot page, so an evictable page is found eventually
+  // even if all of them are hot.
+  for (size_t steps = 1;; steps++) {
+    auto &frame = frames_[hand_cold_];
+    size_t current = hand_cold_;
+    hand_cold_ = Advance(hand_cold_);
+    if (steps % num_frames_ == 0) {
+      RunHotHand();
+    }
+    if (frame.status_ != Status::Cold || !frame.evictable_) {
+      continue;
+    }
+    if (frame.ref_) {
+      frame.ref_ = false;
+      if (frame.test_) {
+        // Re-referenced within its test period: the page has a small reuse distance.
+        frame.status_ = Status::Hot;
+        frame.test_ = false;
+        num_hot_++;
+        BalanceHot();
+      } else {
+        frame.test_ = true;
+      }
+      continue;
+    }
+    if (frame.test_) {
+      non_resident_.Push(frame.page_id_);
+    }
+    frame = FrameInfo{};
+    curr_size_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+}
+
+void ClockProReplacer::BalanceHot() {
+  while (num_hot_ > 0 && num_hot_ > num_frames_ - cold_target_) {
+    RunHotHand();
+  }
+}
+
+void ClockProReplacer::RunHotHand() {
+  for (size_t steps = 0; steps < num_frames_ && num_hot_ > 0; steps++) {
+    auto &frame = frames_[hand_hot_];
+    hand_hot_ = Advance(hand_hot_);
+    if (frame.status_ == Status::Cold && frame.test_) {
+      // The test period ended without a re-reference, so the cold area was larger than needed.
+      frame.test_ = false;
+      cold_target_ = std::max<size_t>(cold_target_ - 1, 1);
+      continue;
+    }
+    if (frame.status_ != Status::Hot) {
+      continue;
+    }
+    if (frame.ref_) {
+      frame.ref_ = false;
+      continue;
+    }
+    frame.status_ = Status::Cold;
+    num_hot_--;
+    return;
+  }
+}
+
+void ClockProReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.status_ != Status::None) {
+    frame.ref_ = true;
+    return;
+  }
+  if (non_resident_.Erase(frame.page_id_)) {
+    // Faulted on a page still in its test period: the cold area is too small.
+    cold_target_ = std::min(cold_target_ + 1, std::max<size_t>(num_frames_ - 1, 1));
+    frame.status_ = Status::Hot;
+    num_hot_++;
+    BalanceHot();
+  } else {
+    frame.status_ = Status::Cold;
+    frame.test_ = true;
+  }  non_resident_.Trim();
+}
+
+void ClockProReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.status_ == Status::None || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ClockProReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.status_ == Status::None) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "cannot remove a non-evictable frame");
+  if (frame.status_ == Status::Hot) {
+    num_hot_--;
+  }
+  frame = FrameInfo{};
+  curr_size_--;
+}
+
+auto ClockProReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // Unreferenced cold pages go first, then referenced cold pages, which may get promoted instead, then hot pages,
+  // which have to be demoted before they can go.
+  auto collect = [&](Status status, bool ref) {
+    for (size_t i = 0; i < frames_.size() && candidates.size() < max_frames; i++) {
+      size_t current = (hand_cold_ + i) % frames_.size();
+      const auto &frame = frames_[current];
+      if (frame.status_ == status && frame.evictable_ && frame.ref_ == ref) {
+        candidates.push_back(static_cast<frame_id_t>(current));
+      }
+    }
+  };
+  collect(Status::Cold, false);
+  collect(Status::Cold, true);
+  collect(Status::Hot, false);
+  collect(Status::Hot, true);
+  return candidates;
+}
+
+auto ClockProReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void ClockProReplacer::AssignPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  frames_[frame_id].page_id_ = page_id;
+}
+
+}  // namespace bustub
@@ -12,18 +12,92 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // Every evictable frame passed over loses its reference bit, so this takes at most two sweeps.
+  while (true) {
+    auto &frame = frames_[hand_];
+    size_t current = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!frame.tracked_ || !frame.evictable_) {
+      continue;
+    }
+    if (frame.ref_) {
+      frame.ref_ = false;
+      continue;
+    }
+    frame = Entry{};
+    curr_size_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  frame.tracked_ = true;
+  frame.ref_ = true;
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "cannot remove a non-evictable frame");
+  frame = Entry{};
+  curr_size_--;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+auto ClockReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // The hand takes the frames without a reference bit on its first sweep, and the others on the second.
+  for (bool ref : {false, true}) {
+    for (size_t i = 0; i < frames_.size() && candidates.size() < max_frames; i++) {
+      size_t current = (hand_ + i) % frames_.size();
+      const auto &frame = frames_[current];
+      if (frame.tracked_ && frame.evictable_ && frame.ref_ == ref) {
+        candidates.push_back(static_cast<frame_id_t>(current));
+      }
+    }
+  }
+  return candidates;
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
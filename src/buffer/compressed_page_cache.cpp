@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace bustub {
+
+/*
+ * The compressed format is a sequence of sequences. Each starts with a token byte whose high nibble is the number of
+ * literals and whose low nibble is the match length minus MIN_MATCH. A nibble of 15 is continued by bytes that are
+ * added to it, up to and including the first byte below 255. Then come the literals, then the 2-byte little-endian
+ * distance back to the match. The last sequence has literals only and ends the input.
+ */
+
+static constexpr size_t HASH_BITS = 12;
+static constexpr size_t MAX_DISTANCE = 65535;
+
+static auto Read32(const char *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static auto Hash(uint32_t value) -> size_t { return (value * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Append the continuation bytes of a length whose nibble is 15. @return false if dst is full */
+static auto WriteLength(size_t length, char *dst, size_t capacity, size_t *op) -> bool {
+  for (; length >= 255; length -= 255) {
+    if (*op >= capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(255);
+  }
+  if (*op >= capacity) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(length);
+  return true;
+}
+
+/** Read the continuation bytes of a length whose nibble is 15. @return false if src ends first */
+static auto ReadLength(const char *src, size_t size, size_t *ip, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*ip >= size) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(src[(*ip)++]);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/** Append a sequence; match_length 0 makes it the last one. @return false if dst is full */
+static auto WriteSequence(const char *literals, size_t literal_length, size_t distance, size_t match_length, char *dst,
+                          size_t capacity, size_t *op) -> bool {
+  if (*op >= capacity) {
+    return false;
+  }
+  size_t match_code = match_length == 0 ? 0 : match_length - PageCompressor::MIN_MATCH;
+  dst[(*op)++] = static_cast<char>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15));
+  if (literal_length >= 15 && !WriteLength(literal_length - 15, dst, capacity, op)) {
+    return false;
+  }
+  if (*op + literal_length > capacity) {
+    return false;
+  }
+  memcpy(dst + *op, literals, literal_length);
+  *op += literal_length;
+  if (match_length == 0) {
+    return true;
+  }
+  if (*op + 2 > capacity) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(distance & 0xFF);
+  dst[(*op)++] = static_cast<char>(distance >> 8);
+  return match_code < 15 || WriteLength(match_code - 15, dst, capacity, op);
+}
+
+auto PageCompressor::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  // Positions plus one, so that zero means empty.
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+  // Like LZ4, look further apart the longer nothing matches, so that incompressible data goes by quickly.
+  size_t misses = 0;
+  while (ip + MIN_MATCH <= size) {
+    uint32_t value = Read32(src + ip);
+    size_t h = Hash(value);
+    size_t candidate = table[h];
+    table[h] = static_cast<uint32_t>(ip + 1);
+    if (candidate == 0 || ip - (candidate - 1) > MAX_DISTANCE || Read32(src + candidate - 1) != value) {
+      ip += 1 + (misses++ >> 6);
+      continue;
+    }
+    misses = 0;
+    size_t match = candidate - 1;
+    size_t length = MIN_MATCH;
+    while (ip + length < size && src[match + length] == src[ip + length]) {
+      length++;
+    }
+    if (!WriteSequence(src + anchor, ip - anchor, ip - match, length, dst, capacity, &op)) {
+      return 0;
+    }
+    ip += length;
+    anchor = ip;
+  }
+  if (!WriteSequence(src + anchor, size - anchor, 0, 0, dst, capacity, &op)) {
+    return 0;
+  }
+  return op;
+}
+
+auto PageCompressor::Decompress(const char *src, size_t size, char *dst, size_t decompressed_size) -> bool {
+  size_t ip = 0;
+  size_t op = 0;
+  // Input that ends anywhere but after the literals of a sequence is truncated.
+  while (ip < size) {
+    auto token = static_cast<uint8_t>(src[ip++]);
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(src, size, &ip, &literal_length)) {
+      return false;
+    }
+    if (literal_length > size - ip || literal_length > decompressed_size - op) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == size) {
+      return op == decompressed_size;
+    }
+    if (size - ip < 2) {
+      return false;
+    }
+    size_t distance = static_cast<uint8_t>(src[ip]) | (static_cast<size_t>(static_cast<uint8_t>(src[ip + 1])) << 8);
+    ip += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(src, size, &ip, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (distance == 0 || distance > op || match_length > decompressed_size - op) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, as a run of one repeated byte does, so copy forward byte by byte.
+    for (size_t i = 0; i < match_length; i++, op++) {
+      dst[op] = dst[op - distance];
+    }
+  }
+  return false;
+}
+
+auto CompressedPageCacheStats::operator+=(const CompressedPageCacheStats &other) -> CompressedPageCacheStats & {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  insertions_ += other.insertions_;
+  evictions_ += other.evictions_;
+  pages_ += other.pages_;
+  bytes_ += other.bytes_;
+  return *this;
+}
+
+auto CompressedPageCacheStats::HitRatio() const -> double {
+  uint64_t lookups = hits_ + misses_;
+  return lookups == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(lookups);
+}
+
+auto CompressedPageCacheStats::CompressionRatio() const -> double {
+  return bytes_ == 0 ? 0 : static_cast<double>(pages_ * BUSTUB_PAGE_SIZE) / static_cast<double>(bytes_);
+}
+
+CompressedPageCache::CompressedPageCache(size_t capacity) : capacity_(capacity) {}
+
+void CompressedPageCache::Put(page_id_t page_id, const char *data) {
+  // Compress outside the latch, so that lookups do not wait for it.
+  std::vector<char> compressed(BUSTUB_PAGE_SIZE);
+  size_t size = PageCompressor::Compress(data, BUSTUB_PAGE_SIZE, compressed.data(), BUSTUB_PAGE_SIZE - 1);
+  if (size == 0) {
+    compressed.assign(data, data + BUSTUB_PAGE_SIZE);
+  } else {
+    compressed.resize(size);
+    compressed.shrink_to_fit();
+  }
+  if (compressed.size() > capacity_) {
+    return;
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    TakeEntry(it);
+  }
+  while (bytes_ + compressed.size() > capacity_) {
+    TakeEntry(entries_.find(lru_.back()));
+    stats_.evictions_++;
+  }
+  lru_.push_front(page_id);
+  bytes_ += compressed.size();
+  entries_.emplace(page_id, Entry{std::move(compressed), lru_.begin()});
+  stats_.insertions_++;
+}
+
+auto CompressedPageCache::Get(page_id_t page_id, char *data) -> bool {
+  std::vector<char> compressed;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto it = entries_.find(page_id);
+    if (it == entries_.end()) {
+      stats_.misses_++;
+      return false;
+    }
+    compressed = TakeEntry(it);
+    stats_.hits_++;
+  }
+  if (compressed.size() == BUSTUB_PAGE_SIZE) {
+    memcpy(data, compressed.data(), BUSTUB_PAGE_SIZE);
+    return true;
+  }
+  return PageCompressor::Decompress(compressed.data(), compressed.size(), data, BUSTUB_PAGE_SIZE);
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    TakeEntry(it);
+  }
+}
+
+auto CompressedPageCache::GetStats() -> CompressedPageCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  CompressedPageCacheStats stats = stats_;
+  stats.pages_ = entries_.size();
+  stats.bytes_ = bytes_;
+  return stats;
+}
+
+auto CompressedPageCache::TakeEntry(std::unordered_map<page_id_t, Entry>::iterator it) -> std::vector<char> {
+  std::vector<char> data = std::move(it->second.data_);
+  bytes_ -= data.size();
+  lru_.erase(it->second.lru_position_);
+  entries_.erase(it);
+  return data;
+}
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<linux/mempolicy.h>) && defined(__NR_mbind)
+#include <linux/mempolicy.h>
+#define BUSTUB_HAS_MBIND
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+FrameArena::FrameArena(size_t num_frames, bool huge_pages, int numa_node) {
+  size_t size = std::max<size_t>(num_frames, 1) * BUSTUB_PAGE_SIZE;
+  huge_pages = huge_pages && size >= HUGE_PAGE_SIZE;
+  void *addr = MAP_FAILED;
+  if (huge_pages) {
+    // Reserved hugetlb pages are guaranteed to be huge, but most systems reserve none.
+    mapped_size_ = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    addr = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    backing_ = FrameArenaBacking::HugeTlbPages;
+  }
+  if (addr == MAP_FAILED && huge_pages) {
+    // Transparent huge pages only back 2 MB aligned ranges, so map a little more and cut it down to an aligned range.
+    addr = mmap(nullptr, mapped_size_ + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr != MAP_FAILED) {
+      auto start = reinterpret_cast<uintptr_t>(addr);
+      uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+      if (aligned > start) {
+        munmap(addr, aligned - start);
+      }
+      munmap(reinterpret_cast<void *>(aligned + mapped_size_), start + HUGE_PAGE_SIZE - aligned);
+      addr = reinterpret_cast<void *>(aligned);
+      backing_ = madvise(addr, mapped_size_, MADV_HUGEPAGE) == 0 ? FrameArenaBacking::TransparentHugePages
+                                                                  : FrameArenaBacking::SmallPages;
+    }
+  }
+  if (addr == MAP_FAILED) {
+    mapped_size_ = size;
+    addr = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    backing_ = FrameArenaBacking::SmallPages;
+  }
+  if (addr == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't map buffer pool frames");
+  }
+  data_ = static_cast<char *>(addr);
+
+#ifdef BUSTUB_HAS_MBIND
+  if (numa_node >= 0 && numa_node < static_cast<int>(sizeof(unsigned long) * 8)) {  // NOLINT
+    // Nothing has been touched yet, so every page of the arena is allocated on the node.
+    unsigned long node_mask = 1UL << numa_node;  // NOLINT
+    if (syscall(__NR_mbind, data_, mapped_size_, MPOL_PREFERRED, &node_mask, sizeof(node_mask) * 8, 0) == 0) {
+      numa_node_ = numa_node;
+    } else {
+      LOG_DEBUG("mbind failed: %s", strerror(errno));
+    }
+  }
+#endif
+}
+
+FrameArena::~FrameArena() { munmap(data_, mapped_size_); }
+
+auto FrameArena::NumaNodeCount() -> int {
+  // The file lists the nodes with memory as ranges, e.g. "0-1,3".
+  std::ifstream online("/sys/devices/system/node/has_memory");
+  std::string ranges;
+  if (!(online >> ranges)) {
+    return 1;
+  }
+  int count = 0;
+  size_t pos = 0;
+  while (pos < ranges.size()) {
+    size_t end = ranges.find(',', pos);
+    std::string range = ranges.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    size_t dash = range.find('-');
+    count += dash == std::string::npos ? 1 : std::stoi(range.substr(dash + 1)) - std::stoi(range.substr(0, dash)) + 1;
+    pos = end == std::string::npos ? ranges.size() : end + 1;
+  }
+  return std::max(count, 1);
+}
+
+}  // namespace bustub
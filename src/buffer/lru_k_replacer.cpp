@@ -12,129 +12,170 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <queue>
+#include <utility>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k){
-		max_size=num_frames;
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), frames_(num_frames), history_(num_frames * k) {
+  heap_.reserve(num_frames);
 }
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool{
-	 std::scoped_lock<std::mutex> lock(latch_);
-        size_t min_ts=current_timestamp_+1;//earliest timestamp
-	std::list<k_distance>::iterator max_k_iter;
-	frame_id_t max_k_id;
-        for(auto [k,v]:cache_le_k_){
-                if(frame_evict_[k]==true&&hist_timestamp_[k].front()<min_ts){
-                        min_ts=hist_timestamp_[k].front();
-                        max_k_iter=v;
-			max_k_id=k;
-                }
-        }
-
-        if(min_ts<(current_timestamp_+1)){
-                *frame_id=max_k_id;
-                hist_timestamp_.erase(max_k_id);
-                cache_frame_.erase(max_k_iter);
-                cache_le_k_.erase(max_k_id);
-               // replacer_size_--;
-              //  return true;
-        }else{
-        	size_t max_k=0;
-   	     for(auto [k,v]:cache_k_){
-                if(frame_evict_[k]==true&&cache_k_[k]->second>max_k){
-                        max_k=cache_k_[k]->second;
-			max_k_id=k;
-                        max_k_iter=v;
-                }
-       	     }
-
-       	     if(max_k){
-                *frame_id=max_k_id;
-                hist_timestamp_.erase(max_k_id);
-                cache_frame_.erase(max_k_iter);
-                cache_k_.erase(max_k_id);
-              //replacer_size_--;
-               // return true;
-             }else{
-	     	return false;
-	     }
-	}
-	return true;
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (heap_.empty()) {
+    return false;
+  }
+  frame_id_t victim = heap_.front();
+  HeapErase(victim);
+  frames_[victim] = FrameInfo{};
+  curr_size_--;
+  *frame_id = victim;
+  return true;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
-	 std::scoped_lock<std::mutex> lock(latch_);
-        current_timestamp_++;
-	replacer_size_--;
-        BUSTUB_ASSERT((long unsigned)frame_id>=replacer_size_,"The frame id is invlaid!\n");
-
-        if(hist_timestamp_.find(frame_id)==hist_timestamp_.end()){
-                std::list<timestamp> *ptr=new std::list<timestamp>;
-                ptr->emplace_back(current_timestamp_);
-                hist_timestamp_.emplace(frame_id,*ptr);
-                cache_frame_.emplace_back(std::make_pair(frame_id,INT_MAX));
-                cache_le_k_.emplace(frame_id,--(cache_frame_.end()));
-        }
-        else{
-		auto iter=hist_timestamp_.find(frame_id);
-                if(iter->second.size()==(k_-1)){
-                        iter->second.emplace_back(current_timestamp_);
-			auto iter_id=cache_le_k_.find(frame_id);
-                        cache_k_.emplace(frame_id,iter_id->second);
-			cache_le_k_.erase(iter_id);
-                }
-                else if(iter->second.size()==k_){
-                        iter->second.emplace_back(current_timestamp_);
-                        iter->second.pop_front();
-                }
-                else{
-                        iter->second.emplace_back(current_timestamp_);
-                }
-        }
-
-        for(auto [frame_id,k_iter]:cache_k_){
-   k_iter->second=hist_timestamp_[frame_id].back()-hist_timestamp_[frame_id].front();
-        }
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  history_[frame_id * k_ + frame.head_] = current_timestamp_++;
+  frame.head_ = (frame.head_ + 1) % k_;
+  if (frame.count_ < k_) {
+    frame.count_++;
+  }
+  // The oldest timestamp only moves forward, so the frame can only sink in the heap.
+  if (frame.heap_pos_ != NOT_IN_HEAP) {
+    SiftDown(frame.heap_pos_);
+  }
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.count_ == 0 || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapPush(frame_id);
+    curr_size_++;
+  } else {
+    HeapErase(frame_id);
+    curr_size_--;
+  }
 }
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable){
-	 std::scoped_lock<std::mutex> lock(latch_);
-        BUSTUB_ASSERT((unsigned long)frame_id>=replacer_size_,"The frame id is invlaid!\n");
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.count_ == 0) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "cannot remove a non-evictable frame");
+  HeapErase(frame_id);
+  frame = FrameInfo{};
+  curr_size_--;
+}
+
+auto LRUKReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // The next victim is always the smallest heap entry still to be listed, and it is the child of one already listed,
+  // so a frontier of heap positions ordered like the heap yields the victims in order.
+  auto later = [this](size_t a, size_t b) { return EvictsBefore(heap_[b], heap_[a]); };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(later)> frontier(later);
+  if (!heap_.empty()) {
+    frontier.push(0);
+  }
+  while (!frontier.empty() && candidates.size() < max_frames) {
+    size_t pos = frontier.top();
+    frontier.pop();
+    candidates.push_back(heap_[pos]);
+    for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap_.size(); child++) {
+      frontier.push(child);
+    }
+  }
+  return candidates;
+}
 
-        if(frame_evict_.at(frame_id)==true&&set_evictable==false)
-                replacer_size_--;
-        if(frame_evict_.at(frame_id)==false&&set_evictable==true)
-                replacer_size_++;
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
 }
 
-void LRUKReplacer::Remove(frame_id_t frame_id){
-	 std::scoped_lock<std::mutex> lock(latch_);
+auto LRUKReplacer::Oldest(frame_id_t frame_id) const -> timestamp {
+  const auto &frame = frames_[frame_id];
+  // Until the ring wraps around, slot 0 holds the first access; afterwards the next slot to be overwritten does.
+  return history_[frame_id * k_ + (frame.count_ < k_ ? 0 : frame.head_)];
+}
 
-        auto iter=frame_evict_.find(frame_id);
-    	if(iter==frame_evict_.end())
-		return;
+auto LRUKReplacer::EvictsBefore(frame_id_t a, frame_id_t b) const -> bool {
+  // Frames with +inf backward k-distance go first. Within either group, the smallest oldest timestamp wins.
+  bool a_inf = frames_[a].count_ < k_;
+  bool b_inf = frames_[b].count_ < k_;
+  if (a_inf != b_inf) {
+    return a_inf;
+  }
+  return Oldest(a) < Oldest(b);
+}
 
-	BUSTUB_ASSERT(frame_evict_.at(frame_id)==false,"The frame is non-evictable!\n");
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  frames_[frame_id].heap_pos_ = heap_.size();
+  heap_.push_back(frame_id);
+  SiftUp(heap_.size() - 1);
+}
 
-	auto iter_rm=cache_k_.find(frame_id);
-	//std::unordered_map<frame_id_t,std::list<k_distance>::iterator> iter_rm=cache_k_.find(frame_id);
-	if(iter_rm!=cache_k_.end()){
-        	iter_rm=cache_k_.find(frame_id);
-		cache_k_.erase(frame_id);
-	}else{
-		iter_rm=cache_le_k_.find(frame_id);
-		cache_le_k_.erase(frame_id);
-	}
+void LRUKReplacer::HeapErase(frame_id_t frame_id) {
+  size_t pos = frames_[frame_id].heap_pos_;
+  size_t last = heap_.size() - 1;
+  if (pos != last) {
+    HeapSwap(pos, last);
+  }
+  heap_.pop_back();
+  frames_[frame_id].heap_pos_ = NOT_IN_HEAP;
+  if (pos < heap_.size()) {
+    SiftUp(pos);
+    SiftDown(pos);
+  }
+}
 
-        hist_timestamp_.erase(frame_id);
-        cache_frame_.erase(iter_rm->second);
-               // replacer_size_--;
- }
+void LRUKReplacer::HeapSwap(size_t i, size_t j) {
+  std::swap(heap_[i], heap_[j]);
+  frames_[heap_[i]].heap_pos_ = i;
+  frames_[heap_[j]].heap_pos_ = j;
+}
 
-auto LRUKReplacer::Size() -> size_t{
-	 std::scoped_lock<std::mutex> lock(latch_);
+void LRUKReplacer::SiftUp(size_t pos) {
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (!EvictsBefore(heap_[pos], heap_[parent])) {
+      return;
+    }
+    HeapSwap(pos, parent);
+    pos = parent;
+  }
+}
 
-        return max_size-replacer_size_;
+void LRUKReplacer::SiftDown(size_t pos) {
+  while (true) {
+    size_t smallest = pos;
+    size_t left = 2 * pos + 1;
+    size_t right = left + 1;
+    if (left < heap_.size() && EvictsBefore(heap_[left], heap_[smallest])) {
+      smallest = left;
+    }
+    if (right < heap_.size() && EvictsBefore(heap_[right], heap_[smallest])) {
+      smallest = right;
+    }
+    if (smallest == pos) {
+      return;
+    }
+    HeapSwap(pos, smallest);
+    pos = smallest;
+  }
 }
 
 }  // namespace bustub
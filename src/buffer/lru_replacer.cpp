@@ -12,18 +12,81 @@
 
 #include "buffer/lru_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : num_pages_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (auto it = lru_list_.rbegin(); it != lru_list_.rend(); ++it) {
+    if (entries_[*it].evictable_) {
+      *frame_id = *it;
+      lru_list_.erase(std::next(it).base());
+      entries_.erase(*frame_id);
+      curr_size_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  auto it = entries_.find(frame_id);
+  if (it == entries_.end()) {
+    lru_list_.push_front(frame_id);
+    entries_[frame_id] = {lru_list_.begin(), false};
+    return;
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, it->second.pos_);
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "frame id is invalid");
+  auto it = entries_.find(frame_id);
+  if (it == entries_.end() || it->second.evictable_ == set_evictable) {
+    return;
+  }
+  it->second.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = entries_.find(frame_id);
+  if (it == entries_.end()) {
+    return;
+  }
+  BUSTUB_ASSERT(it->second.evictable_, "cannot remove a non-evictable frame");
+  lru_list_.erase(it->second.pos_);
+  entries_.erase(it);
+  curr_size_--;
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+auto LRUReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  for (auto it = lru_list_.rbegin(); it != lru_list_.rend() && candidates.size() < max_frames; ++it) {
+    if (entries_[*it].evictable_) {
+      candidates.push_back(*it);
+    }
+  }
+  return candidates;
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy)
+    : pool_size_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_policy));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t { return instances_.size() * pool_size_; }
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::ResetStats() {
+  for (auto &instance : instances_) {
+    instance->ResetStats();
+  }
+}
+
+void ParallelBufferPoolManager::StartCleaner(size_t num_threads, size_t clean_target) {
+  for (auto &instance : instances_) {
+    instance->StartCleaner(num_threads, clean_target);
+  }
+}
+
+void ParallelBufferPoolManager::StopCleaner() {
+  for (auto &instance : instances_) {
+    instance->StopCleaner();
+  }
+}
+
+void ParallelBufferPoolManager::EnableCompressedCache(size_t capacity) {
+  for (auto &instance : instances_) {
+    instance->EnableCompressedCache(capacity / instances_.size());
+  }
+}
+
+auto ParallelBufferPoolManager::GetCompressedCacheStats() -> CompressedPageCacheStats {
+  CompressedPageCacheStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetCompressedCacheStats();
+  }
+  return stats;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) {
+  std::vector<std::vector<page_id_t>> by_instance(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    by_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!by_instance[i].empty()) {
+      instances_[i]->PrefetchPages(by_instance[i], access_type);
+    }
+  }
+}
+
+}  // namespace bustub
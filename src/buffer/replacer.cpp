@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (policy) {
+    case ReplacerPolicy::LRU:
+      return std::make_unique<LRUReplacer>(num_frames);
+    case ReplacerPolicy::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerPolicy::Clock:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacerPolicy::ClockPro:
+      return std::make_unique<ClockProReplacer>(num_frames);
+    case ReplacerPolicy::TwoQueue:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+  }
+  throw Exception("unknown replacer policy");
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacerPolicy::LRU:
+      return "lru";
+    case ReplacerPolicy::LRUK:
+      return "lru-k";
+    case ReplacerPolicy::Clock:
+      return "clock";
+    case ReplacerPolicy::ClockPro:
+      return "clock-pro";
+    case ReplacerPolicy::TwoQueue:
+      return "2q";
+    case ReplacerPolicy::ARC:
+      return "arc";
+  }
+  return "unknown";
+}
+
+auto ParseReplacerPolicy(const std::string &name, ReplacerPolicy *policy) -> bool {
+  std::string lower = name;
+  std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+  for (auto candidate : {ReplacerPolicy::LRU, ReplacerPolicy::LRUK, ReplacerPolicy::Clock, ReplacerPolicy::ClockPro,
+                         ReplacerPolicy::TwoQueue, ReplacerPolicy::ARC}) {
+    if (lower == ReplacerPolicyToString(candidate)) {
+      *policy = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+// The sizes recommended by the paper: A1in holds 25% of the frames, A1out remembers 50% of them.
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : kin_(std::max<size_t>(num_frames / 4, 1)), frames_(num_frames), a1out_(std::max<size_t>(num_frames / 2, 1)) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  if (a1in_.size() > kin_ || am_.empty()) {
+    if (EvictFrom(&a1in_, frame_id)) {
+      return true;
+    }
+    return EvictFrom(&am_, frame_id);
+  }
+  if (EvictFrom(&am_, frame_id)) {
+    return true;
+  }
+  return EvictFrom(&a1in_, frame_id);
+}
+
+auto TwoQueueReplacer::EvictFrom(std::list<frame_id_t> *queue, frame_id_t *frame_id) -> bool {
+  for (auto it = queue->rbegin(); it != queue->rend(); ++it) {
+    auto &frame = frames_[*it];
+    if (!frame.evictable_) {
+      continue;
+    }
+    *frame_id = *it;
+    if (frame.queue_ == Queue::A1In) {
+      a1out_.Push(frame.page_id_);
+    }
+    queue->erase(std::next(it).base());
+    frame = FrameInfo{};
+    curr_size_--;
+    return true;
+  }
+  return false;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  switch (frame.queue_) {
+    case Queue::Am:
+      am_.splice(am_.begin(), am_, frame.pos_);
+      return;
+    case Queue::A1In:
+      // Correlated references to a page in A1in do not count as proof that it is hot.
+      return;
+    case Queue::None:
+      break;
+  }
+  if (a1out_.Erase(frame.page_id_)) {
+    frame.queue_ = Queue::Am;
+    am_.push_front(frame_id);
+    frame.pos_ = am_.begin();
+  } else {
+    frame.queue_ = Queue::A1In;
+    a1in_.push_front(frame_id);
+    frame.pos_ = a1in_.begin();
+  }  a1out_.Trim();
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::None || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::None) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "cannot remove a non-evictable frame");
+  (frame.queue_ == Queue::Am ? am_ : a1in_).erase(frame.pos_);
+  frame = FrameInfo{};
+  curr_size_--;
+}
+
+auto TwoQueueReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  bool a1in_first = a1in_.size() > kin_ || am_.empty();
+  for (const auto *queue : {a1in_first ? &a1in_ : &am_, a1in_first ? &am_ : &a1in_}) {
+    for (auto it = queue->rbegin(); it != queue->rend() && candidates.size() < max_frames; ++it) {
+      if (frames_[*it].evictable_) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void TwoQueueReplacer::AssignPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  frames_[frame_id].page_id_ = page_id;
+}
+
+}  // namespace bustub
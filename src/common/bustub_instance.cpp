@@ -1,3 +1,4 @@
+#include <chrono>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -33,15 +34,76 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/page/header_page.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+/** Create a B+ tree index whose keys are the fixed-size key tuples, padded to KeySize bytes. */
+template <size_t KeySize>
+static auto CreateGenericIndex(Catalog *catalog, Transaction *txn, const IndexStatement &index_stmt,
+                               const Schema &key_schema, const std::vector<uint32_t> &col_ids) -> IndexInfo * {
+  return catalog->CreateIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>(
+      txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids, KeySize,
+      HashFunction<GenericKey<KeySize>>{});
+}
+
+/**
+ * Create a B+ tree index on the key columns of index_stmt. Keys with a VARCHAR column are stored at their actual
+ * length; all others take the smallest GenericKey that holds the key tuple.
+ */
+static auto CreateIndexForKeySchema(Catalog *catalog, Transaction *txn, const IndexStatement &index_stmt,
+                                    const Schema &key_schema, const std::vector<uint32_t> &col_ids) -> IndexInfo * {
+  if (!key_schema.IsInlined()) {
+    return catalog->CreateIndex<VarcharKeyType, RID, VarcharComparatorType>(
+        txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+        VARCHAR_KEY_SIZE, VarcharHashFunctionType{});
+  }
+  uint32_t key_size = key_schema.GetLength();
+  if (key_size <= 4) {
+    return CreateGenericIndex<4>(catalog, txn, index_stmt, key_schema, col_ids);
+  }
+  if (key_size <= 8) {
+    return CreateGenericIndex<8>(catalog, txn, index_stmt, key_schema, col_ids);
+  }
+  if (key_size <= 16) {
+    return CreateGenericIndex<16>(catalog, txn, index_stmt, key_schema, col_ids);
+  }
+  if (key_size <= 32) {
+    return CreateGenericIndex<32>(catalog, txn, index_stmt, key_schema, col_ids);
+  }
+  if (key_size <= 64) {
+    return CreateGenericIndex<64>(catalog, txn, index_stmt, key_schema, col_ids);
+  }
+  throw NotImplementedException(fmt::format("index keys are limited to 64 bytes, got {}", key_size));
+}
+
+/**
+ * B+ tree indexes record their root page ids in the header page, which is page 0. Allocate it before the first table
+ * can take page 0 for its first page. A database file that already existed had it allocated when it was created.
+ */
+void BustubInstance::ReserveHeaderPage() {
+  if (buffer_pool_manager_ == nullptr) {
+    return;
+  }
+  page_id_t page_id;
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->NewPage(&page_id));
+  if (page_id != HEADER_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    return;
+  }
+  header_page->Init();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  exec_ctx->SetDegreeOfParallelism(GetDegreeOfParallelism());
+  return exec_ctx;
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, ReplacerPolicy replacer_policy) {
   enable_logging = false;
 
   // Storage related.
@@ -53,12 +115,15 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ =
+        new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_, replacer_policy);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
 
+  ReserveHeaderPage();
+
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
   txn_manager_ = new TransactionManager(lock_manager_, log_manager_);
@@ -91,6 +156,8 @@ BustubInstance::BustubInstance() {
     buffer_pool_manager_ = nullptr;
   }
 
+  ReserveHeaderPage();
+
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
   txn_manager_ = new TransactionManager(lock_manager_, log_manager_);
@@ -146,6 +213,36 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    WriteOneCell("buffer_stats=", writer);
+    return;
+  }
+  auto stats = buffer_pool_manager_->GetStats();
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("stat");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  auto write_row = [&](const std::string &stat, const std::string &value) {
+    writer.BeginRow();
+    writer.WriteCell(stat);
+    writer.WriteCell(value);
+    writer.EndRow();
+  };
+  write_row("hits", fmt::format("{}", stats.hits_));
+  write_row("misses", fmt::format("{}", stats.misses_));
+  write_row("hit_ratio", fmt::format("{:.4f}", stats.HitRatio()));
+  write_row("pages_read", fmt::format("{}", stats.pages_read_));
+  write_row("pages_written", fmt::format("{}", stats.pages_written_));
+  write_row("evictions", fmt::format("{}", stats.evictions_));
+  write_row("dirty_evictions", fmt::format("{}", stats.dirty_evictions_));
+  write_row("pin_wait_ms", fmt::format("{:.3f}", static_cast<double>(stats.pin_wait_ns_) / 1e6));
+  write_row("fetch_p50_ns", fmt::format("{}", stats.FetchLatencyPercentile(0.5)));
+  write_row("fetch_p99_ns", fmt::format("{}", stats.FetchLatencyPercentile(0.99)));
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -167,7 +264,9 @@ of the query, so it's normal that you'll get a wrong result when executing
 unsupported SQL queries. This shell will be able to run `create table` only
 after you have completed the buffer pool manager. It will be able to execute SQL
 queries after you have implemented necessary query executors. Use `explain` to
-see the execution plan of your query.
+see the execution plan of your query, and `explain analyze` to run it and see
+the rows, time and buffer pool work of each operator. `show buffer_stats` shows
+what the buffer pool has done since the start.
 )";
   WriteOneCell(help, writer);
 }
@@ -228,19 +327,14 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
+          if (index_stmt.table_->schema_.GetColumn(idx).GetType() == TypeId::INVALID) {
+            throw NotImplementedException("cannot create index on a column without a type");
           }
         }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
-        }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        IndexInfo *info = CreateIndexForKeySchema(catalog_, txn, index_stmt, key_schema, col_ids);
         l.unlock();
 
         if (info == nullptr) {
@@ -251,6 +345,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
+        if (show_stmt.variable_ == "buffer_stats") {
+          CmdDisplayBufferStats(writer);
+          continue;
+        }
         auto content = GetSessionVariable(show_stmt.variable_);
         WriteOneCell(fmt::format("{}={}", show_stmt.variable_, content), writer);
         continue;
@@ -300,6 +398,36 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
           output += "\n";
         }
 
+        // Run the query and print what each operator did. The I/O of an operator does not include its children's.
+        if ((explain_stmt.options_ & ExplainOptions::ANALYZE) != 0) {
+          auto exec_ctx = MakeExecutorContext(txn);
+          exec_ctx->EnableAnalyze();
+          auto start = std::chrono::steady_clock::now();
+          is_successful &= execution_engine_->Execute(optimized_plan, nullptr, txn, exec_ctx.get());
+          auto elapsed = std::chrono::steady_clock::now() - start;
+          IoStats total;
+          output += "=== ANALYZE ===";
+          output += "\n";
+          output += optimized_plan->ToAnnotatedString([&](const AbstractPlanNode &plan) {
+            const auto *stats = exec_ctx->GetOperatorStats(&plan);
+            uint64_t hits = stats->io_.hits_;
+            uint64_t misses = stats->io_.misses_;
+            uint64_t reads = stats->io_.pages_read_;
+            uint64_t writes = stats->io_.pages_written_;
+            total.hits_ += hits;
+            total.misses_ += misses;
+            total.pages_read_ += reads;
+            total.pages_written_ += writes;
+            return fmt::format("rows={} time={:.3f}ms hits={} misses={} reads={} writes={}", stats->rows_.load(),
+                               static_cast<double>(stats->time_ns_) / 1e6, hits, misses, reads, writes);
+          });
+          output += "\n";
+          output += fmt::format("Total: time={:.3f}ms hits={} misses={} reads={} writes={}",
+                                std::chrono::duration<double, std::milli>(elapsed).count(), total.hits_.load(),
+                                total.misses_.load(), total.pages_read_.load(), total.pages_written_.load());
+          output += "\n";
+        }
+
         WriteOneCell(output, writer);
 
         continue;
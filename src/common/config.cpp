@@ -20,4 +20,20 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds cleaner_interval = std::chrono::milliseconds(10);
+
+std::atomic<int> read_ahead_pages(8);
+
+std::atomic<int> bulk_load_fill_percent(90);
+
+std::atomic<bool> enable_huge_pages(true);
+
+std::atomic<bool> enable_page_checksums(true);
+
+std::atomic<bool> enable_batch_execution(true);
+
+std::atomic<bool> enable_expression_compilation(true);
+
+std::atomic<bool> enable_page_predicates(true);
+
 }  // namespace bustub
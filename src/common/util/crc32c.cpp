@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.cpp
+//
+// Identification: src/common/util/crc32c.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define BUSTUB_CRC32C_X86 1
+#endif
+
+namespace bustub {
+
+/** The Castagnoli polynomial, bit-reversed. */
+static constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+/** Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes. */
+static auto MakeTables() -> std::array<std::array<uint32_t, 256>, 8> {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (uint32_t b = 0; b < 256; b++) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? CRC32C_POLYNOMIAL : 0);
+    }
+    tables[0][b] = crc;
+  }
+  for (size_t k = 1; k < 8; k++) {
+    for (uint32_t b = 0; b < 256; b++) {
+      tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+    }
+  }
+  return tables;
+}
+
+static const std::array<std::array<uint32_t, 256>, 8> TABLES = MakeTables();
+
+auto Crc32c::ComputeSoftware(const char *data, size_t size, uint32_t crc) -> uint32_t {
+  const auto *p = reinterpret_cast<const uint8_t *>(data);
+  crc = ~crc;
+  for (; size >= 8; size -= 8, p += 8) {
+    uint32_t low;
+    uint32_t high;
+    memcpy(&low, p, sizeof(low));
+    memcpy(&high, p + 4, sizeof(high));
+    low ^= crc;
+    crc = TABLES[7][low & 0xFF] ^ TABLES[6][(low >> 8) & 0xFF] ^ TABLES[5][(low >> 16) & 0xFF] ^
+          TABLES[4][low >> 24] ^ TABLES[3][high & 0xFF] ^ TABLES[2][(high >> 8) & 0xFF] ^
+          TABLES[1][(high >> 16) & 0xFF] ^ TABLES[0][high >> 24];
+  }
+  for (; size > 0; size--, p++) {
+    crc = (crc >> 8) ^ TABLES[0][(crc ^ *p) & 0xFF];
+  }
+  return ~crc;
+}
+
+#ifdef BUSTUB_CRC32C_X86
+__attribute__((target("sse4.2"))) static auto ComputeHardware(const char *data, size_t size, uint32_t crc)
+    -> uint32_t {
+  uint64_t crc64 = ~crc;
+  for (; size >= 8; size -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  auto crc32 = static_cast<uint32_t>(crc64);
+  for (; size > 0; size--, data++) {
+    crc32 = _mm_crc32_u8(crc32, static_cast<uint8_t>(*data));
+  }
+  return ~crc32;
+}
+
+static const bool HAS_SSE42 = __builtin_cpu_supports("sse4.2");
+#endif
+
+auto Crc32c::Compute(const char *data, size_t size, uint32_t crc) -> uint32_t {
+#ifdef BUSTUB_CRC32C_X86
+  if (HAS_SSE42) {
+    return ComputeHardware(data, size, crc);
+  }
+#endif
+  return ComputeSoftware(data, size, crc);
+}
+
+auto Crc32c::IsHardwareAccelerated() -> bool {
+#ifdef BUSTUB_CRC32C_X86
+  return HAS_SSE42;
+#else
+  return false;
+#endif
+}
+
+}  // namespace bustub
@@ -24,10 +24,7 @@ namespace bustub {
 template <typename K, typename V>
 ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
     : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {
-
-	auto ptr=std::make_shared<Bucket>(bucket_size,0);
-	dir_.emplace_back(ptr);
-	dir_.reserve(1);
+  dir_.emplace_back(std::make_shared<Bucket>(bucket_size, 0));
 }
 
 template <typename K, typename V>
@@ -75,58 +72,59 @@ auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-   std::scoped_lock<std::mutex> lock(latch_);
-   return dir_[IndexOf(key)]->Find(key,value);
- }
+  std::scoped_lock<std::mutex> lock(latch_);
+  return dir_[IndexOf(key)]->Find(key, value);
+}
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-        std::scoped_lock<std::mutex> lock(latch_);
-	return dir_[IndexOf(key)]->Remove(key);
+  std::scoped_lock<std::mutex> lock(latch_);
+  return dir_[IndexOf(key)]->Remove(key);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  while (!dir_[IndexOf(key)]->Insert(key, value)) {
+    auto bucket = dir_[IndexOf(key)];
+    if (bucket->GetDepth() == global_depth_) {
+      // Double the directory: the upper half mirrors the lower half.
+      size_t old_size = dir_.size();
+      dir_.reserve(old_size * 2);
+      for (size_t i = 0; i < old_size; i++) {
+        dir_.push_back(dir_[i]);
+      }
+      global_depth_++;
+    }
+    RedistributeBucket(bucket);
+  }
 }
 
 template <typename K, typename V>
-void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) { 
-       	std::scoped_lock<std::mutex> lock(latch_);
-	std::shared_ptr<Bucket> ptr=dir_[IndexOf(key)];
-        if(ptr->Insert(key,value))
-                return;
-
-	//std::shared_ptr<Bucket> ptr=dir_[IndexOf(key)];
-	while(!ptr->Insert(key,value)){
-           if(global_depth_==ptr->GetDepth()){
-                dir_.reserve(dir_.capacity() * 2);
-                int i=1<<global_depth_;//index of the end,corner case:1<<0=1
-                int up_step;
-                while(i>0){
-			i=i-1;
-			up_step=(1<<(global_depth_ - dir_[i]->GetDepth())) - 1;
-					//corner case:1<<0-1=0
-			i=i-up_step;
-                        for(int j=0;j<2*(up_step+1);j++){
-                                dir_[2*i+j]=dir_[i];
-                        }
-                }
-		ptr->IncrementDepth();
-                ++global_depth_;
-		dir_[IndexOf(key)]=std::make_shared<Bucket>(bucket_size_,ptr->GetDepth());
-          }else{
-		ptr->IncrementDepth();
-		auto ptr_new=std::make_shared<Bucket>(bucket_size_,ptr->GetDepth());
-		int mask=~((1<<(global_depth_ - ptr->GetDepth()))-1);
-		//gloabl_depth_ - ptr->GetDepth()>0,corner case:~(1<<(2-1-1)-1)=0xffffffff
-		for(int k=0;k<mask;k++){
-			dir_[(IndexOf(key)&mask)+k]=ptr_new;
-		}
-	  }
-		
-	  for(auto iter=ptr->GetItems().begin();iter!=ptr->GetItems().end();iter++){
-	  	if(reinterpret_cast<int*>(iter->first)==reinterpret_cast<int*>(IndexOf(key))){
-			dir_[IndexOf(key)]->GetItems().emplace_back(*iter);
-			iter=ptr->GetItems().erase(iter);
-		}
-	  }
-	}
+auto ExtendibleHashTable<K, V>::RedistributeBucket(std::shared_ptr<Bucket> bucket) -> void {
+  int local_depth = bucket->GetDepth();
+  size_t split_bit = 1U << local_depth;
+  auto sibling = std::make_shared<Bucket>(bucket_size_, local_depth + 1);
+  bucket->IncrementDepth();
+  num_buckets_++;
+
+  // Move every item whose hash has the split bit set into the sibling.
+  auto &items = bucket->GetItems();
+  for (auto it = items.begin(); it != items.end();) {
+    if ((std::hash<K>()(it->first) & split_bit) != 0) {
+      sibling->GetItems().emplace_back(*it);
+      it = items.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Repoint the directory slots that referenced the old bucket and have the split bit set.
+  for (size_t i = 0; i < dir_.size(); i++) {
+    if (dir_[i] == bucket && (i & split_bit) != 0) {
+      dir_[i] = sibling;
+    }
+  }
 }
 
 //===--------------------------------------------------------------------===//
@@ -137,51 +135,39 @@ ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
-	    typename std::list<std::pair<K,V>>::iterator iter;
-            for(iter=GetItems().begin();iter!=GetItems().end();iter++){
-                if(iter->first==key)
-		      	break;
-            }
-            if(iter==list_.end())
-		 return false;
-
-            value=iter->second;
-            return true;
+  for (const auto &[k, v] : list_) {
+    if (k == key) {
+      value = v;
+      return true;
+    }
+  }
+  return false;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
-	    typename std::list<std::pair<K,V>>::iterator iter;
-            for(iter=GetItems().begin();iter!=GetItems().end();iter++){
-                if(iter->first==key) 
-			break;
-            }
-            if(iter==list_.end()) 
-		    return false;
-
-            list_.erase(iter);
-	    size_--;
-            return true;
+  for (auto it = list_.begin(); it != list_.end(); ++it) {
+    if (it->first == key) {
+      list_.erase(it);
+      return true;
+    }
+  }
+  return false;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-        if(IsFull())
-	       	return false;
-
-	typename std::list<std::pair<K,V>>::iterator iter;
-        for(iter=GetItems().begin();iter!=GetItems().end();iter++){
-                if(iter->first==key)
-                        break;
-        }
-        if(iter==list_.end()){
-                list_.emplace_back(std::make_pair(key,value));
-	}
-	else{
-                iter->second=value;
-	}
-	size_++;
-        return true;
+  for (auto &[k, v] : list_) {
+    if (k == key) {
+      v = value;
+      return true;
+    }
+  }
+  if (IsFull()) {
+    return false;
+  }
+  list_.emplace_back(key, value);
+  return true;
 }
 
 template class ExtendibleHashTable<page_id_t, Page *>;
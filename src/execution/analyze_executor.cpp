@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// analyze_executor.cpp
+//
+// Identification: src/execution/analyze_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/analyze_executor.h"
+
+#include <chrono>  // NOLINT
+
+namespace bustub {
+
+AnalyzeExecutor::AnalyzeExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                                 std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      stats_(exec_ctx->GetOperatorStats(plan)),
+      child_executor_(std::move(child_executor)) {}
+
+void AnalyzeExecutor::Init() {
+  // The executors of the children open scopes of their own, so only this operator's own work lands in stats_->io_.
+  IoStatsScope scope(&stats_->io_);
+  auto start = std::chrono::steady_clock::now();
+  child_executor_->Init();
+  stats_->time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                          .count();
+}
+
+auto AnalyzeExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  IoStatsScope scope(&stats_->io_);
+  auto start = std::chrono::steady_clock::now();
+  bool produced = child_executor_->Next(tuple, rid);
+  stats_->time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                          .count();
+  if (produced) {
+    stats_->rows_++;
+  }
+  return produced;
+}
+
+auto AnalyzeExecutor::NextBatch(TupleBatch *batch) -> bool {
+  IoStatsScope scope(&stats_->io_);
+  auto start = std::chrono::steady_clock::now();
+  bool produced = child_executor_->NextBatch(batch);
+  stats_->time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                          .count();
+  stats_->rows_ += batch->Size();
+  return produced;
+}
+
+}  // namespace bustub
@@ -0,0 +1,449 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.cpp
+//
+// Identification: src/execution/compiled_expression.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_expression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the value that stands for null in a column of C++ type T */
+template <typename T>
+constexpr auto NullOf() -> T {
+  if constexpr (std::is_same_v<T, int8_t>) {
+    return BUSTUB_INT8_NULL;
+  } else if constexpr (std::is_same_v<T, int16_t>) {
+    return BUSTUB_INT16_NULL;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return BUSTUB_INT64_NULL;
+  } else {
+    return BUSTUB_DECIMAL_NULL;
+  }
+}
+
+/** @return true for the types that Compile() handles */
+auto IsCompilableType(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+auto IsNumericType(TypeId type) -> bool { return type != TypeId::BOOLEAN && IsCompilableType(type); }
+
+}  // namespace
+
+auto CompiledExpression::Compile(const AbstractExpression &expr, const Schema &schema)
+    -> std::unique_ptr<CompiledExpression> {
+  std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+  auto result = compiled->Emit(expr, schema);
+  if (!result.has_value()) {
+    return nullptr;
+  }
+  compiled->result_ = *result;
+  compiled->ret_type_ = compiled->register_types_[*result];
+  return compiled;
+}
+
+auto CompiledExpression::AddRegister(TypeId type) -> uint32_t {
+  registers_.emplace_back();
+  register_types_.push_back(type);
+  return static_cast<uint32_t>(registers_.size() - 1);
+}
+
+auto CompiledExpression::EmitToDecimal(uint32_t reg) -> uint32_t {
+  if (register_types_[reg] == TypeId::DECIMAL) {
+    return reg;
+  }
+  Instruction instruction{&ToDecimal};
+  instruction.lhs_ = reg;
+  instruction.dst_ = AddRegister(TypeId::DECIMAL);
+  program_.push_back(instruction);
+  return instruction.dst_;
+}
+
+auto CompiledExpression::Emit(const AbstractExpression &expr, const Schema &schema) -> std::optional<uint32_t> {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    if (column_expr->GetTupleIdx() != 0 || column_expr->GetColIdx() >= schema.GetColumnCount()) {
+      return std::nullopt;
+    }
+    const auto &column = schema.GetColumn(column_expr->GetColIdx());
+    if (!IsCompilableType(column.GetType()) || column.GetType() != expr.GetReturnType()) {
+      return std::nullopt;
+    }
+    Instruction instruction{nullptr};
+    switch (column.GetType()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        instruction.kernel_ = &Load<int8_t>;
+        break;
+      case TypeId::SMALLINT:
+        instruction.kernel_ = &Load<int16_t>;
+        break;
+      case TypeId::INTEGER:
+        instruction.kernel_ = &Load<int32_t>;
+        break;
+      case TypeId::BIGINT:
+        instruction.kernel_ = &Load<int64_t>;
+        break;
+      default:
+        instruction.kernel_ = &Load<double>;
+        break;
+    }
+    instruction.offset_ = column.GetOffset();
+    instruction.dst_ = AddRegister(column.GetType());
+    program_.push_back(instruction);
+    return instruction.dst_;
+  }
+
+  if (const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(&expr); constant_expr != nullptr) {
+    const auto &value = constant_expr->val_;
+    if (!IsCompilableType(value.GetTypeId())) {
+      return std::nullopt;
+    }
+    Instruction instruction{nullptr};
+    instruction.null_constant_ = value.IsNull();
+    if (value.GetTypeId() == TypeId::DECIMAL) {
+      instruction.kernel_ = &Constant<double>;
+      instruction.real_constant_ = instruction.null_constant_ ? 0 : value.GetAs<double>();
+    } else {
+      instruction.kernel_ = &Constant<int64_t>;
+      if (!instruction.null_constant_) {
+        switch (value.GetTypeId()) {
+          case TypeId::BOOLEAN:
+          case TypeId::TINYINT:
+            instruction.int_constant_ = value.GetAs<int8_t>();
+            break;
+          case TypeId::SMALLINT:
+            instruction.int_constant_ = value.GetAs<int16_t>();
+            break;
+          case TypeId::INTEGER:
+            instruction.int_constant_ = value.GetAs<int32_t>();
+            break;
+          default:
+            instruction.int_constant_ = value.GetAs<int64_t>();
+            break;
+        }
+      }
+    }
+    instruction.dst_ = AddRegister(value.GetTypeId());
+    program_.push_back(instruction);
+    return instruction.dst_;
+  }
+
+  if (expr.GetChildren().size() != 2) {
+    return std::nullopt;
+  }
+  auto lhs = Emit(*expr.GetChildAt(0), schema);
+  if (!lhs.has_value()) {
+    return std::nullopt;
+  }
+  auto rhs = Emit(*expr.GetChildAt(1), schema);
+  if (!rhs.has_value()) {
+    return std::nullopt;
+  }
+  TypeId lhs_type = register_types_[*lhs];
+  TypeId rhs_type = register_types_[*rhs];
+  Instruction instruction{nullptr};
+
+  if (const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(&expr); comparison_expr != nullptr) {
+    bool both_numeric = IsNumericType(lhs_type) && IsNumericType(rhs_type);
+    bool both_boolean = lhs_type == TypeId::BOOLEAN && rhs_type == TypeId::BOOLEAN;
+    if (!both_numeric && !both_boolean) {
+      return std::nullopt;
+    }
+    if (lhs_type == TypeId::DECIMAL || rhs_type == TypeId::DECIMAL) {
+      // Like Value, compare an integer to a DECIMAL as a double.
+      lhs = EmitToDecimal(*lhs);
+      rhs = EmitToDecimal(*rhs);
+      switch (comparison_expr->comp_type_) {
+        case ComparisonType::Equal:
+          instruction.kernel_ = &Compare<double, std::equal_to<>>;
+          break;
+        case ComparisonType::NotEqual:
+          instruction.kernel_ = &Compare<double, std::not_equal_to<>>;
+          break;
+        case ComparisonType::LessThan:
+          instruction.kernel_ = &Compare<double, std::less<>>;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          instruction.kernel_ = &Compare<double, std::less_equal<>>;
+          break;
+        case ComparisonType::GreaterThan:
+          instruction.kernel_ = &Compare<double, std::greater<>>;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          instruction.kernel_ = &Compare<double, std::greater_equal<>>;
+          break;
+      }
+    } else {
+      switch (comparison_expr->comp_type_) {
+        case ComparisonType::Equal:
+          instruction.kernel_ = &Compare<int64_t, std::equal_to<>>;
+          break;
+        case ComparisonType::NotEqual:
+          instruction.kernel_ = &Compare<int64_t, std::not_equal_to<>>;
+          break;
+        case ComparisonType::LessThan:
+          instruction.kernel_ = &Compare<int64_t, std::less<>>;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          instruction.kernel_ = &Compare<int64_t, std::less_equal<>>;
+          break;
+        case ComparisonType::GreaterThan:
+          instruction.kernel_ = &Compare<int64_t, std::greater<>>;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          instruction.kernel_ = &Compare<int64_t, std::greater_equal<>>;
+          break;
+      }
+    }
+    if (instruction.kernel_ == nullptr) {
+      return std::nullopt;
+    }
+    instruction.dst_ = AddRegister(TypeId::BOOLEAN);
+  } else if (const auto *arithmetic_expr = dynamic_cast<const ArithmeticExpression *>(&expr);
+             arithmetic_expr != nullptr) {
+    // ArithmeticExpression only takes INTEGER operands and computes an INTEGER, so that is the one kernel needed.
+    if (expr.GetReturnType() != TypeId::INTEGER || lhs_type != TypeId::INTEGER || rhs_type != TypeId::INTEGER) {
+      return std::nullopt;
+    }
+    bool plus = arithmetic_expr->compute_type_ == ArithmeticType::Plus;
+    if (!plus && arithmetic_expr->compute_type_ != ArithmeticType::Minus) {
+      return std::nullopt;
+    }
+    instruction.kernel_ = plus ? &Compute<int32_t, std::plus<>> : &Compute<int32_t, std::minus<>>;
+    instruction.dst_ = AddRegister(TypeId::INTEGER);
+  } else if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    if (lhs_type != TypeId::BOOLEAN || rhs_type != TypeId::BOOLEAN) {
+      return std::nullopt;
+    }
+    instruction.kernel_ = logic_expr->logic_type_ == LogicType::And ? &Logic<true> : &Logic<false>;
+    instruction.dst_ = AddRegister(TypeId::BOOLEAN);
+  } else {
+    return std::nullopt;
+  }
+
+  instruction.lhs_ = *lhs;
+  instruction.rhs_ = *rhs;
+  program_.push_back(instruction);
+  return instruction.dst_;
+}
+
+void CompiledExpression::Run(const TupleBatch &batch) {
+  rows_.resize(batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    rows_[i] = batch.TupleAt(i).GetData();
+  }
+  Execute(rows_.data(), rows_.size());
+}
+
+void CompiledExpression::Run(const Tuple &tuple) {
+  const char *row = tuple.GetData();
+  Execute(&row, 1);
+}
+
+void CompiledExpression::Execute(const char *const *rows, size_t count) {
+  for (size_t i = 0; i < registers_.size(); i++) {
+    auto &reg = registers_[i];
+    if (register_types_[i] == TypeId::DECIMAL) {
+      reg.reals_.resize(count);
+    } else {
+      reg.ints_.resize(count);
+    }
+    reg.nulls_.resize(count);
+  }
+  for (const auto &instruction : program_) {
+    instruction.kernel_(instruction, registers_.data(), rows, count);
+  }
+}
+
+auto CompiledExpression::GetValue(size_t row) const -> Value {
+  const auto &result = registers_[result_];
+  if (result.nulls_[row] != 0) {
+    return ValueFactory::GetNullValueByType(ret_type_);
+  }
+  switch (ret_type_) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(static_cast<int8_t>(result.ints_[row]));
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(result.ints_[row]));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(result.ints_[row]));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(result.ints_[row]));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(result.ints_[row]);
+    default:
+      return ValueFactory::GetDecimalValue(result.reals_[row]);
+  }
+}
+
+void CompiledExpression::SerializeTo(size_t row, char *storage) const {
+  const auto &result = registers_[result_];
+  bool is_null = result.nulls_[row] != 0;
+  switch (ret_type_) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT: {
+      auto value = is_null ? NullOf<int8_t>() : static_cast<int8_t>(result.ints_[row]);
+      memcpy(storage, &value, sizeof(value));
+      break;
+    }
+    case TypeId::SMALLINT: {
+      auto value = is_null ? NullOf<int16_t>() : static_cast<int16_t>(result.ints_[row]);
+      memcpy(storage, &value, sizeof(value));
+      break;
+    }
+    case TypeId::INTEGER: {
+      auto value = is_null ? NullOf<int32_t>() : static_cast<int32_t>(result.ints_[row]);
+      memcpy(storage, &value, sizeof(value));
+      break;
+    }
+    case TypeId::BIGINT: {
+      auto value = is_null ? NullOf<int64_t>() : result.ints_[row];
+      memcpy(storage, &value, sizeof(value));
+      break;
+    }
+    default: {
+      auto value = is_null ? NullOf<double>() : result.reals_[row];
+      memcpy(storage, &value, sizeof(value));
+      break;
+    }
+  }
+}
+
+template <typename T>
+void CompiledExpression::Load(const Instruction &instruction, Register *registers, const char *const *rows,
+                              size_t count) {
+  using Slot = std::conditional_t<std::is_same_v<T, double>, double, int64_t>;
+  auto &dst = registers[instruction.dst_];
+  Slot *values = dst.Values<Slot>().data();
+  uint8_t *nulls = dst.nulls_.data();
+  for (size_t i = 0; i < count; i++) {
+    T value;
+    memcpy(&value, rows[i] + instruction.offset_, sizeof(T));
+    values[i] = value;
+    nulls[i] = static_cast<uint8_t>(value == NullOf<T>());
+  }
+}
+
+template <typename T>
+void CompiledExpression::Constant(const Instruction &instruction, Register *registers, const char *const *rows,
+                                  size_t count) {
+  auto &dst = registers[instruction.dst_];
+  T value;
+  if constexpr (std::is_same_v<T, double>) {
+    value = instruction.real_constant_;
+  } else {
+    value = instruction.int_constant_;
+  }
+  std::fill_n(dst.Values<T>().data(), count, value);
+  std::fill_n(dst.nulls_.data(), count, static_cast<uint8_t>(instruction.null_constant_));
+}
+
+void CompiledExpression::ToDecimal(const Instruction &instruction, Register *registers, const char *const *rows,
+                                   size_t count) {
+  const auto &src = registers[instruction.lhs_];
+  auto &dst = registers[instruction.dst_];
+  for (size_t i = 0; i < count; i++) {
+    dst.reals_[i] = static_cast<double>(src.ints_[i]);
+  }
+  std::copy_n(src.nulls_.data(), count, dst.nulls_.data());
+}
+
+template <typename T, typename Op>
+void CompiledExpression::Compare(const Instruction &instruction, Register *registers, const char *const *rows,
+                                 size_t count) {
+  const T *lhs = registers[instruction.lhs_].Values<T>().data();
+  const T *rhs = registers[instruction.rhs_].Values<T>().data();
+  const uint8_t *lhs_nulls = registers[instruction.lhs_].nulls_.data();
+  const uint8_t *rhs_nulls = registers[instruction.rhs_].nulls_.data();
+  auto &dst = registers[instruction.dst_];
+  int64_t *out = dst.ints_.data();
+  uint8_t *out_nulls = dst.nulls_.data();
+  Op op;
+  for (size_t i = 0; i < count; i++) {
+    out[i] = static_cast<int64_t>(op(lhs[i], rhs[i]));
+    out_nulls[i] = lhs_nulls[i] | rhs_nulls[i];
+  }
+}
+
+template <typename T, typename Op>
+void CompiledExpression::Compute(const Instruction &instruction, Register *registers, const char *const *rows,
+                                 size_t count) {
+  const int64_t *lhs = registers[instruction.lhs_].ints_.data();
+  const int64_t *rhs = registers[instruction.rhs_].ints_.data();
+  const uint8_t *lhs_nulls = registers[instruction.lhs_].nulls_.data();
+  const uint8_t *rhs_nulls = registers[instruction.rhs_].nulls_.data();
+  auto &dst = registers[instruction.dst_];
+  int64_t *out = dst.ints_.data();
+  uint8_t *out_nulls = dst.nulls_.data();
+  Op op;
+  for (size_t i = 0; i < count; i++) {
+    // Wrap around on overflow instead of running into undefined behavior.
+    using Unsigned = std::make_unsigned_t<T>;
+    auto value = static_cast<T>(op(static_cast<Unsigned>(lhs[i]), static_cast<Unsigned>(rhs[i])));
+    out[i] = value;
+    // A result that happens to be the null value of the type reads as null, as it does for Value.
+    out_nulls[i] = lhs_nulls[i] | rhs_nulls[i] | static_cast<uint8_t>(value == NullOf<T>());
+  }
+}
+
+template <bool IsAnd>
+void CompiledExpression::Logic(const Instruction &instruction, Register *registers, const char *const *rows,
+                               size_t count) {
+  const int64_t *lhs = registers[instruction.lhs_].ints_.data();
+  const int64_t *rhs = registers[instruction.rhs_].ints_.data();
+  const uint8_t *lhs_nulls = registers[instruction.lhs_].nulls_.data();
+  const uint8_t *rhs_nulls = registers[instruction.rhs_].nulls_.data();
+  auto &dst = registers[instruction.dst_];
+  int64_t *out = dst.ints_.data();
+  uint8_t *out_nulls = dst.nulls_.data();
+  for (size_t i = 0; i < count; i++) {
+    bool lhs_true = lhs_nulls[i] == 0 && lhs[i] != 0;
+    bool rhs_true = rhs_nulls[i] == 0 && rhs[i] != 0;
+    bool lhs_false = lhs_nulls[i] == 0 && lhs[i] == 0;
+    bool rhs_false = rhs_nulls[i] == 0 && rhs[i] == 0;
+    if constexpr (IsAnd) {
+      // FALSE wins over NULL, and TRUE needs both sides.
+      out[i] = static_cast<int64_t>(lhs_true && rhs_true);
+      out_nulls[i] = static_cast<uint8_t>(!lhs_false && !rhs_false && !(lhs_true && rhs_true));
+    } else {
+      // TRUE wins over NULL, and FALSE needs both sides.
+      out[i] = static_cast<int64_t>(lhs_true || rhs_true);
+      out_nulls[i] = static_cast<uint8_t>(!lhs_true && !rhs_true && !(lhs_false && rhs_false));
+    }
+  }
+}
+
+}  // namespace bustub
@@ -17,8 +17,10 @@
 
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/analyze_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
@@ -42,12 +44,25 @@
 
 namespace bustub {
 
-auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan, const Morsel *morsel)
     -> std::unique_ptr<AbstractExecutor> {
+  if (morsel == nullptr && exec_ctx->GetDegreeOfParallelism() > 1 && GatherExecutor::CanParallelize(*plan)) {
+    // The gather creates a pipeline for each morsel, and those count the stats of the plan nodes under EXPLAIN ANALYZE.
+    return std::make_unique<GatherExecutor>(exec_ctx, plan);
+  }
+  auto executor = CreatePlanExecutor(exec_ctx, plan, morsel);
+  if (exec_ctx->IsAnalyze()) {
+    return std::make_unique<AnalyzeExecutor>(exec_ctx, plan.get(), std::move(executor));
+  }
+  return executor;
+}
+
+auto ExecutorFactory::CreatePlanExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                                         const Morsel *morsel) -> std::unique_ptr<AbstractExecutor> {
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()), morsel);
     }
 
     // Create a new index scan executor
@@ -117,20 +132,20 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
-      return std::make_unique<MockScanExecutor>(exec_ctx, mock_scan_plan);
+      return std::make_unique<MockScanExecutor>(exec_ctx, mock_scan_plan, morsel);
     }
 
     // Create a new projection executor
     case PlanType::Projection: {
       const auto *projection_plan = dynamic_cast<const ProjectionPlanNode *>(plan.get());
-      auto child = ExecutorFactory::CreateExecutor(exec_ctx, projection_plan->GetChildPlan());
+      auto child = ExecutorFactory::CreateExecutor(exec_ctx, projection_plan->GetChildPlan(), morsel);
       return std::make_unique<ProjectionExecutor>(exec_ctx, projection_plan, std::move(child));
     }
 
       // Create a new filter executor
     case PlanType::Filter: {
       const auto *filter_plan = dynamic_cast<const FilterPlanNode *>(plan.get());
-      auto child = ExecutorFactory::CreateExecutor(exec_ctx, filter_plan->GetChildPlan());
+      auto child = ExecutorFactory::CreateExecutor(exec_ctx, filter_plan->GetChildPlan(), morsel);
       return std::make_unique<FilterExecutor>(exec_ctx, filter_plan, std::move(child));
     }
 
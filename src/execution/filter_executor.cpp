@@ -1,4 +1,5 @@
 #include "execution/executors/filter_executor.h"
+#include "common/config.h"
 #include "common/exception.h"
 #include "type/value_factory.h"
 
@@ -6,7 +7,11 @@ namespace bustub {
 
 FilterExecutor::FilterExecutor(ExecutorContext *exec_ctx, const FilterPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  if (enable_expression_compilation) {
+    compiled_predicate_ = CompiledExpression::Compile(*plan_->GetPredicate(), child_executor_->GetOutputSchema());
+  }
+}
 
 void FilterExecutor::Init() {
   // Initialize the child executor
@@ -24,6 +29,13 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       return false;
     }
 
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Run(*tuple);
+      if (compiled_predicate_->IsTrue(0)) {
+        return true;
+      }
+      continue;
+    }
     auto value = filter_expr->Evaluate(tuple, child_executor_->GetOutputSchema());
     if (!value.IsNull() && value.GetAs<bool>()) {
       return true;
@@ -31,4 +43,28 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  // Keep asking the child until some of its rows pass, so that an empty batch still means the end.
+  while (child_executor_->NextBatch(batch)) {
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Run(*batch);
+      batch->Retain([&](size_t i) { return compiled_predicate_->IsTrue(i); });
+      if (!batch->IsEmpty()) {
+        return true;
+      }
+      continue;
+    }
+    batch->Retain([&](size_t i) {
+      auto value = filter_expr->Evaluate(&batch->TupleAt(i), child_schema);
+      return !value.IsNull() && value.GetAs<bool>();
+    });
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
@@ -31,6 +31,18 @@ auto AbstractPlanNode::ChildrenToString(int indent, bool with_schema) const -> s
   return fmt::format("\n{}", fmt::join(children_str, "\n"));
 }
 
+auto AbstractPlanNode::ToAnnotatedString(const std::function<std::string(const AbstractPlanNode &)> &annotate) const
+    -> std::string {
+  std::string result = fmt::format("{} | {}", PlanNodeToString(), annotate(*this));
+  auto indent_str = StringUtil::Indent(2);
+  for (const auto &child : children_) {
+    for (const auto &line : StringUtil::Split(child->ToAnnotatedString(annotate), '\n')) {
+      result += fmt::format("\n{}{}", indent_str, line);
+    }
+  }
+  return result;
+}
+
 auto AggregationPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Agg {{ types={}, aggregates={}, group_by={} }}", agg_types_, aggregates_, group_bys_);
 }
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "execution/executor_factory.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan)
+    : AbstractExecutor(exec_ctx), plan_(std::move(plan)) {}
+
+GatherExecutor::~GatherExecutor() { Stop(); }
+
+auto GatherExecutor::CanParallelize(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+    case PlanType::MockScan:
+      return true;
+    case PlanType::Projection:
+    case PlanType::Filter:
+      return CanParallelize(*plan.GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+auto GatherExecutor::MakeMorsels() const -> std::vector<Morsel> {
+  const AbstractPlanNode *scan = plan_.get();
+  while (!scan->GetChildren().empty()) {
+    scan = scan->GetChildAt(0).get();
+  }
+  if (scan->GetType() == PlanType::SeqScan) {
+    return SeqScanExecutor::MakeMorsels(exec_ctx_, dynamic_cast<const SeqScanPlanNode *>(scan));
+  }
+  return MockScanExecutor::MakeMorsels(dynamic_cast<const MockScanPlanNode *>(scan));
+}
+
+void GatherExecutor::Init() {
+  Stop();
+  morsels_ = MakeMorsels();
+  if (morsels_.size() <= 1) {
+    // Not worth a thread: run the pipeline right here. An empty morsel scans nothing, just like an empty input.
+    if (morsels_.empty()) {
+      morsels_.emplace_back();
+    }
+    serial_executor_ = ExecutorFactory::CreateExecutor(exec_ctx_, plan_, &morsels_[0]);
+    serial_executor_->Init();
+    return;
+  }
+  io_stats_ = IoStatsScope::Current();
+  outputs_ = std::vector<MorselOutput>(morsels_.size());
+  size_t num_workers = std::min(exec_ctx_->GetDegreeOfParallelism(), morsels_.size());
+  window_ = WINDOW_PER_WORKER * num_workers;
+  scheduler_ = std::make_unique<MorselScheduler>(num_workers, morsels_.size(), [this](size_t i) { RunMorsel(i); });
+}
+
+void GatherExecutor::Stop() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stopping_ = true;
+  }
+  window_moved_.notify_all();
+  // Joins the workers, so none of them touches the outputs any more.
+  scheduler_.reset();
+  // The morsels the consumer did not get to were counted already, but not handed on yet.
+  if (io_stats_ != nullptr) {
+    for (size_t i = next_morsel_; i < outputs_.size(); i++) {
+      *io_stats_ += outputs_[i].io_;
+    }
+  }
+  io_stats_ = nullptr;
+  stopping_ = false;
+  serial_executor_.reset();
+  outputs_.clear();
+  error_ = nullptr;
+  failed_ = false;
+  next_morsel_ = 0;
+  next_batch_ = 0;
+  current_batch_.Clear();
+  next_tuple_ = 0;
+}
+
+void GatherExecutor::RunMorsel(size_t index) {
+  if (failed_) {
+    // The query fails anyway; leave the rest of the input alone.
+    return;
+  }
+  {
+    // A worker takes the lowest morsel of its own queue, and steals only once that queue is empty, so the worker that
+    // holds the morsel the consumer waits for never waits here.
+    std::unique_lock<std::mutex> lock(latch_);
+    window_moved_.wait(lock, [&] { return index < next_morsel_ + window_ || stopping_ || failed_; });
+    if (stopping_ || failed_) {
+      return;
+    }
+  }
+  try {
+    // The worker's own scope; the outputs are not resized while the workers run.
+    IoStatsScope scope(&outputs_[index].io_);
+    auto executor = ExecutorFactory::CreateExecutor(exec_ctx_, plan_, &morsels_[index]);
+    executor->Init();
+    std::vector<TupleBatch> batches;
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      batches.push_back(std::move(batch));
+      batch = TupleBatch();
+    }
+    std::scoped_lock<std::mutex> lock(latch_);
+    outputs_[index].batches_ = std::move(batches);
+    outputs_[index].done_ = true;
+  } catch (...) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    failed_ = true;
+  }
+  morsel_done_.notify_all();
+  window_moved_.notify_all();
+}
+
+auto GatherExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (serial_executor_ != nullptr) {
+    return serial_executor_->NextBatch(batch);
+  }
+  batch->Clear();
+  while (next_morsel_ < outputs_.size()) {
+    std::unique_lock<std::mutex> lock(latch_);
+    auto &output = outputs_[next_morsel_];
+    morsel_done_.wait(lock, [&] { return output.done_ || error_ != nullptr; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+    lock.unlock();
+    if (next_batch_ < output.batches_.size()) {
+      *batch = std::move(output.batches_[next_batch_++]);
+      return true;
+    }
+    // Done with the morsel: free its batches and count its work.
+    output.batches_ = std::vector<TupleBatch>();
+    if (io_stats_ != nullptr) {
+      *io_stats_ += output.io_;
+    }
+    next_batch_ = 0;
+    {
+      std::scoped_lock<std::mutex> moved_lock(latch_);
+      next_morsel_++;
+    }
+    window_moved_.notify_all();
+  }
+  return false;
+}
+
+auto GatherExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (next_tuple_ == current_batch_.Size()) {
+    if (!NextBatch(&current_batch_)) {
+      return false;
+    }
+    next_tuple_ = 0;
+  }
+  *rid = current_batch_.RidAt(next_tuple_);
+  *tuple = std::move(current_batch_.TupleAt(next_tuple_++));
+  return true;
+}
+
+}  // namespace bustub
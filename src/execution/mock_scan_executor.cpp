@@ -379,8 +379,12 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
   };
 }
 
-MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan)
+MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, const Morsel *morsel)
     : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {
+  if (morsel != nullptr) {
+    begin_ = morsel->begin_row_;
+    size_ = morsel->end_row_;
+  }
   if (GetShuffled(plan)) {
     for (size_t i = 0; i < size_; i++) {
       shuffled_idx_.push_back(i);
@@ -391,9 +395,22 @@ MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlan
   }
 }
 
+auto MockScanExecutor::MakeMorsels(const MockScanPlanNode *plan) -> std::vector<Morsel> {
+  size_t size = GetSizeOf(plan);
+  size_t morsel_rows = GetShuffled(plan) ? size : MORSEL_ROWS;
+  std::vector<Morsel> morsels;
+  for (size_t begin = 0; begin < size; begin += morsel_rows) {
+    Morsel morsel;
+    morsel.begin_row_ = begin;
+    morsel.end_row_ = std::min(begin + morsel_rows, size);
+    morsels.push_back(morsel);
+  }
+  return morsels;
+}
+
 void MockScanExecutor::Init() {
   // Reset the cursor
-  cursor_ = 0;
+  cursor_ = begin_;
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -411,6 +428,14 @@ auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return EXECUTOR_ACTIVE;
 }
 
+auto MockScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Clear();
+  for (; cursor_ < size_ && !batch->IsFull(); ++cursor_) {
+    batch->Append(func_(shuffled_idx_.empty() ? cursor_ : shuffled_idx_[cursor_]), MakeDummyRID());
+  }
+  return !batch->IsEmpty();
+}
+
 auto MockScanExecutor::MakeDummyRID() -> RID { return RID{0}; }
 
 }  // namespace bustub
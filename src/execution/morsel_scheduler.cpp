@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scheduler.cpp
+//
+// Identification: src/execution/morsel_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_scheduler.h"
+
+#include <utility>
+
+namespace bustub {
+
+MorselScheduler::MorselScheduler(size_t num_workers, size_t num_morsels, Task task) : task_(std::move(task)) {
+  BUSTUB_ASSERT(num_workers > 0, "a scheduler needs a worker");
+  queues_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+  for (size_t morsel = 0; morsel < num_morsels; morsel++) {
+    queues_[morsel % num_workers]->morsels_.push_back(morsel);
+  }
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&MorselScheduler::RunWorker, this, i);
+  }
+}
+
+MorselScheduler::~MorselScheduler() {
+  Cancel();
+  Wait();
+}
+
+void MorselScheduler::Wait() {
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void MorselScheduler::RunWorker(size_t worker) {
+  size_t morsel;
+  while (!cancelled_ && TakeMorsel(worker, &morsel)) {
+    task_(morsel);
+  }
+}
+
+auto MorselScheduler::TakeMorsel(size_t worker, size_t *morsel) -> bool {
+  {
+    auto &own = *queues_[worker];
+    std::scoped_lock<std::mutex> lock(own.latch_);
+    if (!own.morsels_.empty()) {
+      *morsel = own.morsels_.front();
+      own.morsels_.pop_front();
+      return true;
+    }
+  }
+  // Steal the morsel that its owner would get to last.
+  for (size_t i = 1; i < queues_.size(); i++) {
+    auto &victim = *queues_[(worker + i) % queues_.size()];
+    std::scoped_lock<std::mutex> lock(victim.latch_);
+    if (!victim.morsels_.empty()) {
+      *morsel = victim.morsels_.back();
+      victim.morsels_.pop_back();
+      return true;
+    }
+  }
+  // Morsels are never added once the workers run, so empty queues stay empty.
+  return false;
+}
+
+}  // namespace bustub
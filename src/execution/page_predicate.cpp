@@ -0,0 +1,298 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_predicate.cpp
+//
+// Identification: src/execution/page_predicate.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/page_predicate.h"
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_PAGE_PREDICATE_X86 1
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** @return the value that stands for null in a column of C++ type T */
+template <typename T>
+constexpr auto NullOf() -> T {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else {
+    return BUSTUB_INT64_NULL;
+  }
+}
+
+template <typename T, typename Op>
+auto FilterScalar(const char *data, const PagePredicate::Term &term, uint32_t *slots, uint32_t *offsets, size_t begin,
+                  size_t count, size_t kept) -> size_t {
+  auto constant = static_cast<T>(term.constant_);
+  for (size_t i = begin; i < count; i++) {
+    T value;
+    memcpy(&value, data + offsets[i] + term.offset_, sizeof(T));
+    // Copy every row and only keep the ones that qualify, so the loop has no branch to mispredict.
+    slots[kept] = slots[i];
+    offsets[kept] = offsets[i];
+    kept += static_cast<size_t>(value != NullOf<T>() && Op{}(value, constant));
+  }
+  return kept;
+}
+
+template <typename T, typename Op>
+auto FilterScalar(const char *data, const PagePredicate::Term &term, uint32_t *slots, uint32_t *offsets, size_t count)
+    -> size_t {
+  return FilterScalar<T, Op>(data, term, slots, offsets, 0, count, 0);
+}
+
+#ifdef BUSTUB_PAGE_PREDICATE_X86
+
+/** For each 8-bit mask, the lanes whose bit is set, first to last: the permutation that packs them to the front. */
+struct PackTable {
+  uint32_t lanes_[256][8];
+
+  constexpr PackTable() : lanes_() {
+    for (uint32_t mask = 0; mask < 256; mask++) {
+      uint32_t packed = 0;
+      for (uint32_t lane = 0; lane < 8; lane++) {
+        if ((mask & (1U << lane)) != 0) {
+          lanes_[mask][packed++] = lane;
+        }
+      }
+    }
+  }
+};
+
+constexpr PackTable PACK_TABLE;
+
+template <typename T>
+__attribute__((target("avx2"))) inline auto EqualLanes(__m256i lhs, __m256i rhs) -> __m256i {
+  return sizeof(T) == 4 ? _mm256_cmpeq_epi32(lhs, rhs) : _mm256_cmpeq_epi64(lhs, rhs);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) inline auto GreaterLanes(__m256i lhs, __m256i rhs) -> __m256i {
+  return sizeof(T) == 4 ? _mm256_cmpgt_epi32(lhs, rhs) : _mm256_cmpgt_epi64(lhs, rhs);
+}
+
+/** @return all ones in the lanes where Op holds between values and constants */
+template <typename T, typename Op>
+__attribute__((target("avx2"))) inline auto CompareLanes(__m256i values, __m256i constants) -> __m256i {
+  __m256i ones = _mm256_set1_epi32(-1);
+  if constexpr (std::is_same_v<Op, std::equal_to<>>) {
+    return EqualLanes<T>(values, constants);
+  } else if constexpr (std::is_same_v<Op, std::not_equal_to<>>) {
+    return _mm256_xor_si256(EqualLanes<T>(values, constants), ones);
+  } else if constexpr (std::is_same_v<Op, std::less<>>) {
+    return GreaterLanes<T>(constants, values);
+  } else if constexpr (std::is_same_v<Op, std::less_equal<>>) {
+    return _mm256_xor_si256(GreaterLanes<T>(values, constants), ones);
+  } else if constexpr (std::is_same_v<Op, std::greater<>>) {
+    return GreaterLanes<T>(values, constants);
+  } else {
+    return _mm256_xor_si256(GreaterLanes<T>(constants, values), ones);
+  }
+}
+
+/** @return bit i set for each of the eight rows at indexes (byte offsets into data) that satisfy the term */
+template <typename T, typename Op>
+__attribute__((target("avx2"))) inline auto QualifyingRows(const char *data, __m256i indexes, T constant) -> uint32_t {
+  if constexpr (sizeof(T) == 4) {
+    __m256i values = _mm256_i32gather_epi32(reinterpret_cast<const int *>(data), indexes, 1);
+    __m256i keep = _mm256_andnot_si256(EqualLanes<T>(values, _mm256_set1_epi32(NullOf<T>())),
+                                       CompareLanes<T, Op>(values, _mm256_set1_epi32(constant)));
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(keep)));
+  } else {
+    // A 64-bit gather takes four 32-bit indexes: gather the low and the high half of the rows apart.
+    __m256i constants = _mm256_set1_epi64x(constant);
+    __m256i nulls = _mm256_set1_epi64x(NullOf<T>());
+    const auto *base = reinterpret_cast<const long long *>(data);  // NOLINT
+    __m256i low = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(indexes), 1);
+    __m256i high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(indexes, 1), 1);
+    __m256i keep_low = _mm256_andnot_si256(EqualLanes<T>(low, nulls), CompareLanes<T, Op>(low, constants));
+    __m256i keep_high = _mm256_andnot_si256(EqualLanes<T>(high, nulls), CompareLanes<T, Op>(high, constants));
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(keep_low))) |
+           static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(keep_high))) << 4;
+  }
+}
+
+template <typename T, typename Op>
+__attribute__((target("avx2"))) auto FilterAvx2(const char *data, const PagePredicate::Term &term, uint32_t *slots,
+                                                uint32_t *offsets, size_t count) -> size_t {
+  auto constant = static_cast<T>(term.constant_);
+  __m256i column_offset = _mm256_set1_epi32(static_cast<int>(term.offset_));
+  size_t kept = 0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i row_offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets + i));
+    __m256i row_slots = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(slots + i));
+    uint32_t mask = QualifyingRows<T, Op>(data, _mm256_add_epi32(row_offsets, column_offset), constant);
+    // Pack the qualifying rows to the front of the eight and write all eight over the kept rows: kept <= i, so this
+    // only overwrites rows that are already loaded.
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(PACK_TABLE.lanes_[mask]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(offsets + kept), _mm256_permutevar8x32_epi32(row_offsets, lanes));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(slots + kept), _mm256_permutevar8x32_epi32(row_slots, lanes));
+    kept += __builtin_popcount(mask);
+  }
+  return FilterScalar<T, Op>(data, term, slots, offsets, i, count, kept);
+}
+
+const bool HAS_AVX2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+template <typename T, typename Op>
+auto KernelOf() -> PagePredicate::Kernel {
+#ifdef BUSTUB_PAGE_PREDICATE_X86
+  if (HAS_AVX2) {
+    return &FilterAvx2<T, Op>;
+  }
+#endif
+  return &FilterScalar<T, Op>;
+}
+
+template <typename T>
+auto KernelOf(ComparisonType type) -> PagePredicate::Kernel {
+  switch (type) {
+    case ComparisonType::Equal:
+      return KernelOf<T, std::equal_to<>>();
+    case ComparisonType::NotEqual:
+      return KernelOf<T, std::not_equal_to<>>();
+    case ComparisonType::LessThan:
+      return KernelOf<T, std::less<>>();
+    case ComparisonType::LessThanOrEqual:
+      return KernelOf<T, std::less_equal<>>();
+    case ComparisonType::GreaterThan:
+      return KernelOf<T, std::greater<>>();
+    case ComparisonType::GreaterThanOrEqual:
+      return KernelOf<T, std::greater_equal<>>();
+  }
+  return nullptr;
+}
+
+/** @return the comparison that holds for (rhs, lhs) when type holds for (lhs, rhs) */
+auto Mirror(ComparisonType type) -> ComparisonType {
+  switch (type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return type;
+  }
+}
+
+}  // namespace
+
+auto PagePredicate::Compile(const AbstractExpression &expr, const Schema &schema) -> std::unique_ptr<PagePredicate> {
+  std::unique_ptr<PagePredicate> predicate(new PagePredicate());
+  if (!predicate->AddTerms(expr, schema)) {
+    return nullptr;
+  }
+  return predicate;
+}
+
+auto PagePredicate::AddTerms(const AbstractExpression &expr, const Schema &schema) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And && AddTerms(*expr.GetChildAt(0), schema) &&
+           AddTerms(*expr.GetChildAt(1), schema);
+  }
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison_expr == nullptr) {
+    return false;
+  }
+  auto type = comparison_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.GetChildAt(0).get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(expr.GetChildAt(1).get());
+  if (column_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(expr.GetChildAt(1).get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(expr.GetChildAt(0).get());
+    type = Mirror(type);
+  }
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetTupleIdx() != 0 ||
+      column_expr->GetColIdx() >= schema.GetColumnCount()) {
+    return false;
+  }
+
+  const auto &value = constant_expr->val_;
+  if (value.IsNull()) {
+    return false;
+  }
+  int64_t constant;
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      constant = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      constant = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      constant = value.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      constant = value.GetAs<int64_t>();
+      break;
+    default:
+      return false;
+  }
+
+  const auto &column = schema.GetColumn(column_expr->GetColIdx());
+  Term term{nullptr, column.GetOffset(), constant};
+  if (column.GetType() == TypeId::INTEGER) {
+    // The kernel compares in the type of the column, so the constant has to be one of its values.
+    if (constant <= BUSTUB_INT32_NULL || constant > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    term.kernel_ = KernelOf<int32_t>(type);
+  } else if (column.GetType() == TypeId::BIGINT) {
+    term.kernel_ = KernelOf<int64_t>(type);
+  } else {
+    return false;
+  }
+  terms_.push_back(term);
+  return true;
+}
+
+void PagePredicate::Select(TablePage *page, std::vector<uint32_t> *slots) {
+  page->GetLiveTuples(slots, &offsets_);
+  size_t count = slots->size();
+  for (const auto &term : terms_) {
+    if (count == 0) {
+      break;
+    }
+    count = term.kernel_(page->GetData(), term, slots->data(), offsets_.data(), count);
+  }
+  slots->resize(count);
+}
+
+auto PagePredicate::IsVectorized() -> bool {
+#ifdef BUSTUB_PAGE_PREDICATE_X86
+  return HAS_AVX2;
+#else
+  return false;
+#endif
+}
+
+}  // namespace bustub
@@ -1,11 +1,26 @@
 #include "execution/executors/projection_executor.h"
+#include "common/config.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const ProjectionPlanNode *plan,
                                        std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  if (!enable_expression_compilation) {
+    return;
+  }
+  const auto &output_schema = GetOutputSchema();
+  write_output_directly_ = true;
+  for (uint32_t i = 0; i < plan_->GetExpressions().size(); i++) {
+    auto compiled = CompiledExpression::Compile(*plan_->GetExpressions()[i], child_executor_->GetOutputSchema());
+    const auto &column = output_schema.GetColumn(i);
+    if (compiled == nullptr || !column.IsInlined() || column.GetType() != compiled->GetReturnType()) {
+      write_output_directly_ = false;
+    }
+    compiled_exprs_.push_back(std::move(compiled));
+  }
+}
 
 void ProjectionExecutor::Init() {
   // Initialize the child executor
@@ -25,12 +40,58 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   // Compute expressions
   std::vector<Value> values{};
   values.reserve(GetOutputSchema().GetColumnCount());
-  for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+  const auto &exprs = plan_->GetExpressions();
+  for (size_t i = 0; i < exprs.size(); i++) {
+    if (!compiled_exprs_.empty() && compiled_exprs_[i] != nullptr) {
+      compiled_exprs_[i]->Run(child_tuple);
+      values.push_back(compiled_exprs_[i]->GetValue(0));
+    } else {
+      values.push_back(exprs[i]->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+    }
   }
 
   *tuple = Tuple{values, &GetOutputSchema()};
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Clear();
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  for (const auto &compiled : compiled_exprs_) {
+    if (compiled != nullptr) {
+      compiled->Run(child_batch_);
+    }
+  }
+  const auto &output_schema = GetOutputSchema();
+  if (write_output_directly_) {
+    // Every column is fixed-width, so a tuple is just the columns at their offsets.
+    std::vector<char> data(output_schema.GetLength());
+    for (size_t i = 0; i < child_batch_.Size(); i++) {
+      for (uint32_t col = 0; col < compiled_exprs_.size(); col++) {
+        compiled_exprs_[col]->SerializeTo(i, data.data() + output_schema.GetColumn(col).GetOffset());
+      }
+      batch->Append(Tuple{data.data(), static_cast<uint32_t>(data.size())}, child_batch_.RidAt(i));
+    }
+    return true;
+  }
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  const auto &exprs = plan_->GetExpressions();
+  std::vector<Value> values{};
+  values.reserve(output_schema.GetColumnCount());
+  for (size_t i = 0; i < child_batch_.Size(); i++) {
+    values.clear();
+    for (size_t col = 0; col < exprs.size(); col++) {
+      if (!compiled_exprs_.empty() && compiled_exprs_[col] != nullptr) {
+        values.push_back(compiled_exprs_[col]->GetValue(i));
+      } else {
+        values.push_back(exprs[col]->Evaluate(&child_batch_.TupleAt(i), child_schema));
+      }
+    }
+    batch->Append(Tuple{values, &output_schema}, child_batch_.RidAt(i));
+  }
+  return true;
+}
 }  // namespace bustub
@@ -1,23 +1,152 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, const Morsel *morsel)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  if (morsel != nullptr) {
+    begin_page_id_ = morsel->begin_page_id_;
+    end_page_id_ = morsel->end_page_id_;
+  }
+  if (plan_->filter_predicate_ != nullptr && enable_page_predicates) {
+    page_predicate_ = PagePredicate::Compile(*plan_->filter_predicate_, GetOutputSchema());
+  }
+  if (plan_->filter_predicate_ != nullptr && enable_expression_compilation) {
+    compiled_predicate_ = CompiledExpression::Compile(*plan_->filter_predicate_, GetOutputSchema());
+  }
+}
+
+auto SeqScanExecutor::MakeMorsels(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) -> std::vector<Morsel> {
+  auto page_ids = exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())->table_->GetPageIds();
+  std::vector<Morsel> morsels;
+  for (size_t i = 0; i < page_ids.size(); i += MORSEL_PAGES) {
+    Morsel morsel;
+    morsel.begin_page_id_ = page_ids[i];
+    morsel.end_page_id_ = i + MORSEL_PAGES < page_ids.size() ? page_ids[i + MORSEL_PAGES] : INVALID_PAGE_ID;
+    morsels.push_back(morsel);
+  }
+  return morsels;
+}
+
+void SeqScanExecutor::Init() {
+  table_heap_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get();
+  // A full scan reads every page once: go through the scan ring so the rest of the buffer pool is left alone.
+  // A page-filtered scan reads the pages itself, so it does not position an iterator, which would fetch a page.
+  auto *txn = exec_ctx_->GetTransaction();
+  iter_.reset();
+  if (page_predicate_ == nullptr) {
+    iter_ = std::make_unique<TableIterator>(begin_page_id_ == INVALID_PAGE_ID
+                                                ? table_heap_->Begin(txn, AccessType::Scan)
+                                                : table_heap_->BeginAt(begin_page_id_, txn, AccessType::Scan));
+  }
+  page_id_ = begin_page_id_ == INVALID_PAGE_ID ? table_heap_->GetFirstPageId() : begin_page_id_;
+  page_tuples_.clear();
+  page_tuple_idx_ = 0;
+}
+
+auto SeqScanExecutor::IsExhausted() -> bool {
+  if (iter_ == nullptr) {
+    return page_tuple_idx_ == page_tuples_.size() && (page_id_ == INVALID_PAGE_ID || page_id_ == end_page_id_);
+  }
+  return *iter_ == table_heap_->End() || (*iter_)->GetRid().GetPageId() == end_page_id_;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (iter_ == nullptr) {
+    if (!NextFromPages(tuple)) {
+      return false;
+    }
+    *rid = tuple->GetRid();
+    return true;
+  }
+  while (!IsExhausted()) {
+    *tuple = **iter_;
+    *rid = tuple->GetRid();
+    ++(*iter_);
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Run(*tuple);
+      if (compiled_predicate_->IsTrue(0)) {
+        return true;
+      }
+      continue;
+    }
+    if (plan_->filter_predicate_ == nullptr) {
+      return true;
+    }
+    auto value = plan_->filter_predicate_->Evaluate(tuple, GetOutputSchema());
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (page_predicate_ != nullptr) {
+    return NextBatchFromPages(batch);
+  }
+  batch->Clear();
+  const auto &predicate = plan_->filter_predicate_;
+  while (batch->IsEmpty() && !IsExhausted()) {
+    while (!batch->IsFull() && !IsExhausted()) {
+      Tuple tuple = **iter_;
+      ++(*iter_);
+      // A compiled predicate runs over the whole batch at once, below.
+      if (compiled_predicate_ == nullptr && predicate != nullptr) {
+        auto value = predicate->Evaluate(&tuple, GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          continue;
+        }
+      }
+      RID rid = tuple.GetRid();
+      batch->Append(std::move(tuple), rid);
+    }
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Run(*batch);
+      batch->Retain([&](size_t i) { return compiled_predicate_->IsTrue(i); });
+    }
+  }
+  return !batch->IsEmpty();
+}
+
+auto SeqScanExecutor::NextFromPages(Tuple *tuple) -> bool {
+  auto select = [this](TablePage *page, std::vector<uint32_t> *slots) { page_predicate_->Select(page, slots); };
+  while (page_tuple_idx_ == page_tuples_.size()) {
+    if (IsExhausted()) {
+      return false;
+    }
+    page_tuples_.clear();
+    page_tuple_idx_ = 0;
+    page_id_ = table_heap_->ScanPage(page_id_, select, exec_ctx_->GetTransaction(), AccessType::Scan, &page_tuples_);
+  }
+  *tuple = std::move(page_tuples_[page_tuple_idx_++]);
+  return true;
+}
+
+auto SeqScanExecutor::NextBatchFromPages(TupleBatch *batch) -> bool {
+  batch->Clear();
+  Tuple tuple;
+  while (!batch->IsFull() && NextFromPages(&tuple)) {
+    RID rid = tuple.GetRid();
+    batch->Append(std::move(tuple), rid);
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
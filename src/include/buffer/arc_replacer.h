@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements Adaptive Replacement Cache (Megiddo and Modha, FAST '03).
+ *
+ * Resident pages live in T1 (seen once recently) or T2 (seen at least twice), both LRU lists. Pages evicted from
+ * them are remembered in the ghost lists B1 and B2. The target size p of T1 adapts to the workload: a miss on a page
+ * in B1 means T1 was too small and grows p, a miss on a page in B2 shrinks it. A scan only ever passes through T1,
+ * and never reaches T2 unless its pages are read again.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_frames the number of frames in the buffer pool
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void AssignPage(frame_id_t frame_id, page_id_t page_id) override;
+
+ private:
+  enum class List { None, T1, T2 };
+
+  struct FrameInfo {
+    List list_{List::None};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** Evict the least recently used evictable frame of T1 or T2 into the matching ghost list. */
+  auto EvictFrom(List list, frame_id_t *frame_id) -> bool;
+
+  /** Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c, once the incoming page has been looked up. */
+  void TrimGhosts();
+
+  /** Number of frames, c in the paper. */
+  size_t num_frames_;
+  /** Target size of T1. */
+  size_t p_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
+  std::vector<FrameInfo> frames_;
+  /** Resident pages, most recently used first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+};
+
+}  // namespace bustub
@@ -15,7 +15,9 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -40,7 +42,17 @@ class BufferPoolManager {
   /** Grading function. Do not modify! */
   auto FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) -> Page * {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
-    auto *result = FetchPgImp(page_id);
+    auto *result = FetchPgImp(page_id, AccessType::Unknown);
+    GradingCallback(callback, CallbackType::AFTER, page_id);
+    return result;
+  }
+
+  /**
+   * Fetch a page with a hint on how it is going to be used. Bulk sequential readers pass AccessType::Scan.
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type, bufferpool_callback_fn callback = nullptr) -> Page * {
+    GradingCallback(callback, CallbackType::BEFORE, page_id);
+    auto *result = FetchPgImp(page_id, access_type);
     GradingCallback(callback, CallbackType::AFTER, page_id);
     return result;
   }
@@ -84,9 +96,26 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Start reading pages that are about to be fetched, without waiting for the reads. Pages that are resident already,
+   * or for which no frame is available, are skipped; a later FetchPage of a page whose read is still in flight waits
+   * for that read instead of issuing its own.
+   * @param page_ids the pages to read ahead, in the order they will be fetched
+   * @param access_type how the pages are going to be used
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown) {
+    PrefetchPgsImp(page_ids, access_type);
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /** @return what the buffer pool has done since it was created or its statistics were reset */
+  virtual auto GetStats() -> BufferPoolStats = 0;
+
+  /** Set the statistics of the buffer pool back to zero. */
+  virtual void ResetStats() = 0;
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -104,9 +133,11 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
    * @return the requested page
+   * @throws Exception if the page fails its checksum; it is not left pinned
    */
-  virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
+  virtual auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -141,5 +172,12 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Starts asynchronous reads of the given pages into free or evictable frames.
+   * @param page_ids the pages to read ahead
+   * @param access_type how the pages are going to be used
+   */
+  virtual void PrefetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) = 0;
 };
 }  // namespace bustub
@@ -12,14 +12,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "container/hash/sharded_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -37,9 +45,28 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_policy the page replacement policy
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   *
+   * The instance only allocates page ids that are congruent to instance_index modulo num_instances, so the
+   * owning shard of any page can be computed from its id alone.
+   *
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_policy the page replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,13 +76,42 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
+  auto GetStats() -> BufferPoolStats override { return stats_.Snapshot(); }
+
+  void ResetStats() override { stats_.Reset(); }
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @brief Return the arena that holds the data of the frames. */
+  auto GetFrameArena() -> const FrameArena * { return frame_arena_.get(); }
+
+  /**
+   * @brief Start background threads that write dirty pages back before the replacer picks them as victims, so that
+   * misses can reuse clean frames instead of writing inline under the latch. Each pass looks at the clean_target
+   * frames closest to eviction. A page is only written once the log is persistent up to its LSN. A cleaner that
+   * finds nothing to write sleeps for cleaner_interval, or until a miss had to write a dirty victim itself.
+   * Does nothing if the cleaner is already running.
+   * @param num_threads the number of cleaner threads
+   * @param clean_target how many of the frames closest to eviction to keep clean
+   */
+  void StartCleaner(size_t num_threads = 1, size_t clean_target = CLEANER_CLEAN_TARGET);
+
+  /** @brief Stop and join the cleaner threads. Does nothing if the cleaner is not running. */
+  void StopCleaner();
+
+  /**
+   * @brief Keep compressed copies of evicted pages in memory, so that misses on them do not go to disk. Replaces the
+   * compressed cache, if there already is one.
+   * @param capacity the number of bytes the compressed pages may take up; 0 turns the compressed cache off
+   */
+  void EnableCompressedCache(size_t capacity);
+
+  /** @return what the compressed cache has done, all zero if there is none */
+  auto GetCompressedCacheStats() -> CompressedPageCacheStats;
+
  protected:
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
@@ -71,13 +127,8 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
   auto NewPgImp(page_id_t *page_id) -> Page * override;
-  
-  
-  
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
    * but all frames are currently in use and not evictable (in another word, pinned).
    *
@@ -88,14 +139,22 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
+   * A miss hinted with AccessType::Scan is served from the scan ring instead: a handful of frames that bulk readers
+   * recycle among themselves, like PostgreSQL's buffer access strategies. Ring frames are not tracked by the
+   * replacer, and scan hits do not add to the access history, so a full table scan cannot push the working set of
+   * point lookups out of the pool. A non-scan hit on a ring page adopts its frame into the main pool.
+   *
+   * A hit on a page that PrefetchPages is still reading waits for that read to complete.
+   *
+   * With a compressed cache, a miss on a page that the cache holds decompresses it instead of reading it from disk.
+   *
    * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPgImp(page_id_t page_id) -> Page * override;
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
    *
@@ -109,8 +168,6 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
@@ -122,21 +179,28 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto FlushPgImp(page_id_t page_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Flush all the pages in the buffer pool to disk.
    */
   void FlushAllPgsImp() override;
 
   /**
-   * TODO(P1): Add implementation
-   *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Start asynchronous reads of the pages that are not resident. Each page gets a frame the same way a miss
+   * would, but the frame stays pinned by the read until it completes, so it cannot be evicted half read; fetches of the
+   * page find it in the page table and wait for the read. Scan-hinted read-ahead goes to the scan ring, and reads at
+   * most half the ring ahead so that it never recycles frames the scan has yet to reach. Pages that are not allocated
+   * on disk are skipped, and pages in the compressed cache are decompressed right away.
+   * @param page_ids the pages to read ahead
+   * @param access_type how the pages are going to be used
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) override;
+
+  /**
+   * @brief Delete a page from the buffer pool and free it on disk. If page_id is not in the buffer pool, only free it
+   * on disk and return true. If the page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, call DeallocatePage() so that the disk
+   * manager can hand the page id out again. The caller must not fetch the page after deleting it.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
@@ -145,28 +209,91 @@ class BufferPoolManagerInstance : public BufferPoolManager {
 
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
+  /** Number of independently latched shards in the page table */
+  const size_t page_table_shards_ = 64;
 
   /** Array of buffer pool pages. */
   Page *pages_;
+  /** The data of all frames, page-aligned so that frames can be read and written with direct I/O. */
+  std::unique_ptr<FrameArena> frame_arena_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  /** Page table for keeping track of buffer pool pages. Hits only take a shared latch on one of its shards. */
+  ShardedHashTable<page_id_t, frame_id_t> *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<Replacer> replacer_;
+  /** Hits, misses, I/Os and fetch latencies. */
+  BufferPoolCounters stats_;
+  /** Compressed copies of evicted pages, or nullptr. Protected by latch_. */
+  std::unique_ptr<CompressedPageCache> compressed_cache_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * Serializes the slow paths: misses, new pages, deletes and flushes. It protects the free list and the reuse of
+   * frames. Hits and unpins never take it; they synchronize with the slow paths through the page table shard latches
+   * and the atomic pin counts. A miss releases it once the frame is mapped and pinned, before reading the page.
+   */
   std::mutex latch_;
 
+  /** Marks a frame that is not in the scan ring, and a ring slot that holds no frame yet. */
+  static constexpr int NOT_IN_RING = -1;
+  /** Frames recycled by scan-hinted misses. Protected by latch_. */
+  std::vector<frame_id_t> scan_ring_;
+  /** Next slot of the scan ring to recycle. Protected by latch_. */
+  size_t scan_ring_next_{0};
+  /** Scan ring slot each frame occupies, or NOT_IN_RING. Cleared without the latch when a lookup adopts a frame. */
+  std::unique_ptr<std::atomic<int>[]> ring_slot_;
+
+  /** Read state of a frame whose data is valid. */
+  static constexpr int READ_DONE = 0;
+  /** Read state of a frame that a miss or a read-ahead is still reading into. */
+  static constexpr int READ_PENDING = 1;
+  /** Read state of a frame whose read failed; the first fetch reads the page again. */
+  static constexpr int READ_FAILED = 2;
+  /** Read state of each frame. Only reads in flight or failed leave a frame in a state other than READ_DONE. */
+  std::unique_ptr<std::atomic<int>[]> read_state_;
+  /**
+   * Set on main pool frames that a read-ahead brought in and no fetch has hit yet. The read-ahead recorded an access so
+   * that the replacer tracks the frame; the first fetch does not record another, so read-ahead does not make pages look
+   * hot.
+   */
+  std::unique_ptr<std::atomic<bool>[]> read_ahead_;
+  /** Protects the transitions out of READ_PENDING and reads_in_flight_; read_cv_ waits on it. */
+  std::mutex read_latch_;
+  /** Wakes fetches waiting for a read of the page to complete. */
+  std::condition_variable read_cv_;
+  /** Number of read-aheads not completed yet. The destructor waits for it to drop to zero. */
+  size_t reads_in_flight_{0};
+
+  /** Background threads writing back dirty pages near the cold end of the replacer. */
+  std::vector<std::thread> cleaner_threads_;
+  /** Number of frames closest to eviction the cleaner keeps clean. */
+  size_t clean_target_{0};
+  /** Protects cleaner_stop_ and the transitions of cleaning_ back to false; cleaner_cv_ waits on it. */
+  std::mutex cleaner_latch_;
+  /**
+   * Wakes the cleaner early when a miss had to write back a dirty victim, or when the cleaner stops, and wakes flushes
+   * waiting for a cleaner write.
+   */
+  std::condition_variable cleaner_cv_;
+  /** Set to make the cleaner threads exit. */
+  bool cleaner_stop_{false};
+  /**
+   * Set on frames the cleaner is writing back. The cleaner writes a copy of the page, so a newer image written by a
+   * flush could be overtaken by it; flushes wait for the cleaner's write first, and the cleaner never has two writes of
+   * a frame in flight.
+   */
+  std::unique_ptr<std::atomic<bool>[]> cleaning_;
+
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing a freed page of this instance if there is one. Caller should acquire the
+   * latch before calling this function.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
@@ -175,10 +302,122 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the correct BPI
+   * @param page_id
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * @brief Hand the page in a frame that is being evicted to the compressed cache, if there is one and the frame holds
+   * valid data. Caller must hold the latch and have written the page back if it was dirty.
+   * @param frame_id the frame being evicted
+   */
+  void CacheEvictedPage(frame_id_t frame_id);
+
+  /**
+   * @brief Find a frame to hold a new page, taking it from the free list first, then from the oldest scan ring slot,
+   * and from the replacer last. If the frame held a page, write it back when dirty and drop it from the page table.
+   * Caller must hold the latch.
+   * @param[out] frame_id the frame that is now free to use
+   * @param reclaim_scan_ring whether a frame may be taken out of the scan ring
+   * @return false if every frame is pinned, true otherwise
+   */
+  auto GetVictimFrame(frame_id_t *frame_id, bool reclaim_scan_ring = true) -> bool;
+
+  /**
+   * @brief Pin a resident page without taking the latch. Must be called under the page table shard latch that maps
+   * the page to frame_id, which guarantees the frame is not concurrently being handed to another page.
+   * @param frame_id the frame holding the page
+   * @param[out] was_unpinned set to true if the pin count went from 0 to 1
+   * @return false if the frame is owned by the buffer pool (free or being replaced), true otherwise
+   */
+  auto TryPin(frame_id_t frame_id, bool *was_unpinned) -> bool;
+
+  /**
+   * @brief Bring the replacer's evictable flag for a frame in line with its pin count. Pins and unpins race with each
+   * other outside the latch, so the pin count is re-read after publishing the flag until the two agree; the last
+   * thread to change the pin count therefore always leaves a consistent flag behind.
+   * @param frame_id the frame to synchronize
+   */
+  void SyncEvictable(frame_id_t frame_id);
+
+  /**
+   * @brief Empty a scan ring slot. If nobody uses the frame in it, write the page back when dirty, drop it from the
+   * page table and return the frame. If the frame is pinned, hand it over to the replacer instead. Caller must hold
+   * the latch.
+   * @param slot the ring slot to empty
+   * @param[out] frame_id the frame that is now free to use
+   * @return true if a free frame was recovered from the slot, false otherwise
+   */
+  auto RecycleScanRingSlot(size_t slot, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Wait until the data of a pinned frame is valid. If its read-ahead failed, read the page synchronously.
+   * @param frame_id the frame to wait for
+   * @throws Exception if the page fails its checksum, after dropping the pin
+   */
+  void WaitForRead(frame_id_t frame_id);
+
+  /**
+   * @brief Read the page of a pinned frame whose read state is READ_PENDING, and publish the outcome. Caller must not
+   * hold the latch.
+   * @param frame_id the frame to read into
+   * @throws Exception if the page cannot be read or fails its checksum, after marking the frame failed and dropping
+   * the pin
+   */
+  void ReadFrame(frame_id_t frame_id);
+
+  /** @brief Wait until the cleaner has no write of a frame in flight. */
+  void WaitForCleaning(frame_id_t frame_id);
+
+  /**
+   * @brief Completion of a read-ahead: publish the outcome, wake waiting fetches and drop the read's pin.
+   * @param frame_id the frame that was read into
+   * @param ok whether the read succeeded
+   */
+  void FinishRead(frame_id_t frame_id, bool ok);
+
+  /**
+   * @brief Loop of one cleaner thread: write back the dirty frames among the next clean_target victims whose index
+   * modulo num_threads is thread_index, until StopCleaner.
+   */
+  void RunCleaner(size_t thread_index, size_t num_threads);
+
+  /**
+   * @brief Start writing back the page in a frame if it is dirty and the WAL allows it. The page is copied into image
+   * under a read latch that is released before the write starts, so the cleaner never holds a page latch across I/O; a
+   * page whose latch is taken by a writer is skipped until the next pass. The frame stays pinned until FinishCleaning,
+   * which keeps it from being replaced, but no access is recorded for it.
+   * @param frame_id the frame to clean
+   * @param image a page-sized buffer that must stay valid until the write completes
+   * @param[out] write the pending write
+   * @return true if a write was started, false if there was nothing to do
+   */
+  auto StartCleaning(frame_id_t frame_id, char *image, std::future<bool> *write) -> bool;
+
+  /**
+   * @brief Release a frame after its write completed. A failed write leaves the page dirty.
+   * @param frame_id the frame StartCleaning started a write for
+   * @param written whether the write succeeded
+   */
+  void FinishCleaning(frame_id_t frame_id, bool written);
+
+  /**
+   * @brief Find a frame for a scan-hinted miss. Recycle the frame in the next ring slot if nobody uses it; otherwise
+   * fill the slot with a frame from GetVictimFrame. Caller must hold the latch.
+   * @param[out] frame_id the frame that is now free to use
+   * @return false if every frame is pinned, true otherwise
+   */
+  auto GetScanRingFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Latch-free hit path shared by FetchPgImp and its re-check under the latch.
+   * @return the pinned page if it is resident and pinnable, nullptr otherwise
+   */
+  auto PinResidentPage(page_id_t page_id, AccessType access_type) -> Page *;
 };
 }  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Fetch latencies are counted in powers of two: bucket i counts fetches that took [2^i, 2^(i+1)) ns. */
+static constexpr size_t FETCH_LATENCY_BUCKETS = 32;
+
+/** A snapshot of what a buffer pool has done. */
+struct BufferPoolStats {
+  /** Fetches that found the page resident. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages read from disk, including the ones read ahead. */
+  uint64_t pages_read_{0};
+  /** Pages written to disk by evictions, flushes and the page cleaner. */
+  uint64_t pages_written_{0};
+  /** Pages evicted to make room for another page. */
+  uint64_t evictions_{0};
+  /** Evictions that had to write the victim back while a fetch waited for the frame. */
+  uint64_t dirty_evictions_{0};
+  /** Time fetches spent waiting for the buffer pool latch, or for a read of the page that was already in flight. */
+  uint64_t pin_wait_ns_{0};
+  /** How long fetches took, in FETCH_LATENCY_BUCKETS buckets. */
+  std::array<uint64_t, FETCH_LATENCY_BUCKETS> fetch_latency_{};
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats &;
+
+  /** @return the fraction of fetches that found the page resident */
+  auto HitRatio() const -> double;
+
+  /** @return the latency in ns that the given fraction of fetches stayed below, rounded up to a bucket boundary */
+  auto FetchLatencyPercentile(double fraction) const -> uint64_t;
+};
+
+/** Buffer pool work done on behalf of one query operator. Several threads may count into it at once. */
+struct IoStats {
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> pages_read_{0};
+  std::atomic<uint64_t> pages_written_{0};
+
+  auto operator+=(const IoStats &other) -> IoStats &;
+};
+
+/**
+ * While an IoStatsScope is alive, the buffer pool work of its thread is also counted into its IoStats. Scopes nest:
+ * an operator that calls into its child opens a scope for the child, so the child's work is counted to the child only.
+ */
+class IoStatsScope {
+ public:
+  explicit IoStatsScope(IoStats *stats) : previous_(current) { current = stats; }
+
+  ~IoStatsScope() { current = previous_; }
+
+  DISALLOW_COPY_AND_MOVE(IoStatsScope);
+
+  /** @return the IoStats of the innermost scope of the calling thread, or nullptr */
+  static auto Current() -> IoStats * { return current; }
+
+ private:
+  inline static thread_local IoStats *current = nullptr;  // NOLINT
+  IoStats *previous_;
+};
+
+/**
+ * The counters of a buffer pool instance. Each thread counts into a slot of its own, so that threads fetching at the
+ * same time do not bounce a shared cache line between them; a snapshot sums up all slots. Counts are also attributed
+ * to the current IoStatsScope of the calling thread.
+ */
+class BufferPoolCounters {
+ public:
+  /** Count a fetch that found the page resident and took latency_ns. */
+  void CountHit(uint64_t latency_ns);
+  /** Count a fetch that had to read the page and took latency_ns. */
+  void CountMiss(uint64_t latency_ns);
+  /** Count pages read from disk. */
+  void CountReads(uint64_t pages);
+  /** Count a page written to disk. */
+  void CountWrite();
+  /** Count an eviction; a dirty victim was written back first. */
+  void CountEviction(bool dirty);
+  /** Count time a fetch was blocked. */
+  void CountPinWait(uint64_t wait_ns);
+
+  /** @return the sum of all slots */
+  auto Snapshot() const -> BufferPoolStats;
+
+  /** Set all counters back to zero. Counts that race with the reset may survive it. */
+  void Reset();
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> pages_read_{0};
+    std::atomic<uint64_t> pages_written_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> dirty_evictions_{0};
+    std::atomic<uint64_t> pin_wait_ns_{0};
+    std::array<std::atomic<uint64_t>, FETCH_LATENCY_BUCKETS> fetch_latency_{};
+  };
+
+  static constexpr size_t NUM_SLOTS = 16;
+
+  /** @return the slot of the calling thread */
+  auto LocalSlot() -> Slot &;
+
+  std::array<Slot, NUM_SLOTS> slots_;
+};
+
+}  // namespace bustub
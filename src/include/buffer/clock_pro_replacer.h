@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.h
+//
+// Identification: src/include/buffer/clock_pro_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ClockProReplacer implements CLOCK-Pro (Jiang, Chen and Zhang, USENIX ATC '05), the clock approximation of LIRS.
+ *
+ * Resident pages are either hot or cold. A newly loaded page is cold and starts a test period. If it is referenced
+ * again before the cold hand comes back to it, it is promoted to hot. Cold pages evicted during their test period
+ * are remembered as non-resident, and a page that is loaded again while non-resident enters as hot. The hot hand
+ * demotes unreferenced hot pages to cold when there are more hot pages than the hot target, and ends the test
+ * periods it passes. The cold target adapts: it grows when a non-resident page comes back, and shrinks when a test
+ * period ends without a re-reference. Pages read once, as in a scan, stay cold and are evicted first.
+ *
+ * The clock is the frame array itself, so both hands sweep frame ids in order.
+ */
+class ClockProReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ClockProReplacer.
+   * @param num_frames the number of frames in the buffer pool
+   */
+  explicit ClockProReplacer(size_t num_frames);
+
+  ~ClockProReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void AssignPage(frame_id_t frame_id, page_id_t page_id) override;
+
+ private:
+  enum class Status { None, Hot, Cold };
+
+  struct FrameInfo {
+    Status status_{Status::None};
+    bool evictable_{false};
+    bool ref_{false};
+    /** Whether a cold page is in its test period. */
+    bool test_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** Move the hot hand until it demotes one hot page, or has gone around the clock once. */
+  void RunHotHand();
+
+  /** Run the hot hand while there are more hot pages than the hot target. */
+  void BalanceHot();
+
+  auto Advance(size_t hand) const -> size_t { return (hand + 1) % frames_.size(); }
+
+  size_t num_frames_;
+  /** Target number of resident cold pages, m_c in the paper. */
+  size_t cold_target_;
+  size_t num_hot_{0};
+  size_t curr_size_{0};
+  size_t hand_cold_{0};
+  size_t hand_hot_{0};
+  std::mutex latch_;
+  std::vector<FrameInfo> frames_;
+  /** Cold pages evicted during their test period. */
+  GhostList non_resident_;
+};
+
+}  // namespace bustub
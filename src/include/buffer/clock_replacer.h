@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -37,16 +36,30 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct Entry {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool ref_{false};
+  };
+
+  size_t curr_size_{0};
+  /** Position of the clock hand in frames_. */
+  size_t hand_{0};
+  std::mutex latch_;
+  std::vector<Entry> frames_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * A byte-oriented LZ77 compressor in the spirit of LZ4: a sequence of literal runs and back-references of at least
+ * MIN_MATCH bytes within the last 64KB, found through a small hash table. It is fast rather than tight. Database pages
+ * compress well with it because of their free space, repeated column values and fixed-width integers.
+ */
+class PageCompressor {
+ public:
+  /** Shortest back-reference the compressor emits. */
+  static constexpr size_t MIN_MATCH = 4;
+
+  /** @return the largest compressed size of size bytes, for sizing an output buffer that always fits */
+  static auto MaxCompressedSize(size_t size) -> size_t { return size + size / 255 + 16; }
+
+  /**
+   * Compress src into dst.
+   * @param src the data to compress
+   * @param size the number of bytes in src
+   * @param[out] dst the output buffer
+   * @param capacity the number of bytes dst can hold
+   * @return the compressed size, or 0 if it would be larger than capacity
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * Decompress src into dst. Malformed input is detected rather than read or written out of bounds.
+   * @param src the compressed data
+   * @param size the number of bytes in src
+   * @param[out] dst the output buffer
+   * @param decompressed_size the number of bytes src decompresses to
+   * @return true if src decompressed to exactly decompressed_size bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t decompressed_size) -> bool;
+};
+
+/** A snapshot of what a compressed page cache has done. */
+struct CompressedPageCacheStats {
+  /** Lookups that found the page. */
+  uint64_t hits_{0};
+  /** Lookups that did not. */
+  uint64_t misses_{0};
+  /** Pages put into the cache. */
+  uint64_t insertions_{0};
+  /** Pages dropped to make room for other pages. */
+  uint64_t evictions_{0};
+  /** Pages in the cache right now. */
+  uint64_t pages_{0};
+  /** Bytes those pages take up. */
+  uint64_t bytes_{0};
+
+  auto operator+=(const CompressedPageCacheStats &other) -> CompressedPageCacheStats &;
+
+  /** @return the fraction of lookups that found the page */
+  auto HitRatio() const -> double;
+
+  /** @return how many times more pages the cache holds than the same memory would hold uncompressed */
+  auto CompressionRatio() const -> double;
+};
+
+/**
+ * CompressedPageCache keeps compressed copies of pages the buffer pool evicted, so that a miss in the pool can be
+ * served from memory instead of disk. It holds clean copies only: the pool writes a dirty page back before it hands
+ * the page over, so dropping an entry never loses data. It is exclusive of the pool, too: a lookup that finds a page
+ * removes it, because the page is about to live in a frame again. When full, it drops the least recently inserted
+ * pages. Pages that do not compress are kept as they are; they still save a read.
+ */
+class CompressedPageCache {
+ public:
+  /** @param capacity the number of bytes of page data the cache may hold */
+  explicit CompressedPageCache(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * Store a copy of a page, replacing any copy of it already there.
+   * @param page_id the page
+   * @param data the BUSTUB_PAGE_SIZE bytes of the page
+   */
+  void Put(page_id_t page_id, const char *data);
+
+  /**
+   * Look a page up and remove it from the cache.
+   * @param page_id the page
+   * @param[out] data receives the BUSTUB_PAGE_SIZE bytes of the page
+   * @return true if the page was in the cache
+   */
+  auto Get(page_id_t page_id, char *data) -> bool;
+
+  /** Drop the copy of a page, if there is one. */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of bytes of page data the cache may hold */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /** @return what the cache has done so far */
+  auto GetStats() -> CompressedPageCacheStats;
+
+ private:
+  struct Entry {
+    /** The compressed page, or the page itself if it did not compress. */
+    std::vector<char> data_;
+    /** Position in lru_. */
+    std::list<page_id_t>::iterator lru_position_;
+  };
+
+  /** Remove an entry and give back its bytes. Caller must hold latch_. @return the data of the entry */
+  auto TakeEntry(std::unordered_map<page_id_t, Entry>::iterator it) -> std::vector<char>;
+
+  const size_t capacity_;
+  std::mutex latch_;
+  std::unordered_map<page_id_t, Entry> entries_;
+  /** Cached pages, most recently inserted first. */
+  std::list<page_id_t> lru_;
+  size_t bytes_{0};
+  CompressedPageCacheStats stats_;
+};
+
+}  // namespace bustub
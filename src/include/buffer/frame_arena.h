@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** What kind of memory backs a FrameArena. */
+enum class FrameArenaBacking { SmallPages, TransparentHugePages, HugeTlbPages };
+
+/**
+ * FrameArena holds the data of all frames of a buffer pool instance in one contiguous mapping. The frame metadata lives
+ * in a separate array of Pages that point into the arena, so scans over pin counts and dirty bits stay dense.
+ *
+ * Large arenas are backed by 2 MB pages, which need far fewer TLB entries to cover the pool than 4 KB pages: reserved
+ * hugetlb pages if the system has any, transparent huge pages otherwise. The arena can be bound to a NUMA node before
+ * any of it is touched, so that its memory is allocated there.
+ */
+class FrameArena {
+ public:
+  /**
+   * @param num_frames number of frames, each BUSTUB_PAGE_SIZE bytes and page-aligned
+   * @param huge_pages back the arena with huge pages if it is large enough and the system supports them
+   * @param numa_node the node to allocate the memory on, or -1 to follow the calling thread's memory policy
+   */
+  FrameArena(size_t num_frames, bool huge_pages, int numa_node);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of a frame */
+  auto GetFrame(size_t frame_id) const -> char * { return data_ + frame_id * BUSTUB_PAGE_SIZE; }
+
+  /** @return what kind of memory backs the arena */
+  auto GetBacking() const -> FrameArenaBacking { return backing_; }
+
+  /** @return the NUMA node the arena is bound to, or -1 */
+  auto GetNumaNode() const -> int { return numa_node_; }
+
+  /** @return the number of NUMA nodes with memory on this machine, at least 1 */
+  static auto NumaNodeCount() -> int;
+
+ private:
+  char *data_{nullptr};
+  size_t mapped_size_{0};
+  FrameArenaBacking backing_{FrameArenaBacking::SmallPages};
+  int numa_node_{-1};
+};
+
+}  // namespace bustub
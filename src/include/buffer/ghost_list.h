@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// ghost_list.h
+//
+// Identification: src/include/buffer/ghost_list.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * GhostList remembers the ids of pages that were recently evicted, in FIFO order, without holding any frames.
+ * Scan-resistant replacers use it to tell a page that is re-referenced shortly after eviction from one that is only
+ * touched once. Not thread-safe; the owning replacer latches it.
+ *
+ * Push does not enforce the capacity, Trim does. The buffer pool evicts a frame before it tells the replacer which
+ * page goes into it, so replacers trim only after looking the incoming page up; otherwise the eviction made for a
+ * page could push that very page's ghost out.
+ */
+class GhostList {
+ public:
+  /** @param capacity the number of page ids to keep when the list is trimmed */
+  explicit GhostList(size_t capacity) : capacity_(capacity) {}
+
+  /** Remember a page as the newest entry. Invalid page ids are ignored. */
+  void Push(page_id_t page_id) {
+    if (page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    Erase(page_id);
+    list_.push_front(page_id);
+    index_[page_id] = list_.begin();
+  }
+
+  /** Forget the oldest pages until the list is within its capacity. */
+  void Trim() {
+    while (list_.size() > capacity_) {
+      PopOldest();
+    }
+  }
+
+  /** Forget a page. @return true if the page was remembered */
+  auto Erase(page_id_t page_id) -> bool {
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      return false;
+    }
+    list_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  /** Forget the oldest page, if any. */
+  void PopOldest() {
+    if (list_.empty()) {
+      return;
+    }
+    index_.erase(list_.back());
+    list_.pop_back();
+  }
+
+  auto Size() const -> size_t { return list_.size(); }
+
+ private:
+  size_t capacity_;
+  /** Remembered pages, newest first. */
+  std::list<page_id_t> list_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -13,20 +13,15 @@
 #pragma once
 
 #include <limits>
-#include <climits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
-
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-
-
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
  *
@@ -37,13 +32,14 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * The access history of each frame is a fixed-size ring of k timestamps in one flat array, so
+ * RecordAccess never allocates. Evictable frames are kept in an indexed binary min-heap ordered by
+ * eviction priority, so Evict, SetEvictable and Remove cost O(log n) instead of a scan of every frame.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    */
@@ -52,15 +48,11 @@ class LRUKReplacer {
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
    * that are marked as 'evictable' are candidates for eviction.
    *
@@ -74,11 +66,9 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Record the event that the given frame id is accessed at current timestamp.
    * Create a new entry for access history if frame id has not been seen before.
    *
@@ -87,11 +77,9 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame that received a new access.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
    * controls replacer's size. Note that size is equal to number of evictable entries.
    *
@@ -106,11 +94,9 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
    *
@@ -125,39 +111,62 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /**
+   * @brief List the next victims in eviction order by walking the top of the heap best-first.
+   *
+   * @param max_frames the maximum number of frames to list
+   * @return up to max_frames evictable frames
+   */
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
+  using timestamp = size_t;
+
+  static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+  /** Bookkeeping of one frame, stored in a flat array indexed by frame id. */
+  struct FrameInfo {
+    /** Number of timestamps in the frame's ring, at most k. Zero means the frame is not tracked. */
+    size_t count_{0};
+    /** Ring slot the next access is written to. Once the ring is full, it also holds the oldest timestamp. */
+    size_t head_{0};
+    bool evictable_{false};
+    /** Position of the frame in heap_, or NOT_IN_HEAP if it is not evictable. */
+    size_t heap_pos_{NOT_IN_HEAP};
+  };
+
+  /** @return the k-th most recent access of a frame, or its first access if it has fewer than k. */
+  auto Oldest(frame_id_t frame_id) const -> timestamp;
+  /** @return true if frame a should be evicted before frame b. */
+  auto EvictsBefore(frame_id_t a, frame_id_t b) const -> bool;
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(frame_id_t frame_id);
+  void HeapSwap(size_t i, size_t j);
+  void SiftUp(size_t pos);
+  void SiftDown(size_t pos);
+
   size_t current_timestamp_{0};
+  /** Number of evictable frames currently tracked. */
   size_t curr_size_{0};
-  size_t replacer_size_;//the number of  pinned frames.
+  /** Maximum number of frames the replacer may track; frame ids must be below this. */
+  size_t replacer_size_;
   size_t k_;
-  size_t max_size;
   std::mutex latch_;
 
-
-  using timestamp=size_t;
-  using k_distance=std::pair<frame_id_t,size_t>;
-
-  std::unordered_map<frame_id_t,bool> frame_evict_;
-
-  std::unordered_map<frame_id_t,std::list<timestamp> > hist_timestamp_;
-
-  std::list<k_distance> cache_frame_;
-
-  std::unordered_map<frame_id_t,std::list<k_distance>::iterator> cache_k_;
-  std::unordered_map<frame_id_t,std::list<k_distance>::iterator> cache_le_k_;
+  std::vector<FrameInfo> frames_;
+  /** Access history rings, k timestamps per frame, frame i owns [i * k, (i + 1) * k). */
+  std::vector<timestamp> history_;
+  /** Evictable frames, as a binary min-heap on EvictsBefore. */
+  std::vector<frame_id_t> heap_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <mutex>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -37,16 +38,30 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct Entry {
+    std::list<frame_id_t>::iterator pos_;
+    bool evictable_;
+  };
+
+  size_t num_pages_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+  /** Tracked frames, most recently used first. */
+  std::list<frame_id_t> lru_list_;
+  std::unordered_map<frame_id_t, Entry> entries_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool across several BufferPoolManagerInstances so that requests for
+ * different pages do not contend on a single latch. Page ids are striped across the instances: page p lives in
+ * instance (p mod num_instances), and each instance only ever allocates ids from its own residue class.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the page replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the total number of frames across all instances */
+  auto GetPoolSize() -> size_t override;
+
+  /** @return the statistics of all instances added up */
+  auto GetStats() -> BufferPoolStats override;
+
+  void ResetStats() override;
+
+  /** @return the number of instances the pool is sharded into */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * Start the page cleaner of every instance.
+   * @param num_threads the number of cleaner threads per instance
+   * @param clean_target how many of the frames closest to eviction each instance keeps clean
+   */
+  void StartCleaner(size_t num_threads = 1, size_t clean_target = CLEANER_CLEAN_TARGET);
+
+  /** Stop the page cleaner of every instance. */
+  void StopCleaner();
+
+  /**
+   * Give every instance a compressed cache of evicted pages.
+   * @param capacity the number of bytes the compressed pages of all instances together may take up
+   */
+  void EnableCompressedCache(size_t capacity);
+
+  /** @return what the compressed caches of all instances have done, added up */
+  auto GetCompressedCacheStats() -> CompressedPageCacheStats;
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @param access_type how the page is going to be used
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried round robin, starting from a different instance on
+   * every call, so that allocations spread evenly and a single full instance does not fail the request.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk.
+   */
+  void FlushAllPgsImp() override;
+
+  /**
+   * Splits the pages by instance and starts reading them ahead in each.
+   * @param page_ids the pages to read ahead
+   * @param access_type how the pages are going to be used
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) override;
+
+ private:
+  /** The sharded instances, indexed by page_id mod number of instances. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** The pool size of each instance. */
+  const size_t pool_size_;
+  /** The instance NewPgImp will try first on its next call. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
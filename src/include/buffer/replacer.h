@@ -12,12 +12,26 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
 /**
- * Replacer is an abstract class that tracks page usage.
+ * How a page is about to be used. The buffer pool takes it as a hint: pages fetched for a Scan cycle through a small
+ * ring of frames of their own instead of going through the replacer, so bulk sequential reads do not evict the
+ * working set of point lookups.
+ */
+enum class AccessType { Unknown = 0, Lookup, Scan, Index };
+
+/**
+ * Replacer is an abstract class that tracks frame usage and picks the frame to evict when the buffer pool is full.
+ *
+ * A frame is tracked from its first RecordAccess until it is evicted or removed. Newly tracked frames are not
+ * evictable; the buffer pool marks a frame evictable once its pin count drops to zero.
  */
 class Replacer {
  public:
@@ -25,26 +39,73 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * Evict the victim frame as defined by the replacement policy. Only evictable frames are candidates. The frame's
+   * access history is dropped.
+   * @param[out] frame_id id of frame that was evicted
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Record that the given frame was accessed. Starts tracking the frame, as non-evictable, if it is not tracked yet.
+   * @param frame_id the id of the accessed frame
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordAccess(frame_id_t frame_id) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Mark a tracked frame evictable or not evictable. Does nothing for untracked frames.
+   * @param frame_id the id of the frame
+   * @param set_evictable whether the frame may be evicted
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /**
+   * Stop tracking an evictable frame, regardless of its position in the eviction order. Does nothing for untracked
+   * frames, and aborts on non-evictable ones.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of evictable frames */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * List the frames that would be evicted next, most likely victim first, without changing any state. For policies
+   * whose choice depends on what happens before the eviction, the order is the best guess at the time of the call.
+   * @param max_frames the maximum number of frames to list
+   * @return up to max_frames evictable frames
+   */
+  virtual auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
+
+  /**
+   * Tell the replacer which page a frame is about to hold. The buffer pool calls this right before the first
+   * RecordAccess after loading a page into a frame. Policies that remember recently evicted pages use it to
+   * recognize a page that comes back; the others ignore it.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page loaded into the frame
+   */
+  virtual void AssignPage(frame_id_t frame_id, page_id_t page_id) {}
 };
 
+/** The replacement policies a buffer pool can be configured with. */
+enum class ReplacerPolicy { LRU, LRUK, Clock, ClockPro, TwoQueue, ARC };
+
+/**
+ * Create a replacer implementing the given policy.
+ * @param policy the replacement policy
+ * @param num_frames the number of frames in the buffer pool
+ * @param k lookback window, only used by LRU-K
+ */
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+/** @return the name of the policy, as accepted by ParseReplacerPolicy */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
+/**
+ * Parse a policy name: one of lru, lru-k, clock, clock-pro, 2q or arc (case insensitive).
+ * @param[out] policy the parsed policy
+ * @return false if the name is not recognized
+ */
+auto ParseReplacerPolicy(const std::string &name, ReplacerPolicy *policy) -> bool;
+
 }  // namespace bustub
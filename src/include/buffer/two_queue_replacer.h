@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB '94).
+ *
+ * A page loaded for the first time enters A1in, a FIFO holding about a quarter of the frames. Pages evicted from
+ * A1in are remembered in A1out, a ghost FIFO. A page that is loaded again while it is still in A1out has proven it
+ * is re-referenced and enters Am, an LRU list of the hot pages. Hits on A1in pages do not promote them, so a
+ * sequential scan only churns A1in and leaves the hot pages in Am alone.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_frames the number of frames in the buffer pool
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void AssignPage(frame_id_t frame_id, page_id_t page_id) override;
+
+ private:
+  enum class Queue { None, A1In, Am };
+
+  struct FrameInfo {
+    Queue queue_{Queue::None};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** Evict the least recently inserted or used evictable frame of a queue. */
+  auto EvictFrom(std::list<frame_id_t> *queue, frame_id_t *frame_id) -> bool;
+
+  /** Maximum size of A1in before it is preferred for eviction. */
+  size_t kin_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+  std::vector<FrameInfo> frames_;
+  /** First-time pages, newest first. */
+  std::list<frame_id_t> a1in_;
+  /** Re-referenced pages, most recently used first. */
+  std::list<frame_id_t> am_;
+  GhostList a1out_;
+};
+
+}  // namespace bustub
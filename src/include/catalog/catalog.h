@@ -228,12 +228,17 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap. The backfill reads the table once, so keep it from evicting
+    // the pages other queries are working on. Collecting the keys first lets the index be built bottom-up.
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    std::vector<std::pair<KeyType, RID>> entries;
+    for (auto tuple = heap->Begin(txn, AccessType::Scan); tuple != heap->End(); ++tuple) {
+      KeyType index_key;
+      index_key.SetFromKey(tuple->KeyFromTuple(schema, key_schema, key_attrs));
+      entries.emplace_back(index_key, tuple->GetRid());
     }
+    index->InsertEntries(&entries, txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
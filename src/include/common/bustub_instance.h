@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -22,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/util/string_util.h"
@@ -210,8 +213,11 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /** Allocate the header page of the B+ tree indexes, so that no table takes its page id. */
+  void ReserveHeaderPage();
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  explicit BustubInstance(const std::string &db_file_name, ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
 
   BustubInstance();
 
@@ -266,10 +272,26 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return the number of threads a query may run its scans on, set by `SET degree_of_parallelism = n` */
+  auto GetDegreeOfParallelism() -> size_t {
+    auto variable = GetSessionVariable("degree_of_parallelism");
+    if (variable.empty() || !std::all_of(variable.begin(), variable.end(), ::isdigit)) {
+      return 1;
+    }
+    if (variable.size() > 3) {
+      return MAX_DEGREE_OF_PARALLELISM;
+    }
+    return std::clamp<size_t>(std::stoul(variable), 1, MAX_DEGREE_OF_PARALLELISM);
+  }
+
+  /** The most threads a query may run its scans on. */
+  static constexpr size_t MAX_DEGREE_OF_PARALLELISM = 64;
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayBufferStats(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
 };
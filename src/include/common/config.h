@@ -27,6 +27,41 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** An idle buffer pool page cleaner looks for dirty pages again every CLEANER_INTERVAL. */
+extern std::chrono::milliseconds cleaner_interval;
+
+/**
+ * A table iterator reads read_ahead_pages pages ahead of the page it is on; a B+ tree index iterator reads up to that
+ * many of the leaves that follow its leaf under the same parent. 0 turns read-ahead off.
+ */
+extern std::atomic<int> read_ahead_pages;
+
+/**
+ * A bulk-loaded B+ tree fills its pages to this percentage of their capacity, leaving the rest for later inserts.
+ * Pages never start out below their minimum size, however low the percentage.
+ */
+extern std::atomic<int> bulk_load_fill_percent;
+
+/** True if buffer pools should back their frames with huge pages when they are large enough. */
+extern std::atomic<bool> enable_huge_pages;
+
+/**
+ * True if database files created from now on keep a CRC32C checksum of every page. Existing files keep their choice.
+ */
+extern std::atomic<bool> enable_page_checksums;
+
+/** True if the execution engine pulls rows from executors a batch at a time; false pulls them one by one. */
+extern std::atomic<bool> enable_batch_execution;
+
+/** True if executors compile their numeric expressions into typed programs; false walks the expression trees. */
+extern std::atomic<bool> enable_expression_compilation;
+
+/**
+ * True if sequential scans run simple integer filters on the table pages and copy out only the tuples that pass; false
+ * copies every tuple out before filtering it.
+ */
+extern std::atomic<bool> enable_page_predicates;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -35,7 +70,11 @@ static constexpr int BUSTUB_PAGE_SIZE = 4096;
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
-static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int LRUK_REPLACER_K = 10;         // lookback window for lru-k replacer
+static constexpr int SCAN_RING_SIZE = 32;          // max frames per buffer pool instance used by scan-hinted fetches
+static constexpr int CLEANER_CLEAN_TARGET = 64;    // frames closest to eviction the page cleaner keeps clean
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 64;    // max page I/Os in flight in an AsyncDiskManager
+static constexpr int DB_FILE_EXTENT_PAGES = 1024;  // pages an AsyncDiskManager preallocates when the file grows
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.h
+//
+// Identification: src/include/common/util/crc32c.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and most storage engines. On x86 CPUs with SSE4.2 it runs on the
+ * crc32 instruction, eight bytes at a time; elsewhere it falls back to a table-driven implementation that produces the
+ * same values.
+ */
+class Crc32c {
+ public:
+  /**
+   * @param data the bytes to checksum
+   * @param size the number of bytes
+   * @param crc the checksum of the bytes before data, to checksum a buffer in pieces; 0 to start
+   * @return the checksum of the bytes so far
+   */
+  static auto Compute(const char *data, size_t size, uint32_t crc = 0) -> uint32_t;
+
+  /** Compute without the hardware instruction, for testing and benchmarking. */
+  static auto ComputeSoftware(const char *data, size_t size, uint32_t crc = 0) -> uint32_t;
+
+  /** @return true if Compute uses the crc32 instruction */
+  static auto IsHardwareAccelerated() -> bool;
+};
+
+}  // namespace bustub
@@ -36,8 +36,6 @@ template <typename K, typename V>
 class ExtendibleHashTable : public HashTable<K, V> {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
    *
    * @brief Create a new ExtendibleHashTable.
    * @param bucket_size: fixed size for each bucket
@@ -62,10 +60,8 @@ class ExtendibleHashTable : public HashTable<K, V> {
    * @return The number of buckets in the directory.
    */
   auto GetNumBuckets() const -> int;
-	
+
   /**
-   *
-   * TODO(P1): Add implementation
    *
    * @brief Find the value associated with the given key.
    *
@@ -78,8 +74,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto Find(const K &key, V &value) -> bool override;
 
   /**
-   *
-   * TODO(P1): Add implementation
    *
    * @brief Insert the given key-value pair into the hash table.
    * If a key already exists, the value should be updated.
@@ -95,8 +89,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   void Insert(const K &key, const V &value) override;
 
   /**
-   *
-   * TODO(P1): Add implementation
    *
    * @brief Given the key, remove the corresponding key-value pair in the hash table.
    * Shrink & Combination is not required for this project
@@ -124,8 +116,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
     inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
 
     /**
-     *
-     * TODO(P1): Add implementation
      *
      * @brief Find the value associated with the given key in the bucket.
      * @param key The key to be searched.
@@ -135,8 +125,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Find(const K &key, V &value) -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
      *
      * @brief Given the key, remove the corresponding key-value pair in the bucket.
      * @param key The key to be deleted.
@@ -145,8 +133,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Remove(const K &key) -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
      *
      * @brief Insert the given key-value pair into the bucket.
      *      1. If a key already exists, the value should be updated.
@@ -158,24 +144,18 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Insert(const K &key, const V &value) -> bool;
 
    private:
-    // TODO(student): You may add additional private members and helper functions
     size_t size_;
     int depth_;
     std::list<std::pair<K, V>> list_;
-  };//Bucket
+  };
 
  private:
-  // TODO(student): You may add additional private members and helper functions and remove the ones
-  // you don't need.
-
   int global_depth_;    // The global depth of the directory
   size_t bucket_size_;  // The size of a bucket
   int num_buckets_;     // The number of buckets in the hash table
   mutable std::mutex latch_;
   std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
 
-  // The following functions are completely optional, you can delete them if you have your own ideas.
-
   /**
    * @brief Redistribute the kv pairs in a full bucket.
    * @param bucket The bucket to be redistributed.
@@ -196,6 +176,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto GetGlobalDepthInternal() const -> int;
   auto GetLocalDepthInternal(int dir_index) const -> int;
   auto GetNumBucketsInternal() const -> int;
-};//ExtendileHashTable
+};
 
 }  // namespace bustub
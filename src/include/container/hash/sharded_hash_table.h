@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sharded_hash_table.h
+//
+// Identification: src/include/container/hash/sharded_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * sharded_hash_table.h
+ *
+ * Implementation of an in-memory concurrent hash table that splits its key space into independently latched shards.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * ShardedHashTable partitions keys across a fixed number of shards, each guarded by its own reader-writer latch.
+ * Lookups only take a shared latch on one shard, so concurrent readers never serialize, and writers only block the
+ * readers of the shard they modify.
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class ShardedHashTable : public HashTable<K, V> {
+ public:
+  /**
+   * @brief Create a new ShardedHashTable.
+   * @param num_shards number of shards, rounded up to a power of two
+   */
+  explicit ShardedHashTable(size_t num_shards) {
+    size_t shards = 1;
+    while (shards < num_shards) {
+      shards <<= 1;
+    }
+    num_shards_ = shards;
+    shards_ = std::make_unique<Shard[]>(num_shards_);
+  }
+
+  DISALLOW_COPY_AND_MOVE(ShardedHashTable);
+
+  ~ShardedHashTable() override = default;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override {
+    return FindAndApply(key, &value, [](const V &) { return true; });
+  }
+
+  /**
+   * @brief Find the value associated with the given key and, while the shard is still read-latched, apply fn to it.
+   *
+   * Because fn runs before the shard latch is released, a concurrent Remove of the same key cannot complete between
+   * the lookup and fn. Callers use this to take a reference on the value that the remover must observe.
+   *
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @param fn Predicate invoked with the value under the shard's read latch.
+   * @return True if the key is found and fn returned true, false otherwise.
+   */
+  template <typename Fn>
+  auto FindAndApply(const K &key, V *value, Fn &&fn) -> bool {
+    auto &shard = ShardOf(key);
+    std::shared_lock<std::shared_mutex> lock(shard.latch_);
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) {
+      return false;
+    }
+    *value = it->second;
+    return fn(it->second);
+  }
+
+  /**
+   * @brief Insert the given key-value pair into the hash table. If a key already exists, the value is updated.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override {
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::shared_mutex> lock(shard.latch_);
+    shard.map_[key] = value;
+  }
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override {
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::shared_mutex> lock(shard.latch_);
+    return shard.map_.erase(key) > 0;
+  }
+
+  /** @return the number of shards */
+  auto GetNumShards() const -> size_t { return num_shards_; }
+
+ private:
+  /** One independently latched partition of the table, padded to its own cache line. */
+  struct alignas(64) Shard {
+    std::shared_mutex latch_;
+    std::unordered_map<K, V> map_;
+  };
+
+  auto ShardOf(const K &key) -> Shard & {
+    // Keys such as page ids are often strided (e.g. striped across buffer pool instances), so mix the bits with the
+    // murmur3 finalizer before picking a shard.
+    uint64_t h = std::hash<K>()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return shards_[h & (num_shards_ - 1)];
+  }
+
+  size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/compiled_expression.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * CompiledExpression is an expression tree flattened into a program of type-specialized instructions. Every
+ * instruction runs one kernel over all the rows of a batch, and columns are read straight from the tuple bytes, so
+ * evaluating an expression neither boxes a Value at each node nor dispatches through Type for each row.
+ *
+ * Compile() takes column references into the input tuple, constants, comparisons and AND/OR over the fixed-width
+ * numeric and boolean types, and INTEGER arithmetic, the only arithmetic that ArithmeticExpression does. Nulls behave as
+ * they do for Value: a null operand makes a comparison or arithmetic null, and AND/OR follow three-valued logic.
+ *
+ * The registers of the program live in the CompiledExpression, so it is not thread-safe: every executor compiles its
+ * own.
+ */
+class CompiledExpression {
+ public:
+  /**
+   * @param expr the expression to compile
+   * @param schema the schema of the tuples that expr is evaluated on
+   * @return the program of expr, or nullptr if expr uses anything else than the supported types and expressions, in
+   * which case it has to be evaluated with AbstractExpression::Evaluate
+   */
+  static auto Compile(const AbstractExpression &expr, const Schema &schema) -> std::unique_ptr<CompiledExpression>;
+
+  /** Evaluate the expression on every row of batch. Row i of the result belongs to row i of the batch. */
+  void Run(const TupleBatch &batch);
+
+  /** Evaluate the expression on tuple, which becomes row 0 of the result. */
+  void Run(const Tuple &tuple);
+
+  /** @return true if the result of row is true, and not null */
+  auto IsTrue(size_t row) const -> bool {
+    const auto &result = registers_[result_];
+    return result.nulls_[row] == 0 && result.ints_[row] != 0;
+  }
+
+  /** @return the result of row as a Value */
+  auto GetValue(size_t row) const -> Value;
+
+  /** Write the result of row to storage, the way Value::SerializeTo writes a value of the return type. */
+  void SerializeTo(size_t row, char *storage) const;
+
+  /** @return the type of the result */
+  auto GetReturnType() const -> TypeId { return ret_type_; }
+
+ private:
+  /** The values of one node of the expression, for every row of the batch. */
+  struct Register {
+    /** The values of every type but DECIMAL; booleans are 0 or 1 */
+    std::vector<int64_t> ints_;
+    /** The values of DECIMAL */
+    std::vector<double> reals_;
+    /** 1 where the value is null */
+    std::vector<uint8_t> nulls_;
+
+    template <typename T>
+    auto Values() -> std::vector<T> & {
+      if constexpr (std::is_same_v<T, double>) {
+        return reals_;
+      } else {
+        return ints_;
+      }
+    }
+  };
+
+  struct Instruction;
+
+  /** Runs an instruction over count rows. */
+  using Kernel = void (*)(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+
+  struct Instruction {
+    Kernel kernel_;
+    /** The register the instruction writes */
+    uint32_t dst_{0};
+    /** The registers of the operands */
+    uint32_t lhs_{0};
+    uint32_t rhs_{0};
+    /** Loads: the offset of the column in the tuple */
+    uint32_t offset_{0};
+    /** Constants: the value, in the member of its type */
+    int64_t int_constant_{0};
+    double real_constant_{0};
+    bool null_constant_{false};
+  };
+
+  CompiledExpression() = default;
+
+  /**
+   * Append the instructions of expr to the program.
+   * @return the register that holds the result of expr, or std::nullopt if expr cannot be compiled
+   */
+  auto Emit(const AbstractExpression &expr, const Schema &schema) -> std::optional<uint32_t>;
+
+  /** @return a new register for a value of type */
+  auto AddRegister(TypeId type) -> uint32_t;
+
+  /** @return the register that holds the value of reg as a DECIMAL, converting it if it is an integer */
+  auto EmitToDecimal(uint32_t reg) -> uint32_t;
+
+  /** Run the program over count rows. */
+  void Execute(const char *const *rows, size_t count);
+
+  template <typename T>
+  static void Load(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+  template <typename T>
+  static void Constant(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+  static void ToDecimal(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+  template <typename T, typename Op>
+  static void Compare(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+  template <typename T, typename Op>
+  static void Compute(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+  template <bool IsAnd>
+  static void Logic(const Instruction &instruction, Register *registers, const char *const *rows, size_t count);
+
+  std::vector<Instruction> program_;
+  std::vector<Register> registers_;
+  /** The type of the values in each register */
+  std::vector<TypeId> register_types_;
+  /** The register that holds the result */
+  uint32_t result_{0};
+  TypeId ret_type_{TypeId::INVALID};
+  /** The data of the rows of the current run */
+  std::vector<const char *> rows_;
+};
+
+}  // namespace bustub
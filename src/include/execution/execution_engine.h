@@ -21,6 +21,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -85,11 +86,20 @@ class ExecutionEngine {
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid)) {
+    if (!enable_batch_execution) {
+      RID rid{};
+      Tuple tuple{};
+      while (executor->Next(&tuple, &rid)) {
+        if (result_set != nullptr) {
+          result_set->push_back(tuple);
+        }
+      }
+      return;
+    }
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
       if (result_set != nullptr) {
-        result_set->push_back(tuple);
+        batch.MoveTuplesTo(result_set);
       }
     }
   }
@@ -12,15 +12,33 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "buffer/buffer_pool_stats.h"
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class AbstractPlanNode;
+
+/** What one operator of an analyzed query did. */
+struct OperatorStats {
+  /** Buffer pool work of the operator itself, not counting its children. */
+  IoStats io_;
+  /** Rows the operator produced. */
+  std::atomic<uint64_t> rows_{0};
+  /** Time spent in the operator, including its children. */
+  std::atomic<uint64_t> time_ns_{0};
+};
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -60,6 +78,28 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** Collect OperatorStats for every executor created from now on, as EXPLAIN ANALYZE does. */
+  void EnableAnalyze() { analyze_ = true; }
+
+  /** @return true if executors collect OperatorStats */
+  auto IsAnalyze() const -> bool { return analyze_; }
+
+  /** Run scans and the pipelines above them on up to degree worker threads; 1 runs the whole query on the caller. */
+  void SetDegreeOfParallelism(size_t degree) { degree_of_parallelism_ = degree; }
+
+  /** @return the number of worker threads a parallel pipeline may use */
+  auto GetDegreeOfParallelism() const -> size_t { return degree_of_parallelism_; }
+
+  /** @return the stats of the operator that executes plan, created on first use */
+  auto GetOperatorStats(const AbstractPlanNode *plan) -> OperatorStats * {
+    std::scoped_lock<std::mutex> lock(operator_stats_latch_);
+    auto &stats = operator_stats_[plan];
+    if (stats == nullptr) {
+      stats = std::make_unique<OperatorStats>();
+    }
+    return stats.get();
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +111,12 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** Whether executors collect OperatorStats */
+  bool analyze_{false};
+  /** The number of worker threads a parallel pipeline may use */
+  size_t degree_of_parallelism_{1};
+  std::mutex operator_stats_latch_;
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<OperatorStats>> operator_stats_;
 };
 
 }  // namespace bustub
@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -27,9 +28,16 @@ class ExecutorFactory {
    * Creates a new executor given the executor context and plan node.
    * @param exec_ctx The executor context for the created executor
    * @param plan The plan node that needs to be executed
+   * @param morsel The slice of the input that the scan below plan is restricted to, or nullptr for all of it. Pipelines
+   * created for a morsel always run on the calling thread.
    * @return An executor for the given plan in the provided context
    */
-  static auto CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+  static auto CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                             const Morsel *morsel = nullptr) -> std::unique_ptr<AbstractExecutor>;
+
+ private:
+  /** @return the executor of the plan node, without the AnalyzeExecutor that EXPLAIN ANALYZE puts around it */
+  static auto CreatePlanExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan, const Morsel *morsel)
       -> std::unique_ptr<AbstractExecutor>;
 };
 }  // namespace bustub
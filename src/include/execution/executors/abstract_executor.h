@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <utility>
+
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model,
+ * with NextBatch to pass rows between executors a batch at a time.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
  */
@@ -46,6 +50,23 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next rows produced by this executor, as many as fit into the batch. The default calls Next until the
+   * batch is full, so that every executor can feed a parent that works a batch at a time; executors that gain from
+   * handling many rows per call override it. A caller drives an executor through either Next or NextBatch.
+   * @param[out] batch Cleared, then filled with the next rows
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    batch->Clear();
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->Append(std::move(tuple), rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// analyze_executor.h
+//
+// Identification: src/include/execution/executors/analyze_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * AnalyzeExecutor runs another executor and counts what it does into the OperatorStats of its plan node: the rows it
+ * produces, the time it takes and the buffer pool work it does. EXPLAIN ANALYZE puts one around every executor.
+ */
+class AnalyzeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new AnalyzeExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The plan node that child_executor executes
+   * @param child_executor The executor to count
+   */
+  AnalyzeExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                  std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the child executor */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the child executor.
+   * @param[out] tuple The next tuple produced by the child executor
+   * @param[out] rid The next tuple RID produced by the child executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next rows from the child executor.
+   * @param[out] batch The next rows produced by the child executor
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema of the child executor */
+  auto GetOutputSchema() const -> const Schema & override { return child_executor_->GetOutputSchema(); };
+
+ private:
+  /** The stats of the plan node */
+  OperatorStats *stats_;
+  /** The executor that does the work */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+};
+}  // namespace bustub
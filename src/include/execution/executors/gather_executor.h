@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_stats.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
+#include "execution/morsel_scheduler.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * GatherExecutor runs a pipeline in parallel. It cuts the input of the scan at the bottom of the pipeline into morsels,
+ * runs a copy of the pipeline over each morsel on the worker threads of a MorselScheduler, and hands on the output of
+ * the morsels in morsel order, so the rows come out in the same order as they would from the pipeline itself. Whatever
+ * consumes the pipeline, be it the client, a hash join build or an aggregation, reads from the gather.
+ *
+ * Only the WINDOW_PER_WORKER * num_workers morsels from the one handed on next may run ahead of the consumer: a worker
+ * that takes a morsel past the window waits for the consumer to catch up, so a slow consumer holds the output of a few
+ * morsels in memory rather than that of the whole input.
+ *
+ * The buffer pool work of the workers is counted per morsel and added to the IoStatsScope that was current when Init()
+ * ran, as the consumer moves past each morsel, so it is attributed as if the pipeline had run on the calling thread.
+ *
+ * The executor factory puts a gather in place of every pipeline that CanParallelize() accepts when the query runs with
+ * a degree of parallelism above 1.
+ *
+ * Out of scope: there is no exchange that partitions a hash join build or an aggregation across the workers. The hash
+ * join and aggregation executors of this tree are the course's stubs, so there is no build or merge phase to split;
+ * they consume a gather like any other child, and only the pipelines below them run in parallel.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The root of the pipeline to run in parallel
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan);
+
+  /** Stop the workers of the current run. */
+  ~GatherExecutor() override;
+
+  /** Cut the input into morsels and start running the pipeline over them. */
+  void Init() override;
+
+  /**
+   * Yield the next tuple of the pipeline.
+   * @param[out] tuple The next tuple produced by the pipeline
+   * @param[out] rid The next tuple RID produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next rows of the pipeline.
+   * @param[out] batch The next rows produced by the pipeline
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema of the pipeline */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+  /** @return true if plan is a pipeline of projections and filters over a sequential or mock scan */
+  static auto CanParallelize(const AbstractPlanNode &plan) -> bool;
+
+  /** The number of morsels per worker that may run ahead of the consumer. */
+  static constexpr size_t WINDOW_PER_WORKER = 2;
+
+ private:
+  /** What the pipeline produced over one morsel. */
+  struct MorselOutput {
+    std::vector<TupleBatch> batches_;
+    /** Set once batches_ holds all of the output of the morsel */
+    bool done_{false};
+    /** The buffer pool work of the morsel that no executor of the pipeline counted for itself */
+    IoStats io_;
+  };
+
+  /** @return the input of the pipeline, cut into morsels */
+  auto MakeMorsels() const -> std::vector<Morsel>;
+
+  /** Run the pipeline over a morsel; called on a worker thread. */
+  void RunMorsel(size_t index);
+
+  /** Stop the workers and drop what they produced. */
+  void Stop();
+
+  /** The root of the pipeline */
+  AbstractPlanNodeRef plan_;
+  /** The input of the current run */
+  std::vector<Morsel> morsels_;
+  /** The pipeline, when the input fits into a single morsel and the calling thread runs it by itself */
+  std::unique_ptr<AbstractExecutor> serial_executor_;
+  /** The workers of the current run */
+  std::unique_ptr<MorselScheduler> scheduler_;
+  /** Where the buffer pool work of the workers goes, or nullptr; the IoStatsScope current when Init() ran */
+  IoStats *io_stats_{nullptr};
+
+  /** Protects outputs_, error_, next_morsel_ and stopping_ */
+  std::mutex latch_;
+  /** Signalled whenever a morsel is done or fails */
+  std::condition_variable morsel_done_;
+  /** Signalled whenever the consumer moves on to the next morsel, or the run stops */
+  std::condition_variable window_moved_;
+  std::vector<MorselOutput> outputs_;
+  /** The number of morsels that may run from next_morsel_ on */
+  size_t window_{0};
+  /** Set while Stop() waits for the workers, so that none of them waits for the window */
+  bool stopping_{false};
+  /** The first error thrown by a worker, to be thrown by Next() */
+  std::exception_ptr error_;
+  /** Set along with error_, for the workers to check without the latch */
+  std::atomic<bool> failed_{false};
+
+  /** The morsel whose output is handed on next; the consumer changes it under the latch */
+  size_t next_morsel_{0};
+  /** The next batch of that morsel */
+  size_t next_batch_{0};
+  /** The batch that Next() takes its tuples from */
+  TupleBatch current_batch_;
+  /** The next tuple of current_batch_ */
+  size_t next_tuple_{0};
+};
+
+}  // namespace bustub
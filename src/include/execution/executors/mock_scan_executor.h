@@ -18,6 +18,7 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -35,8 +36,18 @@ class MockScanExecutor : public AbstractExecutor {
    * Construct a new MockScanExecutor instance.
    * @param exec_ctx The executor context
    * @param plan The mock scan plan to be executed
+   * @param morsel The rows to scan, or nullptr to scan the whole table
    */
-  MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan);
+  MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, const Morsel *morsel = nullptr);
+
+  /** The number of rows in a morsel of a parallel scan. */
+  static constexpr size_t MORSEL_ROWS = 16384;
+
+  /**
+   * @return the table of the plan cut into morsels of MORSEL_ROWS rows, in scan order. Tables that are scanned in a
+   * random order cannot be cut up, and come back as a single morsel.
+   */
+  static auto MakeMorsels(const MockScanPlanNode *plan) -> std::vector<Morsel>;
 
   /** Initialize the mock scan. */
   void Init() override;
@@ -49,6 +60,13 @@ class MockScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next rows from the sequential scan.
+   * @param[out] batch The next rows produced by the scan
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -68,13 +86,16 @@ class MockScanExecutor : public AbstractExecutor {
   /** The plan node for the scan */
   const MockScanPlanNode *plan_;
 
+  /** The first row of the scan */
+  std::size_t begin_{0};
+
   /** The cursor for the current mock scan */
   std::size_t cursor_{0};
 
   /** The table function */
   std::function<Tuple(std::size_t)> func_;
 
-  /** The size of the mock table */
+  /** The row after the last row of the scan: the size of the mock table, unless the scan is a morsel */
   std::size_t size_;
 
   /** The shuffled output */
@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/projection_plan.h"
@@ -47,6 +48,13 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next rows from the projection.
+   * @param[out] batch The next rows produced by the projection
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +64,17 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The rows of the child that NextBatch projects */
+  TupleBatch child_batch_;
+
+  /** The program of each expression, or nullptr for those that have to be evaluated as expression trees */
+  std::vector<std::unique_ptr<CompiledExpression>> compiled_exprs_;
+
+  /**
+   * True if every expression is compiled and every output column is fixed-width, so that NextBatch writes the output
+   * tuples straight from the results of the programs
+   */
+  bool write_output_directly_{false};
 };
 }  // namespace bustub
@@ -12,11 +12,17 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
+#include "execution/page_predicate.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -30,8 +36,15 @@ class SeqScanExecutor : public AbstractExecutor {
    * Construct a new SeqScanExecutor instance.
    * @param exec_ctx The executor context
    * @param plan The sequential scan plan to be executed
+   * @param morsel The pages to scan, or nullptr to scan the whole table
    */
-  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, const Morsel *morsel = nullptr);
+
+  /** The number of pages in a morsel of a parallel scan. */
+  static constexpr size_t MORSEL_PAGES = 16;
+
+  /** @return the table of the plan cut into morsels of MORSEL_PAGES pages, in scan order */
+  static auto MakeMorsels(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) -> std::vector<Morsel>;
 
   /** Initialize the sequential scan */
   void Init() override;
@@ -44,11 +57,44 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next rows from the sequential scan.
+   * @param[out] batch The next rows produced by the sequential scan
+   * @return `true` if any row was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** @return true if the scan has passed its last page */
+  auto IsExhausted() -> bool;
+
+  /** Next for a filter that runs on the pages: read pages until one of them has a tuple that passes it. */
+  auto NextFromPages(Tuple *tuple) -> bool;
+
+  /** NextBatch for a filter that runs on the pages: copy out only the tuples that pass it. */
+  auto NextBatchFromPages(TupleBatch *batch) -> bool;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  TableHeap *table_heap_{nullptr};
+  /** The position of the scan, or nullptr for a page-filtered scan, which tracks page_id_ instead */
+  std::unique_ptr<TableIterator> iter_;
+  /** The first page of the scan, or INVALID_PAGE_ID for the first page of the table */
+  page_id_t begin_page_id_{INVALID_PAGE_ID};
+  /** The page the scan stops at, or INVALID_PAGE_ID to scan to the end of the table */
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  /** The filter predicate as a program, or nullptr if there is none or it has to be evaluated as an expression tree */
+  std::unique_ptr<CompiledExpression> compiled_predicate_;
+  /** The filter predicate as a page filter, or nullptr if it has to be evaluated on the tuples */
+  std::unique_ptr<PagePredicate> page_predicate_;
+  /** The next page a page-filtered scan reads */
+  page_id_t page_id_{INVALID_PAGE_ID};
+  /** The tuples of the last page read that passed the page filter and are not in a batch yet, from page_tuple_idx_ */
+  std::vector<Tuple> page_tuples_;
+  size_t page_tuple_idx_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel.h
+//
+// Identification: src/include/execution/morsel.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A slice of the input of a scan. A parallel query runs its pipeline once per morsel, each time with the scan at the
+ * bottom of the pipeline restricted to the morsel.
+ */
+struct Morsel {
+  /** SeqScan: the first page of the slice */
+  page_id_t begin_page_id_{INVALID_PAGE_ID};
+  /** SeqScan: the page after the slice, or INVALID_PAGE_ID if the slice runs to the end of the table */
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  /** MockScan: the first row of the slice */
+  size_t begin_row_{0};
+  /** MockScan: the row after the slice */
+  size_t end_row_{0};
+};
+
+}  // namespace bustub
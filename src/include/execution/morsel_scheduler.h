@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scheduler.h
+//
+// Identification: src/include/execution/morsel_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MorselScheduler runs a task once for each morsel of a parallel query, on worker threads of its own.
+ *
+ * Morsel i starts out in the queue of worker i % num_workers, so the workers move through the input together and the
+ * morsels finish roughly in order. A worker takes its morsels from the front of its own queue; once that is empty, it
+ * steals from the back of another worker's queue, so a worker that got slow morsels does not hold up the query.
+ */
+class MorselScheduler {
+ public:
+  /** The work for one morsel. It runs on a worker thread and must not throw. */
+  using Task = std::function<void(size_t morsel)>;
+
+  /**
+   * Start running the morsels.
+   * @param num_workers the number of worker threads, at least 1
+   * @param num_morsels the number of morsels, numbered 0 to num_morsels - 1
+   * @param task the work for one morsel
+   */
+  MorselScheduler(size_t num_workers, size_t num_morsels, Task task);
+
+  /** Cancel the morsels that have not started and wait for the workers. */
+  ~MorselScheduler();
+
+  DISALLOW_COPY_AND_MOVE(MorselScheduler);
+
+  /** Do not start any more morsels. Morsels that are running finish. */
+  void Cancel() { cancelled_ = true; }
+
+  /** Wait until every morsel has run, or the workers stopped after Cancel(). */
+  void Wait();
+
+ private:
+  /** The morsels waiting for one worker. */
+  struct WorkQueue {
+    std::mutex latch_;
+    std::deque<size_t> morsels_;
+  };
+
+  /** Run morsels until none are left, or the scheduler is cancelled. */
+  void RunWorker(size_t worker);
+
+  /** Take the next morsel of the worker: its own first, stolen ones after that. */
+  auto TakeMorsel(size_t worker, size_t *morsel) -> bool;
+
+  Task task_;
+  std::atomic<bool> cancelled_{false};
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_predicate.h
+//
+// Identification: src/include/execution/page_predicate.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+/**
+ * PagePredicate is a scan filter that runs on a TablePage before any tuple is copied out of it. It picks the live
+ * tuples of the page into a selection vector of slots, and then every term of the filter narrows the selection down,
+ * reading its column straight from the tuple bytes in the page. The kernels compare eight rows at a time with AVX2
+ * where the CPU has it.
+ *
+ * Compile() takes a comparison between an INTEGER or BIGINT column of the scanned table and an integer constant, or
+ * an AND of such comparisons. A null column value never satisfies a term, as a null comparison is never true.
+ *
+ * The selection scratch space lives in the PagePredicate, so it is not thread-safe: every executor compiles its own.
+ */
+class PagePredicate {
+ public:
+  /**
+   * @param expr the filter to compile
+   * @param schema the schema of the table the filter runs on
+   * @return the page filter of expr, or nullptr if expr is anything else than a conjunction of comparisons between a
+   * column and a constant that fits the column
+   */
+  static auto Compile(const AbstractExpression &expr, const Schema &schema) -> std::unique_ptr<PagePredicate>;
+
+  /**
+   * Pick the tuples of page that satisfy the filter.
+   * @param page a page of the table, read latched
+   * @param[out] slots the slots of the tuples picked, in slot order
+   */
+  void Select(TablePage *page, std::vector<uint32_t> *slots);
+
+  /** @return true if the kernels compare rows with AVX2 on this CPU */
+  static auto IsVectorized() -> bool;
+
+  /** One comparison of the conjunction. */
+  struct Term;
+
+  /**
+   * Narrows a selection down to the rows that satisfy a term.
+   * @param data the page data
+   * @param term the comparison
+   * @param slots the slots of the selection, compacted in place
+   * @param offsets the offset of each tuple of the selection in the page, compacted in place along with slots
+   * @param count the number of rows in the selection
+   * @return the number of rows left
+   */
+  using Kernel = auto (*)(const char *data, const Term &term, uint32_t *slots, uint32_t *offsets, size_t count)
+      -> size_t;
+
+  struct Term {
+    Kernel kernel_;
+    /** The offset of the column in the tuple */
+    uint32_t offset_;
+    /** The constant, in the type of the column */
+    int64_t constant_;
+  };
+
+ private:
+  PagePredicate() = default;
+
+  /** Append the terms of expr. @return false if expr cannot be compiled */
+  auto AddTerms(const AbstractExpression &expr, const Schema &schema) -> bool;
+
+  std::vector<Term> terms_;
+  /** The offsets of the tuples of the current selection */
+  std::vector<uint32_t> offsets_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -92,6 +93,12 @@ class AbstractPlanNode {
     return fmt::format("{}{}", PlanNodeToString(), ChildrenToString(2, with_schema));
   }
 
+  /**
+   * @param annotate the text to add to the line of each plan node
+   * @return the plan node and its children without their schemas, each followed by its annotation
+   */
+  auto ToAnnotatedString(const std::function<std::string(const AbstractPlanNode &)> &annotate) const -> std::string;
+
   /** @return the cloned plan node with new children */
   virtual auto CloneWithChildren(std::vector<AbstractPlanNodeRef> children) const
       -> std::unique_ptr<AbstractPlanNode> = 0;
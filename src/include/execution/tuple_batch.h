@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The rows that one call of AbstractExecutor::NextBatch produces: up to Capacity() tuples, each next to its RID.
+ * Executors move tuples in and out of a batch rather than copying them.
+ */
+class TupleBatch {
+ public:
+  /** The number of rows a batch holds unless told otherwise. */
+  static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+  explicit TupleBatch(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {
+    tuples_.reserve(capacity);
+    rids_.reserve(capacity);
+  }
+
+  auto Size() const -> size_t { return tuples_.size(); }
+  auto Capacity() const -> size_t { return capacity_; }
+  auto IsEmpty() const -> bool { return tuples_.empty(); }
+  auto IsFull() const -> bool { return tuples_.size() >= capacity_; }
+
+  void Clear() {
+    tuples_.clear();
+    rids_.clear();
+  }
+
+  void Append(Tuple &&tuple, RID rid) {
+    tuples_.push_back(std::move(tuple));
+    rids_.push_back(rid);
+  }
+
+  auto TupleAt(size_t index) -> Tuple & { return tuples_[index]; }
+  auto TupleAt(size_t index) const -> const Tuple & { return tuples_[index]; }
+  auto RidAt(size_t index) const -> RID { return rids_[index]; }
+
+  /** Keep the rows for which keep(index) is true, in their order. */
+  template <typename KeepFunc>
+  void Retain(KeepFunc keep) {
+    size_t kept = 0;
+    for (size_t i = 0; i < tuples_.size(); i++) {
+      if (!keep(i)) {
+        continue;
+      }
+      if (kept != i) {
+        tuples_[kept] = std::move(tuples_[i]);
+        rids_[kept] = rids_[i];
+      }
+      kept++;
+    }
+    tuples_.resize(kept);
+    rids_.resize(kept);
+  }
+
+  /** Move the tuples of the batch to the end of out. */
+  void MoveTuplesTo(std::vector<Tuple> *out) {
+    for (auto &tuple : tuples_) {
+      out->push_back(std::move(tuple));
+    }
+    Clear();
+  }
+
+ private:
+  size_t capacity_;
+  std::vector<Tuple> tuples_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.h
+//
+// Identification: src/include/storage/disk/async_disk_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** The I/O engines an AsyncDiskManager can run on. */
+enum class AsyncIoBackend { Auto, IoUring, ThreadPool };
+
+/**
+ * AsyncDiskManager reads and writes the pages of the database file with many I/Os in flight at once. Requests are
+ * queued, handed to the kernel in batches and reaped in batches. It runs on io_uring when the kernel supports it, and
+ * on a pool of threads doing pread/pwrite otherwise.
+ *
+ * The synchronous ReadPage and WritePage go through the same queue and wait for their I/O. Buffer pool instances that
+ * call them concurrently therefore overlap their I/O instead of queueing up behind a single file latch.
+ *
+ * With direct I/O the file is opened with O_DIRECT, so pages bypass the kernel page cache instead of being cached
+ * twice, and I/O latency no longer depends on writeback of the cache. Direct I/O needs page-aligned buffers; buffer
+ * pool frames are, and other buffers are copied through an aligned bounce buffer. The file grows by
+ * DB_FILE_EXTENT_PAGES at a time with fallocate, so writes past the end do not allocate blocks one page at a time.
+ */
+class AsyncDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that reads and writes the specified database file.
+   * @param db_file the file name of the database file
+   * @param queue_depth the maximum number of page I/Os in flight
+   * @param backend the engine to run on; Auto and IoUring fall back to ThreadPool if io_uring is not available
+   * @param direct_io true to bypass the page cache; falls back to buffered I/O if the file system does not support it
+   */
+  explicit AsyncDiskManager(const std::string &db_file, size_t queue_depth = ASYNC_IO_QUEUE_DEPTH,
+                            AsyncIoBackend backend = AsyncIoBackend::Auto, bool direct_io = false);
+
+  /** Waits for the I/Os in flight, then stops the engine and closes the file. */
+  ~AsyncDiskManager() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  auto WritePageAsync(page_id_t page_id, const char *page_data, disk_callback_fn callback)
+      -> std::future<bool> override;
+
+  auto ReadPageAsync(page_id_t page_id, char *page_data, disk_callback_fn callback) -> std::future<bool> override;
+
+  /** @return the engine in use, never Auto; ThreadPool once io_uring has failed */
+  auto GetBackend() const -> AsyncIoBackend;
+
+  /** @return true if the file was opened for direct I/O */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
+  /** An engine that executes queued page I/Os. Defined in the implementation file. */
+  class Engine;
+
+ private:
+  /** Preallocate the extents up to and including page_id, if a write to it would grow the file. */
+  void EnsureAllocated(page_id_t page_id);
+
+  /** Compact cut off the end of the file, preallocated extents included: take the size of the file again. */
+  void FileTruncated() override;
+
+  /** Queue a read; with verify, a page that fails its checksum completes as a failed read. */
+  auto SubmitRead(page_id_t page_id, char *page_data, disk_callback_fn callback, bool verify) -> std::future<bool>;
+
+  /** File descriptor of the database file, used by the engine instead of the stream. */
+  int fd_;
+  bool direct_io_{false};
+  std::unique_ptr<Engine> engine_;
+  /** Bytes of the file that are allocated. Changes under extent_latch_; only Compact makes it shrink. */
+  std::atomic<off_t> allocated_size_{0};
+  /** False once fallocate turned out to be unsupported; writes then grow the file by themselves. */
+  bool preallocate_{true};
+  std::mutex extent_latch_;
+};
+
+}  // namespace bustub
@@ -13,18 +13,37 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>  // NOLINT
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <set>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
 namespace bustub {
 
+/** Called with the outcome of an asynchronous page I/O once it completes: true if it succeeded. */
+using disk_callback_fn = std::function<void(bool)>;
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * A database file created while enable_page_checksums is set keeps a CRC32C of every page in a checksum file next to
+ * it. Page layouts leave no room for a checksum, so it lives outside the page. Each write records the checksum of the
+ * new contents before the page goes to disk, and each read verifies it, which catches torn writes and pages corrupted
+ * on the device. The checksum of the previous contents is kept too and also accepted. A crash can fall between
+ * recording the checksum and writing the page, and the page on disk is then still intact.
+ *
+ * The checksum file is synced before the page write it covers is issued, so after a crash it never lags behind the
+ * db file. Before a checksum is dropped from the pair, the db file is synced so that the page on disk can no longer be
+ * the version it describes. A page on disk therefore always matches one of its two checksums unless it was torn or
+ * damaged, clean shutdown or not. The price is a sync of the checksum file for every write that changes a page, and a
+ * sync of the db file when a page is written again before its last write was synced.
  */
 class DiskManager {
  public:
@@ -37,13 +56,46 @@ class DiskManager {
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Shut down the disk manager and close all the file resources. The free space map is written back and marked clean.
    */
   void ShutDown();
 
+  /**
+   * Allocate a page. The lowest free page whose id maps to the given buffer pool instance is reused; if there is none,
+   * the instance gets its next page id past the end of the database.
+   * @param num_instances number of instances in the parallel buffer pool, or 1
+   * @param instance_index the instance the page id must map to, i.e. page_id % num_instances == instance_index
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(uint32_t num_instances, uint32_t instance_index) -> page_id_t;
+
+  /**
+   * Return a page to the free space map, so that AllocatePage can hand it out again. Pages that are already free or
+   * were never allocated are ignored.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page has been allocated and not freed since */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /** @return one past the largest page id that has been allocated */
+  auto GetNumPages() -> page_id_t;
+
+  /** @return the number of free pages below GetNumPages() */
+  auto GetNumFreePages() -> size_t;
+
+  /**
+   * Shrink the database file. Free pages at the end are cut off, and the disk blocks of the other free pages are given
+   * back to the file system. Table heaps and indexes refer to pages by id, so pages in use are never moved. Only call
+   * this while no buffer pool uses the disk manager.
+   * @return the number of free pages that no longer take up space in the file system
+   */
+  auto Compact() -> size_t;
+
   /**
    * Write a page to the database file.
    * @param page_id id of the page
@@ -55,9 +107,33 @@ class DiskManager {
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
+   * @throws Exception if the page fails its checksum
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Start writing a page to the database file. The page data must stay valid and unchanged until the I/O completes.
+   * This implementation writes synchronously; disk managers that can overlap I/Os override it.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   * @param callback called on completion, before the future becomes ready, possibly from another thread; may be
+   * nullptr
+   * @return a future that tells whether the write succeeded
+   */
+  virtual auto WritePageAsync(page_id_t page_id, const char *page_data, disk_callback_fn callback)
+      -> std::future<bool>;
+
+  /**
+   * Start reading a page from the database file. The buffer must stay valid until the I/O completes.
+   * This implementation reads synchronously; disk managers that can overlap I/Os override it.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   * @param callback called on completion, before the future becomes ready, possibly from another thread; may be
+   * nullptr
+   * @return a future that tells whether the read succeeded; a page that fails its checksum is a failed read
+   */
+  virtual auto ReadPageAsync(page_id_t page_id, char *page_data, disk_callback_fn callback) -> std::future<bool>;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +159,12 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return true if the pages of this database file carry checksums */
+  auto HasChecksums() const -> bool { return crc_fd_ >= 0; }
+
+  /** @return the number of page reads that failed their checksum */
+  auto GetNumChecksumFailures() const -> uint64_t { return checksum_failures_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -94,6 +176,45 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
+
+  /** Read the free space map of a database file that already existed, and mark it unclean until ShutDown. */
+  void LoadFreeSpaceMap(bool db_existed);
+  /** Persist how many page ids may be in use, reserving a whole extent of them ahead. */
+  void ReserveFreeSpaceMapPages();
+  /** Write back the free space map and mark it clean. */
+  void SaveFreeSpaceMap();
+  /** @return true if the page is allocated. Caller holds free_space_latch_. */
+  auto PageInUse(page_id_t page_id) const -> bool;
+  /** @return the index of the set of free_pages_ that page_id goes in. Caller holds free_space_latch_. */
+  auto FreeSetOf(page_id_t page_id) const -> size_t;
+  /** Add a page to the free pages. Caller holds free_space_latch_. */
+  void AddFreePage(page_id_t page_id);
+  /** Free the page ids the instance cursors never reached, and restart the cursors at the end for num_instances. */
+  void ResetCursors(uint32_t num_instances);
+  /** Called by Compact after it truncated the database file, with db_io_latch_ and free_space_latch_ held. */
+  virtual void FileTruncated() {}
+
+  /** Open the checksum file of a database file that already existed, or create one for a new file if enabled. */
+  void LoadChecksums(bool db_existed);
+  /**
+   * Record the checksum of the contents a page is about to be written with, and make it durable. Every call must be
+   * followed by PageWritten once the write is done, whether it succeeded or not.
+   */
+  void RecordChecksum(page_id_t page_id, const char *page_data);
+  /** Note that a page write whose checksum was recorded is done. */
+  void PageWritten(page_id_t page_id);
+  /** Sync the db file, so that the pages whose writes are done are their current versions on disk. Caller holds the
+   * checksum latch. */
+  void SyncWrittenPages();
+  /** Forget the checksums of a page whose contents no longer matter. */
+  void ForgetChecksum(page_id_t page_id);
+  /** Write the checksums of a page at slot to the checksum file. Caller holds checksum_latch_. */
+  void WriteChecksums(size_t slot);
+  /** @return true if the page matches one of its recorded checksums, or has none; counts and logs a mismatch */
+  auto VerifyChecksum(page_id_t page_id, const char *page_data) -> bool;
+  /** @throws Exception if the page fails its checksum */
+  void VerifyPage(page_id_t page_id, const char *page_data);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -106,6 +227,42 @@ class DiskManager {
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+
+  // stream to write the free space map, a bitmap of the free pages kept next to the db file
+  std::fstream fsm_io_;
+  std::string fsm_name_;
+  // protects everything below
+  std::mutex free_space_latch_;
+  // free pages below num_pages_, one set for each buffer pool instance they map to, lowest first; a single set until
+  // the first allocation tells the number of instances
+  std::vector<std::set<page_id_t>> free_pages_ = std::vector<std::set<page_id_t>>(1);
+  size_t num_free_pages_{0};
+  // one past the largest page id that has been handed out
+  page_id_t num_pages_{0};
+  // the number of pages the free space map file claims, which is at least num_pages_
+  page_id_t reserved_pages_{0};
+  // the next fresh page id of each buffer pool instance; ids below num_pages_ that a cursor has not reached are unused
+  std::vector<page_id_t> next_page_ids_;
+  uint32_t cursor_instances_{0};
+
+  // the checksum file: the current and the previous CRC32C of each page, 0 for none; -1 if the pages have no checksums
+  int crc_fd_{-1};
+  std::string crc_name_;
+  // the db file, opened to sync it when checksums are dropped; -1 if the pages have no checksums
+  int db_sync_fd_{-1};
+  // protects checksums_ and everything below it
+  std::mutex checksum_latch_;
+  // two entries per page, like the checksum file
+  std::vector<uint32_t> checksums_;
+  // one entry per page: true while the page on disk may still be the version its previous checksum describes
+  std::vector<bool> unsynced_;
+  // one entry per page: the writes of the page that were recorded but are not done yet
+  std::vector<uint32_t> pending_writes_;
+  // the pages whose writes were done since the db file was last synced
+  std::vector<page_id_t> written_pages_;
+  // signalled whenever a page write is done
+  std::condition_variable write_done_;
+  std::atomic<uint64_t> checksum_failures_{0};
 };
 
 }  // namespace bustub
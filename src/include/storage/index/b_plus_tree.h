@@ -10,12 +10,16 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/page_reclaimer.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -32,6 +36,17 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency uses optimistic lock coupling. Every page has a version that its write latch bumps. Readers take no
+ * latches: they remember a page's version, read the page, and check the version again before trusting what they
+ * read, including the page id of the child they descend to. Writers descend the same way and take the write latch
+ * only on the pages they change, and only if those pages still have the version they read. Any failed check starts
+ * the operation over from the root. An operation that finds no free frame in the buffer pool for a page it needs
+ * gives up instead of starting over, as nothing it could wait for would free one.
+ *
+ * To keep every change local to a leaf and its parent, inserts split full internal pages and removes refill or merge
+ * internal pages at their minimum size on the way down, before they reach the leaf. Pages that a merge or a root
+ * change unlinks go to a PageReclaimer, which deletes them once no operation can still be reading them.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -45,19 +60,29 @@ class BPlusTree {
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
-  // Insert a key-value pair into this B+ tree.
+  // Insert a key-value pair into this B+ tree. Returns false if the key exists or the buffer pool has no frame to
+  // spare.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and its value from this B+ tree. Does nothing if the buffer pool has no frame to spare.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // return the value associated with a given key; false if it is not there, or the buffer pool has no frame to spare
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  // Look up a batch of keys; (*results)[i] gets the value of keys[i] appended. @return the number of keys found
+  // A batch the buffer pool has too few frames for is split up; the keys left once a single one finds no frame are not
+  // looked up.
+  auto GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr) -> size_t;
+
+  // Build an empty B+ tree bottom-up from key-value pairs; sorts them first unless they already are.
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction = nullptr) -> bool;
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
-  // index iterator
+  // index iterator; an iterator that cannot pin the leaf it needs is at the end
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
@@ -68,13 +93,131 @@ class BPlusTree {
   // draw the B+ tree
   void Draw(BufferPoolManager *bpm, const std::string &outf);
 
-  // read data from file and insert one by one
+  // read data from file and bulk load it, or insert it one by one if the tree is not empty
   void InsertFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
+  /**
+   * A pinned tree page. The page is read optimistically against the version it had when it was pinned, until Upgrade
+   * or Latch takes its write latch. Unlatches and unpins the page when it goes away.
+   */
+  class NodeHandle {
+   public:
+    NodeHandle() = default;
+    // Take over a pin and remember the current version of the page.
+    NodeHandle(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page), version_(page->GetVersion()) {}
+    // Take over a pin together with a version read earlier.
+    NodeHandle(BufferPoolManager *bpm, Page *page, uint64_t version) : bpm_(bpm), page_(page), version_(version) {}
+    NodeHandle(NodeHandle &&other) noexcept
+        : bpm_(other.bpm_),
+          page_(std::exchange(other.page_, nullptr)),
+          version_(other.version_),
+          latched_(std::exchange(other.latched_, false)) {}
+    auto operator=(NodeHandle &&other) noexcept -> NodeHandle & {
+      if (this != &other) {
+        Release();
+        bpm_ = other.bpm_;
+        page_ = std::exchange(other.page_, nullptr);
+        version_ = other.version_;
+        latched_ = std::exchange(other.latched_, false);
+      }
+      return *this;
+    }
+    DISALLOW_COPY(NodeHandle);
+    ~NodeHandle() { Release(); }
+
+    auto Valid() const -> bool { return page_ != nullptr; }
+    auto PageId() const -> page_id_t { return page_->GetPageId(); }
+    auto Version() const -> uint64_t { return version_; }
+    template <typename T>
+    auto As() const -> T * {
+      return reinterpret_cast<T *>(page_->GetData());
+    }
+
+    // @return true if everything read from the page so far is consistent
+    auto Validate() const -> bool { return latched_ || page_->ValidateVersion(version_); }
+    // @return true if the write latch is now held; false if the page changed since it was pinned
+    auto Upgrade() -> bool { return latched_ || (latched_ = page_->TryUpgradeLatch(version_)); }
+    void Latch() {
+      page_->WLatch();
+      latched_ = true;
+    }
+    // Hand the pin over to the caller.
+    auto Detach() -> Page * { return std::exchange(page_, nullptr); }
+
+   private:
+    void Release() {
+      if (page_ == nullptr) {
+        return;
+      }
+      page_id_t page_id = page_->GetPageId();
+      if (latched_) {
+        page_->WUnlatch();
+      }
+      bpm_->UnpinPage(page_id, latched_);
+      page_ = nullptr;
+      latched_ = false;
+    }
+
+    BufferPoolManager *bpm_{nullptr};
+    Page *page_{nullptr};
+    uint64_t version_{0};
+    bool latched_{false};
+  };
+
+  /**
+   * How a step of an operation went. RETRY: a version check failed, and the operation starts over from the root.
+   * NO_FRAME: the buffer pool had no frame for a page the step needed, and the operation gives up.
+   */
+  enum class Step { DONE, RETRY, NO_FRAME };
+
+  // One attempt of an operation. The results are only set when the attempt is DONE.
+  auto TryGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found) -> Step;
+  // batch holds indexes into keys, in key order. Removes the probes it finishes, adding to found.
+  auto TryGetValues(const std::vector<KeyType> &keys, std::vector<size_t> *batch,
+                    std::vector<std::vector<ValueType>> *results, size_t *found) -> Step;
+  // split_hint carries over between attempts: a page that has to split before a child of it can, because the
+  // separator the child needs does not fit.
+  auto TryInsert(const KeyType &key, const ValueType &value, page_id_t *split_hint, bool *inserted) -> Step;
+  auto TryRemove(const KeyType &key) -> Step;
+
+  // Descent helpers.
+  auto FetchRoot(NodeHandle *root) -> Step;
+  auto FetchChild(const NodeHandle &parent, page_id_t child_id, NodeHandle *child) -> Step;
+  auto FetchLatched(page_id_t page_id, NodeHandle *node) -> Step;
+  // Find the leaf that covers key, or the leftmost leaf if key is nullptr; leaf stays invalid if the tree is empty.
+  // following, if given, receives up to read_ahead_pages page ids of the leaves after it under the same parent.
+  auto FindLeaf(const KeyType *key, NodeHandle *leaf, std::vector<page_id_t> *following) -> Step;
+
+  // Structure changes. Each one either completes or changes nothing; anything but DONE ends the attempt.
+  auto StartNewTree(const KeyType &key, const ValueType &value) -> Step;
+  auto SplitInternal(NodeHandle *parent, NodeHandle *node, int index_in_parent, const KeyType &key,
+                     page_id_t *split_hint) -> Step;
+  auto SplitLeaf(NodeHandle *parent, NodeHandle *node, int index_in_parent, int index, const KeyType &key,
+                 const ValueType &value, page_id_t *split_hint) -> Step;
+  auto RebalanceInternal(NodeHandle *parent, NodeHandle *node, int index_in_parent) -> Step;
+  auto RebalanceLeaf(NodeHandle *parent, NodeHandle *node, int index_in_parent, int index) -> Step;
+  void CollapseRoot(NodeHandle *root);
+
+  // Bulk load helpers. level holds the first key and the page id of every page on the level built last.
+  auto BuildLeaves(const std::vector<std::pair<KeyType, ValueType>> &entries, int fill_percent,
+                   std::vector<std::pair<KeyType, page_id_t>> *level, std::vector<page_id_t> *built) -> bool;
+  auto BuildInternalLevel(std::vector<std::pair<KeyType, page_id_t>> *level, int fill_percent,
+                          std::vector<page_id_t> *built) -> bool;
+  void SetRootPageId(page_id_t root_page_id);
+  void DiscardPage(page_id_t page_id);
+
+  // Iterator support. Seek positions an iterator at the first key >= key, or > key if after is set.
+  void Seek(INDEXITERATOR_TYPE *iterator, const KeyType *key, bool after);
+  void Advance(INDEXITERATOR_TYPE *iterator);
+  auto Settle(INDEXITERATOR_TYPE *iterator, NodeHandle leaf, int index) -> Step;
+  void ReadAhead(INDEXITERATOR_TYPE *iterator, const std::vector<page_id_t> &following);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -82,13 +225,21 @@ class BPlusTree {
 
   void ToString(BPlusTreePage *page, BufferPoolManager *bpm) const;
 
+  // GetValues descends with this many probes at a time. It pins up to twice as many pages at once, and halves the
+  // batch whenever the buffer pool runs out of frames for it.
+  static constexpr size_t GET_VALUES_BATCH = 16;
+
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // Changes while the old root is write-latched, or under root_latch_ when there was no root.
+  std::atomic<page_id_t> root_page_id_;
+  // Serializes root changes and their header page updates.
+  std::mutex root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  PageReclaimer reclaimer_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -35,6 +36,17 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  /**
+   * Add many entries at once. An empty index is bulk loaded from them; otherwise, or if the bulk load runs out of
+   * buffer pool frames, they are inserted one by one.
+   * @param entries the entries to add, in any order; sorted in place
+   * @param transaction The transaction context
+   */
+  void InsertEntries(std::vector<std::pair<KeyType, RID>> *entries, Transaction *transaction);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -48,8 +60,10 @@ class BPlusTreeIndex : public Index {
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
 
-/** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
-
+/**
+ * Indexes on a single INTEGER column. CREATE INDEX picks the key type from the key schema, so an index may use any
+ * GenericKey size up to 64 bytes, or VarcharKeyType if a key column is a VARCHAR.
+ */
 constexpr static const auto INTEGER_SIZE = 4;
 using IntegerKeyType = GenericKey<INTEGER_SIZE>;
 using IntegerValueType = RID;
@@ -59,4 +73,11 @@ using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Indexes with a VARCHAR column take keys of up to VARCHAR_KEY_SIZE bytes, stored at their actual length. */
+constexpr static const auto VARCHAR_KEY_SIZE = 512;
+using VarcharKeyType = VarlenKey<VARCHAR_KEY_SIZE>;
+using VarcharComparatorType = VarlenComparator<VARCHAR_KEY_SIZE>;
+using BPlusTreeIndexForOneVarcharColumn = BPlusTreeIndex<VarcharKeyType, RID, VarcharComparatorType>;
+using VarcharHashFunctionType = HashFunction<VarcharKeyType>;
+
 }  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -32,7 +34,8 @@ class GenericKey {
   inline void SetFromKey(const Tuple &tuple) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    // A longer key tuple, which can only have VARCHAR columns, is cut short; those belong in a VarlenKey.
+    memcpy(data_, tuple.GetData(), std::min<size_t>(tuple.GetLength(), KeySize));
   }
 
   // NOTE: for test purpose only
@@ -55,6 +58,9 @@ class GenericKey {
     return Value::DeserializeFrom(data_ptr, column_type);
   }
 
+  // the key of a single integer column of integer_size bytes
+  inline auto ToInteger(int integer_size) const -> int64_t { return DecodeIntegerKey(data_, integer_size); }
+
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
   inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
@@ -72,11 +78,20 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys of a single integer column are compared as integers, without going through Value. That orders a NULL key
+ * below every other key, where Value would find it equal to all of them.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    if (integer_size_ != 0) {
+      int64_t lhs_integer = lhs.ToInteger(integer_size_);
+      int64_t rhs_integer = rhs.ToInteger(integer_size_);
+      return lhs_integer < rhs_integer ? -1 : (lhs_integer > rhs_integer ? 1 : 0);
+    }
+
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +109,40 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  /**
+   * @return the size of the integer column that makes up the whole key, or 0 if the keys are anything else; B+ tree
+   * pages search such keys without building them (see PackedEntries::IntegerLowerBound)
+   */
+  inline auto IntegerKeySize() const -> int { return integer_size_; }
+
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, integer_size_{other.integer_size_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  // integer_keys: compare keys of a single integer column as integers; false compares them as Values, for testing and
+  // benchmarking
+  explicit GenericComparator(Schema *key_schema, bool integer_keys = true)
+      : key_schema_(key_schema), integer_size_(integer_keys ? IntegerSizeOf(key_schema) : 0) {}
 
  private:
+  static auto IntegerSizeOf(Schema *key_schema) -> int {
+    if (key_schema->GetColumnCount() != 1) {
+      return 0;
+    }
+    const auto &col = key_schema->GetColumn(0);
+    switch (col.GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        return col.GetOffset() == 0 && col.GetFixedLength() <= KeySize ? static_cast<int>(col.GetFixedLength()) : 0;
+      default:
+        return 0;
+    }
+  }
+
   Schema *key_schema_;
+  int integer_size_;
 };
 
 }  // namespace bustub
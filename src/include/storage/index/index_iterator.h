@@ -19,36 +19,51 @@ namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * The iterator keeps the leaf it is on pinned, but not latched, and reads it optimistically. If a writer changed the
+ * leaf in between, the iterator finds its place again from the root, at the first key after the one it returned
+ * last. The entry it returns is a copy and stays valid whatever happens to the tree.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator();
-  IndexIterator(const IndexIterator& iter);
+  // The end iterator.
+  IndexIterator() = default;
+  IndexIterator(const IndexIterator &other);
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(const IndexIterator &other) -> IndexIterator &;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
 
   ~IndexIterator();  // NOLINT
 
-
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool;
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
-  //BPlusTree* b_plus_tree;
-  BufferPoolManager *buffer_pool_manager_; 
-  MappingType* KeyValue;
-  //page_id_t CurrentPageId;
-  page_id_t NextPageId;
-  size_t CurrentIndex;
-  size_t MaxIndex;
+  friend class BPlusTree<KeyType, ValueType, KeyComparator>;
+
+  // Unpin the leaf and turn into the end iterator.
+  void Release();
 
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  // The pinned leaf, or nullptr at the end.
+  Page *page_{nullptr};
+  // The version of the leaf that item_ was read at.
+  uint64_t version_{0};
+  int index_{0};
+  MappingType item_;
+  // The last leaf that read-ahead asked for.
+  page_id_t read_ahead_end_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
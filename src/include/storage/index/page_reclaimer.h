@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_reclaimer.h
+//
+// Identification: src/include/storage/index/page_reclaimer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageReclaimer holds back DeletePage for B+ tree pages that a merge or a root change unlinked, until no operation
+ * that could still reach them is running. Optimistic readers pick up child page ids without holding latches, so a
+ * reader may fetch a page right after a writer unlinked it; if the page were deleted at once, its id could already
+ * belong to an unrelated page.
+ *
+ * Every tree operation runs inside a Guard. Guards enter the current epoch, and the epoch only advances once every
+ * guard of the epoch before it has left. A page retired in epoch e is therefore deleted once the epoch reaches e + 2.
+ * Pages still pinned at that point (by an index iterator parked on them) are retried later.
+ */
+class PageReclaimer {
+ public:
+  /** Marks an operation in progress. Leaving the scope ends the operation. */
+  class Guard {
+   public:
+    Guard(PageReclaimer *reclaimer, uint64_t epoch) : reclaimer_(reclaimer), epoch_(epoch) {}
+    Guard(Guard &&other) noexcept : reclaimer_(std::exchange(other.reclaimer_, nullptr)), epoch_(other.epoch_) {}
+    DISALLOW_COPY(Guard);
+    auto operator=(Guard &&other) -> Guard & = delete;
+    ~Guard() {
+      if (reclaimer_ != nullptr) {
+        reclaimer_->Exit(epoch_);
+      }
+    }
+
+   private:
+    PageReclaimer *reclaimer_;
+    uint64_t epoch_;
+  };
+
+  explicit PageReclaimer(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /**
+   * Does not delete pages that are still waiting: the tree may outlive its buffer pool. Pages left over from the last
+   * few operations stay allocated.
+   */
+  ~PageReclaimer() = default;
+
+  DISALLOW_COPY_AND_MOVE(PageReclaimer);
+
+  /** @return a guard for an operation that starts now */
+  auto Enter() -> Guard;
+
+  /**
+   * Delete a page once no running operation can reach it.
+   * @param page_id a page that the caller just unlinked from the tree
+   */
+  void Retire(page_id_t page_id);
+
+ private:
+  void Exit(uint64_t epoch);
+
+  /** Advance the epoch as far as the running guards allow and delete the pages that became unreachable. */
+  void TryReclaim();
+
+  BufferPoolManager *bpm_;
+  std::atomic<uint64_t> epoch_{0};
+  /** The number of guards in the even and in the odd epochs. At most two epochs have guards at a time. */
+  std::array<std::atomic<int64_t>, 2> active_{};
+  /** True while retired_ is not empty, so that leaving a guard is cheap when there is nothing to delete. */
+  std::atomic<bool> has_retired_{false};
+  /** Protects retired_ and serializes epoch advances. */
+  std::mutex latch_;
+  /** Pages waiting for deletion, with the epoch they were retired in. */
+  std::vector<std::pair<uint64_t, page_id_t>> retired_;
+};
+
+}  // namespace bustub
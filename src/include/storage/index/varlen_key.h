@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_key.h
+//
+// Identification: src/include/storage/index/varlen_key.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Key for indexes over VARCHAR columns. Like GenericKey it holds the key tuple, but it also records how long the
+ * tuple is, and B+ tree pages store only that many bytes of it (see SlottedEntries).
+ *
+ * MaxSize bounds the key tuple, fixed part and strings together. Longer keys are rejected rather than cut short,
+ * since a cut key could compare equal to a different one.
+ */
+template <size_t MaxSize>
+class VarlenKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple) {
+    if (tuple.GetLength() > MaxSize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key is longer than " + std::to_string(MaxSize) + " bytes");
+    }
+    size_ = tuple.GetLength();
+    memcpy(data_, tuple.GetData(), size_);
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    size_ = sizeof(int64_t);
+    memcpy(data_, &key, sizeof(int64_t));
+  }
+
+  /** @return the number of bytes at the start of this object that make up the key */
+  inline auto Length() const -> uint32_t { return sizeof(size_) + Size(); }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    const auto &col = schema->GetColumn(column_idx);
+    if (col.IsInlined()) {
+      return Value::DeserializeFrom(data_ + col.GetOffset(), col.GetType());
+    }
+    // Optimistic B+ tree readers compare keys copied off pages that may be changing underneath them, so the offset
+    // and the length are not trusted to stay inside the key.
+    uint32_t size = Size();
+    uint32_t offset;
+    memcpy(&offset, data_ + col.GetOffset(), sizeof(uint32_t));
+    uint32_t length = 0;
+    if (size >= sizeof(uint32_t) && offset <= size - sizeof(uint32_t)) {
+      memcpy(&length, data_ + offset, sizeof(uint32_t));
+      if (length == BUSTUB_VALUE_NULL) {
+        return {col.GetType(), nullptr, length, false};
+      }
+      if (length > 0 && length <= size - offset - sizeof(uint32_t)) {
+        return {col.GetType(), data_ + offset + sizeof(uint32_t), length, true};
+      }
+    }
+    return {col.GetType(), std::string()};
+  }
+
+  // NOTE: for test purpose only
+  // the key bytes, with anything unprintable replaced by '.'
+  friend auto operator<<(std::ostream &os, const VarlenKey &key) -> std::ostream & {
+    std::string printable(key.data_, key.Size());
+    std::replace_if(
+        printable.begin(), printable.end(), [](char c) { return std::isprint(static_cast<unsigned char>(c)) == 0; },
+        '.');
+    os << printable;
+    return os;
+  }
+
+  // the length of the key tuple, followed by the tuple itself
+  uint32_t size_;
+  char data_[MaxSize];
+
+ private:
+  inline auto Size() const -> uint32_t { return std::min<uint32_t>(size_, MaxSize); }
+};
+
+/**
+ * Function object returns true if lhs < rhs, used for trees
+ */
+template <size_t MaxSize>
+class VarlenComparator {
+ public:
+  inline auto operator()(const VarlenKey<MaxSize> &lhs, const VarlenKey<MaxSize> &rhs) const -> int {
+    uint32_t column_count = key_schema_->GetColumnCount();
+
+    for (uint32_t i = 0; i < column_count; i++) {
+      Value lhs_value = (lhs.ToValue(key_schema_, i));
+      Value rhs_value = (rhs.ToValue(key_schema_, i));
+
+      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+        return -1;
+      }
+      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+        return 1;
+      }
+    }
+    // equals
+    return 0;
+  }
+
+  VarlenComparator(const VarlenComparator &other) : key_schema_{other.key_schema_} {}
+
+  // constructor
+  explicit VarlenComparator(Schema *key_schema) : key_schema_(key_schema) {}
+
+ private:
+  Schema *key_schema_;
+};
+
+}  // namespace bustub
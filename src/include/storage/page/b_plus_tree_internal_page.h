@@ -10,27 +10,33 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <initializer_list>
 #include <queue>
+#include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/b_plus_tree_slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_ENTRIES PageEntries<KeyType, ValueType, BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE>
+#define INTERNAL_PAGE_SIZE (INTERNAL_PAGE_ENTRIES::MAX_ENTRIES)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
  * K(i) <= K < K(i+1).
  * NOTE: since the number of keys does not equal to number of child pointers,
  * the first key always remains invalid. That is to say, any search/lookup
- * should ignore the first key.
+ * should ignore the first key. It still holds a key from the subtree, usually
+ * the separator it was split off with, so that it compresses like the others.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * Internal page format (keys are stored in increasing order, compressed as described in
+ * PackedEntries, or in slots as described in SlottedEntries if their length varies):
+ *  ---------------------------------------------------------------------------------------------------
+ * | HEADER | WINDOW (4) | PREFIX | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ *  ---------------------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -39,12 +45,47 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
 
   auto KeyAt(int index) const -> KeyType;
+  // The caller checks HasRoomFor(key, 0) first.
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
-  //auto GetAyrray() const -> *MappingType;
+  void SetValueAt(int index, const ValueType &value);
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  /**
+   * @return the index of the child whose subtree covers key. Optimistic readers call this on pages that may change
+   * underneath them, so it never looks outside the page, whatever the size field says.
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // Room checks, as for leaf pages. Keys moved in by a merge or a borrow have to be among keys.
+  auto HasRoomFor(std::initializer_list<KeyType> keys, int new_entries = 1, int fill_percent = 100) const -> bool;
+  auto HasRoomForAllOf(const BPlusTreeInternalPage &other, const KeyType &middle_key) const -> bool;
+  auto CanSpareEntry() const -> bool;
+
+  // Make this page a new root with the two children of a split root.
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  // The caller checks HasRoomFor first.
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+
+  /**
+   * Split helpers, as for leaf pages. The key that separates the two halves ends up in the first slot of the right
+   * half, for the caller to push up into the parent.
+   */
+  auto GetItems() const -> std::vector<MappingType>;
+  void SetItems(const MappingType *items, int count);
+  static auto PickSplit(const std::vector<MappingType> &items, int preferred, int min_size) -> int;
+
+  /**
+   * Merge and borrow helpers. middle_key is the parent key that separates this page from the recipient; it comes
+   * down into the recipient with the first child of the right-hand page. After a borrow the right-hand page's first
+   * slot holds the key that replaces middle_key in the parent.
+   */
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];//std::pair<KeyType, ValueType>
- };
+  INTERNAL_PAGE_ENTRIES entries_;
+};
 }  // namespace bustub
@@ -10,26 +10,30 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <initializer_list>
 #include <utility>
 #include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/b_plus_tree_slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_ENTRIES PageEntries<KeyType, ValueType, BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE>
+#define LEAF_PAGE_SIZE (LEAF_PAGE_ENTRIES::MAX_ENTRIES)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Leaf page format (keys are stored in order, compressed as described in
+ * PackedEntries, or in slots as described in SlottedEntries if their length varies):
+ *  ---------------------------------------------------------------------------------
+ * | HEADER | WINDOW (4) | PREFIX | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ---------------------------------------------------------------------------------
  *
  *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
@@ -38,6 +42,8 @@ namespace bustub {
  *  -----------------------------------------------
  * | ParentPageId (4) | PageId (4) | NextPageId (4)
  *  -----------------------------------------------
+ *
+ * MaxSize caps the number of entries, but a page usually runs out of bytes first. The default cap is never reached.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -49,10 +55,46 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto GetItem(int index) const -> MappingType;
+
+  /**
+   * @return the index of the first key that is >= key, or the size if there is none. Like the internal page lookup,
+   * this stays inside the page even if the size field is being changed underneath it.
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * Byte limits, on top of MaxSize. A new key can take up more room than the others if it does not share their
+   * prefix, so the checks take the keys involved.
+   * @return true if new_entries more entries, whose keys are among keys, fit into fill_percent of the page
+   */
+  auto HasRoomFor(std::initializer_list<KeyType> keys, int new_entries = 1, int fill_percent = 100) const -> bool;
+  // @return true if the page can take all the entries of other
+  auto HasRoomForAllOf(const BPlusTreeLeafPage &other) const -> bool;
+  // @return true if the page stays at its minimum size or half full in bytes after losing an entry
+  auto CanSpareEntry() const -> bool;
+
+  // The caller checks HasRoomFor first.
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+
+  /**
+   * Split helpers. The caller collects the entries, inserts the new one, lets PickSplit choose where to cut (see
+   * PickSplitIndex) and hands each half to a page with SetItems.
+   */
+  auto GetItems() const -> std::vector<MappingType>;
+  void SetItems(const MappingType *items, int count);
+  static auto PickSplit(const std::vector<MappingType> &items, int preferred, int min_size) -> int;
+
+  // Merge and borrow helpers, after the room checks. The caller fixes the parent keys.
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  LEAF_PAGE_ENTRIES entries_;
 };
 }  // namespace bustub
@@ -0,0 +1,349 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_packed_entries.h
+//
+// Identification: src/include/storage/page/b_plus_tree_packed_entries.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+namespace bustub {
+
+/**
+ * The bytes of a set of keys that actually need storing. Every key in the set has the same bytes in front of Begin(),
+ * the prefix, and only zero bytes from End() on, which is where fixed-size keys keep their padding. A page stores the
+ * prefix once and only bytes [Begin(), End()) of each key.
+ *
+ * Keys are treated as plain bytes here; their order is the comparator's business and plays no part.
+ */
+template <typename KeyType>
+class KeyWindow {
+  static_assert(std::is_trivially_copyable_v<KeyType>, "keys are stored as raw bytes");
+
+ public:
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+
+  /** The window of an empty set. */
+  KeyWindow() = default;
+
+  /** The window of a non-empty page that stores prefix and bytes [begin, end) of its keys. */
+  KeyWindow(const char *prefix, int begin, int end) : common_(begin), end_(end), empty_(false) {
+    std::memset(Bytes(&reference_), 0, KEY_SIZE);
+    std::memcpy(Bytes(&reference_), prefix, begin);
+  }
+
+  /** @return the number of bytes that key takes up without its trailing zero bytes */
+  static auto TrimmedSize(const KeyType &key) -> int {
+    const char *bytes = Bytes(&key);
+    int size = KEY_SIZE;
+    while (size > 0 && bytes[size - 1] == 0) {
+      size--;
+    }
+    return size;
+  }
+
+  void Add(const KeyType &key) {
+    const char *bytes = Bytes(&key);
+    if (empty_) {
+      reference_ = key;
+      common_ = KEY_SIZE;
+      empty_ = false;
+    } else {
+      const char *reference = Bytes(&reference_);
+      int common = 0;
+      while (common < common_ && reference[common] == bytes[common]) {
+        common++;
+      }
+      common_ = common;
+    }
+    end_ = std::max(end_, TrimmedSize(key));
+  }
+
+  auto Begin() const -> int { return std::min(common_, end_); }
+  auto End() const -> int { return end_; }
+  auto Width() const -> int { return end_ - Begin(); }
+  /** The first Begin() bytes are the prefix. */
+  auto Prefix() const -> const char * { return Bytes(&reference_); }
+
+ private:
+  static auto Bytes(KeyType *key) -> char * { return reinterpret_cast<char *>(key); }
+  static auto Bytes(const KeyType *key) -> const char * { return reinterpret_cast<const char *>(key); }
+
+  KeyType reference_;
+  // The length of the prefix all keys share; the window may start earlier if the keys are shorter than that.
+  int common_{0};
+  int end_{0};
+  bool empty_{true};
+};
+
+/**
+ * Pick the index at which to split size sorted entries into two pages. Candidates lie within an eighth of the entries
+ * around preferred and leave at least min_size entries on either side, if such candidates exist. Both halves have to
+ * fit into a page, which fits(i) tells for a split at i; among the candidates that do, the one with the shortest key
+ * at i wins, since that key becomes the separator in the parent.
+ * @return the first index of the right half, or -1 if no split gives two halves that fit
+ */
+template <typename FitsFunc, typename KeySizeFunc>
+auto PickSplitIndex(int size, int preferred, int min_size, FitsFunc fits, KeySizeFunc key_size) -> int {
+  if (size < 2) {
+    return -1;
+  }
+  preferred = std::clamp(preferred, 1, size - 1);
+  int low = std::max(preferred - size / 8, 1);
+  int high = std::min(preferred + size / 8, size - 1);
+  if (std::max(low, min_size) <= std::min(high, size - min_size)) {
+    low = std::max(low, min_size);
+    high = std::min(high, size - min_size);
+  }
+  int best = -1;
+  int best_key_size = 0;
+  for (int i = low; i <= high; i++) {
+    int size_at_i = key_size(i);
+    bool closer = best == -1 || std::abs(i - preferred) < std::abs(best - preferred);
+    if (fits(i) && (best == -1 || size_at_i < best_key_size || (size_at_i == best_key_size && closer))) {
+      best = i;
+      best_key_size = size_at_i;
+    }
+  }
+  // Keys that compress very differently on the two sides may rule out every balanced split.
+  for (int i = 1; best == -1 && i < 2 * size; i++) {
+    int candidate = preferred + (i % 2 == 1 ? (i + 1) / 2 : -(i / 2));
+    if (candidate >= 1 && candidate < size && fits(candidate)) {
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+/**
+ * The sorted entries of a B+ tree page, with keys cut down to the KeyWindow of the page. Capacity is the number of
+ * bytes from the start of this object to the end of the page.
+ *
+ * Format (size in byte):
+ *  -------------------------------------------------------------------------------------------------------
+ * | WindowBegin (2) | WindowEnd (2) | Prefix (WindowBegin) | KEY(1)[Begin, End) + VALUE(1) | KEY(2)... |
+ *  -------------------------------------------------------------------------------------------------------
+ *
+ * All entries take the same number of bytes, so an entry is found by its index alone and a page of keys that do not
+ * compress is no bigger than one that holds them whole. An entry whose key widens the window repacks the page.
+ *
+ * Optimistic readers may read a page while it is being repacked, so every read is kept inside the page whatever the
+ * header says. Values are stored unaligned and copied in and out.
+ */
+template <typename KeyType, typename ValueType, int Capacity>
+class PackedEntries {
+ public:
+  using Item = std::pair<KeyType, ValueType>;
+  using Window = KeyWindow<KeyType>;
+
+  static constexpr int HEADER_SIZE = 4;
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  /** A bound on the entries of any page: only keys that take up no bytes at all could reach it. */
+  static constexpr int MAX_ENTRIES = (Capacity - HEADER_SIZE) / VALUE_SIZE;
+
+  /** @return the number of bytes that count entries with keys in window take up */
+  static auto BytesFor(const Window &window, int count) -> int {
+    return HEADER_SIZE + window.Begin() + count * (window.Width() + VALUE_SIZE);
+  }
+  /** @return true if count entries with keys in window fit into fill_percent of the page */
+  static auto Fits(const Window &window, int count, int fill_percent = 100) -> bool {
+    return BytesFor(window, count) * 100 <= Capacity * fill_percent;
+  }
+
+  /** @see PickSplitIndex */
+  static auto PickSplit(const std::vector<Item> &items, int preferred, int min_size) -> int {
+    int size = static_cast<int>(items.size());
+    // left[i] covers the keys before i, right[i] the keys from i on.
+    std::vector<Window> left(size + 1);
+    std::vector<Window> right(size + 1);
+    for (int i = 0; i < size; i++) {
+      left[i + 1] = left[i];
+      left[i + 1].Add(items[i].first);
+    }
+    for (int i = size - 1; i >= 0; i--) {
+      right[i] = right[i + 1];
+      right[i].Add(items[i].first);
+    }
+    return PickSplitIndex(
+        size, preferred, min_size, [&](int i) { return Fits(left[i], i) && Fits(right[i], size - i); },
+        [&](int i) { return Window::TrimmedSize(items[i].first); });
+  }
+
+  /** @return true if new_entries more entries, whose keys are among keys, fit into fill_percent of the page */
+  template <typename Keys>
+  auto HasRoomFor(int size, const Keys &keys, int new_entries, int fill_percent = 100) const -> bool {
+    Window window = GetWindow(size);
+    for (const KeyType &key : keys) {
+      window.Add(key);
+    }
+    return Fits(window, size + new_entries, fill_percent);
+  }
+
+  void Clear() {
+    begin_ = 0;
+    end_ = 0;
+  }
+
+  auto GetWindow(int size) const -> Window { return size == 0 ? Window() : Window(Data(), Begin(), End()); }
+  auto BytesUsed(int size) const -> int { return HEADER_SIZE + Begin() + ClampSize(size) * Stride(); }
+
+  /** @return size, cut down to the number of entries that fit into the page with the current window */
+  auto ClampSize(int size) const -> int {
+    return std::clamp(size, 0, (Capacity - HEADER_SIZE - Begin()) / Stride());
+  }
+
+  auto KeyAt(int index) const -> KeyType {
+    KeyType key;
+    char *bytes = reinterpret_cast<char *>(&key);
+    int begin = Begin();
+    int end = End();
+    std::memcpy(bytes, Data(), begin);
+    std::memcpy(bytes + begin, Entry(index), end - begin);
+    std::memset(bytes + end, 0, KEY_SIZE - end);
+    return key;
+  }
+
+  /**
+   * For keys that are a single integer column of integer_size bytes: binary search down to a block of entries, which
+   * KeySearch finishes without branching. The keys are decoded straight from the page rather than rebuilt.
+   * @return the first index in [begin, size) whose key is not below bound, or size if there is none
+   */
+  auto IntegerLowerBound(int begin, int size, int integer_size, int64_t bound) const -> int {
+    // The prefix and the layout are read once, and every index below stays under the clamped size. The window holds
+    // at most eight bytes of the key, few enough that a loop beats a call to memcpy.
+    int window_begin = std::min(Begin(), integer_size);
+    int window_end = std::clamp(End(), window_begin, integer_size);
+    char prefix[sizeof(int64_t)] = {};
+    std::memcpy(prefix, Data(), window_begin);
+    uint64_t prefix_bits = DecodeIntegerKey(prefix, sizeof(int64_t));
+    const auto *entries = reinterpret_cast<const uint8_t *>(Data() + Begin());
+    int stride = Stride();
+    int shift = 64 - 8 * integer_size;
+    auto key_at = [&](int index) {
+      const uint8_t *entry = entries + index * stride;
+      uint64_t bits = prefix_bits;
+      for (int i = window_begin; i < window_end; i++) {
+        bits |= static_cast<uint64_t>(entry[i - window_begin]) << (8 * i);
+      }
+      return static_cast<int64_t>(bits << shift) >> shift;
+    };
+
+    int low = std::max(begin, 0);
+    int high = std::max(ClampSize(size), low);
+    while (high - low > KeySearch::BLOCK_SIZE) {
+      int mid = low + (high - low) / 2;
+      if (key_at(mid) < bound) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    int64_t block[KeySearch::BLOCK_SIZE];
+    for (int i = 0; i < KeySearch::BLOCK_SIZE; i++) {
+      block[i] = low + i < high ? key_at(low + i) : INT64_MAX;
+    }
+    return low + KeySearch::CountBelow(block, bound);
+  }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value;
+    std::memcpy(reinterpret_cast<char *>(&value), Entry(index) + (End() - Begin()), VALUE_SIZE);
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) {
+    std::memcpy(Entry(index) + (End() - Begin()), reinterpret_cast<const char *>(&value), VALUE_SIZE);
+  }
+
+  /** The caller makes sure there is room. */
+  void SetKeyAt(int size, int index, const KeyType &key) {
+    Widen(size, key);
+    std::memcpy(Entry(index), reinterpret_cast<const char *>(&key) + Begin(), End() - Begin());
+  }
+
+  /** The caller makes sure there is room. */
+  void InsertAt(int size, int index, const KeyType &key, const ValueType &value) {
+    Widen(size, key);
+    char *entry = Entry(index);
+    std::memmove(entry + Stride(), entry, (size - index) * Stride());
+    std::memcpy(entry, reinterpret_cast<const char *>(&key) + Begin(), End() - Begin());
+    SetValueAt(index, value);
+  }
+
+  void RemoveAt(int size, int index) {
+    char *entry = Entry(index);
+    std::memmove(entry, entry + Stride(), (size - index - 1) * Stride());
+  }
+
+  auto Items(int size) const -> std::vector<Item> {
+    std::vector<Item> items;
+    items.reserve(size);
+    for (int i = 0; i < size; i++) {
+      items.emplace_back(KeyAt(i), ValueAt(i));
+    }
+    return items;
+  }
+
+  /** Replace the entries with items[0, count), packed as tightly as their keys allow. The caller checked they fit. */
+  void Assign(const Item *items, int count) {
+    Window window;
+    for (int i = 0; i < count; i++) {
+      window.Add(items[i].first);
+    }
+    Pack(window, items, count);
+  }
+
+ private:
+  auto Begin() const -> int { return std::min<int>(begin_, KEY_SIZE); }
+  auto End() const -> int { return std::clamp<int>(end_, Begin(), KEY_SIZE); }
+  auto Stride() const -> int { return End() - Begin() + VALUE_SIZE; }
+  // The prefix, followed by the entries.
+  auto Data() const -> const char * { return reinterpret_cast<const char *>(this) + HEADER_SIZE; }
+  auto Data() -> char * { return reinterpret_cast<char *>(this) + HEADER_SIZE; }
+
+  auto Entry(int index) const -> const char * {
+    return Data() + Begin() + std::clamp(index, 0, ClampSize(MAX_ENTRIES) - 1) * Stride();
+  }
+  auto Entry(int index) -> char * { return const_cast<char *>(std::as_const(*this).Entry(index)); }
+
+  // Repack the entries if key does not fit into the current window.
+  void Widen(int size, const KeyType &key) {
+    Window window = GetWindow(size);
+    window.Add(key);
+    if (window.Begin() != Begin() || window.End() != End()) {
+      std::vector<Item> items = Items(size);
+      Pack(window, items.data(), size);
+    }
+  }
+
+  void Pack(const Window &window, const Item *items, int count) {
+    begin_ = window.Begin();
+    end_ = window.End();
+    std::memcpy(Data(), window.Prefix(), Begin());
+    for (int i = 0; i < count; i++) {
+      std::memcpy(Entry(i), reinterpret_cast<const char *>(&items[i].first) + Begin(), End() - Begin());
+      SetValueAt(i, items[i].second);
+    }
+  }
+
+  uint16_t begin_;
+  uint16_t end_;
+};
+
+}  // namespace bustub
@@ -17,6 +17,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
+#include "storage/index/varlen_key.h"
 
 namespace bustub {
 
@@ -39,11 +40,13 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * ----------------------------------------------------------------------------
  * | ParentPageId (4) | PageId(4) |
  * ----------------------------------------------------------------------------
+ *
+ * ParentPageId is only recorded when a page is created: splits and merges move children between parents without
+ * rewriting them, since that would mean latching every moved child. Never descend or climb through it.
  */
 class BPlusTreePage {
  public:
   auto IsLeafPage() const -> bool;
-  auto IsRootPage() const -> bool;
   void SetPageType(IndexPageType page_type);
 
   auto GetSize() const -> int;
@@ -64,12 +67,12 @@ class BPlusTreePage {
 
  private:
   // member variable, attributes that both internal and leaf page share
-  IndexPageType page_type_   __attribute__((__unused__));
-  lsn_t lsn_   __attribute__((__unused__));
-  int size_   __attribute__((__unused__));
-  int max_size_   __attribute__((__unused__));
-  page_id_t parent_page_id_   __attribute__((__unused__));
-  page_id_t page_id_   __attribute__((__unused__));
+  IndexPageType page_type_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  page_id_t parent_page_id_;
+  page_id_t page_id_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,223 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_entries.h
+//
+// Identification: src/include/storage/page/b_plus_tree_slotted_entries.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_packed_entries.h"
+
+namespace bustub {
+
+/**
+ * The sorted entries of a B+ tree page for keys of varying length, such as VarlenKey. A key takes up only the
+ * Length() bytes it reports. Capacity is the number of bytes from the start of this object to the end of the page.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------------------------------------
+ * | CellsBegin (2) | CellBytes (2) | SLOT(1) | ... | SLOT(n) | free space | CELL(n) | ... | CELL(1) |
+ *  ----------------------------------------------------------------------------------------------------
+ *
+ * Slots are in key order and hold the offset and the key length of their cell, 2 bytes each. A cell is the key
+ * followed by the value; cells are added from the end of the page towards the slots. A removed entry leaves a hole
+ * among the cells, which is reclaimed once an insert runs out of contiguous free space. CellBytes counts live cell
+ * bytes only, so room checks never see holes.
+ *
+ * As in PackedEntries, every read stays inside the page whatever the slots say, and values are stored unaligned.
+ */
+template <typename KeyType, typename ValueType, int Capacity>
+class SlottedEntries {
+  static_assert(std::is_trivially_copyable_v<KeyType>, "keys are stored as raw bytes");
+
+ public:
+  using Item = std::pair<KeyType, ValueType>;
+
+  static constexpr int HEADER_SIZE = 4;
+  static constexpr int SLOT_SIZE = 4;
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  /** A bound on the entries of any page: only keys that take up no bytes at all could reach it. */
+  static constexpr int MAX_ENTRIES = (Capacity - HEADER_SIZE) / (SLOT_SIZE + VALUE_SIZE);
+
+  /** @return the number of bytes an entry with key takes up, slot included */
+  static auto EntrySize(const KeyType &key) -> int { return SLOT_SIZE + KeyLength(key) + VALUE_SIZE; }
+
+  /** @see PickSplitIndex */
+  static auto PickSplit(const std::vector<Item> &items, int preferred, int min_size) -> int {
+    int size = static_cast<int>(items.size());
+    // bytes[i] is the size of the entries before i.
+    std::vector<int> bytes(size + 1);
+    for (int i = 0; i < size; i++) {
+      bytes[i + 1] = bytes[i] + EntrySize(items[i].first);
+    }
+    auto fits = [&](int i) { return Fits(bytes[i]) && Fits(bytes[size] - bytes[i]); };
+    return PickSplitIndex(size, preferred, min_size, fits, [&](int i) { return KeyLength(items[i].first); });
+  }
+
+  /**
+   * @return true if new_entries more entries, whose keys are among keys, fit into fill_percent of the page. A key
+   * that replaces another one is counted in full.
+   */
+  template <typename Keys>
+  auto HasRoomFor(int size, const Keys &keys, int new_entries, int fill_percent = 100) const -> bool {
+    int bytes = BytesUsed(size) + new_entries * (SLOT_SIZE + VALUE_SIZE);
+    for (const KeyType &key : keys) {
+      bytes += KeyLength(key);
+    }
+    return bytes * 100 <= Capacity * fill_percent;
+  }
+
+  void Clear() {
+    cells_begin_ = Capacity;
+    cell_bytes_ = 0;
+  }
+
+  /** @return the number of bytes the first count entries take up */
+  auto BytesUsed(int count) const -> int {
+    int bytes = HEADER_SIZE;
+    for (int i = 0; i < ClampSize(count); i++) {
+      int length;
+      Cell(i, &length);
+      bytes += SLOT_SIZE + length + VALUE_SIZE;
+    }
+    return bytes;
+  }
+
+  auto ClampSize(int size) const -> int { return std::clamp(size, 0, MAX_ENTRIES); }
+
+  /** Only the first Length() bytes of the key are set. */
+  auto KeyAt(int index) const -> KeyType {
+    KeyType key;
+    int length;
+    const char *cell = Cell(index, &length);
+    std::memcpy(reinterpret_cast<char *>(&key), cell, length);
+    return key;
+  }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value;
+    int length;
+    const char *cell = Cell(index, &length);
+    std::memcpy(reinterpret_cast<char *>(&value), cell + length, VALUE_SIZE);
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) {
+    int length;
+    char *cell = const_cast<char *>(Cell(index, &length));
+    std::memcpy(cell + length, reinterpret_cast<const char *>(&value), VALUE_SIZE);
+  }
+
+  /** The caller makes sure there is room. */
+  void SetKeyAt(int size, int index, const KeyType &key) {
+    ValueType value = ValueAt(index);
+    RemoveAt(size, index);
+    InsertAt(size - 1, index, key, value);
+  }
+
+  /** The caller makes sure there is room. */
+  void InsertAt(int size, int index, const KeyType &key, const ValueType &value) {
+    int length = KeyLength(key);
+    if (cells_begin_ - (HEADER_SIZE + (size + 1) * SLOT_SIZE) < length + VALUE_SIZE) {
+      Compact(size);
+    }
+    char *slot = Bytes() + HEADER_SIZE + index * SLOT_SIZE;
+    std::memmove(slot + SLOT_SIZE, slot, (size - index) * SLOT_SIZE);
+    cells_begin_ -= length + VALUE_SIZE;
+    cell_bytes_ += length + VALUE_SIZE;
+    std::memcpy(Bytes() + cells_begin_, reinterpret_cast<const char *>(&key), length);
+    std::memcpy(Bytes() + cells_begin_ + length, reinterpret_cast<const char *>(&value), VALUE_SIZE);
+    SetSlot(index, cells_begin_, length);
+  }
+
+  void RemoveAt(int size, int index) {
+    int length;
+    Cell(index, &length);
+    cell_bytes_ -= length + VALUE_SIZE;
+    char *slot = Bytes() + HEADER_SIZE + index * SLOT_SIZE;
+    std::memmove(slot, slot + SLOT_SIZE, (size - index - 1) * SLOT_SIZE);
+  }
+
+  auto Items(int size) const -> std::vector<Item> {
+    std::vector<Item> items;
+    items.reserve(size);
+    for (int i = 0; i < size; i++) {
+      items.emplace_back(KeyAt(i), ValueAt(i));
+    }
+    return items;
+  }
+
+  /** Replace the entries with items[0, count). The caller checked they fit. */
+  void Assign(const Item *items, int count) {
+    Clear();
+    for (int i = 0; i < count; i++) {
+      InsertAt(i, i, items[i].first, items[i].second);
+    }
+  }
+
+ private:
+  static auto KeyLength(const KeyType &key) -> int { return std::clamp(static_cast<int>(key.Length()), 0, KEY_SIZE); }
+  static auto Fits(int entry_bytes) -> bool { return HEADER_SIZE + entry_bytes <= Capacity; }
+
+  auto Bytes() const -> const char * { return reinterpret_cast<const char *>(this); }
+  auto Bytes() -> char * { return reinterpret_cast<char *>(this); }
+
+  // The cell of the entry at index, and the length of its key.
+  auto Cell(int index, int *length) const -> const char * {
+    uint16_t slot[2];
+    std::memcpy(slot, Bytes() + HEADER_SIZE + std::clamp(index, 0, MAX_ENTRIES - 1) * SLOT_SIZE, SLOT_SIZE);
+    int offset = std::clamp<int>(slot[0], HEADER_SIZE, Capacity - VALUE_SIZE);
+    *length = std::min<int>({slot[1], KEY_SIZE, Capacity - VALUE_SIZE - offset});
+    return Bytes() + offset;
+  }
+
+  void SetSlot(int index, int offset, int length) {
+    uint16_t slot[2] = {static_cast<uint16_t>(offset), static_cast<uint16_t>(length)};
+    std::memcpy(Bytes() + HEADER_SIZE + index * SLOT_SIZE, slot, SLOT_SIZE);
+  }
+
+  // Move the cells of the first size entries together at the end of the page, closing the holes between them.
+  void Compact(int size) {
+    char buffer[Capacity];
+    int begin = Capacity;
+    for (int i = 0; i < size; i++) {
+      int length;
+      const char *cell = Cell(i, &length);
+      begin -= length + VALUE_SIZE;
+      std::memcpy(buffer + begin, cell, length + VALUE_SIZE);
+      SetSlot(i, begin, length);
+    }
+    std::memcpy(Bytes() + begin, buffer + begin, Capacity - begin);
+    cells_begin_ = begin;
+    cell_bytes_ = Capacity - begin;
+  }
+
+  uint16_t cells_begin_;
+  uint16_t cell_bytes_;
+};
+
+/** Keys that report their own Length() go into slots, fixed-size keys are packed. */
+template <typename KeyType, typename = void>
+struct HasKeyLength : std::false_type {};
+template <typename KeyType>
+struct HasKeyLength<KeyType, std::void_t<decltype(std::declval<const KeyType &>().Length())>> : std::true_type {};
+
+template <typename KeyType, typename ValueType, int Capacity>
+using PageEntries = std::conditional_t<HasKeyLength<KeyType>::value, SlottedEntries<KeyType, ValueType, Capacity>,
+                                       PackedEntries<KeyType, ValueType, Capacity>>;
+
+}  // namespace bustub
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <new>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -30,11 +33,25 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
-
-  /** Default destructor. */
-  ~Page() = default;
+  /** Constructor. Allocates page-aligned memory for the page data and zeros it out. */
+  Page() : data_(new (std::align_val_t(BUSTUB_PAGE_SIZE)) char[BUSTUB_PAGE_SIZE]), owns_data_(true) { ResetMemory(); }
+
+  /**
+   * Constructor for pages whose data lives in memory owned by someone else, like the frames of a buffer pool. Zeros
+   * out the page data.
+   * @param data BUSTUB_PAGE_SIZE bytes that outlive the page; page-aligned if the page is used for direct I/O
+   */
+  explicit Page(char *data) : data_(data) { ResetMemory(); }
+
+  /** Destructor. Frees the page data if the page allocated it. */
+  ~Page() {
+    if (owns_data_) {
+      operator delete[](data_, std::align_val_t(BUSTUB_PAGE_SIZE));
+    }
+  }
+
+  Page(const Page &) = delete;
+  auto operator=(const Page &) -> Page & = delete;
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -48,15 +65,57 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. The page version turns odd while the latch is held. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1);
+    rwlatch_.WUnlock();
+  }
+
+  /**
+   * Start an optimistic read of the page, waiting out any writer that holds the write latch. The reader must hold a
+   * pin, and must call ValidateVersion with the returned version before it trusts anything it read.
+   * @return the current (even) page version
+   */
+  inline auto GetVersion() -> uint64_t {
+    uint64_t version;
+    while (((version = version_.load(std::memory_order_acquire)) & 1) != 0) {
+      std::this_thread::yield();
+    }
+    return version;
+  }
+
+  /** @return true if no writer has latched the page since GetVersion returned version */
+  inline auto ValidateVersion(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * Turn an optimistic read into a write latch.
+   * @return true if the write latch is now held; false, without the latch, if the page changed since version
+   */
+  inline auto TryUpgradeLatch(uint64_t version) -> bool {
+    rwlatch_.WLock();
+    if (version_.load(std::memory_order_relaxed) != version) {
+      rwlatch_.WUnlock();
+      return false;
+    }
+    version_.fetch_add(1);
+    return true;
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Acquire the page read latch if no writer holds it. @return true if the read latch is now held */
+  inline auto TryRLatch() -> bool { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
@@ -79,15 +138,22 @@ class Page {
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
   /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
+  char *data_;
+  /** True if data_ was allocated by the page itself. */
+  bool owns_data_{false};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /**
+   * The pin count of this page. Buffer pool hits pin and unpin without a pool-wide latch, so this is atomic; -1 marks
+   * a frame that the buffer pool itself owns (free, or being replaced) and that cannot be pinned.
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by WLatch and WUnlatch, so it is odd exactly while a writer holds the latch. */
+  std::atomic<uint64_t> version_ = 0;
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -138,6 +139,13 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /**
+   * List the tuples of this page that are not deleted, for readers that look at the tuple bytes in place.
+   * @param[out] slots the slot numbers of the tuples, in order
+   * @param[out] offsets the offset of each of those tuples from the start of the page data
+   */
+  void GetLiveTuples(std::vector<uint32_t> *slots, std::vector<uint32_t> *offsets);
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
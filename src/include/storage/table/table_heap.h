@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -95,12 +99,42 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param acquire_read_lock whether to read latch the page
+   * @param access_type buffer pool hint for the page fetch
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true,
+                AccessType access_type = AccessType::Unknown) -> bool;
+
+  /**
+   * @param txn transaction performing the scan
+   * @param access_type buffer pool hint for every page the iterator fetches; full scans pass AccessType::Scan
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, AccessType access_type = AccessType::Unknown) -> TableIterator;
+
+  /**
+   * @param page_id the page to start from, which must be one of the pages of this table
+   * @param txn transaction performing the scan
+   * @param access_type buffer pool hint for every page the iterator fetches
+   * @return an iterator at the first tuple on page_id or the pages after it
+   */
+  auto BeginAt(page_id_t page_id, Transaction *txn, AccessType access_type = AccessType::Unknown) -> TableIterator;
+
+  /**
+   * Copy out the tuples of one page that select picks, leaving the others in place.
+   * @param page_id the page to read, which must be one of the pages of this table
+   * @param select called with the read-latched page; fills its second argument with the slots to copy out, in order
+   * @param txn transaction performing the scan
+   * @param access_type buffer pool hint for the page fetch
+   * @param[out] tuples the tuples picked, appended
+   * @return the id of the page after page_id, or INVALID_PAGE_ID if page_id is the last page of the table
+   */
+  auto ScanPage(page_id_t page_id, const std::function<void(TablePage *, std::vector<uint32_t> *)> &select,
+                Transaction *txn, AccessType access_type, std::vector<Tuple> *tuples) -> page_id_t;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /** @return the ids of the pages of this table, in the order a scan visits them, without fetching any page */
+  auto GetPageIds() -> std::vector<page_id_t>;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -113,6 +147,12 @@ class TableHeap {
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** Protects page_ids_ and page_ids_known_. Taken while a page is latched, never the other way round. */
+  std::mutex page_ids_latch_;
+  /** The ids of the pages of this table in scan order, kept up to date as InsertTuple links new pages */
+  std::vector<page_id_t> page_ids_;
+  /** False for an opened table until the first GetPageIds walks its pages */
+  bool page_ids_known_{false};
 };
 
 }  // namespace bustub
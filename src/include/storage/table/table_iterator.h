@@ -14,6 +14,7 @@
 
 #include <cassert>
 
+#include "buffer/replacer.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -23,16 +24,28 @@ namespace bustub {
 class TableHeap;
 
 /**
- * TableIterator enables the sequential scan of a TableHeap.
+ * TableIterator enables the sequential scan of a TableHeap. Whenever it moves on to the next page, it asks the buffer
+ * pool to read the following pages ahead, so a scan of cold pages keeps several reads in flight instead of waiting for
+ * one page at a time.
  */
 class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * @param table_heap the table to iterate over
+   * @param rid the first tuple, or an invalid RID for the end iterator
+   * @param txn the transaction reading the table
+   * @param access_type buffer pool hint for every page the iterator fetches
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, AccessType access_type = AccessType::Unknown);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        access_type_(other.access_type_),
+        read_ahead_end_(other.read_ahead_end_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +67,27 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    access_type_ = other.access_type_;
+    read_ahead_end_ = other.read_ahead_end_;
     return *this;
   }
 
  private:
+  /**
+   * Read ahead of the page the iterator just moved to. Only the next page is known from the page itself; heap pages
+   * are usually allocated one after another, so while the chain goes forward, the pages after it are guessed to
+   * continue with the same stride, up to read_ahead_pages in all.
+   * @param page_id the page the iterator is on
+   * @param next_page_id the page after it
+   */
+  void ReadAhead(page_id_t page_id, page_id_t next_page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  AccessType access_type_;
+  /** The last page read ahead, so that every page is requested once. */
+  page_id_t read_ahead_end_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -42,12 +42,21 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
+  // constructor for creating a new tuple from its serialized data, deep copy
+  Tuple(const char *data, uint32_t size);
+
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move constructor, takes over the data of other
+  Tuple(Tuple &&other) noexcept;
+
+  // move assign operator, takes over the data of other
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -60,6 +60,10 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
             // Ensure right child is table scan
             if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan) {
               const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
+              // An index lookup would skip the filter of the scan.
+              if (right_seq_scan.filter_predicate_ != nullptr) {
+                return optimized_plan;
+              }
               if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
                 if (auto index = MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx());
                     index != std::nullopt) {
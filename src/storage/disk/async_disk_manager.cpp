@@ -0,0 +1,620 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.cpp
+//
+// Identification: src/storage/disk/async_disk_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define BUSTUB_HAS_IO_URING
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <new>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/** A queued page I/O. */
+struct IoRequest {
+  bool write_;
+  page_id_t page_id_;
+  /** Source of a write. */
+  const char *write_data_;
+  /** Destination of a read. */
+  char *read_data_;
+  disk_callback_fn callback_;
+  /** Checks the page a read brought in, or nullptr. */
+  std::function<bool(const char *)> verify_;
+  std::promise<bool> done_;
+  /** Page-aligned copy of the caller's buffer for direct I/O on a buffer that is not aligned, or nullptr. */
+  char *bounce_{nullptr};
+
+  ~IoRequest() {
+    if (bounce_ != nullptr) {
+      operator delete[](bounce_, std::align_val_t(BUSTUB_PAGE_SIZE));
+    }
+  }
+
+  auto Offset() const -> off_t { return static_cast<off_t>(page_id_) * BUSTUB_PAGE_SIZE; }
+
+  /** @return the memory the engine transfers the page from or into */
+  auto Buffer() const -> char * {
+    if (bounce_ != nullptr) {
+      return bounce_;
+    }
+    return write_ ? const_cast<char *>(write_data_) : read_data_;
+  }
+
+  /** Give the request a bounce buffer if direct I/O can't use the caller's buffer as it is. */
+  void AlignForDirectIo() {
+    if (reinterpret_cast<uintptr_t>(Buffer()) % BUSTUB_PAGE_SIZE == 0) {
+      return;
+    }
+    bounce_ = new (std::align_val_t(BUSTUB_PAGE_SIZE)) char[BUSTUB_PAGE_SIZE];
+    if (write_) {
+      memcpy(bounce_, write_data_, BUSTUB_PAGE_SIZE);
+    }
+  }
+
+  /**
+   * Report the outcome of the I/O to the callback and the future. A read that ends early ran past the end of the
+   * file, and reads zeroes from there on like DiskManager::ReadPage does.
+   * @param result the number of bytes transferred, or a negated errno
+   */
+  void Complete(ssize_t result) {
+    bool ok = result >= 0 && (!write_ || result == BUSTUB_PAGE_SIZE);
+    if (!ok) {
+      LOG_DEBUG("I/O error on page %d: %s", page_id_, result < 0 ? strerror(static_cast<int>(-result)) : "short write");
+    } else if (!write_) {
+      if (result < BUSTUB_PAGE_SIZE) {
+        LOG_DEBUG("Read less than a page");
+        memset(Buffer() + result, 0, BUSTUB_PAGE_SIZE - result);
+      }
+      if (bounce_ != nullptr) {
+        memcpy(read_data_, bounce_, BUSTUB_PAGE_SIZE);
+      }
+      ok = verify_ == nullptr || verify_(read_data_);
+    }
+    if (callback_ != nullptr) {
+      callback_(ok);
+    }
+    done_.set_value(ok);
+  }
+};
+
+/**
+ * The queue in front of an engine. Submit never blocks; the engine takes the queued requests off in batches as it has
+ * room for them.
+ */
+class AsyncDiskManager::Engine {
+ public:
+  Engine(int fd, size_t queue_depth) : fd_(fd), queue_depth_(queue_depth) {}
+
+  virtual ~Engine() = default;
+
+  /** @return the engine that runs the requests */
+  virtual auto Backend() const -> AsyncIoBackend = 0;
+
+  void Submit(std::unique_ptr<IoRequest> request) {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      queue_.push_back(std::move(request));
+    }
+    cv_.notify_one();
+  }
+
+ protected:
+  /**
+   * Move up to max_requests queued requests into batch, waiting for one if the queue is empty.
+   * @return false once the engine is stopping and the queue has drained
+   */
+  auto TakeBatch(size_t max_requests, std::vector<std::unique_ptr<IoRequest>> *batch) -> bool {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return false;
+    }
+    while (!queue_.empty() && batch->size() < max_requests) {
+      batch->push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    return true;
+  }
+
+  /** Make TakeBatch return false once the queue is empty. */
+  void Stop() {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  int fd_;
+  size_t queue_depth_;
+
+ private:
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<IoRequest>> queue_;
+  bool stop_{false};
+};
+
+namespace {
+
+/** Runs each request as a blocking pread/pwrite on one of queue_depth threads. */
+class ThreadPoolEngine : public AsyncDiskManager::Engine {
+ public:
+  ThreadPoolEngine(int fd, size_t queue_depth) : Engine(fd, queue_depth) {
+    for (size_t i = 0; i < queue_depth_; i++) {
+      workers_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~ThreadPoolEngine() override {
+    Stop();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  auto Backend() const -> AsyncIoBackend override { return AsyncIoBackend::ThreadPool; }
+
+ private:
+  void Run() {
+    std::vector<std::unique_ptr<IoRequest>> batch;
+    while (TakeBatch(1, &batch)) {
+      auto &request = batch.front();
+      ssize_t result = request->write_ ? pwrite(fd_, request->Buffer(), BUSTUB_PAGE_SIZE, request->Offset())
+                                       : pread(fd_, request->Buffer(), BUSTUB_PAGE_SIZE, request->Offset());
+      request->Complete(result < 0 ? -errno : result);
+      batch.clear();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+};
+
+#ifdef BUSTUB_HAS_IO_URING
+
+/**
+ * Runs requests on an io_uring, driven through the raw system calls. A submitter thread turns batches of queued
+ * requests into submission queue entries and hands each batch to the kernel with one io_uring_enter; a reaper thread
+ * waits for completions and processes all that are ready at once. Each thread is the only one touching its ring, so
+ * the rings need no latch, only the acquire/release ordering on their head and tail indexes.
+ *
+ * If io_uring_enter fails for any other reason than a transient one, the requests the kernel did not take fail, and
+ * the submitter hands every request after them to a thread pool engine instead.
+ */
+class IoUringEngine : public AsyncDiskManager::Engine {
+ public:
+  /** @return the engine, or nullptr if the kernel does not allow io_uring or cannot read and write files with it */
+  static auto Create(int fd, size_t queue_depth) -> std::unique_ptr<AsyncDiskManager::Engine> {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+    if (ring_fd < 0) {
+      return nullptr;
+    }
+    if (!SupportsReadWrite(ring_fd)) {
+      close(ring_fd);
+      return nullptr;
+    }
+    auto engine = std::unique_ptr<IoUringEngine>(new IoUringEngine(fd, ring_fd, params));
+    if (!engine->MapRings()) {
+      return nullptr;
+    }
+    engine->submitter_ = std::thread([engine = engine.get()] { engine->RunSubmitter(); });
+    engine->reaper_ = std::thread([engine = engine.get()] { engine->RunReaper(); });
+    return engine;
+  }
+
+  ~IoUringEngine() override {
+    Stop();
+    if (submitter_.joinable()) {
+      submitter_.join();
+    }
+    if (reaper_.joinable()) {
+      reaper_.join();
+    }
+    fallback_.reset();
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    close(ring_fd_);
+  }
+
+  auto Backend() const -> AsyncIoBackend override {
+    return fallen_back_ ? AsyncIoBackend::ThreadPool : AsyncIoBackend::IoUring;
+  }
+
+ private:
+  IoUringEngine(int fd, int ring_fd, const io_uring_params &params)
+      : Engine(fd, params.sq_entries), ring_fd_(ring_fd), params_(params) {}
+
+  /**
+   * IORING_OP_READ and IORING_OP_WRITE came after io_uring itself, in Linux 5.6 along with IORING_REGISTER_PROBE.
+   * @return true if the kernel runs both on the ring
+   */
+  static auto SupportsReadWrite(int ring_fd) -> bool {
+    constexpr unsigned max_ops = 256;
+    std::vector<uint64_t> buffer((sizeof(io_uring_probe) + max_ops * sizeof(io_uring_probe_op)) / sizeof(uint64_t) + 1);
+    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, max_ops) < 0) {
+      return false;
+    }
+    for (unsigned op : {IORING_OP_READ, IORING_OP_WRITE}) {
+      if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto MapRings() -> bool {
+    sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                  IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    sqes_ = mmap(nullptr, params_.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return false;
+    }
+    auto *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params_.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params_.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params_.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params_.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params_.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params_.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params_.cq_off.cqes);
+    return true;
+  }
+
+  auto Enter(unsigned to_submit, unsigned min_complete, unsigned flags) -> int {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+  }
+
+  /**
+   * Publish the count entries up to tail and make the kernel consume all of them. The entries it consumes count as in
+   * flight before the reaper can see them complete.
+   * @param[out] error the errno of io_uring_enter if it failed
+   * @return the number of entries the kernel did not take, which are taken back off the ring
+   */
+  auto SubmitUpTo(unsigned tail, unsigned count, int *error) -> unsigned {
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    while (count > 0) {
+      int submitted;
+      {
+        std::scoped_lock<std::mutex> lock(in_flight_latch_);
+        submitted = Enter(count, 0, 0);
+        *error = submitted < 0 ? errno : 0;
+        if (submitted > 0) {
+          in_flight_ += submitted;
+        }
+      }
+      if (submitted < 0) {
+        if (*error == EINTR || *error == EAGAIN || *error == EBUSY) {
+          continue;
+        }
+        // The kernel only reads the ring inside io_uring_enter, so the entries past its head are still ours.
+        __atomic_store_n(sq_tail_, tail - count, __ATOMIC_RELEASE);
+        return count;
+      }
+      in_flight_cv_.notify_all();
+      count -= submitted;
+    }
+    return 0;
+  }
+
+  void RunSubmitter() {
+    std::vector<std::unique_ptr<IoRequest>> batch;
+    unsigned tail = *sq_tail_;
+    while (fallback_ == nullptr) {
+      // Completions are only reaped as fast as they arrive, so never have more in flight than the ring holds.
+      size_t room;
+      {
+        std::unique_lock<std::mutex> lock(in_flight_latch_);
+        in_flight_cv_.wait(lock, [&] { return in_flight_ < queue_depth_; });
+        room = queue_depth_ - in_flight_;
+      }
+      if (!TakeBatch(room, &batch)) {
+        break;
+      }
+      for (auto &request : batch) {
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe *sqe = &static_cast<io_uring_sqe *>(sqes_)[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = request->write_ ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(request->Buffer());
+        sqe->len = BUSTUB_PAGE_SIZE;
+        sqe->off = request->Offset();
+        sqe->user_data = reinterpret_cast<uint64_t>(request.release());
+        sq_array_[index] = index;
+        tail++;
+      }
+      int error;
+      unsigned rejected = SubmitUpTo(tail, batch.size(), &error);
+      batch.clear();
+      if (rejected > 0) {
+        LOG_WARN("io_uring_enter failed: %s, falling back to a thread pool", strerror(error));
+        for (unsigned position = tail - rejected; position != tail; position++) {
+          std::unique_ptr<IoRequest> request(
+              reinterpret_cast<IoRequest *>(static_cast<io_uring_sqe *>(sqes_)[position & sq_mask_].user_data));
+          request->Complete(-error);
+        }
+        tail -= rejected;
+        fallback_ = std::make_unique<ThreadPoolEngine>(fd_, queue_depth_);
+        fallen_back_ = true;
+      }
+    }
+    while (TakeBatch(queue_depth_, &batch)) {
+      for (auto &request : batch) {
+        fallback_->Submit(std::move(request));
+      }
+      batch.clear();
+    }
+
+    // The reaper stops once everything in flight has completed.
+    {
+      std::scoped_lock<std::mutex> lock(in_flight_latch_);
+      stop_reaper_ = true;
+    }
+    in_flight_cv_.notify_all();
+  }
+
+  void RunReaper() {
+    while (true) {
+      {
+        // Only wait on the ring for completions that are sure to come.
+        std::unique_lock<std::mutex> lock(in_flight_latch_);
+        in_flight_cv_.wait(lock, [&] { return in_flight_ > 0 || stop_reaper_; });
+        if (in_flight_ == 0) {
+          return;
+        }
+      }
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        // Interrupted waits just come back here.
+        Enter(0, 1, IORING_ENTER_GETEVENTS);
+        continue;
+      }
+      size_t completed = 0;
+      for (; head != tail; head++) {
+        io_uring_cqe *cqe = &cqes_[head & cq_mask_];
+        std::unique_ptr<IoRequest> request(reinterpret_cast<IoRequest *>(cqe->user_data));
+        request->Complete(cqe->res);
+        completed++;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      {
+        std::scoped_lock<std::mutex> lock(in_flight_latch_);
+        in_flight_ -= completed;
+      }
+      in_flight_cv_.notify_all();
+    }
+  }
+
+  int ring_fd_;
+  io_uring_params params_;
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  void *sq_ring_{MAP_FAILED};
+  void *cq_ring_{MAP_FAILED};
+  void *sqes_{MAP_FAILED};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+
+  // protects in_flight_ and stop_reaper_, and is held across io_uring_enter submissions
+  std::mutex in_flight_latch_;
+  std::condition_variable in_flight_cv_;
+  // entries the kernel has taken whose completions have not been reaped
+  size_t in_flight_{0};
+  bool stop_reaper_{false};
+
+  // runs the requests once the ring has failed; only the submitter thread touches it before the destructor
+  std::unique_ptr<AsyncDiskManager::Engine> fallback_;
+  std::atomic<bool> fallen_back_{false};
+
+  std::thread submitter_;
+  std::thread reaper_;
+};
+
+#endif
+
+}  // namespace
+
+AsyncDiskManager::AsyncDiskManager(const std::string &db_file, size_t queue_depth, AsyncIoBackend backend,
+                                   bool direct_io)
+    : DiskManager(db_file) {
+  // The base class has created the file if it did not exist.
+  fd_ = -1;
+  if (direct_io) {
+    fd_ = open(db_file.c_str(), O_RDWR | O_DIRECT);
+    if (fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("the file system does not support direct I/O, falling back to buffered I/O");
+    }
+    direct_io_ = fd_ >= 0;
+  }
+  if (fd_ < 0) {
+    fd_ = open(db_file.c_str(), O_RDWR);
+  }
+  if (fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    allocated_size_ = stat_buf.st_size;
+  }
+  queue_depth = std::max<size_t>(queue_depth, 1);
+#ifdef BUSTUB_HAS_IO_URING
+  if (backend != AsyncIoBackend::ThreadPool) {
+    engine_ = IoUringEngine::Create(fd_, queue_depth);
+  }
+#endif
+  if (engine_ == nullptr) {
+    if (backend == AsyncIoBackend::IoUring) {
+      LOG_WARN("io_uring is not available, falling back to a thread pool");
+    }
+    engine_ = std::make_unique<ThreadPoolEngine>(fd_, queue_depth);
+  }
+}
+
+AsyncDiskManager::~AsyncDiskManager() {
+  engine_.reset();
+  close(fd_);
+}
+
+auto AsyncDiskManager::GetBackend() const -> AsyncIoBackend { return engine_->Backend(); }
+
+void AsyncDiskManager::EnsureAllocated(page_id_t page_id) {
+  off_t end = (static_cast<off_t>(page_id) + 1) * BUSTUB_PAGE_SIZE;
+  if (end <= allocated_size_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  off_t allocated = allocated_size_.load(std::memory_order_relaxed);
+  if (!preallocate_ || end <= allocated) {
+    return;
+  }
+  const off_t extent = static_cast<off_t>(DB_FILE_EXTENT_PAGES) * BUSTUB_PAGE_SIZE;
+  off_t new_size = (end + extent - 1) / extent * extent;
+  if (fallocate(fd_, 0, allocated, new_size - allocated) != 0) {
+    // Not every file system can preallocate; a write past the end still grows the file.
+    LOG_DEBUG("fallocate failed: %s", strerror(errno));
+    preallocate_ = false;
+    return;
+  }
+  allocated_size_.store(new_size, std::memory_order_relaxed);
+}
+
+void AsyncDiskManager::FileTruncated() {
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    allocated_size_.store(stat_buf.st_size, std::memory_order_relaxed);
+  }
+}
+
+void AsyncDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  WritePageAsync(page_id, page_data, nullptr).get();
+}
+
+void AsyncDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  if (!SubmitRead(page_id, page_data, nullptr, false).get()) {
+    // Complete() logged the error. Unlike a read past the end of the file, there is no data to stand in for the page.
+    throw Exception(fmt::format("I/O error reading page {} of {}", page_id, file_name_));
+  }
+  VerifyPage(page_id, page_data);
+}
+
+auto AsyncDiskManager::WritePageAsync(page_id_t page_id, const char *page_data, disk_callback_fn callback)
+    -> std::future<bool> {
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    num_writes_ += 1;
+  }
+  auto request = std::make_unique<IoRequest>();
+  request->write_ = true;
+  request->page_id_ = page_id;
+  request->write_data_ = page_data;
+  request->read_data_ = nullptr;
+  RecordChecksum(page_id, page_data);
+  if (HasChecksums()) {
+    request->callback_ = [this, page_id, callback = std::move(callback)](bool ok) {
+      PageWritten(page_id);
+      if (callback != nullptr) {
+        callback(ok);
+      }
+    };
+  } else {
+    request->callback_ = std::move(callback);
+  }
+  if (direct_io_) {
+    request->AlignForDirectIo();
+  }
+  EnsureAllocated(page_id);
+  auto done = request->done_.get_future();
+  engine_->Submit(std::move(request));
+  return done;
+}
+
+auto AsyncDiskManager::ReadPageAsync(page_id_t page_id, char *page_data, disk_callback_fn callback)
+    -> std::future<bool> {
+  return SubmitRead(page_id, page_data, std::move(callback), true);
+}
+
+auto AsyncDiskManager::SubmitRead(page_id_t page_id, char *page_data, disk_callback_fn callback, bool verify)
+    -> std::future<bool> {
+  auto request = std::make_unique<IoRequest>();
+  request->write_ = false;
+  request->page_id_ = page_id;
+  request->write_data_ = nullptr;
+  request->read_data_ = page_data;
+  request->callback_ = std::move(callback);
+  if (verify && HasChecksums()) {
+    request->verify_ = [this, page_id](const char *data) { return VerifyChecksum(page_id, data); };
+  }
+  if (direct_io_) {
+    request->AlignForDirectIo();
+  }
+  auto done = request->done_.get_future();
+  engine_->Submit(std::move(request));
+  return done;
+}
+
+}  // namespace bustub
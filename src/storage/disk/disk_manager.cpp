@@ -10,22 +10,42 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
+#include <set>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/util/crc32c.h"
+#include "fmt/format.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+/** Start of the free space map file. A bitmap with one bit per page follows; a set bit marks a free page. */
+struct FreeSpaceMapHeader {
+  uint32_t magic_;
+  /** Zero while a disk manager has the file open. Pages may have been reused from the bitmap since it was written. */
+  uint32_t clean_;
+  /** No page id at or above this has been handed out. */
+  page_id_t num_pages_;
+};
+
+static constexpr uint32_t FREE_SPACE_MAP_MAGIC = 0x42465342;
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
@@ -50,10 +70,12 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
   }
 
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  bool db_existed = true;
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!db_io_.is_open()) {
     db_io_.clear();
+    db_existed = false;
     // create a new file
     db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
     if (!db_io_.is_open()) {
@@ -61,6 +83,20 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
   buffer_used = nullptr;
+
+  fsm_name_ = file_name_.substr(0, n) + ".fsm";
+  LoadFreeSpaceMap(db_existed);
+  crc_name_ = file_name_.substr(0, n) + ".crc";
+  LoadChecksums(db_existed);
+}
+
+DiskManager::~DiskManager() {
+  if (crc_fd_ >= 0) {
+    close(crc_fd_);
+  }
+  if (db_sync_fd_ >= 0) {
+    close(db_sync_fd_);
+  }
 }
 
 /**
@@ -71,6 +107,7 @@ void DiskManager::ShutDown() {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
   }
+  SaveFreeSpaceMap();
   log_io_.close();
 }
 
@@ -78,6 +115,7 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  RecordChecksum(page_id, page_data);
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
   size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
   // set write cursor to offset
@@ -87,10 +125,11 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
-    return;
+  } else {
+    // needs to flush to keep disk file in sync
+    db_io_.flush();
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  PageWritten(page_id);
 }
 
 /**
@@ -120,6 +159,380 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
       memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
     }
   }
+  VerifyPage(page_id, page_data);
+}
+
+auto DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, disk_callback_fn callback)
+    -> std::future<bool> {
+  WritePage(page_id, page_data);
+  if (callback != nullptr) {
+    callback(true);
+  }
+  std::promise<bool> done;
+  done.set_value(true);
+  return done.get_future();
+}
+
+auto DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, disk_callback_fn callback) -> std::future<bool> {
+  bool ok = true;
+  try {
+    ReadPage(page_id, page_data);
+  } catch (const Exception &e) {
+    ok = false;
+  }
+  if (callback != nullptr) {
+    callback(ok);
+  }
+  std::promise<bool> done;
+  done.set_value(ok);
+  return done.get_future();
+}
+
+auto DiskManager::AllocatePage(uint32_t num_instances, uint32_t instance_index) -> page_id_t {
+  std::scoped_lock lock(free_space_latch_);
+  if (num_instances != cursor_instances_) {
+    ResetCursors(num_instances);
+  }
+  auto &free_pages = free_pages_[instance_index];
+  if (!free_pages.empty()) {
+    page_id_t page_id = *free_pages.begin();
+    free_pages.erase(free_pages.begin());
+    num_free_pages_--;
+    return page_id;
+  }
+  page_id_t page_id = next_page_ids_[instance_index];
+  next_page_ids_[instance_index] += static_cast<page_id_t>(num_instances);
+  num_pages_ = std::max(num_pages_, page_id + 1);
+  if (num_pages_ > reserved_pages_) {
+    ReserveFreeSpaceMapPages();
+  }
+  return page_id;
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  {
+    std::scoped_lock lock(free_space_latch_);
+    if (!PageInUse(page_id)) {
+      return;
+    }
+    AddFreePage(page_id);
+  }
+  // Compact may punch the page out of the file, and whoever allocates it next may read it before writing it.
+  ForgetChecksum(page_id);
+}
+
+auto DiskManager::IsAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock lock(free_space_latch_);
+  return PageInUse(page_id);
+}
+
+auto DiskManager::GetNumPages() -> page_id_t {
+  std::scoped_lock lock(free_space_latch_);
+  return num_pages_;
+}
+
+auto DiskManager::GetNumFreePages() -> size_t {
+  std::scoped_lock lock(free_space_latch_);
+  return num_free_pages_;
+}
+
+auto DiskManager::Compact() -> size_t {
+  std::scoped_lock lock(db_io_latch_, free_space_latch_);
+  ResetCursors(cursor_instances_);
+  size_t released = 0;
+  while (num_pages_ > 0 && free_pages_[FreeSetOf(num_pages_ - 1)].erase(num_pages_ - 1) > 0) {
+    num_free_pages_--;
+    num_pages_--;
+    released++;
+  }
+  ResetCursors(cursor_instances_);
+  if (file_name_.empty()) {
+    return released;
+  }
+
+  db_io_.flush();
+  off_t file_size = GetFileSize(file_name_);
+  off_t end = static_cast<off_t>(num_pages_) * BUSTUB_PAGE_SIZE;
+  if (file_size > end) {
+    if (truncate(file_name_.c_str(), end) != 0) {
+      LOG_WARN("can't truncate db file: %s", strerror(errno));
+      return released;
+    }
+    file_size = end;
+    FileTruncated();
+  }
+#ifdef FALLOC_FL_PUNCH_HOLE
+  // Free pages in the middle of the file keep their ids, but not their blocks.
+  int fd = open(file_name_.c_str(), O_RDWR);
+  if (fd < 0) {
+    return released;
+  }
+  for (const auto &free_pages : free_pages_) {
+    for (page_id_t page_id : free_pages) {
+      off_t offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+      if (offset < file_size &&
+          fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, BUSTUB_PAGE_SIZE) == 0) {
+        released++;
+      }
+    }
+  }
+  close(fd);
+#endif
+  return released;
+}
+
+void DiskManager::LoadFreeSpaceMap(bool db_existed) {
+  fsm_io_.open(fsm_name_, std::ios::binary | std::ios::in | std::ios::out);
+  if (!fsm_io_.is_open() || !db_existed) {
+    // A map left behind by a db file that has since been removed does not describe the new file.
+    fsm_io_.close();
+    fsm_io_.clear();
+    fsm_io_.open(fsm_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!fsm_io_.is_open()) {
+      throw Exception("can't open free space map file");
+    }
+  }
+
+  FreeSpaceMapHeader header{};
+  fsm_io_.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (fsm_io_.gcount() == sizeof(header) && header.magic_ == FREE_SPACE_MAP_MAGIC && header.num_pages_ >= 0) {
+    num_pages_ = header.num_pages_;
+    if (header.clean_ != 0) {
+      std::vector<uint8_t> bitmap((num_pages_ + 7) / 8);
+      fsm_io_.read(reinterpret_cast<char *>(bitmap.data()), static_cast<std::streamsize>(bitmap.size()));
+      if (fsm_io_.gcount() == static_cast<std::streamsize>(bitmap.size())) {
+        for (page_id_t page_id = 0; page_id < num_pages_; page_id++) {
+          if (((bitmap[page_id / 8] >> (page_id % 8)) & 1) != 0) {
+            AddFreePage(page_id);
+          }
+        }
+      }
+    } else {
+      // Pages freed before the crash may have been reused since the map was written. Leaking them is safe; handing
+      // out a page that is still in use is not.
+      LOG_WARN("db file was not shut down cleanly, its free pages are not reused");
+    }
+  }
+  fsm_io_.clear();
+  ReserveFreeSpaceMapPages();
+}
+
+void DiskManager::ReserveFreeSpaceMapPages() {
+  if (!fsm_io_.is_open()) {
+    return;
+  }
+  // Written ahead of the allocations it covers, so that after a crash no page id in use is handed out again.
+  reserved_pages_ = (num_pages_ / DB_FILE_EXTENT_PAGES + 1) * DB_FILE_EXTENT_PAGES;
+  FreeSpaceMapHeader header{FREE_SPACE_MAP_MAGIC, 0, reserved_pages_};
+  fsm_io_.seekp(0);
+  fsm_io_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  fsm_io_.flush();
+  if (fsm_io_.bad()) {
+    LOG_DEBUG("I/O error while writing free space map");
+  }
+}
+
+void DiskManager::SaveFreeSpaceMap() {
+  std::scoped_lock lock(free_space_latch_);
+  if (!fsm_io_.is_open()) {
+    return;
+  }
+  ResetCursors(cursor_instances_);
+  std::vector<uint8_t> bitmap((num_pages_ + 7) / 8);
+  for (const auto &free_pages : free_pages_) {
+    for (page_id_t page_id : free_pages) {
+      bitmap[page_id / 8] |= 1 << (page_id % 8);
+    }
+  }
+  FreeSpaceMapHeader header{FREE_SPACE_MAP_MAGIC, 1, num_pages_};
+  fsm_io_.close();
+  fsm_io_.open(fsm_name_, std::ios::binary | std::ios::trunc | std::ios::out);
+  fsm_io_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  fsm_io_.write(reinterpret_cast<const char *>(bitmap.data()), static_cast<std::streamsize>(bitmap.size()));
+  if (fsm_io_.bad()) {
+    LOG_DEBUG("I/O error while writing free space map");
+  }
+  fsm_io_.close();
+}
+
+void DiskManager::LoadChecksums(bool db_existed) {
+  if (db_existed) {
+    // A database file keeps the choice it was created with.
+    crc_fd_ = open(crc_name_.c_str(), O_RDWR);
+    if (crc_fd_ < 0) {
+      return;
+    }
+    db_sync_fd_ = open(file_name_.c_str(), O_RDONLY);
+    struct stat stat_buf;
+    if (fstat(crc_fd_, &stat_buf) == 0 && stat_buf.st_size > 0) {
+      checksums_.resize(stat_buf.st_size / sizeof(uint32_t));
+      if (pread(crc_fd_, checksums_.data(), checksums_.size() * sizeof(uint32_t), 0) !=
+          static_cast<ssize_t>(checksums_.size() * sizeof(uint32_t))) {
+        LOG_WARN("can't read checksum file, pages are not verified");
+        checksums_.clear();
+      }
+    }
+    // Whatever was written before has been synced by ShutDown, or has been lost in a crash: either way the pages on
+    // disk are what they will stay.
+    unsynced_.assign(checksums_.size() / 2, false);
+    pending_writes_.assign(checksums_.size() / 2, 0);
+    return;
+  }
+  if (!enable_page_checksums) {
+    // A checksum file left behind by a db file that has since been removed must not turn checksums on later.
+    unlink(crc_name_.c_str());
+    return;
+  }
+  crc_fd_ = open(crc_name_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (crc_fd_ < 0) {
+    throw Exception("can't open checksum file");
+  }
+  db_sync_fd_ = open(file_name_.c_str(), O_RDONLY);
+}
+
+void DiskManager::RecordChecksum(page_id_t page_id, const char *page_data) {
+  if (crc_fd_ < 0) {
+    return;
+  }
+  uint32_t crc = Crc32c::Compute(page_data, BUSTUB_PAGE_SIZE);
+  std::unique_lock lock(checksum_latch_);
+  size_t slot = static_cast<size_t>(page_id) * 2;
+  if (slot >= checksums_.size()) {
+    checksums_.resize(slot + 2, 0);
+    unsynced_.resize(page_id + 1, false);
+    pending_writes_.resize(page_id + 1, 0);
+  }
+  if (checksums_[slot] != crc) {
+    if (unsynced_[page_id]) {
+      // The page on disk may still be the version the previous checksum describes, which is about to be dropped.
+      write_done_.wait(lock, [&] { return pending_writes_[page_id] == 0; });
+      SyncWrittenPages();
+    }
+    checksums_[slot + 1] = checksums_[slot];
+    checksums_[slot] = crc;
+    WriteChecksums(slot);
+    // A crash must not leave a page on disk that is newer than its checksums.
+    if (fdatasync(crc_fd_) != 0) {
+      LOG_WARN("can't sync checksum file: %s", strerror(errno));
+    }
+    unsynced_[page_id] = true;
+  }
+  pending_writes_[page_id]++;
+}
+
+void DiskManager::PageWritten(page_id_t page_id) {
+  if (crc_fd_ < 0) {
+    return;
+  }
+  {
+    std::scoped_lock lock(checksum_latch_);
+    pending_writes_[page_id]--;
+    written_pages_.push_back(page_id);
+  }
+  write_done_.notify_all();
+}
+
+void DiskManager::SyncWrittenPages() {
+  if (db_sync_fd_ < 0 || fdatasync(db_sync_fd_) != 0) {
+    LOG_WARN("can't sync db file, a crash may leave pages that fail their checksums");
+    return;
+  }
+  for (page_id_t page_id : written_pages_) {
+    unsynced_[page_id] = false;
+  }
+  written_pages_.clear();
+}
+
+void DiskManager::ForgetChecksum(page_id_t page_id) {
+  if (crc_fd_ < 0) {
+    return;
+  }
+  std::scoped_lock lock(checksum_latch_);
+  size_t slot = static_cast<size_t>(page_id) * 2;
+  if (slot >= checksums_.size()) {
+    return;
+  }
+  checksums_[slot] = 0;
+  checksums_[slot + 1] = 0;
+  unsynced_[page_id] = false;
+  WriteChecksums(slot);
+}
+
+void DiskManager::WriteChecksums(size_t slot) {
+  if (pwrite(crc_fd_, &checksums_[slot], 2 * sizeof(uint32_t), static_cast<off_t>(slot * sizeof(uint32_t))) !=
+      2 * sizeof(uint32_t)) {
+    LOG_DEBUG("I/O error while writing checksum file");
+  }
+}
+
+auto DiskManager::VerifyChecksum(page_id_t page_id, const char *page_data) -> bool {
+  if (crc_fd_ < 0) {
+    return true;
+  }
+  uint32_t crc = Crc32c::Compute(page_data, BUSTUB_PAGE_SIZE);
+  uint32_t current;
+  uint32_t previous;
+  {
+    std::scoped_lock lock(checksum_latch_);
+    size_t slot = static_cast<size_t>(page_id) * 2;
+    if (slot >= checksums_.size()) {
+      return true;
+    }
+    current = checksums_[slot];
+    previous = checksums_[slot + 1];
+  }
+  if (current == 0 || crc == current || crc == previous) {
+    return true;
+  }
+  checksum_failures_++;
+  LOG_ERROR("page %d failed its checksum: %08x on disk, %08x expected", page_id, crc, current);
+  return false;
+}
+
+void DiskManager::VerifyPage(page_id_t page_id, const char *page_data) {
+  if (!VerifyChecksum(page_id, page_data)) {
+    throw Exception(fmt::format("page {} of {} is corrupt", page_id, file_name_));
+  }
+}
+
+auto DiskManager::PageInUse(page_id_t page_id) const -> bool {
+  if (page_id < 0 || page_id >= num_pages_ || free_pages_[FreeSetOf(page_id)].count(page_id) > 0) {
+    return false;
+  }
+  return cursor_instances_ == 0 || page_id < next_page_ids_[page_id % cursor_instances_];
+}
+
+auto DiskManager::FreeSetOf(page_id_t page_id) const -> size_t {
+  return static_cast<size_t>(page_id) % free_pages_.size();
+}
+
+void DiskManager::AddFreePage(page_id_t page_id) {
+  if (free_pages_[FreeSetOf(page_id)].insert(page_id).second) {
+    num_free_pages_++;
+  }
+}
+
+void DiskManager::ResetCursors(uint32_t num_instances) {
+  for (uint32_t i = 0; i < cursor_instances_; i++) {
+    for (page_id_t page_id = next_page_ids_[i]; page_id < num_pages_; page_id += cursor_instances_) {
+      AddFreePage(page_id);
+    }
+  }
+  if (num_instances > 0 && num_instances != free_pages_.size()) {
+    // Sort the free pages by the instance they map to now.
+    std::vector<std::set<page_id_t>> free_pages(num_instances);
+    for (const auto &old_free_pages : free_pages_) {
+      for (page_id_t page_id : old_free_pages) {
+        free_pages[static_cast<size_t>(page_id) % num_instances].insert(page_id);
+      }
+    }
+    free_pages_ = std::move(free_pages);
+  }
+  cursor_instances_ = num_instances;
+  next_page_ids_.assign(num_instances, num_pages_);
+  for (uint32_t i = 0; i < num_instances; i++) {
+    next_page_ids_[i] += static_cast<page_id_t>((i + num_instances - num_pages_ % num_instances) % num_instances);
+  }
 }
 
 /**
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <numeric>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -7,6 +11,7 @@
 #include "storage/page/header_page.h"
 
 namespace bustub {
+
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                           int leaf_max_size, int internal_max_size)
@@ -15,12 +20,12 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      reclaimer_(buffer_pool_manager) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
- //测试 : vscode下git功能提交测试。
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
@@ -33,51 +38,256 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-	if(IsEmpty())	return false;
-
-	InternalPage *internal; LeafPage *leaf;
-	page_id_t cur_id;
-	Page *page = buffer_pool_manager_->FetchPgImp( root_page_id_ );
-
-	IndexPageType page_type;
-	memcpy(page_type, page->GetData(), sizeof(IndexPageType));
-	int l,r,mid;//the key of array_[0] is invalid
-	while( page_type == INTERNAL_PAGE ){
-		page_internal = reinterpret_cast< InternalPage* >( page->GetData() );
-		l = 1; r = page_internal->GetSize(); mid = 0;
-		while(l <= r){
-			mid = l + ( r + 1 - l ) / 2;//the root of (l+r)/2
-			if(comparator(key , page_interna->KeyAt(mid)) < 0){
-				r = mid - 1;
-			}else if(comparator(page_internal->KeyAt(mid) , key) < 0){
-				l = mid + 1;
-			}else{
-				r = mid;
-				break;
-			}
-		}//r
-  		curr_id = page->GetPageId();
-		buffer_pool_manager_->UnpinPgImp( curr_id, false );
-		page = bufffer_pool_manager_->FetchPgImp( page_internal->ValueAt( r ) );
-		memcpy(page_type, page->GetData(), sizeof( IndexPageType ));
-	}	
-	curr_id = page->GetPageId();
-	page_leaf = reinterpret_cast< LeafPage* >( page->GetData() );
-	l = 0; l = page_leaf->GetSize() - 1; mid = 0;
-	while( l <= r){
-		mid = l + ( r + 1 - l ) / 2;
-		if(comparator( key , page_leaf->KeyAt(mid) ) < 0){
-			r = mid - 1;
-		}else if(comparator( page_leaf->KeyAt(mid) , key ) < 0){
-			l = mid + 1;
-		}else{
-			break;
-		}
-	}
-	if(l > r){ return false; }
-	(*result).emplace_back(page_leaf->ValueAt( mid ));
-	buffer_pool_manager_->UnpinPgImp(curr_id , false);
-	return true;
+  while (true) {
+    {
+      auto guard = reclaimer_.Enter();
+      bool found = false;
+      if (auto step = TryGetValue(key, result, &found); step != Step::RETRY) {
+        return step == Step::DONE && found;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found) -> Step {
+  NodeHandle leaf;
+  if (auto step = FindLeaf(&key, &leaf, nullptr); step != Step::DONE) {
+    return step;
+  }
+  if (!leaf.Valid()) {
+    *found = false;
+    return Step::DONE;
+  }
+  ValueType value;
+  *found = leaf.As<LeafPage>()->Lookup(key, &value, comparator_);
+  if (!leaf.Validate()) {
+    return Step::RETRY;
+  }
+  if (*found) {
+    result->push_back(value);
+  }
+  return Step::DONE;
+}
+
+/*
+ * Batched point lookups. The probes are sorted and go down the tree together,
+ * one level at a time: the probes of a node are split up among its children,
+ * and all of those children are pinned and prefetched before any of them is
+ * searched. Sorted probes share most of their path, so a page on it is pinned
+ * once for all of them, and the cache misses of one level overlap instead of
+ * each lookup waiting on its own, one level after the other.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) -> size_t {
+  if (results->size() < keys.size()) {
+    results->resize(keys.size());
+  }
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+  size_t found = 0;
+  for (size_t begin = 0; begin < order.size(); begin += GET_VALUES_BATCH) {
+    size_t end = std::min(begin + GET_VALUES_BATCH, order.size());
+    // The batches still to run, the next one last. A batch that finds no frame for its pages is split in two halves,
+    // which pin fewer pages at a time; one probe pins at most two.
+    std::vector<std::vector<size_t>> pending;
+    pending.emplace_back(order.begin() + begin, order.begin() + end);
+    while (!pending.empty()) {
+      std::vector<size_t> batch = std::move(pending.back());
+      pending.pop_back();
+      while (true) {
+        Step step;
+        {
+          auto guard = reclaimer_.Enter();
+          step = TryGetValues(keys, &batch, results, &found);
+        }
+        if (step == Step::DONE) {
+          break;
+        }
+        if (step == Step::NO_FRAME) {
+          if (batch.size() == 1) {
+            return found;
+          }
+          auto middle = batch.begin() + batch.size() / 2;
+          pending.emplace_back(middle, batch.end());
+          pending.emplace_back(batch.begin(), middle);
+          break;
+        }
+        std::this_thread::yield();
+      }
+    }
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryGetValues(const std::vector<KeyType> &keys, std::vector<size_t> *batch,
+                                  std::vector<std::vector<ValueType>> *results, size_t *found) -> Step {
+  NodeHandle root;
+  if (auto step = FetchRoot(&root); step != Step::DONE) {
+    return step;
+  }
+  if (!root.Valid()) {
+    batch->clear();
+    return Step::DONE;
+  }
+  // The nodes of the current level; nodes[i] covers the probes in batch [bounds[i], bounds[i + 1]).
+  std::vector<NodeHandle> nodes;
+  std::vector<size_t> bounds = {0, batch->size()};
+  nodes.push_back(std::move(root));
+  bool leaves = false;
+  while (!leaves) {
+    std::vector<std::pair<size_t, page_id_t>> children;
+    std::vector<size_t> parents;
+    leaves = true;
+    for (size_t i = 0; i < nodes.size(); i++) {
+      if (nodes[i].template As<BPlusTreePage>()->IsLeafPage()) {
+        children.emplace_back(bounds[i], INVALID_PAGE_ID);
+        parents.push_back(i);
+        continue;
+      }
+      leaves = false;
+      auto *internal = nodes[i].template As<InternalPage>();
+      for (size_t probe = bounds[i]; probe < bounds[i + 1]; probe++) {
+        page_id_t child_id = internal->ValueAt(internal->Lookup(keys[(*batch)[probe]], comparator_));
+        if (probe == bounds[i] || child_id != children.back().second) {
+          children.emplace_back(probe, child_id);
+          parents.push_back(i);
+        }
+      }
+    }
+    if (leaves) {
+      break;
+    }
+    // Pin every child before searching any of them. A leaf among internal pages can only come from a torn read; it
+    // stays as it is and fails its version check later.
+    std::vector<NodeHandle> next(children.size());
+    for (size_t j = 0; j < children.size(); j++) {
+      if (children[j].second == INVALID_PAGE_ID) {
+        next[j] = std::move(nodes[parents[j]]);
+        continue;
+      }
+      if (auto step = FetchChild(nodes[parents[j]], children[j].second, &next[j]); step != Step::DONE) {
+        return step;
+      }
+      const char *data = next[j].template As<char>();
+      __builtin_prefetch(data);
+      __builtin_prefetch(data + BUSTUB_PAGE_SIZE / 2);
+    }
+    nodes = std::move(next);
+    bounds.clear();
+    for (const auto &child : children) {
+      bounds.push_back(child.first);
+    }
+    bounds.push_back(batch->size());
+  }
+
+  std::vector<size_t> unfinished;
+  std::vector<std::pair<size_t, ValueType>> hits;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    auto *leaf = nodes[i].template As<LeafPage>();
+    hits.clear();
+    for (size_t probe = bounds[i]; probe < bounds[i + 1]; probe++) {
+      ValueType value;
+      if (leaf->Lookup(keys[(*batch)[probe]], &value, comparator_)) {
+        hits.emplace_back((*batch)[probe], value);
+      }
+    }
+    if (!nodes[i].Validate()) {
+      unfinished.insert(unfinished.end(), batch->begin() + bounds[i], batch->begin() + bounds[i + 1]);
+      continue;
+    }
+    for (const auto &[key_index, value] : hits) {
+      (*results)[key_index].push_back(value);
+    }
+    *found += hits.size();
+  }
+  *batch = std::move(unfinished);
+  return batch->empty() ? Step::DONE : Step::RETRY;
+}
+
+/*
+ * Pin the root and check that it is still the root once its version is
+ * known. Root changes latch the old root, so the version check of whatever
+ * is read from the page covers the root page id as well.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRoot(NodeHandle *root) -> Step {
+  page_id_t root_page_id = root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    *root = NodeHandle();
+    return Step::DONE;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id);
+  if (page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  *root = NodeHandle(buffer_pool_manager_, page);
+  return root_page_id_ == root_page_id ? Step::DONE : Step::RETRY;
+}
+
+/*
+ * Lock coupling without locks: the child page id is only trusted once the
+ * parent is validated, and the child is only trusted if the parent is still
+ * unchanged after the child's version was taken.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchChild(const NodeHandle &parent, page_id_t child_id, NodeHandle *child) -> Step {
+  if (!parent.Validate()) {
+    return Step::RETRY;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(child_id);
+  if (page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  *child = NodeHandle(buffer_pool_manager_, page);
+  return parent.Validate() ? Step::DONE : Step::RETRY;
+}
+
+/*
+ * Write-latch a sibling that is only reachable through a parent the caller
+ * has already latched
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchLatched(page_id_t page_id, NodeHandle *node) -> Step {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  *node = NodeHandle(buffer_pool_manager_, page, 0);
+  node->Latch();
+  return Step::DONE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeaf(const KeyType *key, NodeHandle *leaf, std::vector<page_id_t> *following) -> Step {
+  NodeHandle node;
+  if (auto step = FetchRoot(&node); step != Step::DONE) {
+    return step;
+  }
+  while (node.Valid() && !node.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = node.template As<InternalPage>();
+    int index = key == nullptr ? 0 : internal->Lookup(*key, comparator_);
+    page_id_t child_id = internal->ValueAt(index);
+    if (following != nullptr) {
+      following->clear();
+      int size = std::clamp(internal->GetSize(), 1, static_cast<int>(INTERNAL_PAGE_SIZE));
+      auto depth = static_cast<size_t>(std::max(read_ahead_pages.load(), 0));
+      for (int i = index + 1; i < size && following->size() < depth; i++) {
+        following->push_back(internal->ValueAt(i));
+      }
+    }
+    NodeHandle child;
+    if (auto step = FetchChild(node, child_id, &child); step != Step::DONE) {
+      return step;
+    }
+    node = std::move(child);
+  }
+  *leaf = std::move(node);
+  return Step::DONE;
 }
 
 /*****************************************************************************
@@ -92,180 +302,415 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-	if(root_page_id_==INVALID_PAGE_ID){
-		Page *page_=buffer_pool_manager_->NewPgImp(&root_Page_id_);
-		LeafPage *page_leaf=reinterpret_cast<LeafPage*>(page_->GetData());
-		page_leaf->Init(root_page_id_,INVALID_PAGE_ID,leaf_max_size_);
-		page_leaf->SetNextPageId(INVALID_PAGE_ID);
-		MappingType *array=page_leaf->GetArray();
-		page_leaf->array[0]=std::make_pair(key,value);
-		page_leaf->IncreaseSize(1);
-		buffer_pool_manager_->UnpinPgImp(root_page_id_,true);
-		return true;
-	}
-	std::vector<int>index_pos;
-	Page *page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-	InternalPage *page_internal ; LeafPage *page_leaf;
-	Mapping *array,*array_2;//=page_leaf->GetArray();
-        IndexPageType page_type;
-	memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-     	int l,r,mid;//array_[0].first is invalid
-        while(page_type==INTERNAL_PAGE){
-		page_internal=reinterpret_cast<InternalPage*>(page->GetData());
-                l=1; r=page_internal->GetSize(); mid=0;
-                while(l<=r){
-                	mid=l+(r+1-l)/2;//the root of (l+r)/2
-                        if(comparator(key , page_internal->KeyAt(mid)) < 0){//key<KeyAt(mid)
-                        	r=mid-1;
-                        }else if(comparator(page_internal->KeyAt(mid) , key) <0){
-                 		l=mid+1;
-                        }else{
-				r=mid;
-                        	break;
-              		}
-                }
-		index_pos.emplace_back(r);
-		page=bufffer_pool_manager_->FetchPgImp(page_internal->ValueAt(r));
-       		memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-       	}
-	page_leaf=reinterpret_cast<LeafPage*>(page->GetData());
-        l=0; l=page_leaf->GetSize()-1; mid=0;
-        while(l<=r){
-               	mid=l+(r+1-l)/2;
-               	if(comparator(key , page_leaf->KeyAt(mid))<0){
-                       	r=mid-1;
-               	}else if(comparator(page_leaf->KeyAt(mid) , key)<0){
-                       	l=mid+1;
-		}else{
-			break;
-		}
-	}//l;
-	if(l<=r){ return false; }//duplicate
-
-	array=page_leaf->GetArray();
-	for(int k=page_leaf.GetSize()-1; k>=l; k--){
-		array[k+1]=array[k];
-	}
-	array[l]=std::make_pair(key,value);
-	page_leaf->IncreaseSize(1);
-	page_id_t curr_id,parent_id;
-	if(page_leaf->GetSize()<page_leaf->GetMaxSize()){
-		curr_id=page_leaf->GetPageId() ; parent_id=page_leaf->GetParentId();
-		while(parent_id!=INVALID_PAGE_ID){
-			buffer_pool_manager_->unpinPgImp(curr_id,true);
-			curr_id=parent_id;
-			page=buffer_pool_manager_->FetchPgImp(curr_id);
-			page_internal=reinterpret_cast<InternalPage*>(page->GetData());
-			parent_id=page_internal->GetParentId();
-		}
-		return true;
-	}
-//--------------------------overflow--------------------------------------------------------------------
-	LeafPage *leaf_split;
-	Page *page_split;
-	page_id_t old_split_id;
-	curr_id=page_leaf->GetPageId() ; parent_id=page_leaf->GetParentId();
-		
-	page_split=buffer_pool_manager_->NewPgImp(&old_split_id);
-	leaf_split=reinterpret_cast<LeafPage*>(page_split->GetData());
-        leaf_split->Init(old_split_id,parent_id,leaf_max_size_);
-
-        leaf_split->SetNextPageId(page_leaf->GetNextPageId);
-	page_leaf->SetNextPageId(old_split_id);
-
-	KeyType key_overflow=page_leaf->KeyAt((leaf_max_size_)/2);//overflow
-	memcpy(leaf_split->GetArray(),page_leaf->GetArray()+(leaf_max_size_)/2,sizeof(MappingType)*((leaf_max_size_+1)/2));
-	page_leaf->SetSize((leaf_max_size_)/2);
-	leaf_split->SetSize((leaf_max_size_+1)/2);
-		//Note:memset(page_leaf->GetArray()+(leaf_max_size_)/2,0,sizeof(MappingType)*(leaf_max_size_+1)/2);
-		
-	buffer_pool_manager_->UnpinPgImp(old_splid_id,true);
-	buffer_pool_manager_->UnpinPgImp(curr_id,true);
-
-	int pos;
-	curr_id=page_leaf->GetPageId(); parent_id=page_internal->GetParentPageId();
-	//std::pair(key_flow,_old_split_id);
-	while(1){//parent_id!=INVALID_PAGE_ID){
-		pos=index_pos.back();
-		index_pos.pop_back();
-		page=buffer_pool_manager_->FetchPgImp(parent_id);
-		page_internal=reinterpret_cast<InternalPage*>(page->GetData());
-		curr_id=page_internal->GetPageId(); parent_id=page_internal->GetParentPageId();
-
-		if((int k=page_internal->GetSize())  <  internal_max_size_){
-			array=Page_internal->GetArray();
-                	for(k;k>pos;k--){
-                        	array[k+1]=array[k];
-                	}
-                	array[pos+1]=std::make_pair(key_overflow,old_split_id);
-                        page_internal->IncreaseSize(1);
-
-			while(parent_id!=INVALID_PAGE_ID){
-					buffer_pool_manager_->UnpinPgImp(curr_id,true);
-					curr_id=parent_id;
-					page=buffer_pool_manager_->FetchPgImp(curr_id);
-					page_internal=reinterpret_cast<InternalPage*>(page->GetData());
-	                		parent_id=page_internal->GetParentId();
-			}
-			buffer_pool_manager_->UnpinPgImp(curr_id,true);
-			//break;
-			return true;
-		}
-		
-		InternalPage *internal_split;
-		page_id_t new_split_id;
-		page_split=buffer_pool_manager_->NewPgImp(&new_split_id);
-		internal_split=reinterpret_cast<InternalPage*>(page_split->GetData());
-		
-		internal_split->Init(new_split_id,parent_id,internal_max_size_);
-		
-		//key_overflow=page_internal->KeyAt((internal_max_size_+1)/2+1);
-		
-		array=page_intrenal->GetArray(); array_2=internal_split->GetArray();
-		
-		memcpy(array_2 , array[(internal_max_size_/2+1)],sizeof(MappingType)*((internal_max_size_+1)/2));
-		//key_overflow=array_2[0].first;
-		page_internal->SetSize(internal_max_size_/2);
-		internal_split->SetSize((internal_max_size_+1)/2);
-
-			
-		/*l=1;r=internal_insert->GetSize();
-		while(l<=r){
-                	mid=l+(r+1-l)/2;
-                	if(comparator(key , page_leaf->KeyAt(mid))<0){
-                        	r=mid-1;
-                	}else if(comparator(page_leaf->KeyAt(mid) , key)<0){
-                        	l=mid+1;
-                	}else{
-                        	break;
-                	}
-        	}//l;
-		array=internal_insert->GetArray();
-		for(int k=internal_insert->GetSize();k>=l;k--){
-			array[k+1]=array[k];
-		}
-		array[l]=std::make_pair(Key_overflow,old_split_id);*/
-
-		if(pos<=(internal_max_size_/2+1)){ InsertIntoInternal_pos(page_internal,key_flow,old_split_id);}
-		else{ InsertIntoInternal_pos(internal_split,key_flow,old_split_id);}
-
-		key_overflow=array_2[0].first;
-		//parent_id=page_internal->GetParentPageId();
-                buffer_pool_manager_->UnpinPgImp(curr_id,true);
-                buffer_pool_manager_->UnpinPgImp(new_split_id,true);
-                old_split_id=new_split_id;
-
-		if(curr_id=root_page_id_){
-			//old_split_id=new_split_id;
-                        page_split=buffer_pool_manager_->NewPgImp(&new_split_id);
-                	internal_split=reinterpret_cast<InternalPage*>(page_split->GetData());
-			array=internal_split->GetArray();
-			array[0].second=curr_id;
-			array[1]=std::make_pair(key_overflow,old_split_id);
-			buffer_pool_manager_->UnpinPgImp(new_split_id,true);
-
-                }
-	return true;
+  page_id_t split_hint = INVALID_PAGE_ID;
+  while (true) {
+    {
+      auto guard = reclaimer_.Enter();
+      bool inserted = false;
+      if (auto step = TryInsert(key, value, &split_hint, &inserted); step != Step::RETRY) {
+        return step == Step::DONE && inserted;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryInsert(const KeyType &key, const ValueType &value, page_id_t *split_hint, bool *inserted)
+    -> Step {
+  NodeHandle parent;
+  NodeHandle node;
+  if (auto step = FetchRoot(&node); step != Step::DONE) {
+    return step;
+  }
+  if (!node.Valid()) {
+    auto step = StartNewTree(key, value);
+    *inserted = step == Step::DONE;
+    return step;
+  }
+  int index_in_parent = 0;
+  while (!node.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = node.template As<InternalPage>();
+    // Split on the way down, so that the parent of the leaf always has room for one more child, at least by count.
+    // A page that ran out of bytes for a separator instead is split by the attempt after the one that found out.
+    if (internal->GetSize() >= internal_max_size_ || (node.PageId() == *split_hint && internal->GetSize() >= 2)) {
+      if (auto step = SplitInternal(&parent, &node, index_in_parent, key, split_hint); step != Step::DONE) {
+        return step;
+      }
+      internal = node.template As<InternalPage>();
+    }
+    int index = internal->Lookup(key, comparator_);
+    NodeHandle child;
+    if (auto step = FetchChild(node, internal->ValueAt(index), &child); step != Step::DONE) {
+      return step;
+    }
+    parent = std::move(node);
+    node = std::move(child);
+    index_in_parent = index;
+  }
+
+  auto *leaf = node.template As<LeafPage>();
+  int size = leaf->GetSize();
+  int index = leaf->KeyIndex(key, comparator_);
+  bool duplicate = index < size && comparator_(leaf->KeyAt(index), key) == 0;
+  if (!node.Validate()) {
+    return Step::RETRY;
+  }
+  if (duplicate) {
+    *inserted = false;
+    return Step::DONE;
+  }
+  if (size + 1 < leaf_max_size_ && leaf->HasRoomFor({key})) {
+    if (!node.Upgrade()) {
+      return Step::RETRY;
+    }
+    leaf->InsertAt(index, key, value);
+    *inserted = true;
+    return Step::DONE;
+  }
+  auto step = SplitLeaf(&parent, &node, index_in_parent, index, key, value, split_hint);
+  *inserted = step == Step::DONE;
+  return step;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) -> Step {
+  std::scoped_lock lock(root_latch_);
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    return Step::RETRY;
+  }
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->InsertAt(0, key, value);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return Step::DONE;
+}
+
+/*
+ * Split a full internal page into itself and a new right sibling. New pages
+ * are allocated before any latch is taken, and are unreachable until the
+ * parent (or, for the root, the root page id) points to them. Unless the
+ * root was split, node ends up as the latched half that covers key.
+ *
+ * The split point is the one near the middle with the shortest separator.
+ * If the parent has no room left for it, split_hint names the parent and
+ * nothing changes.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitInternal(NodeHandle *parent, NodeHandle *node, int index_in_parent, const KeyType &key,
+                                   page_id_t *split_hint) -> Step {
+  page_id_t sibling_id;
+  Page *sibling_page = buffer_pool_manager_->NewPage(&sibling_id);
+  if (sibling_page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  page_id_t root_id = INVALID_PAGE_ID;
+  Page *root_page = nullptr;
+  if (!parent->Valid() && (root_page = buffer_pool_manager_->NewPage(&root_id)) == nullptr) {
+    DiscardPage(sibling_id);
+    return Step::NO_FRAME;
+  }
+  auto discard_new_pages = [&]() {
+    DiscardPage(sibling_id);
+    if (root_page != nullptr) {
+      DiscardPage(root_id);
+    }
+  };
+  if ((parent->Valid() && !parent->Upgrade()) || !node->Upgrade()) {
+    discard_new_pages();
+    return Step::RETRY;
+  }
+  auto *internal = node->template As<InternalPage>();
+  auto items = internal->GetItems();
+  int size = static_cast<int>(items.size());
+  int split = InternalPage::PickSplit(items, (size + 1) / 2, internal->GetMinSize());
+  if (split == -1 || (parent->Valid() && !parent->template As<InternalPage>()->HasRoomFor({items[split].first}))) {
+    if (split != -1) {
+      *split_hint = parent->PageId();
+    }
+    discard_new_pages();
+    return Step::RETRY;
+  }
+  *split_hint = INVALID_PAGE_ID;
+  auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+  sibling->Init(sibling_id, parent->Valid() ? parent->PageId() : root_id, internal_max_size_);
+  internal->SetItems(items.data(), split);
+  sibling->SetItems(items.data() + split, size - split);
+  if (root_page != nullptr) {
+    auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+    root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(node->PageId(), sibling->KeyAt(0), sibling_id);
+    buffer_pool_manager_->UnpinPage(root_id, true);
+    SetRootPageId(root_id);
+    buffer_pool_manager_->UnpinPage(sibling_id, true);
+    return Step::RETRY;
+  }
+  parent->template As<InternalPage>()->InsertAt(index_in_parent + 1, sibling->KeyAt(0), sibling_id);
+  if (comparator_(key, sibling->KeyAt(0)) >= 0) {
+    // The parent is still latched, so nobody else can have reached the new page yet.
+    NodeHandle sibling_node(buffer_pool_manager_, sibling_page, 0);
+    sibling_node.Latch();
+    *node = std::move(sibling_node);
+  } else {
+    buffer_pool_manager_->UnpinPage(sibling_id, true);
+  }
+  return Step::DONE;
+}
+
+/*
+ * Split a full leaf the same way, inserting key on the side it belongs to.
+ * Keys that pack very differently can leave no split with room for key on
+ * either side; then the leaf is split without it, and false has the insert
+ * start over.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitLeaf(NodeHandle *parent, NodeHandle *node, int index_in_parent, int index,
+                               const KeyType &key, const ValueType &value, page_id_t *split_hint) -> Step {
+  page_id_t sibling_id;
+  Page *sibling_page = buffer_pool_manager_->NewPage(&sibling_id);
+  if (sibling_page == nullptr) {
+    return Step::NO_FRAME;
+  }
+  page_id_t root_id = INVALID_PAGE_ID;
+  Page *root_page = nullptr;
+  if (!parent->Valid() && (root_page = buffer_pool_manager_->NewPage(&root_id)) == nullptr) {
+    DiscardPage(sibling_id);
+    return Step::NO_FRAME;
+  }
+  auto discard_new_pages = [&]() {
+    DiscardPage(sibling_id);
+    if (root_page != nullptr) {
+      DiscardPage(root_id);
+    }
+  };
+  if ((parent->Valid() && !parent->Upgrade()) || !node->Upgrade()) {
+    discard_new_pages();
+    return Step::RETRY;
+  }
+  auto *leaf = node->template As<LeafPage>();
+  auto items = leaf->GetItems();
+  items.emplace(items.begin() + index, key, value);
+  int split = LeafPage::PickSplit(items, static_cast<int>(items.size()) / 2, leaf->GetMinSize());
+  bool inserted = split != -1;
+  if (!inserted) {
+    items.erase(items.begin() + index);
+    split = LeafPage::PickSplit(items, static_cast<int>(items.size()) / 2, leaf->GetMinSize());
+  }
+  if (split == -1 || (parent->Valid() && !parent->template As<InternalPage>()->HasRoomFor({items[split].first}))) {
+    if (split != -1) {
+      *split_hint = parent->PageId();
+    }
+    discard_new_pages();
+    return Step::RETRY;
+  }
+  *split_hint = INVALID_PAGE_ID;
+  int size = static_cast<int>(items.size());
+  auto *sibling = reinterpret_cast<LeafPage *>(sibling_page->GetData());
+  sibling->Init(sibling_id, parent->Valid() ? parent->PageId() : root_id, leaf_max_size_);
+  leaf->SetItems(items.data(), split);
+  sibling->SetItems(items.data() + split, size - split);
+  sibling->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(sibling_id);
+  if (root_page != nullptr) {
+    auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+    root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(node->PageId(), sibling->KeyAt(0), sibling_id);
+    buffer_pool_manager_->UnpinPage(root_id, true);
+    SetRootPageId(root_id);
+  } else {
+    parent->template As<InternalPage>()->InsertAt(index_in_parent + 1, sibling->KeyAt(0), sibling_id);
+  }
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+  return inserted ? Step::DONE : Step::RETRY;
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the whole tree bottom-up instead of inserting entries one by one:
+ * write the leaves left to right, then build every internal level from the
+ * first keys and page ids of the level below, until one page is left for the
+ * root. Pages are filled to bulk_load_fill_percent of their capacity. Of
+ * several entries with the same key only the first one is kept, as Insert
+ * would.
+ * @return : false if the tree is not empty or the buffer pool ran out of
+ * frames; the tree is left unchanged in that case
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction)
+    -> bool {
+  auto less = [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; };
+  if (!std::is_sorted(entries->begin(), entries->end(), less)) {
+    std::stable_sort(entries->begin(), entries->end(), less);
+  }
+  auto same_key = [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; };
+  entries->erase(std::unique(entries->begin(), entries->end(), same_key), entries->end());
+
+  // Holding the root latch keeps concurrent inserts from starting a tree of their own in the meantime. Everything
+  // else sees an empty tree until the root page id is set.
+  std::scoped_lock lock(root_latch_);
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  if (entries->empty()) {
+    return true;
+  }
+  int fill_percent = std::clamp(bulk_load_fill_percent.load(), 1, 100);
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  std::vector<page_id_t> built;
+  bool ok = BuildLeaves(*entries, fill_percent, &level, &built);
+  while (ok && level.size() > 1) {
+    ok = BuildInternalLevel(&level, fill_percent, &built);
+  }
+  if (!ok) {
+    for (page_id_t page_id : built) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    return false;
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  return true;
+}
+
+/*
+ * Fill the leaves left to right. A leaf is closed once it holds the target
+ * number of entries or fill_percent of its bytes, but never before it could
+ * lose an entry without dropping below its minimum. The last leaf, which
+ * gets whatever is left, is merged into or balanced with the one before.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BuildLeaves(const std::vector<std::pair<KeyType, ValueType>> &entries, int fill_percent,
+                                 std::vector<std::pair<KeyType, page_id_t>> *level, std::vector<page_id_t> *built)
+    -> bool {
+  // Inserts split a leaf when it reaches leaf_max_size_, so a leaf holds one entry less than that.
+  int target = std::max(((leaf_max_size_ - 1) * fill_percent + 99) / 100, 1);
+  Page *prev_page = nullptr;
+  Page *page = nullptr;
+  auto unpin = [this](Page *pinned) {
+    if (pinned != nullptr) {
+      buffer_pool_manager_->UnpinPage(pinned->GetPageId(), true);
+    }
+  };
+  LeafPage *leaf = nullptr;
+  for (const auto &[key, value] : entries) {
+    if (leaf == nullptr || leaf->GetSize() + 1 >= leaf_max_size_ || !leaf->HasRoomFor({key}) ||
+        (leaf->CanSpareEntry() && (leaf->GetSize() >= target || !leaf->HasRoomFor({key}, 1, fill_percent)))) {
+      page_id_t page_id;
+      Page *next_page = buffer_pool_manager_->NewPage(&page_id);
+      if (next_page == nullptr) {
+        unpin(prev_page);
+        unpin(page);
+        return false;
+      }
+      built->push_back(page_id);
+      level->emplace_back(key, page_id);
+      if (leaf != nullptr) {
+        leaf->SetNextPageId(page_id);
+      }
+      unpin(prev_page);
+      prev_page = std::exchange(page, next_page);
+      leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    }
+    leaf->InsertAt(leaf->GetSize(), key, value);
+  }
+  if (prev_page != nullptr && !leaf->CanSpareEntry()) {
+    auto *prev = reinterpret_cast<LeafPage *>(prev_page->GetData());
+    if (prev->GetSize() + leaf->GetSize() < leaf_max_size_ && prev->HasRoomForAllOf(*leaf)) {
+      leaf->MoveAllTo(prev);
+      unpin(page);
+      buffer_pool_manager_->DeletePage(built->back());
+      built->pop_back();
+      level->pop_back();
+      page = nullptr;
+    } else {
+      auto items = prev->GetItems();
+      auto last_items = leaf->GetItems();
+      items.insert(items.end(), last_items.begin(), last_items.end());
+      int size = static_cast<int>(items.size());
+      int split = LeafPage::PickSplit(items, size / 2, leaf->GetMinSize());
+      prev->SetItems(items.data(), split);
+      leaf->SetItems(items.data() + split, size - split);
+      level->back().first = items[split].first;
+    }
+  }
+  unpin(prev_page);
+  unpin(page);
+  return true;
+}
+
+/*
+ * Replace level by the level of internal pages above it, filled the same way
+ * as the leaves.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BuildInternalLevel(std::vector<std::pair<KeyType, page_id_t>> *level, int fill_percent,
+                                        std::vector<page_id_t> *built) -> bool {
+  int target = std::max((internal_max_size_ * fill_percent + 99) / 100, 2);
+  std::vector<std::pair<KeyType, page_id_t>> parents;
+  Page *prev_page = nullptr;
+  Page *page = nullptr;
+  auto unpin = [this](Page *pinned) {
+    if (pinned != nullptr) {
+      buffer_pool_manager_->UnpinPage(pinned->GetPageId(), true);
+    }
+  };
+  InternalPage *internal = nullptr;
+  for (const auto &[key, child_id] : *level) {
+    if (internal == nullptr || internal->GetSize() >= internal_max_size_ || !internal->HasRoomFor({key}) ||
+        (internal->GetSize() >= 2 && internal->CanSpareEntry() &&
+         (internal->GetSize() >= target || !internal->HasRoomFor({key}, 1, fill_percent)))) {
+      page_id_t page_id;
+      Page *next_page = buffer_pool_manager_->NewPage(&page_id);
+      if (next_page == nullptr) {
+        unpin(prev_page);
+        unpin(page);
+        return false;
+      }
+      built->push_back(page_id);
+      parents.emplace_back(key, page_id);
+      unpin(prev_page);
+      prev_page = std::exchange(page, next_page);
+      internal = reinterpret_cast<InternalPage *>(page->GetData());
+      internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    }
+    // The first key goes into the unused first slot, the same way a split leaves it there.
+    internal->InsertAt(internal->GetSize(), key, child_id);
+  }
+  if (prev_page != nullptr && !internal->CanSpareEntry()) {
+    auto *prev = reinterpret_cast<InternalPage *>(prev_page->GetData());
+    const KeyType &middle_key = parents.back().first;
+    if (prev->GetSize() + internal->GetSize() <= internal_max_size_ && prev->HasRoomForAllOf(*internal, middle_key)) {
+      internal->MoveAllTo(prev, middle_key);
+      unpin(page);
+      buffer_pool_manager_->DeletePage(built->back());
+      built->pop_back();
+      parents.pop_back();
+      page = nullptr;
+    } else {
+      auto items = prev->GetItems();
+      auto last_items = internal->GetItems();
+      items.insert(items.end(), last_items.begin(), last_items.end());
+      int size = static_cast<int>(items.size());
+      int split = InternalPage::PickSplit(items, (size + 1) / 2, internal->GetMinSize());
+      prev->SetItems(items.data(), split);
+      internal->SetItems(items.data() + split, size - split);
+      parents.back().first = items[split].first;
+    }
+  }
+  unpin(prev_page);
+  unpin(page);
+  *level = std::move(parents);
+  return true;
 }
 
 /*****************************************************************************
@@ -280,119 +725,234 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-	if(root_page_id_==INVALID_PAGE_ID){ return; }
-	Page *page;
-	InternalPage *page_internal;
-	LeafPage *page_leaf;
-	page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-	IndexPageType page_type;
-	memcpy(page_type,page->GetData());
-	int l,r,mid;
-	std::vector<int>index_pos;
-	while(page_type==INTERNAL_PAGE){
-		page_internal=reinterpret_cast<InternalPage*>(page->GetData());
-		l=1; r=page_internal->GetSize()-1; mid=0;
-                while(l<=r){
-                        mid=l+(r+1-l)/2;//the root of (l+r)/2
-                        if(comparator(key , page_internal->KeyAt(mid)) < 0){//key<KeyAt(mid)
-                                r=mid-1;
-                        }else if(comparator(page_internal->KeyAt(mid) , key) <0){
-                                l=mid+1;
-                        }else{
-                                r=mid;
-                                break;
-                        }
-                }
-                index_pos.emplace_back(r);
-                page=bufffer_pool_manager_->FetchPgImp(page_internal->ValueAt(r));
-                memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-	}
-	page_leaf=reinterpret_cast<LeafPage*>(page->GetData());
-	l=0; l=page_leaf->GetSize()-1; mid=0;
-        while(l<=r){
-		mid=l+(r+1-l)/2;
-                if(comparator(key , page_leaf->KeyAt(mid))<0){
-                	r=mid-1;
-                }else if(comparator(page_leaf->KeyAt(mid) , key)<0){
-                        l=mid+1;
-                }else{
-                                //r=mid;
-                        break;
-		}
-	}
-	if(l<=r){
-		MappingType *array=page_leaf->GetArray();
-		for(int k=mid;k<page_leaf->GetSize()-1;k++){
-			array[k]=array[k+1];
-		}
-		page_leaf->IncreaseSize(-1);
-	}
-	if(page_leaf->GetSize()>=((leaf_max_size_+0)/2)) { return; }
-	int pos=index_pos.back();
-	index_pos.pop_back();
-		//1
-	Page *page_bro,*page_par;
-	InternalPage *internal_par,*internal_bro;
-	LeafPage *leaf_bro;
-	MappingType *array_bro,*array_curr;
-	page_id_t curr_id=page_leaf->GetPageId() , par_id=page_leaf->GetParentId() , bro_id;
-	//if(0<pos)
-	page_par=buffer_pool_manager_->FetchPgImp(par_id); internal_par=page_par->GetData();
-	if(0<pos){	
-		page_bro=buffer_pool_manager_->FetchPgImp(internal_par->ValueAt(pos-1)); leaf_bro=page_bro->GetData();
-	       	//bro_page_id=leaf_bro->GetPageId();
-		if(leaf_bro->GetSize()>leaf_bro->GetMinSize()){
-			array_curr=page_leaf->GetArray();array_bro=leaf_bro->GetArray();
-			for(int k=page_leaf->GetSize()-1;k>1;k--){
-				array_curr[k+1]=array_curr[k];
-			}
-			array_curr[1]=array_bro[leaf_bro->GetSize()-1];
-			leaf_bro->IncreaseSize(-1);
-			page_leaf->IncreaseSize(1);
-			return;
-			//leaf_bro->GetArray()[]=leaf_bro->GetArray()[leaf_bro->Getsize()-1];
-		}
-	}
-	//if(0<pos){
-	//	page_parent=
-	//	page_bro=buffer_pool_manager_->FetchPgImp(page);}
-	//2
-	if(pos<page_leaf->GetMaxSize()-1){
-		page_bro=buffer_pool_manager_->FetchPgImp(internal_par->ValueAt(pos+1));leaf_pro=page_bro->GetData();
-		if(leaf_bro->GetSize()>leaf_bro->GetMinSize()){
-			array_curr=page_leaf->GetArray() ; array_bro=leaf_bro->GetArray();
-			//for(int k=page_leaf->GetSize()-1 ; k>1 ; k--){
-			//	array_curr[k+1]=array_curr[k];
-			//}
-			array_curr[page_leaf->GetSize()]=array_bro[1];
-			for(int k=1 ; k<leaf_bro->GetSize()-1 ; k++){
-				array_bro[k]=array_bro[k+1];
-			}
-			leaf_bro->IncreaseSize(-1);
-			page_leaf->IncreaseSize(1);
-			return;
-		}
-	}
-	//3 merge
-	if(0<r){
-		page_bro=buffer_pool_manager_->FetchPgImp(internal_par->ValueAt(pos-1)) ; leaf_pro=page_bro->GetData();
-		array_curr=page_leaf->GetArray() ; array_bro=leaf_bro->GetArray();
-		memcpy(array_bro[page_bro->Getsize()],array_curr,sizeof(MappingType)*(page_leaf->GetSize()));
-		array_curr=internal_par->GetArray();
-		for(int k=pos;k<internal_par->GetSize();k++){
-			array_curr[k]=array_curr[k+1];
-		}	
-	}else{
-		page_bro=buffer_pool_manager_->FetchPgImp(internal_par->ValueAt(pos-1)) ; leaf_pro=page_bro->GetData();
-                array_curr=page_leaf->GetArray() ; array_bro=leaf_bro->GetArray();
-                memcpy(array_bro[page_bro->Getsize()],array_curr,sizeof(MappingType)*(page_leaf->GetSize()));
-                array_curr=internal_par->GetArray();
-                for(int k=pos;k<internal_par->GetSize();k++){
-                        array_curr[k]=array_curr[k+1];
-
-	        }
-	}
+  while (true) {
+    {
+      auto guard = reclaimer_.Enter();
+      if (TryRemove(key) != Step::RETRY) {
+        return;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryRemove(const KeyType &key) -> Step {
+  NodeHandle parent;
+  NodeHandle node;
+  if (auto step = FetchRoot(&node); step != Step::DONE) {
+    return step;
+  }
+  if (!node.Valid()) {
+    return Step::DONE;
+  }
+  int index_in_parent = 0;
+  while (!node.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = node.template As<InternalPage>();
+    // Fix pages at their minimum on the way down, so that the parent of the leaf can always lose one child.
+    if (!parent.Valid() && internal->GetSize() == 1) {
+      CollapseRoot(&node);
+      return Step::RETRY;
+    }
+    if (parent.Valid() && !internal->CanSpareEntry()) {
+      // Keep going down from the fixed page rather than start over, or two removes on sibling pages can take the
+      // same child back and forth between them forever.
+      if (auto step = RebalanceInternal(&parent, &node, index_in_parent); step != Step::DONE) {
+        return step;
+      }
+      internal = node.template As<InternalPage>();
+    }
+    int index = internal->Lookup(key, comparator_);
+    NodeHandle child;
+    if (auto step = FetchChild(node, internal->ValueAt(index), &child); step != Step::DONE) {
+      return step;
+    }
+    parent = std::move(node);
+    node = std::move(child);
+    index_in_parent = index;
+  }
+
+  auto *leaf = node.template As<LeafPage>();
+  int size = leaf->GetSize();
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found = index < size && comparator_(leaf->KeyAt(index), key) == 0;
+  if (!node.Validate()) {
+    return Step::RETRY;
+  }
+  if (!found) {
+    return Step::DONE;
+  }
+  if (parent.Valid() && !leaf->CanSpareEntry()) {
+    return RebalanceLeaf(&parent, &node, index_in_parent, index);
+  }
+  if (!node.Upgrade()) {
+    return Step::RETRY;
+  }
+  leaf->RemoveAt(index);
+  if (!parent.Valid() && leaf->GetSize() == 0) {
+    SetRootPageId(INVALID_PAGE_ID);
+    reclaimer_.Retire(node.PageId());
+  }
+  return Step::DONE;
+}
+
+/*
+ * The root has a single child left: make the child the root
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollapseRoot(NodeHandle *root) {
+  if (!root->Upgrade()) {
+    return;
+  }
+  SetRootPageId(root->template As<InternalPage>()->ValueAt(0));
+  reclaimer_.Retire(root->PageId());
 }
+
+/*
+ * Latch the parent, then the two siblings left to right, and either merge
+ * the right one into the left one or move one entry over to the page that is
+ * short. Either way node is the latched page that now holds its children.
+ * If the keys leave no room for either (or the parent has no other child),
+ * the page stays below its minimum for now.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RebalanceInternal(NodeHandle *parent, NodeHandle *node, int index_in_parent) -> Step {
+  if (!parent->Upgrade()) {
+    return Step::RETRY;
+  }
+  auto *parent_page = parent->template As<InternalPage>();
+  if (parent_page->GetSize() < 2) {
+    return node->Upgrade() ? Step::DONE : Step::RETRY;
+  }
+  NodeHandle left;
+  NodeHandle right;
+  bool node_is_left = index_in_parent == 0;
+  if (node_is_left) {
+    if (!node->Upgrade()) {
+      return Step::RETRY;
+    }
+    if (auto step = FetchLatched(parent_page->ValueAt(1), &right); step != Step::DONE) {
+      return step;
+    }
+    left = std::move(*node);
+  } else {
+    if (auto step = FetchLatched(parent_page->ValueAt(index_in_parent - 1), &left); step != Step::DONE) {
+      return step;
+    }
+    if (!node->Upgrade()) {
+      return Step::RETRY;
+    }
+    right = std::move(*node);
+  }
+  int right_index = node_is_left ? 1 : index_in_parent;
+  auto *left_page = left.template As<InternalPage>();
+  auto *right_page = right.template As<InternalPage>();
+  KeyType middle_key = parent_page->KeyAt(right_index);
+  if (left_page->GetSize() + right_page->GetSize() <= internal_max_size_ &&
+      left_page->HasRoomForAllOf(*right_page, middle_key)) {
+    right_page->MoveAllTo(left_page, middle_key);
+    parent_page->RemoveAt(right_index);
+    reclaimer_.Retire(right.PageId());
+    *node = std::move(left);
+    return Step::DONE;
+  }
+  if (node_is_left) {
+    if (right_page->GetSize() >= 2 && left_page->HasRoomFor({middle_key}) &&
+        parent_page->HasRoomFor({right_page->KeyAt(1)}, 0)) {
+      right_page->MoveFirstToEndOf(left_page, middle_key);
+      parent_page->SetKeyAt(right_index, right_page->KeyAt(0));
+    }
+    *node = std::move(left);
+  } else {
+    KeyType last_key = left_page->KeyAt(left_page->GetSize() - 1);
+    if (left_page->GetSize() >= 2 && right_page->HasRoomFor({middle_key, last_key}) &&
+        parent_page->HasRoomFor({last_key}, 0)) {
+      left_page->MoveLastToFrontOf(right_page, middle_key);
+      parent_page->SetKeyAt(right_index, right_page->KeyAt(0));
+    }
+    *node = std::move(right);
+  }
+  return Step::DONE;
+}
+
+/*
+ * Same as RebalanceInternal, for a leaf that would drop below its minimum
+ * size once the entry at index is gone
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RebalanceLeaf(NodeHandle *parent, NodeHandle *node, int index_in_parent, int index) -> Step {
+  if (!parent->Upgrade()) {
+    return Step::RETRY;
+  }
+  auto *parent_page = parent->template As<InternalPage>();
+  if (parent_page->GetSize() < 2) {
+    if (!node->Upgrade()) {
+      return Step::RETRY;
+    }
+    node->template As<LeafPage>()->RemoveAt(index);
+    return Step::DONE;
+  }
+  NodeHandle left;
+  NodeHandle right;
+  bool node_is_left = index_in_parent == 0;
+  if (node_is_left) {
+    if (!node->Upgrade()) {
+      return Step::RETRY;
+    }
+    if (auto step = FetchLatched(parent_page->ValueAt(1), &right); step != Step::DONE) {
+      return step;
+    }
+    left = std::move(*node);
+  } else {
+    if (auto step = FetchLatched(parent_page->ValueAt(index_in_parent - 1), &left); step != Step::DONE) {
+      return step;
+    }
+    if (!node->Upgrade()) {
+      return Step::RETRY;
+    }
+    right = std::move(*node);
+  }
+  int right_index = node_is_left ? 1 : index_in_parent;
+  auto *left_page = left.template As<LeafPage>();
+  auto *right_page = right.template As<LeafPage>();
+  (node_is_left ? left_page : right_page)->RemoveAt(index);
+  if (left_page->GetSize() + right_page->GetSize() < leaf_max_size_ && left_page->HasRoomForAllOf(*right_page)) {
+    right_page->MoveAllTo(left_page);
+    parent_page->RemoveAt(right_index);
+    reclaimer_.Retire(right.PageId());
+  } else if (node_is_left) {
+    if (right_page->GetSize() >= 2 && left_page->HasRoomFor({right_page->KeyAt(0)}) &&
+        parent_page->HasRoomFor({right_page->KeyAt(1)}, 0)) {
+      right_page->MoveFirstToEndOf(left_page);
+      parent_page->SetKeyAt(right_index, right_page->KeyAt(0));
+    }
+  } else {
+    KeyType last_key = left_page->KeyAt(left_page->GetSize() - 1);
+    if (left_page->GetSize() >= 2 && right_page->HasRoomFor({last_key}) &&
+        parent_page->HasRoomFor({last_key}, 0)) {
+      left_page->MoveLastToFrontOf(right_page);
+      parent_page->SetKeyAt(right_index, right_page->KeyAt(0));
+    }
+  }
+  return Step::DONE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetRootPageId(page_id_t root_page_id) {
+  std::scoped_lock lock(root_latch_);
+  root_page_id_ = root_page_id;
+  UpdateRootPageId();
+}
+
+/*
+ * Give back a page that was allocated for a split that did not happen
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DiscardPage(page_id_t page_id) {
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -403,29 +963,10 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-	if(root_page_id_==INVALID_PAGE_ID)
-		return INDEXITERATOR_TYPE(buffer_pool_manager_,nullptr,INVALID_PAGE_ID,0,0);
-
-	Pages *page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-	page_id_t curr_id;
-	InternalPage *internal ; LeafPage *leaf ;
-	IndexPageType page_type;
-        memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-	while(page_type==INTERNAL_PAGE){
-		internal=reinterpret_cast<InternalPage*>(page->GetData());
-		curr_id=internal->GetPageId();
-		page=buffer_Pool_manager_->FetchPgImp(internal->ValueAt(0));
-		buffer_pool_manager_->UnpinPgImp(curr_id,false);
-                memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-	}
-	leaf=reinterpret_cast<LeafPage*>(page->GetData());
-	curr_id=leaf->GetPageId();
-	MappingType *KeyValue=&leaf->ValueAt(1);
-	page_id_t next_page_id=leaf->GetNextPageId();
-	int curr_max_index=page_leaf->GetSize()-1;
-
-	buffer_pool_manager_->UnpinPgImp(curr_id,false);	
-	return INDEXITERATOR_TYPE(buffer_pool_manager_,KeyValue,next_page_id,0,curr_max_index); }
+  INDEXITERATOR_TYPE iterator;
+  Seek(&iterator, nullptr, false);
+  return iterator;
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -434,31 +975,9 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-	if(root_page_id_==INVALID_PAGE_ID)
-                return INDEXITERATOR_TYPE(buffer_pool_manager_,nullptr,INVALID_PAGE_ID,0,0);
-
-        Pages *index_page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-        page_id_t page_id;
-        IndexPageType page_type;
-        memset(page_type,0,sizeof(IndexPageType));
-        memcpy(page_type,page_data,sizeof(IndexPageType));
-        InternalPage page_internal;
-        memcpy(page_internal,page_data,BUSTUB_PAGE_SIZE);
-        while(page_type==INTERNAL_PAGE){
-                memcpy(page_internal,page_data,BUSTUB_PAGE_SIZE);
-                buffer_pool_manager_->UnpinPgImp();
-                buffer_Pool_manager_->FetchPgImp();
-                page_data=index_page->GetData();
-                memcpy(page_type,page_data,sizeof(IndexPageType));
-        }
-        LeafPage &page_leaf;
-        page_leaf=reinterpret_cast<LeafPage*>(page_data);
-        MappingType KeyValue=&page_leaf->array_[1];
-        page_id_t next_page_id=page_leaf->GetNextPageId();
-        int curr_max_size=page_leaf->GetSize();
-        return INDEXITERATOR_TYPE(buffer_pool_manager_,KeyValue,next_page_id,1,curr_max_size); 
-
-
+  INDEXITERATOR_TYPE iterator;
+  Seek(&iterator, &key, false);
+  return iterator;
 }
 
 /*
@@ -468,31 +987,130 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-	if(root_page_id_==INVALID_PAGE_ID)
-                return INDEXITERATOR_TYPE(buffer_pool_manager_,nullptr,INVALID_PAGE_ID,0,0);
-
-       // Pages *page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-        Pages *page=buffer_pool_manager_->FetchPgImp(root_page_id_);
-        page_id_t curr_id,next_id;
-        InternalPage *internal ; LeafPage *leaf ;
-        IndexPageType page_type;
-        memcpy(page_type,page->GetData(),sizeof(IndexPageType));
-        while(page_type==INTERNAL_PAGE){
-                internal=reinterpret_cast<InternalPage*>(page->GetData());
-                curr_id=internal->GetPageId();
-		next_id=internal->ValueAt(internal->GetMaxSize());
-
-                page=buffer_Pool_manager_->FetchPgImp(next_id);
-                buffer_pool_manager_->UnpinPgImp(curr_id,false);
-                memcpy(page_type,page->GetData(),sizeof(IndexPageType));
+  INDEXITERATOR_TYPE iterator;
+  iterator.tree_ = this;
+  return iterator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Seek(INDEXITERATOR_TYPE *iterator, const KeyType *key, bool after) {
+  iterator->Release();
+  iterator->tree_ = this;
+  while (true) {
+    {
+      auto guard = reclaimer_.Enter();
+      NodeHandle leaf;
+      std::vector<page_id_t> following;
+      auto step = FindLeaf(key, &leaf, read_ahead_pages.load() > 0 ? &following : nullptr);
+      if (step == Step::NO_FRAME) {
+        // Leave the iterator at the end.
+        return;
+      }
+      if (step == Step::DONE) {
+        if (!leaf.Valid()) {
+          return;
+        }
+        int index = 0;
+        if (key != nullptr) {
+          auto *page = leaf.template As<LeafPage>();
+          index = page->KeyIndex(*key, comparator_);
+          int size = std::clamp(page->GetSize(), 0, static_cast<int>(LEAF_PAGE_SIZE));
+          if (after && index < size && comparator_(page->KeyAt(index), *key) == 0) {
+            index++;
+          }
+        }
+        step = Settle(iterator, std::move(leaf), index);
+        if (step == Step::DONE) {
+          ReadAhead(iterator, following);
+        }
+        if (step != Step::RETRY) {
+          return;
         }
-        leaf=reinterpret_cast<LeafPage*>(page->GetData());
-	curr_id=leaf->GetPageId();
-	max_index=leaf->GetMaxSize()-1;
-        MappingType *KeyValue=&leaf->ValueAt(max_index);
-        page_id_t next_page_id=leaf->GetNextPageId();
-        int curr_max_index=page_leaf->GetSize()-1;
-        return INDEXITERATOR_TYPE(buffer_pool_manager_,KeyValue,next_page_id,curr_max_index+1,curr_max_index);
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Advance(INDEXITERATOR_TYPE *iterator) {
+  {
+    auto guard = reclaimer_.Enter();
+    NodeHandle leaf(buffer_pool_manager_, iterator->page_, iterator->version_);
+    iterator->page_ = nullptr;
+    page_id_t leaf_id = leaf.PageId();
+    if (Settle(iterator, std::move(leaf), iterator->index_ + 1) == Step::DONE) {
+      if (read_ahead_pages.load() <= 0 || iterator->page_ == nullptr) {
+        return;
+      }
+      // On reaching the last leaf that read-ahead asked for, or one it never covered, ask for the next batch.
+      page_id_t page_id = iterator->page_->GetPageId();
+      if (page_id != leaf_id &&
+          (iterator->read_ahead_end_ == INVALID_PAGE_ID || page_id == iterator->read_ahead_end_)) {
+        NodeHandle next_leaf;
+        std::vector<page_id_t> following;
+        if (FindLeaf(&iterator->item_.first, &next_leaf, &following) == Step::DONE && next_leaf.Valid() &&
+            next_leaf.Validate()) {
+          ReadAhead(iterator, following);
+        }
+      }
+      return;
+    }
+  }
+  // The leaf changed under the iterator, or the next one could not be pinned: find the first key after the one it
+  // returned last. If the buffer pool still has no frame for it, the iterator ends there.
+  KeyType last_key = iterator->item_.first;
+  Seek(iterator, &last_key, true);
+}
+
+/*
+ * Position the iterator at index in leaf, moving along the leaf chain while
+ * the index is past the end of a leaf
+ * @return RETRY if the leaf changed since it was read, NO_FRAME if the next
+ * leaf could not be pinned; nothing was done in either case
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Settle(INDEXITERATOR_TYPE *iterator, NodeHandle leaf, int index) -> Step {
+  while (true) {
+    auto *page = leaf.template As<LeafPage>();
+    int size = std::clamp(page->GetSize(), 0, static_cast<int>(LEAF_PAGE_SIZE));
+    if (index < size) {
+      MappingType item = page->GetItem(index);
+      if (!leaf.Validate()) {
+        return Step::RETRY;
+      }
+      iterator->item_ = item;
+      iterator->index_ = index;
+      iterator->version_ = leaf.Version();
+      iterator->page_ = leaf.Detach();
+      return Step::DONE;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    if (!leaf.Validate()) {
+      return Step::RETRY;
+    }
+    if (next_page_id == INVALID_PAGE_ID) {
+      return Step::DONE;
+    }
+    NodeHandle next;
+    if (auto step = FetchChild(leaf, next_page_id, &next); step != Step::DONE) {
+      return step;
+    }
+    leaf = std::move(next);
+    index = 0;
+  }
+}
+
+/*
+ * Prefetch the leaves after the iterator's leaf, so that a range scan does
+ * not stall on every leaf it moves to
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadAhead(INDEXITERATOR_TYPE *iterator, const std::vector<page_id_t> &following) {
+  iterator->read_ahead_end_ = following.empty() ? INVALID_PAGE_ID : following.back();
+  if (!following.empty()) {
+    buffer_pool_manager_->PrefetchPages(following);
+  }
 }
 
 /**
@@ -515,30 +1133,36 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  header_page->WLatch();
+  // A tree that became empty and then got a new root already has its record.
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
+  header_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
 /*
  * This method is used for test only
- * Read data from file and insert one by one
+ * Read data from file and bulk load it into an empty tree, or insert it one
+ * by one otherwise
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *transaction) {
   int64_t key;
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  while (input >> key) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
+    entries.emplace_back(index_key, rid);
+  }
+  if (IsEmpty() && BulkLoad(&entries, transaction)) {
+    return;
+  }
+  for (const auto &[index_key, rid] : entries) {
     Insert(index_key, rid, transaction);
   }
 }
@@ -625,12 +1249,6 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
       out << leaf_prefix << leaf->GetPageId() << " -> " << leaf_prefix << leaf->GetNextPageId() << ";\n";
       out << "{rank=same " << leaf_prefix << leaf->GetPageId() << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
     }
-
-    // Print parent links if there is a parent
-    if (leaf->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << leaf->GetParentPageId() << ":p" << leaf->GetPageId() << " -> " << leaf_prefix
-          << leaf->GetPageId() << ";\n";
-    }
   } else {
     auto *inner = reinterpret_cast<InternalPage *>(page);
     // Print node name
@@ -657,14 +1275,12 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
     out << "</TR>";
     // Print table end
     out << "</TABLE>>];\n";
-    // Print Parent link
-    if (inner->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << inner->GetParentPageId() << ":p" << inner->GetPageId() << " -> " << internal_prefix
-          << inner->GetPageId() << ";\n";
-    }
     // Print leaves
     for (int i = 0; i < inner->GetSize(); i++) {
       auto child_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i))->GetData());
+      // Print child link (pages do not keep their parent page id up to date)
+      out << internal_prefix << inner->GetPageId() << ":p" << inner->ValueAt(i) << " -> "
+          << (child_page->IsLeafPage() ? leaf_prefix : internal_prefix) << inner->ValueAt(i) << ";\n";
       ToGraph(child_page, bpm, out);
       if (i > 0) {
         auto sibling_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i - 1))->GetData());
@@ -691,8 +1307,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
-    std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
-              << " next: " << leaf->GetNextPageId() << std::endl;
+    std::cout << "Leaf Page: " << leaf->GetPageId() << " next: " << leaf->GetNextPageId() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
       std::cout << leaf->KeyAt(i) << ",";
     }
@@ -700,7 +1315,7 @@ void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const
     std::cout << std::endl;
   } else {
     auto *internal = reinterpret_cast<InternalPage *>(page);
-    std::cout << "Internal Page: " << internal->GetPageId() << " parent: " << internal->GetParentPageId() << std::endl;
+    std::cout << "Internal Page: " << internal->GetPageId() << std::endl;
     for (int i = 0; i < internal->GetSize(); i++) {
       std::cout << internal->KeyAt(i) << ": " << internal->ValueAt(i) << ",";
     }
@@ -718,5 +1333,6 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<VarlenKey<512>, RID, VarlenComparator<512>>;
 
 }  // namespace bustub
@@ -2,73 +2,88 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(const IndexIterator &other)
+    : tree_(other.tree_),
+      version_(other.version_),
+      index_(other.index_),
+      item_(other.item_),
+      read_ahead_end_(other.read_ahead_end_) {
+  if (other.page_ != nullptr) {
+    // The other iterator holds a pin, so this is a buffer pool hit on the same frame.
+    page_ = tree_->buffer_pool_manager_->FetchPage(other.page_->GetPageId());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : tree_(other.tree_),
+      page_(std::exchange(other.page_, nullptr)),
+      version_(other.version_),
+      index_(other.index_),
+      item_(other.item_),
+      read_ahead_end_(other.read_ahead_end_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(const IndexIterator& iter) = default{
-	buffer_pool_manager_=iter.buffer_pool_manager_;
-	KeyValue=iter.KeyValue;
-	NextPageId=iter.NextPageId;
-	CurrentIndex=iter.CurrentIndex;
-	MaxIndex=iter.MaxIndex;
+auto INDEXITERATOR_TYPE::operator=(const IndexIterator &other) -> IndexIterator & {
+  if (this != &other) {
+    *this = IndexIterator(other);
+  }
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> IndexIterator & {
+  if (this != &other) {
+    Release();
+    tree_ = other.tree_;
+    page_ = std::exchange(other.page_, nullptr);
+    version_ = other.version_;
+    index_ = other.index_;
+    item_ = other.item_;
+    read_ahead_end_ = other.read_ahead_end_;
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool {
-	if(NextPageId==nullptr&&CurrentIndex==MaxIndex){ return true; }
-	
-	return false;	
-	//throw std::runtime_error("unimplemented");
- }
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-       	return *KeyValue;
-	//throw std::runtime_error("unimplemented"); 
+void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    tree_->buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-       //throw std::runtime_error("unimplemented");
-       if(CurrentIndex<MaxIndex){
-	       CurrentIndex++;
-       		return *this;
-       }
-       Pages *next_page=buffer_pool_manager_->FetchPgimp(NextPageId);
-       LeafPage next_leaf;
-       char *leaf_data=next_page->GetData();
-       memcpy(next_leaf,leaf_data,BUSTUB_PAGE_SIZE);
-       //CurrentPageId=next_leaf.GetPageId();
-       NextPageId=next_leaf.GetNextPageId();
-       CurrentIndex=0;
-       MaxIndex=leaf.GetMaxSize();
-       buffer_pool_manager_->UnpinPgimp(NextPageId);
-       return *this;
-}
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_ == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return item_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const -> bool {
-       //throw std::runtime_error("unimplemented"); 
-	return KeyValue!=itr.KeyValue;
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  if (page_ != nullptr) {
+    tree_->Advance(this);
+  }
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const -> bool {
-       //throw std::runtime_error("unimplemented"); }
-	return KeyValue==itr.KeyValue;
+  if (page_ == nullptr || itr.page_ == nullptr) {
+    return page_ == itr.page_;
+  }
+  return page_->GetPageId() == itr.page_->GetPageId() && index_ == itr.index_;
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
@@ -81,4 +96,6 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<VarlenKey<512>, RID, VarlenComparator<512>>;
+
 }  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_reclaimer.cpp
+//
+// Identification: src/storage/index/page_reclaimer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/page_reclaimer.h"
+
+namespace bustub {
+
+auto PageReclaimer::Enter() -> Guard {
+  while (true) {
+    uint64_t epoch = epoch_.load();
+    active_[epoch & 1].fetch_add(1);
+    // The epoch may have moved on between the load and the increment, and a guard counted against a stale epoch
+    // would not hold back the deletions it has to.
+    if (epoch_.load() == epoch) {
+      return {this, epoch};
+    }
+    active_[epoch & 1].fetch_sub(1);
+  }
+}
+
+void PageReclaimer::Exit(uint64_t epoch) {
+  active_[epoch & 1].fetch_sub(1);
+  if (has_retired_.load(std::memory_order_relaxed)) {
+    TryReclaim();
+  }
+}
+
+void PageReclaimer::Retire(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  retired_.emplace_back(epoch_.load(), page_id);
+  has_retired_ = true;
+}
+
+void PageReclaimer::TryReclaim() {
+  std::unique_lock lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+  // Epoch e + 1 shares its counter with epoch e - 1, so it can begin once the guards of e - 1 are gone. Two steps
+  // are enough to delete everything retired in the current epoch when nothing else is running.
+  for (int step = 0; step < 2; step++) {
+    uint64_t epoch = epoch_.load();
+    if (active_[(epoch + 1) & 1].load() != 0) {
+      break;
+    }
+    epoch_.store(epoch + 1);
+  }
+  uint64_t epoch = epoch_.load();
+  std::vector<std::pair<uint64_t, page_id_t>> still_retired;
+  for (const auto &[retired_epoch, page_id] : retired_) {
+    if (retired_epoch + 2 > epoch || !bpm_->DeletePage(page_id)) {
+      still_retired.emplace_back(retired_epoch, page_id);
+    }
+  }
+  retired_ = std::move(still_retired);
+  has_retired_ = !retired_.empty();
+}
+
+}  // namespace bustub
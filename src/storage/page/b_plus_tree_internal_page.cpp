@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -26,35 +27,165 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
-	//page_type_=INTERNAL_PAGE;
-	SetPageType( INTERNAL_PAGE );
-	//size_=0;
-	SetSize( 0 );
-	SetMaxSize( max_size );
-	//page_id_=page_id;
-	//parent_page_id_=parent_id;
-	//max_size_=max_size;
-	SetPageId( page_id );
-	SetParentPageId( parent_id )
-	array_=new MappingType[max_size];
-
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  entries_.Clear();
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {  return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return entries_.KeyAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {  array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  entries_.SetKeyAt(GetSize(), index, key);
+}
 
 /*
- * Helper method to get the value associated with input "index"(a.k.a array
+ * Helper method to get/set the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {  return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return entries_.ValueAt(index); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  entries_.SetValueAt(index, value);
+}
+
+/*
+ * Helper method to find the array index of a child, or -1 if this page does
+ * not point to it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (entries_.ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Binary search for the last key that is <= key; slot 0 stands in for minus
+ * infinity
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if constexpr (HasIntegerKeys<KeyComparator>::value) {
+    if (int integer_size = comparator.IntegerKeySize(); integer_size != 0) {
+      // The last key <= key is the one before the first key > key.
+      int64_t integer = key.ToInteger(integer_size);
+      if (integer == INT64_MAX) {
+        return std::max(entries_.ClampSize(GetSize()), 1) - 1;
+      }
+      return entries_.IntegerLowerBound(1, GetSize(), integer_size, integer + 1) - 1;
+    }
+  }
+  int low = 1;
+  int high = std::max(entries_.ClampSize(GetSize()), 1) - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(entries_.KeyAt(mid), key) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return high;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(std::initializer_list<KeyType> keys, int new_entries,
+                                                int fill_percent) const -> bool {
+  return entries_.HasRoomFor(GetSize(), keys, new_entries, fill_percent);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForAllOf(const BPlusTreeInternalPage &other,
+                                                     const KeyType &middle_key) const -> bool {
+  std::vector<KeyType> keys{middle_key};
+  keys.reserve(other.GetSize());
+  for (int i = 1; i < other.GetSize(); i++) {
+    keys.push_back(other.KeyAt(i));
+  }
+  return entries_.HasRoomFor(GetSize(), keys, other.GetSize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSpareEntry() const -> bool {
+  return GetSize() - 1 >= GetMinSize() ||
+         2 * entries_.BytesUsed(GetSize() - 1) >= BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  MappingType items[] = {{new_key, old_value}, {new_key, new_value}};
+  SetItems(items, 2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  entries_.InsertAt(GetSize(), index, key, value);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  entries_.RemoveAt(GetSize(), index);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetItems() const -> std::vector<MappingType> {
+  return entries_.Items(GetSize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetItems(const MappingType *items, int count) {
+  entries_.Assign(items, count);
+  SetSize(count);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::PickSplit(const std::vector<MappingType> &items, int preferred, int min_size)
+    -> int {
+  return INTERNAL_PAGE_ENTRIES::PickSplit(items, preferred, min_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  std::vector<MappingType> items = recipient->GetItems();
+  items.emplace_back(middle_key, ValueAt(0));
+  for (int i = 1; i < GetSize(); i++) {
+    items.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  recipient->SetItems(items.data(), static_cast<int>(items.size()));
+  SetSize(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  recipient->InsertAt(recipient->GetSize(), middle_key, ValueAt(0));
+  RemoveAt(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  recipient->SetKeyAt(0, middle_key);
+  recipient->InsertAt(0, KeyAt(GetSize() - 1), ValueAt(GetSize() - 1));
+  IncreaseSize(-1);
+}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
@@ -62,4 +193,5 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<VarlenKey<512>, page_id_t, VarlenComparator<512>>;
 }  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_X86 1
+#endif
+
+namespace bustub {
+
+auto KeySearch::CountBelowScalar(const int64_t *block, int64_t bound) -> int {
+  int count = 0;
+  for (int i = 0; i < BLOCK_SIZE; i++) {
+    count += static_cast<int>(block[i] < bound);
+  }
+  return count;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_X86
+__attribute__((target("avx2"))) static auto CountBelowAvx2(const int64_t *block, int64_t bound) -> int {
+  __m256i bounds = _mm256_set1_epi64x(bound);
+  __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+  __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 4));
+  // Each lane that holds a key below the bound becomes all ones; a byte mask has eight bits per lane.
+  auto low_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi64(bounds, low)));
+  auto high_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi64(bounds, high)));
+  return (__builtin_popcount(low_mask) + __builtin_popcount(high_mask)) / 8;
+}
+
+static const bool HAS_AVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+auto KeySearch::CountBelow(const int64_t *block, int64_t bound) -> int {
+#ifdef BUSTUB_KEY_SEARCH_X86
+  if (HAS_AVX2) {
+    return CountBelowAvx2(block, bound);
+  }
+#endif
+  return CountBelowScalar(block, bound);
+}
+
+auto KeySearch::IsVectorized() -> bool {
+#ifdef BUSTUB_KEY_SEARCH_X86
+  return HAS_AVX2;
+#else
+  return false;
+#endif
+}
+
+}  // namespace bustub
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
@@ -28,13 +29,13 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
-	page_type_=LEAF_PAGE;
-	size_=0;
-	page_id_=page_id;
-	parent_page_id_=parent_id;
-	max_size_=max_size;
-	next_page_id_=0;
-	arrar_=new KeyType[max_size];
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  next_page_id_ = INVALID_PAGE_ID;
+  entries_.Clear();
 }
 
 /**
@@ -51,9 +52,119 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  return array_[index].first;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return entries_.KeyAt(index); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return entries_.ValueAt(index); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const -> MappingType {
+  return {entries_.KeyAt(index), entries_.ValueAt(index)};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if constexpr (HasIntegerKeys<KeyComparator>::value) {
+    if (int integer_size = comparator.IntegerKeySize(); integer_size != 0) {
+      return entries_.IntegerLowerBound(0, GetSize(), integer_size, key.ToInteger(integer_size));
+    }
+  }
+  int low = 0;
+  int high = entries_.ClampSize(GetSize());
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(entries_.KeyAt(mid), key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index >= entries_.ClampSize(GetSize()) || comparator(entries_.KeyAt(index), key) != 0) {
+    return false;
+  }
+  *value = entries_.ValueAt(index);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(std::initializer_list<KeyType> keys, int new_entries,
+                                            int fill_percent) const -> bool {
+  return entries_.HasRoomFor(GetSize(), keys, new_entries, fill_percent);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomForAllOf(const BPlusTreeLeafPage &other) const -> bool {
+  std::vector<KeyType> keys;
+  keys.reserve(other.GetSize());
+  for (int i = 0; i < other.GetSize(); i++) {
+    keys.push_back(other.KeyAt(i));
+  }
+  return entries_.HasRoomFor(GetSize(), keys, other.GetSize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanSpareEntry() const -> bool {
+  return GetSize() - 1 >= GetMinSize() ||
+         2 * entries_.BytesUsed(GetSize() - 1) >= BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  entries_.InsertAt(GetSize(), index, key, value);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  entries_.RemoveAt(GetSize(), index);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItems() const -> std::vector<MappingType> { return entries_.Items(GetSize()); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetItems(const MappingType *items, int count) {
+  entries_.Assign(items, count);
+  SetSize(count);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::PickSplit(const std::vector<MappingType> &items, int preferred, int min_size) -> int {
+  return LEAF_PAGE_ENTRIES::PickSplit(items, preferred, min_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  std::vector<MappingType> items = recipient->GetItems();
+  for (int i = 0; i < GetSize(); i++) {
+    items.push_back(GetItem(i));
+  }
+  recipient->SetItems(items.data(), static_cast<int>(items.size()));
+  recipient->SetNextPageId(next_page_id_);
+  SetSize(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(recipient->GetSize(), KeyAt(0), ValueAt(0));
+  RemoveAt(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(0, KeyAt(GetSize() - 1), ValueAt(GetSize() - 1));
+  IncreaseSize(-1);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -61,4 +172,5 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<VarlenKey<512>, RID, VarlenComparator<512>>;
 }  // namespace bustub
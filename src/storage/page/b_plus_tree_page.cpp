@@ -17,12 +17,7 @@ namespace bustub {
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
  */
-auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == LEAF_PAGE; }
-auto BPlusTreePage::IsRootPage() const -> bool {
-       //return page_id_ == parent_page_id_;
-       return parent_page_id_ == INVALID_PAGE_ID;
-	//return max_size_ == ;
-}
+auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
 void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
@@ -30,7 +25,7 @@ void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_typ
  * page)
  */
 auto BPlusTreePage::GetSize() const -> int { return size_; }
-void BPlusTreePage::SetSize(int size) { size_ = size;}
+void BPlusTreePage::SetSize(int size) { size_ = size; }
 void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
@@ -41,19 +36,16 @@ void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
+ * Generally, min page size == max page size / 2. The root is exempt; the tree checks for it itself, because the page
+ * cannot tell that it is the root.
  */
-auto BPlusTreePage::GetMinSize() const -> int {
-	//if( page_id_ == parent_page_id_ ) return 2;
-	if(parent_page_id_ == INVALID_PAGE_ID) return 2;
-	return max_size_ / 2;}
-}
+auto BPlusTreePage::GetMinSize() const -> int { return max_size_ / 2; }
 
 /*
  * Helper methods to get/set parent page id
  */
 auto BPlusTreePage::GetParentPageId() const -> page_id_t { return parent_page_id_; }
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_  =  parent_page_id; }
+void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_ = parent_page_id; }
 
 /*
  * Helper methods to get/set self page id
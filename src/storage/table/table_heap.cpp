@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "common/logger.h"
 #include "fmt/format.h"
@@ -34,6 +35,8 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_ids_.push_back(first_page_id_);
+  page_ids_known_ = true;
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
@@ -77,6 +80,13 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      {
+        // The last page is write-latched, so pages are linked, and added here, one at a time and in scan order.
+        std::scoped_lock<std::mutex> lock(page_ids_latch_);
+        if (page_ids_known_) {
+          page_ids_.push_back(next_page_id);
+        }
+      }
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -156,9 +166,10 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
-auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
+auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock,
+                         AccessType access_type) -> bool {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId(), access_type));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
@@ -176,24 +187,88 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::Begin(Transaction *txn, AccessType access_type) -> TableIterator {
   // Start an iterator from the first page.
+  return BeginAt(first_page_id_, txn, access_type);
+}
+
+auto TableHeap::BeginAt(page_id_t page_id, Transaction *txn, AccessType access_type) -> TableIterator {
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
-  auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, access_type));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
+    // Read the next page id before unpinning: once unpinned, the frame may be handed to another page.
+    auto next_page_id = page->GetNextPageId();
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
       break;
     }
-    page_id = page->GetNextPageId();
+    page_id = next_page_id;
+  }
+  return {this, rid, txn, access_type};
+}
+
+auto TableHeap::ScanPage(page_id_t page_id, const std::function<void(TablePage *, std::vector<uint32_t> *)> &select,
+                         Transaction *txn, AccessType access_type, std::vector<Tuple> *tuples) -> page_id_t {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, access_type));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  auto next_page_id = page->GetNextPageId();
+  if (next_page_id != INVALID_PAGE_ID && read_ahead_pages > 0) {
+    // Start reading the next page while this one is filtered and copied out.
+    buffer_pool_manager_->PrefetchPages({next_page_id}, access_type);
+  }
+  std::vector<uint32_t> slots;
+  select(page, &slots);
+  for (auto slot : slots) {
+    Tuple tuple;
+    if (page->GetTuple(RID(page_id, slot), &tuple, txn, lock_manager_)) {
+      tuples->push_back(std::move(tuple));
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+auto TableHeap::GetPageIds() -> std::vector<page_id_t> {
+  {
+    std::scoped_lock<std::mutex> lock(page_ids_latch_);
+    if (page_ids_known_) {
+      return page_ids_;
+    }
+  }
+  // Walk the pages of an opened table once. Only the page headers are needed, which is still a pass over the whole
+  // table: keep it in the scan ring.
+  std::vector<page_id_t> page_ids;
+  auto page_id = first_page_id_;
+  while (true) {
+    page_ids.push_back(page_id);
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      // The last page stays latched until the ids are in place, so that InsertTuple cannot link a page after it that
+      // neither the walk nor InsertTuple records.
+      std::scoped_lock<std::mutex> lock(page_ids_latch_);
+      if (!page_ids_known_) {
+        page_ids_ = std::move(page_ids);
+        page_ids_known_ = true;
+      }
+      page_ids = page_ids_;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return page_ids;
+    }
+    page_id = next_page_id;
   }
-  return {this, rid, txn};
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
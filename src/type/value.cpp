@@ -292,6 +292,8 @@ auto Value::CheckComparable(const Value &o) const -> bool {
       // Anything can be cast to a string!
       return true;
       break;
+    case TypeId::TIMESTAMP:
+      return o.GetTypeId() == TypeId::TIMESTAMP;
     default:
       break;
   }  // END OF SWITCH
@@ -0,0 +1,217 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_cleaner_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_cleaner_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "../test/buffer/counting_disk_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+
+namespace bustub {
+
+/** Wait until the disk has seen the given number of writes, for at most a few seconds. */
+auto WaitForWrites(CountingDiskManager *disk_manager, size_t writes) -> bool {
+  for (int i = 0; i < 500 && disk_manager->writes_ < writes; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return disk_manager->writes_ == writes;
+}
+
+TEST(BufferPoolManagerCleanerTest, WritesAheadOfEvictionTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page-%d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // The cleaner writes every dirty page back on its own.
+  bpm->StartCleaner(2, buffer_pool_size);
+  ASSERT_TRUE(WaitForWrites(disk_manager, buffer_pool_size));
+
+  // So replacing all of them does not write anything.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(buffer_pool_size, disk_manager->writes_);
+  bpm->StopCleaner();
+
+  // Nothing was lost on the way.
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerCleanerTest, RespectsWalTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, log_manager);
+  enable_logging = true;
+  log_manager->SetPersistentLSN(9);
+
+  // Half of the pages were changed by log records that are already on disk, the other half not yet.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    page->SetLSN(i % 2 == 0 ? 5 : 10);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  bpm->StartCleaner(1, buffer_pool_size);
+  ASSERT_TRUE(WaitForWrites(disk_manager, buffer_pool_size / 2));
+  std::this_thread::sleep_for(5 * cleaner_interval);
+  EXPECT_EQ(buffer_pool_size / 2, disk_manager->writes_);
+
+  // Once the log catches up, the rest can go too.
+  log_manager->SetPersistentLSN(10);
+  EXPECT_TRUE(WaitForWrites(disk_manager, buffer_pool_size));
+  bpm->StopCleaner();
+  enable_logging = false;
+
+  delete bpm;
+  delete log_manager;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerCleanerTest, SkipsLatchedPagesTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // A writer holds the latch of one page, pinned but evictable again once it unpins.
+  auto *latched = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, latched);
+  latched->WLatch();
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], true));
+
+  // The cleaner writes all the others without waiting for it.
+  bpm->StartCleaner(1, buffer_pool_size);
+  ASSERT_TRUE(WaitForWrites(disk_manager, buffer_pool_size - 1));
+  std::this_thread::sleep_for(5 * cleaner_interval);
+  EXPECT_EQ(buffer_pool_size - 1, disk_manager->writes_);
+
+  latched->WUnlatch();
+  EXPECT_TRUE(WaitForWrites(disk_manager, buffer_pool_size));
+  bpm->StopCleaner();
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** A disk whose writes do not complete until the test lets them. */
+class BlockingDiskManager : public CountingDiskManager {
+ public:
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    writes_started_++;
+    std::unique_lock<std::mutex> lock(gate_latch_);
+    gate_cv_.wait(lock, [&] { return open_; });
+    lock.unlock();
+    CountingDiskManager::WritePage(page_id, page_data);
+  }
+
+  void Open() {
+    {
+      std::scoped_lock<std::mutex> lock(gate_latch_);
+      open_ = true;
+    }
+    gate_cv_.notify_all();
+  }
+
+  std::atomic<size_t> writes_started_{0};
+
+ private:
+  std::mutex gate_latch_;
+  std::condition_variable gate_cv_;
+  bool open_{false};
+};
+
+TEST(BufferPoolManagerCleanerTest, NoLatchHeldAcrossWritesTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new BlockingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "before");
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  bpm->StartCleaner(1, buffer_pool_size);
+  for (int i = 0; i < 500 && disk_manager->writes_started_ == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(1, disk_manager->writes_started_);
+
+  // The write is stuck in the disk, but a writer can still latch and change the page.
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  auto latched = std::async(std::launch::async, [&] {
+    page->WLatch();
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "after");
+    page->WUnlatch();
+  });
+  bool not_blocked = latched.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+  disk_manager->Open();
+  latched.wait();
+  EXPECT_TRUE(not_blocked);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // The cleaner wrote the image it copied; the change waits for the next write.
+  ASSERT_TRUE(WaitForWrites(disk_manager, 2));
+  bpm->StopCleaner();
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_EQ("after", std::string(data));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
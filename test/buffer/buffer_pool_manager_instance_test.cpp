@@ -12,18 +12,26 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -89,7 +97,7 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerInstanceTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -145,4 +153,145 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DirectIoTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new AsyncDiskManager(db_name, 8, AsyncIoBackend::Auto, true);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Frames are page-aligned, so direct I/O reads and writes them in place.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(bpm->GetPages()[i].GetData()) % BUSTUB_PAGE_SIZE);
+  }
+
+  // Write more pages than fit in the pool, then read all of them back through the disk.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 32; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  for (int i = 0; i < 32; ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeletedPagesAreReusedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 3;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(i, page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // A resident page and a page that was evicted are both freed on disk, and their ids come back lowest first.
+  EXPECT_TRUE(bpm->DeletePage(4));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_EQ(2U, disk_manager->GetNumFreePages());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(4, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(5, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** A disk whose reads of one page do not complete until the test lets them. */
+class SlowReadDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit SlowReadDiskManager(page_id_t slow_page_id) : slow_page_id_(slow_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == slow_page_id_) {
+      slow_reads_++;
+      std::unique_lock<std::mutex> lock(gate_latch_);
+      gate_cv_.wait(lock, [&] { return open_; });
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void Open() {
+    {
+      std::scoped_lock<std::mutex> lock(gate_latch_);
+      open_ = true;
+    }
+    gate_cv_.notify_all();
+  }
+
+  std::atomic<int> slow_reads_{0};
+
+ private:
+  page_id_t slow_page_id_;
+  std::mutex gate_latch_;
+  std::condition_variable gate_cv_;
+  bool open_{false};
+};
+
+TEST(BufferPoolManagerInstanceTest, MissReadsWithoutLatchTest) {
+  auto *disk_manager = new SlowReadDiskManager(0);
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  for (page_id_t page_id = 0; page_id < 2; page_id++) {
+    snprintf(data, sizeof(data), "page-%d", page_id);
+    disk_manager->WritePage(page_id, data);
+  }
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  // One fetch is stuck reading page 0, and a second one waits for the same read.
+  auto fetch = [&](page_id_t page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    std::string contents = page == nullptr ? "" : page->GetData();
+    bpm->UnpinPage(page_id, false);
+    return contents;
+  };
+  auto first = std::async(std::launch::async, fetch, 0);
+  for (int i = 0; i < 500 && disk_manager->slow_reads_ == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(1, disk_manager->slow_reads_);
+  auto second = std::async(std::launch::async, fetch, 0);
+
+  // Misses on other pages go on meanwhile.
+  auto other = std::async(std::launch::async, fetch, 1);
+  bool not_blocked = other.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+  disk_manager->Open();
+  EXPECT_TRUE(not_blocked);
+  EXPECT_EQ("page-1", other.get());
+  EXPECT_EQ("page-0", first.get());
+  EXPECT_EQ("page-0", second.get());
+  EXPECT_EQ(1, disk_manager->slow_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
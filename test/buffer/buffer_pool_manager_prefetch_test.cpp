@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_prefetch_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_prefetch_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Completes asynchronous reads on a background thread after a delay, and counts both kinds of reads. */
+class DelayedReadDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit DelayedReadDiskManager(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) : delay_(delay) {}
+
+  ~DelayedReadDiskManager() override {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    sync_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  auto ReadPageAsync(page_id_t page_id, char *page_data, disk_callback_fn callback) -> std::future<bool> override {
+    async_reads_++;
+    auto done = std::make_shared<std::promise<bool>>();
+    auto future = done->get_future();
+    std::scoped_lock<std::mutex> lock(latch_);
+    threads_.emplace_back([this, page_id, page_data, callback, done] {
+      std::this_thread::sleep_for(delay_);
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+      if (callback != nullptr) {
+        callback(true);
+      }
+      done->set_value(true);
+    });
+    return future;
+  }
+
+  std::atomic<size_t> sync_reads_{0};
+  std::atomic<size_t> async_reads_{0};
+
+ private:
+  std::chrono::milliseconds delay_;
+  std::mutex latch_;
+  std::vector<std::thread> threads_;
+};
+
+/** Create num_pages pages holding their own id, and unpin them all. */
+static auto CreatePages(BufferPoolManager *bpm, size_t num_pages) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    EXPECT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page-%d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerPrefetchTest, PrefetchedPagesAreNotReadAgainTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new DelayedReadDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  auto page_ids = CreatePages(bpm, 3 * buffer_pool_size);
+
+  // The first pages were evicted long ago. Read them ahead, then fetch them.
+  std::vector<page_id_t> ahead(page_ids.begin(), page_ids.begin() + 8);
+  bpm->PrefetchPages(ahead);
+  EXPECT_EQ(8U, disk_manager->async_reads_);
+  for (page_id_t page_id : ahead) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0U, disk_manager->sync_reads_);
+
+  // Resident pages and pages that were never allocated are not read.
+  bpm->PrefetchPages({page_ids[0], page_ids.back(), 1000});
+  EXPECT_EQ(8U, disk_manager->async_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerPrefetchTest, FetchWaitsForReadTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new DelayedReadDiskManager(std::chrono::milliseconds(50));
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  auto page_ids = CreatePages(bpm, 3 * buffer_pool_size);
+
+  // Several threads fetch a page whose read is still in flight. All of them wait for it; none reads it again.
+  bpm->PrefetchPages({page_ids[0], page_ids[1]});
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      page_id_t page_id = page_ids[t % 2];
+      auto *page = bpm->FetchPage(page_id);
+      if (page == nullptr || std::string(page->GetData()) != "page-" + std::to_string(page_id)) {
+        mismatches++;
+      }
+      if (page != nullptr) {
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+  EXPECT_EQ(0U, disk_manager->sync_reads_);
+
+  // Reads still in flight when the pool goes away are waited for.
+  bpm->PrefetchPages({page_ids[2], page_ids[3]});
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerPrefetchTest, ParallelPrefetchTest) {
+  auto *disk_manager = new DelayedReadDiskManager();
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+  auto page_ids = CreatePages(bpm, 96);
+
+  std::vector<page_id_t> ahead(page_ids.begin(), page_ids.begin() + 12);
+  bpm->PrefetchPages(ahead);
+  EXPECT_EQ(12U, disk_manager->async_reads_);
+  for (page_id_t page_id : ahead) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0U, disk_manager->sync_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerPrefetchTest, TableIteratorReadAheadTest) {
+  const size_t buffer_pool_size = 128;
+  const int rows = 2000;
+
+  auto *disk_manager = new DelayedReadDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 400)});
+  Transaction txn(0);
+  TableHeap table(bpm, nullptr, nullptr, &txn);
+  std::string payload(400, 'x');
+  for (int i = 0; i < rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(payload)}, &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, &txn));
+  }
+  // Push the whole table out of the pool.
+  CreatePages(bpm, buffer_pool_size);
+
+  // A scan reads most of the table ahead rather than fetching it one page at a time.
+  size_t sync_reads = disk_manager->sync_reads_;
+  size_t async_reads = disk_manager->async_reads_;
+  int count = 0;
+  for (auto it = table.Begin(&txn, AccessType::Scan); it != table.End(); ++it) {
+    EXPECT_EQ(count, it->GetValue(&schema, 0).GetAs<int32_t>());
+    count++;
+  }
+  EXPECT_EQ(rows, count);
+  EXPECT_GT(disk_manager->async_reads_ - async_reads, 4 * (disk_manager->sync_reads_ - sync_reads));
+
+  // Without the hint, pages are read ahead into the main pool.
+  async_reads = disk_manager->async_reads_;
+  count = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    EXPECT_EQ(count, it->GetValue(&schema, 0).GetAs<int32_t>());
+    count++;
+  }
+  EXPECT_EQ(rows, count);
+  EXPECT_LT(async_reads, disk_manager->async_reads_);
+
+  // Read-ahead can be turned off.
+  read_ahead_pages = 0;
+  async_reads = disk_manager->async_reads_;
+  count = 0;
+  for (auto it = table.Begin(&txn, AccessType::Scan); it != table.End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(rows, count);
+  EXPECT_EQ(async_reads, disk_manager->async_reads_);
+  read_ahead_pages = 8;
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_scan_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_scan_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../test/buffer/counting_disk_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(BufferPoolManagerScanTest, ScanKeepsWorkingSetTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t hot_pages = 32;
+  const size_t scan_pages = 512;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < hot_pages + scan_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page-%d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Bring the hot pages in.
+  for (size_t i = 0; i < hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // Scan the rest of the table with the bulk read hint. Every page must still read back correctly.
+  for (size_t i = hot_pages; i < page_ids.size(); i++) {
+    auto *page = bpm->FetchPage(page_ids[i], AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_ids[i]), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // The scan went through the ring, so none of the hot pages had to be read again.
+  size_t reads_before = disk_manager->reads_;
+  for (size_t i = 0; i < hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerScanTest, LookupAdoptsScannedPageTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // A scan brings the page in through the ring, then a lookup hits it and moves it to the main pool.
+  page_id_t adopted = page_ids.back();
+  ASSERT_NE(nullptr, bpm->FetchPage(adopted, AccessType::Scan));
+  ASSERT_TRUE(bpm->UnpinPage(adopted, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(adopted, AccessType::Lookup));
+  ASSERT_TRUE(bpm->UnpinPage(adopted, false));
+
+  // Further scanning recycles the ring, but does not take the adopted page with it.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i], AccessType::Scan));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  size_t reads_before = disk_manager->reads_;
+  ASSERT_NE(nullptr, bpm->FetchPage(adopted));
+  ASSERT_TRUE(bpm->UnpinPage(adopted, false));
+  EXPECT_EQ(reads_before, disk_manager->reads_);
+
+  // A page that is still pinned by a scan is never recycled under it.
+  auto *pinned = bpm->FetchPage(page_ids[0], AccessType::Scan);
+  ASSERT_NE(nullptr, pinned);
+  for (size_t i = 1; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i], AccessType::Scan));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(page_ids[0], pinned->GetPageId());
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+
+  // Ring frames can be deleted like any other.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1], AccessType::Scan));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[1], false));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[1]));
+  for (size_t i = 2; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i], AccessType::Scan));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerScanTest, RingFramesReturnToPoolTest) {
+  const size_t buffer_pool_size = 64;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Fill the ring with scanned pages.
+  for (size_t i = buffer_pool_size; i < page_ids.size(); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i], AccessType::Scan));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // Once the scan is over, a working set as large as the whole pool fits again.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  size_t reads_before = disk_manager->reads_;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
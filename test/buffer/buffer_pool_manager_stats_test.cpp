@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_stats_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_stats_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <numeric>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** @return the number of fetches in the latency histogram */
+static auto LatencyCount(const BufferPoolStats &stats) -> uint64_t {
+  return std::accumulate(stats.fetch_latency_.begin(), stats.fetch_latency_.end(), uint64_t{0});
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerStatsTest, CountsTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Eight dirty pages through four frames: the first four are written back to make room for the rest.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(4U, stats.evictions_);
+  EXPECT_EQ(4U, stats.dirty_evictions_);
+  EXPECT_EQ(4U, stats.pages_written_);
+  EXPECT_EQ(0U, stats.hits_ + stats.misses_);
+
+  // The last pages are resident, the first ones have to be read.
+  for (size_t i = buffer_pool_size; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(4U, stats.hits_);
+  EXPECT_EQ(1U, stats.misses_);
+  EXPECT_EQ(1U, stats.pages_read_);
+  EXPECT_EQ(5U, stats.evictions_);
+  EXPECT_EQ(5U, stats.dirty_evictions_);
+  EXPECT_DOUBLE_EQ(0.8, stats.HitRatio());
+  EXPECT_EQ(5U, LatencyCount(stats));
+  EXPECT_LE(stats.FetchLatencyPercentile(0.5), stats.FetchLatencyPercentile(0.99));
+  EXPECT_GT(stats.FetchLatencyPercentile(0.99), 0U);
+
+  bpm->FlushAllPages();
+  EXPECT_EQ(5U + buffer_pool_size, bpm->GetStats().pages_written_);
+
+  bpm->ResetStats();
+  stats = bpm->GetStats();
+  EXPECT_EQ(0U, stats.hits_ + stats.misses_ + stats.pages_read_ + stats.pages_written_ + stats.evictions_);
+  EXPECT_EQ(0U, LatencyCount(stats));
+  EXPECT_EQ(0U, stats.FetchLatencyPercentile(0.5));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerStatsTest, IoStatsScopeTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Work is counted to the innermost scope only, and to none once the scopes are gone.
+  IoStats outer;
+  IoStats inner;
+  {
+    IoStatsScope outer_scope(&outer);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids.back()));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids.back(), false));
+    {
+      IoStatsScope inner_scope(&inner);
+      EXPECT_EQ(&inner, IoStatsScope::Current());
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+      ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+    }
+    EXPECT_EQ(&outer, IoStatsScope::Current());
+  }
+  EXPECT_EQ(nullptr, IoStatsScope::Current());
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[1], false));
+
+  EXPECT_EQ(1U, outer.hits_);
+  EXPECT_EQ(0U, outer.misses_);
+  EXPECT_EQ(0U, outer.pages_read_);
+  EXPECT_EQ(0U, inner.hits_);
+  EXPECT_EQ(1U, inner.misses_);
+  EXPECT_EQ(1U, inner.pages_read_);
+  EXPECT_EQ(2U, bpm->GetStats().misses_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerStatsTest, ParallelStatsTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(4, 2, disk_manager);
+
+  // Each instance holds two of the pages, so all of them stay resident.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(8U, stats.hits_);
+  EXPECT_EQ(0U, stats.misses_);
+  EXPECT_EQ(8U, LatencyCount(stats));
+
+  bpm->ResetStats();
+  EXPECT_EQ(0U, bpm->GetStats().hits_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
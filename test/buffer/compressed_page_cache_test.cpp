@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../test/buffer/counting_disk_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** @return true if data survives a round trip through the compressor */
+static auto RoundTrips(const std::vector<char> &data, size_t *compressed_size) -> bool {
+  std::vector<char> compressed(PageCompressor::MaxCompressedSize(data.size()));
+  *compressed_size = PageCompressor::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  if (*compressed_size == 0) {
+    return false;
+  }
+  std::vector<char> decompressed(data.size());
+  return PageCompressor::Decompress(compressed.data(), *compressed_size, decompressed.data(), decompressed.size()) &&
+         decompressed == data;
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CompressorTest) {
+  size_t size;
+  std::vector<char> zeros(BUSTUB_PAGE_SIZE, 0);
+  ASSERT_TRUE(RoundTrips(zeros, &size));
+  EXPECT_LT(size, 64U);
+
+  // Rows of a table: a counter and a repeated payload, followed by free space.
+  std::vector<char> rows(BUSTUB_PAGE_SIZE, 0);
+  for (int i = 0; i < 100; i++) {
+    snprintf(rows.data() + i * 32, 32, "%08d|some payload text", i);
+  }
+  ASSERT_TRUE(RoundTrips(rows, &size));
+  EXPECT_LT(size, BUSTUB_PAGE_SIZE / 4U);
+
+  // Random bytes do not compress, but still round-trip given enough room, as do short and empty inputs.
+  std::mt19937 rng(0);
+  std::vector<char> random(BUSTUB_PAGE_SIZE);
+  for (auto &c : random) {
+    c = static_cast<char>(rng());
+  }
+  ASSERT_TRUE(RoundTrips(random, &size));
+  EXPECT_GE(size, static_cast<size_t>(BUSTUB_PAGE_SIZE));
+  std::vector<char> out(BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(0U, PageCompressor::Compress(random.data(), random.size(), out.data(), BUSTUB_PAGE_SIZE - 1));
+  ASSERT_TRUE(RoundTrips({'a', 'b', 'c'}, &size));
+  ASSERT_TRUE(RoundTrips({}, &size));
+
+  // Truncated or corrupted input is rejected.
+  std::vector<char> compressed(PageCompressor::MaxCompressedSize(rows.size()));
+  size = PageCompressor::Compress(rows.data(), rows.size(), compressed.data(), compressed.size());
+  EXPECT_FALSE(PageCompressor::Decompress(compressed.data(), size - 1, out.data(), out.size()));
+  compressed[1] = static_cast<char>(0xFF);
+  compressed[2] = static_cast<char>(0xFF);
+  std::vector<char> small(16);
+  EXPECT_FALSE(PageCompressor::Decompress(compressed.data(), size, small.data(), small.size()));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CacheTest) {
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  std::vector<char> out(BUSTUB_PAGE_SIZE);
+  // Room for only a few compressed pages.
+  CompressedPageCache cache(200);
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    snprintf(page.data(), BUSTUB_PAGE_SIZE, "page-%d", page_id);
+    cache.Put(page_id, page.data());
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(10U, stats.insertions_);
+  EXPECT_EQ(10U, stats.pages_ + stats.evictions_);
+  EXPECT_LE(stats.bytes_, 200U);
+  EXPECT_GT(stats.CompressionRatio(), 10);
+
+  // The oldest pages were dropped; a hit takes the page out of the cache.
+  EXPECT_FALSE(cache.Get(0, out.data()));
+  ASSERT_TRUE(cache.Get(9, out.data()));
+  EXPECT_EQ("page-9", std::string(out.data()));
+  EXPECT_FALSE(cache.Get(9, out.data()));
+  cache.Erase(8);
+  EXPECT_FALSE(cache.Get(8, out.data()));
+  stats = cache.GetStats();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(3U, stats.misses_);
+
+  // Pages that do not compress are kept as they are, unless they do not fit at all.
+  std::mt19937 rng(0);
+  for (auto &c : page) {
+    c = static_cast<char>(rng());
+  }
+  cache.Put(100, page.data());
+  EXPECT_FALSE(cache.Get(100, out.data()));
+  CompressedPageCache large(2 * BUSTUB_PAGE_SIZE);
+  large.Put(100, page.data());
+  ASSERT_TRUE(large.Get(100, out.data()));
+  EXPECT_EQ(page, out);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 8;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->EnableCompressedCache(64 * BUSTUB_PAGE_SIZE);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page-%d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Every evicted page is in the compressed cache, so none has to be read.
+  for (page_id_t page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0U, disk_manager->reads_);
+  auto stats = bpm->GetCompressedCacheStats();
+  EXPECT_EQ(page_ids.size(), stats.hits_);
+  EXPECT_EQ(0U, bpm->GetStats().pages_read_);
+
+  // A deleted page leaves no copy behind for the page that reuses its id.
+  page_id_t deleted = page_ids[0];
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids.back()));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids.back(), false));
+  for (size_t i = 1; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  ASSERT_TRUE(bpm->DeletePage(deleted));
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(deleted, page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Without the compressed cache, misses go to disk.
+  bpm->EnableCompressedCache(0);
+  for (page_id_t page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_LT(0U, disk_manager->reads_);
+  EXPECT_EQ(0U, bpm->GetCompressedCacheStats().hits_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
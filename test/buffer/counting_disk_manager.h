@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// counting_disk_manager.h
+//
+// Identification: test/buffer/counting_disk_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Counts the page reads and writes that reach the disk. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    writes_++;
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  std::atomic<size_t> reads_{0};
+  std::atomic<size_t> writes_{0};
+};
+
+}  // namespace bustub
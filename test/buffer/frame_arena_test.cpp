@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, FramesTest) {
+  for (bool huge_pages : {false, true}) {
+    // Large enough for huge pages, and not a multiple of them.
+    const size_t num_frames = 1000;
+    FrameArena arena(num_frames, huge_pages, -1);
+    if (!huge_pages) {
+      EXPECT_EQ(FrameArenaBacking::SmallPages, arena.GetBacking());
+    }
+    if (arena.GetBacking() != FrameArenaBacking::SmallPages) {
+      EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(arena.GetFrame(0)) % (2 << 20));
+    }
+    for (size_t i = 0; i < num_frames; i++) {
+      EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(arena.GetFrame(i)) % BUSTUB_PAGE_SIZE);
+      memset(arena.GetFrame(i), static_cast<int>(i % 128), BUSTUB_PAGE_SIZE);
+    }
+    for (size_t i = 0; i < num_frames; i++) {
+      EXPECT_EQ(static_cast<char>(i % 128), arena.GetFrame(i)[0]);
+      EXPECT_EQ(static_cast<char>(i % 128), arena.GetFrame(i)[BUSTUB_PAGE_SIZE - 1]);
+    }
+  }
+
+  // Small arenas never take a whole huge page.
+  FrameArena small(10, true, -1);
+  EXPECT_EQ(FrameArenaBacking::SmallPages, small.GetBacking());
+
+  // Binding to a node that exists works wherever the kernel supports it; a node that does not exist is ignored.
+  FrameArena bound(10, false, FrameArena::NumaNodeCount() + 64);
+  EXPECT_EQ(-1, bound.GetNumaNode());
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolFramesTest) {
+  const size_t buffer_pool_size = 1024;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // The frame data is one contiguous arena; the metadata is a separate array.
+  const FrameArena *arena = bpm->GetFrameArena();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(arena->GetFrame(i), bpm->GetPages()[i].GetData());
+  }
+
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id = 0; page_id < static_cast<page_id_t>(2 * buffer_pool_size); page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
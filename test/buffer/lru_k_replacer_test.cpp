@@ -16,7 +16,7 @@
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -97,4 +97,72 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, RandomizedTest) {
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+
+  // Reference model: the full access history of every tracked frame, and its evictable flag.
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t now = 0;
+
+  auto expected_victim = [&]() -> int {
+    int victim = -1;
+    bool victim_inf = false;
+    size_t victim_ts = 0;
+    for (size_t fid = 0; fid < num_frames; fid++) {
+      if (history[fid].empty() || !evictable[fid]) {
+        continue;
+      }
+      bool inf = history[fid].size() < k;
+      size_t ts = inf ? history[fid].front() : history[fid][history[fid].size() - k];
+      if (victim == -1 || (inf && !victim_inf) || (inf == victim_inf && ts < victim_ts)) {
+        victim = static_cast<int>(fid);
+        victim_inf = inf;
+        victim_ts = ts;
+      }
+    }
+    return victim;
+  };
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> frame_dist(0, num_frames - 1);
+  std::uniform_int_distribution<int> op_dist(0, 9);
+  for (int i = 0; i < 20000; i++) {
+    int fid = frame_dist(rng);
+    int op = op_dist(rng);
+    if (op < 5) {
+      lru_replacer.RecordAccess(fid);
+      history[fid].push_back(now++);
+    } else if (op < 8) {
+      bool set_evictable = op_dist(rng) < 5;
+      lru_replacer.SetEvictable(fid, set_evictable);
+      if (!history[fid].empty()) {
+        evictable[fid] = set_evictable;
+      }
+    } else if (op < 9) {
+      if (history[fid].empty() || evictable[fid]) {
+        lru_replacer.Remove(fid);
+        history[fid].clear();
+        evictable[fid] = false;
+      }
+    } else {
+      int expected = expected_victim();
+      int value;
+      ASSERT_EQ(expected != -1, lru_replacer.Evict(&value));
+      if (expected != -1) {
+        ASSERT_EQ(expected, value);
+        history[expected].clear();
+        evictable[expected] = false;
+      }
+    }
+    size_t expected_size = 0;
+    for (size_t fid = 0; fid < num_frames; fid++) {
+      expected_size += !history[fid].empty() && evictable[fid] ? 1 : 0;
+    }
+    ASSERT_EQ(expected_size, lru_replacer.Size());
+  }
+}
 }  // namespace bustub
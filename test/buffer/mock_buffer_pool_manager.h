@@ -128,7 +128,7 @@ class MockBufferPoolManager : public BufferPoolManagerInstance {
    */
   Page *FetchPgImp(page_id_t page_id) {
     counter.AddCount(FuncType::FetchPage);
-    return BufferPoolManager::FetchPgImp(page_id);
+    return BufferPoolManager::FetchPgImp(page_id, AccessType::Unknown);
   }
 
   /**
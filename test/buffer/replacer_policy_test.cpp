@@ -0,0 +1,195 @@
+/**
+ * replacer_policy_test.cpp
+ */
+
+#include <memory>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+const std::vector<ReplacerPolicy> ALL_POLICIES = {ReplacerPolicy::LRU,      ReplacerPolicy::LRUK,
+                                                  ReplacerPolicy::Clock,    ReplacerPolicy::ClockPro,
+                                                  ReplacerPolicy::TwoQueue, ReplacerPolicy::ARC};
+
+TEST(ReplacerPolicyTest, ParseTest) {
+  for (auto policy : ALL_POLICIES) {
+    ReplacerPolicy parsed;
+    ASSERT_TRUE(ParseReplacerPolicy(ReplacerPolicyToString(policy), &parsed));
+    EXPECT_EQ(policy, parsed);
+  }
+  ReplacerPolicy parsed;
+  EXPECT_TRUE(ParseReplacerPolicy("ARC", &parsed));
+  EXPECT_EQ(ReplacerPolicy::ARC, parsed);
+  EXPECT_FALSE(ParseReplacerPolicy("fifo", &parsed));
+}
+
+TEST(ReplacerPolicyTest, ContractTest) {
+  for (auto policy : ALL_POLICIES) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto replacer = MakeReplacer(policy, 8, 2);
+    frame_id_t frame_id;
+
+    // Newly tracked frames are not evictable.
+    for (frame_id_t fid = 0; fid < 6; fid++) {
+      replacer->AssignPage(fid, fid);
+      replacer->RecordAccess(fid);
+    }
+    EXPECT_EQ(0U, replacer->Size());
+    EXPECT_FALSE(replacer->Evict(&frame_id));
+
+    // Untracked frames are ignored.
+    replacer->SetEvictable(7, true);
+    replacer->Remove(7);
+    EXPECT_EQ(0U, replacer->Size());
+
+    for (frame_id_t fid = 0; fid < 6; fid++) {
+      replacer->SetEvictable(fid, true);
+    }
+    EXPECT_EQ(6U, replacer->Size());
+    replacer->SetEvictable(2, false);
+    replacer->Remove(3);
+    EXPECT_EQ(4U, replacer->Size());
+
+    // Only the evictable frames come out, each exactly once.
+    std::set<frame_id_t> evicted;
+    while (replacer->Evict(&frame_id)) {
+      EXPECT_TRUE(evicted.insert(frame_id).second);
+    }
+    EXPECT_EQ(std::set<frame_id_t>({0, 1, 4, 5}), evicted);
+    EXPECT_EQ(0U, replacer->Size());
+
+    // An evicted frame can be reused for another page.
+    replacer->AssignPage(0, 100);
+    replacer->RecordAccess(0);
+    replacer->SetEvictable(0, true);
+    replacer->SetEvictable(2, true);
+    EXPECT_EQ(2U, replacer->Size());
+  }
+}
+
+TEST(ReplacerPolicyTest, EvictionCandidatesTest) {
+  const size_t num_frames = 16;
+  for (auto policy : ALL_POLICIES) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto replacer = MakeReplacer(policy, num_frames, 2);
+    for (frame_id_t fid = 0; fid < static_cast<frame_id_t>(num_frames); fid++) {
+      replacer->AssignPage(fid, fid);
+      replacer->RecordAccess(fid);
+    }
+    // Skewed accesses, so the policies have something to tell apart.
+    std::mt19937 rng(0);
+    for (int i = 0; i < 200; i++) {
+      replacer->RecordAccess(static_cast<frame_id_t>(rng() % (rng() % num_frames + 1)));
+    }
+    for (frame_id_t fid = 0; fid < static_cast<frame_id_t>(num_frames); fid++) {
+      replacer->SetEvictable(fid, fid % 5 != 0);
+    }
+
+    // Every evictable frame is listed once, and listing changes nothing.
+    auto candidates = replacer->EvictionCandidates(num_frames);
+    EXPECT_EQ(replacer->Size(), candidates.size());
+    std::set<frame_id_t> unique(candidates.begin(), candidates.end());
+    EXPECT_EQ(candidates.size(), unique.size());
+    for (auto fid : candidates) {
+      EXPECT_NE(0, fid % 5);
+    }
+    EXPECT_EQ(candidates, replacer->EvictionCandidates(num_frames));
+    EXPECT_EQ(2U, replacer->EvictionCandidates(2).size());
+
+    // The first candidate is the next victim. CLOCK-Pro may promote it on the way instead.
+    if (policy == ReplacerPolicy::ClockPro) {
+      continue;
+    }
+    frame_id_t victim;
+    ASSERT_TRUE(replacer->Evict(&victim));
+    EXPECT_EQ(candidates[0], victim);
+    // Evicting does not reorder the rest under LRU and LRU-K, so the whole list is the eviction order.
+    if (policy == ReplacerPolicy::LRU || policy == ReplacerPolicy::LRUK) {
+      for (size_t i = 1; i < candidates.size(); i++) {
+        ASSERT_TRUE(replacer->Evict(&victim));
+        EXPECT_EQ(candidates[i], victim);
+      }
+    }
+  }
+}
+
+/** Replay accesses against a replacer the way the buffer pool drives it, and count the hits. */
+class PolicySimulator {
+ public:
+  PolicySimulator(ReplacerPolicy policy, size_t num_frames)
+      : replacer_(MakeReplacer(policy, num_frames, 2)), num_frames_(num_frames), frame_to_page_(num_frames) {}
+
+  auto Access(page_id_t page_id) -> bool {
+    auto it = page_to_frame_.find(page_id);
+    if (it != page_to_frame_.end()) {
+      replacer_->RecordAccess(it->second);
+      return true;
+    }
+    frame_id_t frame_id;
+    if (next_free_ < num_frames_) {
+      frame_id = static_cast<frame_id_t>(next_free_++);
+    } else {
+      EXPECT_TRUE(replacer_->Evict(&frame_id));
+      page_to_frame_.erase(frame_to_page_[frame_id]);
+    }
+    frame_to_page_[frame_id] = page_id;
+    page_to_frame_[page_id] = frame_id;
+    replacer_->AssignPage(frame_id, page_id);
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, true);
+    return false;
+  }
+
+ private:
+  std::unique_ptr<Replacer> replacer_;
+  size_t num_frames_;
+  size_t next_free_{0};
+  std::vector<page_id_t> frame_to_page_;
+  std::unordered_map<page_id_t, frame_id_t> page_to_frame_;
+};
+
+TEST(ReplacerPolicyTest, ScanResistanceTest) {
+  const size_t num_frames = 100;
+  const page_id_t hot_pages = 50;
+  const page_id_t scan_pages = 1000;
+
+  auto hot_hits_after_scan = [&](ReplacerPolicy policy) {
+    PolicySimulator simulator(policy, num_frames);
+    // Warm up: the hot set is re-read often enough, and through enough eviction, to be recognized as hot.
+    for (int round = 0; round < 20; round++) {
+      for (page_id_t page_id = 0; page_id < hot_pages; page_id++) {
+        simulator.Access(page_id);
+      }
+      for (page_id_t page_id = 0; page_id < hot_pages; page_id++) {
+        simulator.Access(hot_pages + round * hot_pages + page_id);
+      }
+    }
+    // A long sequential scan, with a trickle of hot accesses.
+    for (page_id_t i = 0; i < scan_pages; i++) {
+      simulator.Access(10000 + i);
+      if (i % 10 == 0) {
+        simulator.Access(i / 10 % hot_pages);
+      }
+    }
+    int hits = 0;
+    for (page_id_t page_id = 0; page_id < hot_pages; page_id++) {
+      hits += simulator.Access(page_id) ? 1 : 0;
+    }
+    return hits;
+  };
+
+  // Plain LRU lets the scan flush the hot set; the scan-resistant policies keep most of it.
+  EXPECT_LT(hot_hits_after_scan(ReplacerPolicy::LRU), hot_pages / 2);
+  for (auto policy : {ReplacerPolicy::ClockPro, ReplacerPolicy::TwoQueue, ReplacerPolicy::ARC}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    EXPECT_GE(hot_hits_after_scan(policy), hot_pages * 8 / 10);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bustub_instance_test.cpp
+//
+// Identification: test/common/bustub_instance_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static void Execute(BustubInstance *bustub, const std::string &sql) {
+  std::stringstream out;
+  SimpleStreamWriter writer(out, true);
+  bustub->ExecuteSql(sql, writer);
+}
+
+// NOLINTNEXTLINE
+TEST(BustubInstanceTest, CreateIndexTest) {
+  BustubInstance bustub;
+  Execute(&bustub,
+          "CREATE TABLE t (i1 INT, i2 INT, b1 BIGINT, b2 BIGINT, b3 BIGINT, b4 BIGINT, b5 BIGINT, b6 BIGINT, "
+          "b7 BIGINT, b8 BIGINT, s VARCHAR(16), x BOOLEAN, y SMALLINT, d DECIMAL, f DOUBLE PRECISION, w TIMESTAMP);");
+  auto *table_info = bustub.catalog_->GetTable("t");
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  const auto &schema = table_info->schema_;
+
+  // The binder maps the types the parser gives back to the types of BusTub.
+  std::vector<std::pair<std::string, TypeId>> types{
+      {"i1", TypeId::INTEGER}, {"b1", TypeId::BIGINT},   {"s", TypeId::VARCHAR},  {"x", TypeId::BOOLEAN},
+      {"y", TypeId::SMALLINT}, {"d", TypeId::DECIMAL},   {"f", TypeId::DECIMAL},  {"w", TypeId::TIMESTAMP},
+  };
+  for (const auto &[name, type] : types) {
+    EXPECT_EQ(type, schema.GetColumn(schema.GetColIdx(name)).GetType()) << name;
+  }
+
+  // Fill the table before creating the indexes, which backfill from it.
+  auto *txn = bustub.txn_manager_->Begin();
+  std::vector<Tuple> tuples;
+  std::vector<RID> tuple_rids;
+  for (int i = 0; i < 500; i++) {
+    std::vector<Value> values{
+        ValueFactory::GetIntegerValue(i % 7),
+        ValueFactory::GetIntegerValue(i),
+    };
+    for (int64_t column = 1; column <= 8; column++) {
+      values.push_back(ValueFactory::GetBigIntValue(column == 8 ? i : (i % 3) * column));
+    }
+    values.push_back(ValueFactory::GetVarcharValue("key" + std::to_string(i)));
+    values.push_back(ValueFactory::GetBooleanValue(i % 2 == 0));
+    values.push_back(ValueFactory::GetSmallIntValue(static_cast<int16_t>(i % 11)));
+    values.push_back(ValueFactory::GetDecimalValue(i / 2.0));
+    values.push_back(ValueFactory::GetDecimalValue(i * 0.25));
+    values.push_back(ValueFactory::GetTimestampValue(1000000 + i));
+    Tuple tuple(values, &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+    tuples.push_back(tuple);
+    tuple_rids.push_back(rid);
+  }
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+
+  struct IndexCase {
+    std::string name_;
+    std::string columns_;
+    size_t key_size_;
+  };
+  // Every key is unique, through i2, b8, s or d.
+  std::vector<IndexCase> cases{
+      {"k8", "i1, i2", 8},
+      {"k16", "b1, b8", 16},
+      {"k32", "b1, b2, b3, b8", 32},
+      {"k64", "b1, b2, b3, b4, b5, b6, b7, b8", 64},
+      {"kvarchar", "i1, s", VARCHAR_KEY_SIZE},
+      {"ktypes", "x, y, d, w", 32},
+  };
+  for (const auto &index_case : cases) {
+    Execute(&bustub, "CREATE INDEX " + index_case.name_ + " ON t(" + index_case.columns_ + ");");
+    auto *index_info = bustub.catalog_->GetIndex(index_case.name_, "t");
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info) << index_case.name_;
+    EXPECT_EQ(index_case.key_size_, index_info->key_size_) << index_case.name_;
+
+    auto *index = index_info->index_.get();
+    const auto &key_attrs = index->GetKeyAttrs();
+    for (size_t i = 0; i < tuples.size(); i++) {
+      std::vector<RID> rids;
+      index->ScanKey(tuples[i].KeyFromTuple(schema, index_info->key_schema_, key_attrs), &rids, nullptr);
+      ASSERT_EQ(1, rids.size()) << index_case.name_;
+      EXPECT_EQ(tuple_rids[i], rids[0]) << index_case.name_;
+    }
+  }
+
+  // A key that does not fit the largest generic key is refused.
+  std::stringstream out;
+  SimpleStreamWriter writer(out, true);
+  txn = bustub.txn_manager_->Begin();
+  EXPECT_THROW(bustub.ExecuteSqlTxn("CREATE INDEX k68 ON t(b1, b2, b3, b4, b5, b6, b7, b8, i1);", writer, txn),
+               NotImplementedException);
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+  EXPECT_EQ(Catalog::NULL_INDEX_INFO, bustub.catalog_->GetIndex("k68", "t"));
+}
+
+}  // namespace bustub
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c_test.cpp
+//
+// Identification: test/common/crc32c_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/crc32c.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, KnownValuesTest) {
+  // The check value of CRC-32C, and test vectors from RFC 3720.
+  std::string digits = "123456789";
+  EXPECT_EQ(0xE3069283U, Crc32c::Compute(digits.data(), digits.size()));
+  std::vector<char> zeros(32, 0);
+  EXPECT_EQ(0x8A9136AAU, Crc32c::Compute(zeros.data(), zeros.size()));
+  std::vector<char> ones(32, static_cast<char>(0xFF));
+  EXPECT_EQ(0x62A8AB43U, Crc32c::Compute(ones.data(), ones.size()));
+  EXPECT_EQ(0U, Crc32c::Compute(nullptr, 0));
+}
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, HardwareMatchesSoftwareTest) {
+  std::mt19937 rng(0);
+  std::vector<char> data(3 * BUFSIZ + 7);
+  for (auto &c : data) {
+    c = static_cast<char>(rng());
+  }
+  // Every length and alignment, to cover the byte-at-a-time head and tail of both implementations.
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t size = 0; size < 64; size++) {
+      EXPECT_EQ(Crc32c::ComputeSoftware(data.data() + offset, size), Crc32c::Compute(data.data() + offset, size));
+    }
+  }
+  uint32_t whole = Crc32c::Compute(data.data(), data.size());
+  EXPECT_EQ(Crc32c::ComputeSoftware(data.data(), data.size()), whole);
+
+  // Checksumming in pieces gives the checksum of the whole.
+  uint32_t crc = Crc32c::Compute(data.data(), 1000);
+  crc = Crc32c::Compute(data.data() + 1000, data.size() - 1000, crc);
+  EXPECT_EQ(whole, crc);
+}
+
+}  // namespace bustub
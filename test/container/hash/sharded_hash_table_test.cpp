@@ -0,0 +1,75 @@
+/**
+ * sharded_hash_table_test.cpp
+ */
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/sharded_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ShardedHashTableTest, SampleTest) {
+  auto table = std::make_unique<ShardedHashTable<int, std::string>>(4);
+  EXPECT_EQ(4U, table->GetNumShards());
+
+  for (int i = 0; i < 100; i++) {
+    table->Insert(i, std::to_string(i));
+  }
+  std::string result;
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(table->Find(i, result));
+    EXPECT_EQ(std::to_string(i), result);
+  }
+  EXPECT_FALSE(table->Find(100, result));
+
+  // Insert overwrites an existing key.
+  table->Insert(7, "seven");
+  EXPECT_TRUE(table->Find(7, result));
+  EXPECT_EQ("seven", result);
+
+  EXPECT_TRUE(table->Remove(7));
+  EXPECT_FALSE(table->Remove(7));
+  EXPECT_FALSE(table->Find(7, result));
+}
+
+TEST(ShardedHashTableTest, FindAndApplyTest) {
+  auto table = std::make_unique<ShardedHashTable<int, int>>(8);
+  table->Insert(1, 10);
+
+  int value = 0;
+  EXPECT_TRUE(table->FindAndApply(1, &value, [](int v) { return v == 10; }));
+  EXPECT_EQ(10, value);
+  EXPECT_FALSE(table->FindAndApply(1, &value, [](int v) { return v != 10; }));
+  EXPECT_FALSE(table->FindAndApply(2, &value, [](int) { return true; }));
+}
+
+TEST(ShardedHashTableTest, ConcurrentInsertTest) {
+  const int num_threads = 8;
+  const int keys_per_thread = 1000;
+  auto table = std::make_unique<ShardedHashTable<int, int>>(16);
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&table, tid]() {
+      for (int i = 0; i < keys_per_thread; i++) {
+        int key = tid * keys_per_thread + i;
+        table->Insert(key, key);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int value;
+  for (int key = 0; key < num_threads * keys_per_thread; key++) {
+    EXPECT_TRUE(table->Find(key, value));
+    EXPECT_EQ(key, value);
+  }
+}
+
+}  // namespace bustub
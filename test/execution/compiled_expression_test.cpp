@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression_test.cpp
+//
+// Identification: test/execution/compiled_expression_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "execution/compiled_expression.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto Column(uint32_t idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, idx, type);
+}
+
+static auto Constant(const Value &value) -> AbstractExpressionRef {
+  return std::make_shared<ConstantValueExpression>(value);
+}
+
+static auto Compare(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ComparisonType type)
+    -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::move(lhs), std::move(rhs), type);
+}
+
+/** Check that the program of expr gets the same results as expr itself, tuple by tuple and batch by batch. */
+static void ExpectSameResults(const AbstractExpression &expr, const Schema &schema, const std::vector<Tuple> &tuples) {
+  auto compiled = CompiledExpression::Compile(expr, schema);
+  ASSERT_NE(nullptr, compiled) << expr.ToString();
+  EXPECT_EQ(expr.GetReturnType(), compiled->GetReturnType());
+
+  TupleBatch batch(tuples.size());
+  for (const auto &tuple : tuples) {
+    batch.Append(Tuple(tuple), RID());
+  }
+  compiled->Run(batch);
+  std::vector<char> data(8);
+  for (size_t i = 0; i < tuples.size(); i++) {
+    auto expected = expr.Evaluate(&tuples[i], schema);
+    auto actual = compiled->GetValue(i);
+    ASSERT_EQ(expected.IsNull(), actual.IsNull()) << expr.ToString() << " on " << tuples[i].ToString(&schema);
+    ASSERT_EQ(expected.GetTypeId(), actual.GetTypeId());
+    if (!expected.IsNull()) {
+      ASSERT_EQ(CmpBool::CmpTrue, expected.CompareEquals(actual))
+          << expr.ToString() << " on " << tuples[i].ToString(&schema);
+    }
+    // The serialized result reads back as the same value.
+    compiled->SerializeTo(i, data.data());
+    auto read_back = Value::DeserializeFrom(data.data(), expr.GetReturnType());
+    ASSERT_EQ(expected.IsNull(), read_back.IsNull());
+    if (expr.GetReturnType() == TypeId::BOOLEAN) {
+      ASSERT_EQ(!expected.IsNull() && expected.GetAs<bool>(), compiled->IsTrue(i));
+    }
+  }
+
+  // A single tuple runs as a batch of one.
+  compiled->Run(tuples[0]);
+  auto expected = expr.Evaluate(&tuples[0], schema);
+  ASSERT_EQ(expected.IsNull(), compiled->GetValue(0).IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, MatchesTreeEvaluationTest) {
+  Schema schema{{{"a", TypeId::INTEGER}, {"b", TypeId::BIGINT}, {"c", TypeId::DECIMAL}, {"d", TypeId::SMALLINT},
+                 {"e", TypeId::BOOLEAN}, {"f", TypeId::INTEGER}}};
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int> small(-5, 5);
+  std::uniform_int_distribution<int> null_dice(0, 9);
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 500; i++) {
+    // Every column is null once in a while.
+    auto is_null = [&]() { return null_dice(generator) == 0; };
+    std::vector<Value> values{
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(small(generator)),
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                  : ValueFactory::GetBigIntValue(static_cast<int64_t>(small(generator)) << 33),
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::DECIMAL)
+                  : ValueFactory::GetDecimalValue(small(generator) / 2.0),
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::SMALLINT)
+                  : ValueFactory::GetSmallIntValue(static_cast<int16_t>(small(generator))),
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::BOOLEAN)
+                  : ValueFactory::GetBooleanValue(small(generator) > 0),
+        // Large enough for a + f to overflow now and then.
+        is_null() ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                  : ValueFactory::GetIntegerValue(small(generator) * 500000000),
+    };
+    tuples.emplace_back(values, &schema);
+  }
+
+  auto a = Column(0, TypeId::INTEGER);
+  auto b = Column(1, TypeId::BIGINT);
+  auto c = Column(2, TypeId::DECIMAL);
+  auto d = Column(3, TypeId::SMALLINT);
+  auto e = Column(4, TypeId::BOOLEAN);
+  auto f = Column(5, TypeId::INTEGER);
+  auto two = Constant(ValueFactory::GetIntegerValue(2));
+  auto null = Constant(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+
+  for (auto type : {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan,
+                    ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual}) {
+    ExpectSameResults(*Compare(a, two, type), schema, tuples);
+    ExpectSameResults(*Compare(a, b, type), schema, tuples);
+    ExpectSameResults(*Compare(c, a, type), schema, tuples);
+    ExpectSameResults(*Compare(d, c, type), schema, tuples);
+    ExpectSameResults(*Compare(b, Constant(ValueFactory::GetDecimalValue(0.5)), type), schema, tuples);
+    ExpectSameResults(*Compare(a, null, type), schema, tuples);
+  }
+
+  auto a_plus_f = std::make_shared<ArithmeticExpression>(a, f, ArithmeticType::Plus);
+  auto a_minus_two = std::make_shared<ArithmeticExpression>(a, two, ArithmeticType::Minus);
+  ExpectSameResults(*a_plus_f, schema, tuples);
+  ExpectSameResults(*a_minus_two, schema, tuples);
+  ExpectSameResults(*Compare(a_plus_f, a_minus_two, ComparisonType::GreaterThan), schema, tuples);
+
+  // AND and OR over nulls: e is null now and then, and so is each comparison.
+  auto a_positive = Compare(a, Constant(ValueFactory::GetIntegerValue(0)), ComparisonType::GreaterThan);
+  auto c_small = Compare(c, Constant(ValueFactory::GetDecimalValue(1.0)), ComparisonType::LessThan);
+  for (auto type : {LogicType::And, LogicType::Or}) {
+    ExpectSameResults(LogicExpression(a_positive, c_small, type), schema, tuples);
+    ExpectSameResults(LogicExpression(e, a_positive, type), schema, tuples);
+    ExpectSameResults(LogicExpression(std::make_shared<LogicExpression>(e, c_small, LogicType::Or), a_positive, type),
+                      schema, tuples);
+  }
+  ExpectSameResults(*e, schema, tuples);
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, RejectsUnsupportedTest) {
+  Schema schema{{{"a", TypeId::INTEGER}, {"s", TypeId::VARCHAR, 16}}};
+  auto a = Column(0, TypeId::INTEGER);
+  auto s = Column(1, TypeId::VARCHAR);
+  EXPECT_EQ(nullptr, CompiledExpression::Compile(*s, schema));
+  EXPECT_EQ(nullptr, CompiledExpression::Compile(
+                         *Compare(s, Constant(ValueFactory::GetVarcharValue("x")), ComparisonType::Equal), schema));
+  // A column of the right side of a join.
+  EXPECT_EQ(nullptr, CompiledExpression::Compile(ColumnValueExpression(1, 0, TypeId::INTEGER), schema));
+  // Anything that contains an unsupported node.
+  auto a_positive = Compare(a, Constant(ValueFactory::GetIntegerValue(0)), ComparisonType::GreaterThan);
+  auto s_x = Compare(s, Constant(ValueFactory::GetVarcharValue("x")), ComparisonType::Equal);
+  EXPECT_EQ(nullptr, CompiledExpression::Compile(LogicExpression(a_positive, s_x, LogicType::And), schema));
+  EXPECT_NE(nullptr, CompiledExpression::Compile(*a_positive, schema));
+}
+
+}  // namespace bustub
@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_predicate_test.cpp
+//
+// Identification: test/execution/page_predicate_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/page_predicate.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return the rows of sql, with the filters of scans run on the pages or not */
+static auto RunWithPagePredicates(BustubInstance *bustub, bool enabled, const std::string &sql) -> std::string {
+  enable_page_predicates = enabled;
+  std::stringstream out;
+  SimpleStreamWriter writer(out, true, ",");
+  bustub->ExecuteSql(sql, writer);
+  enable_page_predicates = true;
+  return out.str();
+}
+
+// NOLINTNEXTLINE
+TEST(PagePredicateTest, MatchesTupleFilterTest) {
+  BustubInstance bustub;
+  auto *txn = bustub.txn_manager_->Begin();
+  auto *table_info = bustub.catalog_->CreateTable(
+      txn, "t",
+      Schema{{Column{"a", TypeId::INTEGER}, Column{"s", TypeId::VARCHAR, 8}, Column{"b", TypeId::BIGINT},
+              Column{"d", TypeId::DECIMAL}}});
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int> small(-50, 50);
+  std::uniform_int_distribution<int> null_dice(0, 9);
+  std::vector<RID> rids;
+  for (int i = 0; i < 10000; i++) {
+    // Every column is null once in a while, and the varchar makes the tuples differ in size.
+    std::vector<Value> values{
+        null_dice(generator) == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                  : ValueFactory::GetIntegerValue(small(generator)),
+        ValueFactory::GetVarcharValue(std::string(i % 8, 'x')),
+        null_dice(generator) == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                  : ValueFactory::GetBigIntValue(static_cast<int64_t>(small(generator)) << 33),
+        ValueFactory::GetDecimalValue(i / 4.0),
+    };
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+    rids.push_back(rid);
+  }
+  // Leave holes in the pages.
+  for (size_t i = 0; i < rids.size(); i += 13) {
+    ASSERT_TRUE(table_info->table_->MarkDelete(rids[i], txn));
+  }
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+
+  for (const auto *sql : {
+           "SELECT a, b FROM t WHERE a > 10",
+           "SELECT a, b FROM t WHERE a = 7",
+           "SELECT a, b FROM t WHERE a <> 7",
+           "SELECT a, b FROM t WHERE a <= -3 AND b <> 0",
+           "SELECT a, b FROM t WHERE 5 < a AND a < 20 AND b >= 0",
+           "SELECT a, b FROM t WHERE b > 0",
+           "SELECT a, b FROM t WHERE b < 0 AND a >= -20",
+           "SELECT a, b FROM t WHERE a > 100",
+           // Filters the pages cannot run fall back to the tuples.
+           "SELECT a, b FROM t WHERE a > 10 OR b < 0",
+           "SELECT a, b FROM t WHERE a > b",
+           "SELECT a, d FROM t WHERE a > 10 AND d < 100",
+       }) {
+    // Tuple at a time too: the page filter serves Next as well as NextBatch.
+    for (bool batch : {false, true}) {
+      enable_batch_execution = batch;
+      auto expected = RunWithPagePredicates(&bustub, false, sql);
+      auto actual = RunWithPagePredicates(&bustub, true, sql);
+      EXPECT_EQ(expected, actual) << sql << (batch ? " in batches" : " by tuple");
+    }
+    enable_batch_execution = true;
+  }
+  EXPECT_FALSE(RunWithPagePredicates(&bustub, true, "SELECT a FROM t WHERE a > 10").empty());
+  EXPECT_TRUE(RunWithPagePredicates(&bustub, true, "SELECT a FROM t WHERE a > 100").empty());
+}
+
+// NOLINTNEXTLINE
+TEST(PagePredicateTest, NullFilterTest) {
+  BustubInstance bustub;
+  auto *txn = bustub.txn_manager_->Begin();
+  auto *table_info = bustub.catalog_->CreateTable(
+      txn, "t", Schema{{Column{"a", TypeId::INTEGER}, Column{"s", TypeId::VARCHAR, 8}}});
+  std::vector<std::pair<std::optional<int>, std::optional<std::string>>> rows;
+  for (int i = 0; i < 1000; i++) {
+    std::optional<int> a;
+    std::optional<std::string> s;
+    if (i % 5 != 0) {
+      a = i % 50;
+    }
+    if (i % 7 != 0) {
+      s = std::string(i % 4, 'x');
+    }
+    std::vector<Value> values{
+        a.has_value() ? ValueFactory::GetIntegerValue(*a) : ValueFactory::GetNullValueByType(TypeId::INTEGER),
+        s.has_value() ? ValueFactory::GetVarcharValue(*s) : ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+    };
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+    rows.emplace_back(a, s);
+  }
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+
+  // A filter that comes out null leaves the row out, whichever way the scan runs it.
+  auto count = [&](const std::function<bool(const std::optional<int> &, const std::optional<std::string> &)> &pred) {
+    return std::count_if(rows.begin(), rows.end(), [&](const auto &row) { return pred(row.first, row.second); });
+  };
+  std::vector<std::pair<std::string, std::ptrdiff_t>> cases{
+      {"SELECT a FROM t WHERE a > 10 OR s = 'xx'",
+       count([](const auto &a, const auto &s) { return (a.has_value() && *a > 10) || (s.has_value() && *s == "xx"); })},
+      {"SELECT a FROM t WHERE s <> 'x'",
+       count([](const auto &a, const auto &s) { return s.has_value() && *s != "x"; })},
+      {"SELECT a FROM t WHERE a < 10 AND s = 'xxx'",
+       count([](const auto &a, const auto &s) { return a.has_value() && *a < 10 && s.has_value() && *s == "xxx"; })},
+  };
+  for (bool batch : {false, true}) {
+    for (bool compile : {false, true}) {
+      enable_batch_execution = batch;
+      enable_expression_compilation = compile;
+      for (const auto &[sql, expected] : cases) {
+        auto result = RunWithPagePredicates(&bustub, true, sql);
+        EXPECT_EQ(std::count(result.begin(), result.end(), '\n'), expected) << sql;
+      }
+    }
+  }
+  enable_batch_execution = true;
+  enable_expression_compilation = true;
+}
+
+// NOLINTNEXTLINE
+TEST(PagePredicateTest, CompileTest) {
+  Schema schema{{{"a", TypeId::INTEGER}, {"b", TypeId::BIGINT}, {"d", TypeId::DECIMAL}}};
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::BIGINT);
+  auto d = std::make_shared<ColumnValueExpression>(0, 2, TypeId::DECIMAL);
+  auto constant = [](const Value &value) { return std::make_shared<ConstantValueExpression>(value); };
+  auto one = constant(ValueFactory::GetIntegerValue(1));
+  auto a_gt_one = std::make_shared<ComparisonExpression>(a, one, ComparisonType::GreaterThan);
+  auto b_lt_one = std::make_shared<ComparisonExpression>(b, one, ComparisonType::LessThan);
+
+  EXPECT_NE(nullptr, PagePredicate::Compile(*a_gt_one, schema));
+  EXPECT_NE(nullptr, PagePredicate::Compile(ComparisonExpression(one, b, ComparisonType::Equal), schema));
+  EXPECT_NE(nullptr, PagePredicate::Compile(LogicExpression(a_gt_one, b_lt_one, LogicType::And), schema));
+
+  EXPECT_EQ(nullptr, PagePredicate::Compile(LogicExpression(a_gt_one, b_lt_one, LogicType::Or), schema));
+  EXPECT_EQ(nullptr, PagePredicate::Compile(ComparisonExpression(a, b, ComparisonType::Equal), schema));
+  EXPECT_EQ(nullptr, PagePredicate::Compile(ComparisonExpression(d, one, ComparisonType::Equal), schema));
+  EXPECT_EQ(nullptr, PagePredicate::Compile(
+                         ComparisonExpression(a, constant(ValueFactory::GetDecimalValue(0.5)), ComparisonType::Equal),
+                         schema));
+  // A constant outside of the range of the column, and a null constant.
+  EXPECT_EQ(nullptr, PagePredicate::Compile(ComparisonExpression(a, constant(ValueFactory::GetBigIntValue(1LL << 40)),
+                                                                 ComparisonType::LessThan),
+                                            schema));
+  auto null = constant(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  EXPECT_EQ(nullptr, PagePredicate::Compile(ComparisonExpression(a, null, ComparisonType::Equal), schema));
+}
+
+}  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_scan_test.cpp
+//
+// Identification: test/execution/parallel_scan_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executors/gather_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/morsel_scheduler.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, SchedulerRunsEveryMorselOnceTest) {
+  for (size_t num_workers : {1, 3, 8}) {
+    const size_t num_morsels = 1000;
+    std::vector<std::atomic<int>> runs(num_morsels);
+    MorselScheduler scheduler(num_workers, num_morsels, [&](size_t morsel) { runs[morsel]++; });
+    scheduler.Wait();
+    for (size_t i = 0; i < num_morsels; i++) {
+      EXPECT_EQ(1, runs[i]) << "morsel " << i << " with " << num_workers << " workers";
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, SchedulerCancelTest) {
+  std::atomic<size_t> started{0};
+  std::atomic<bool> release{false};
+  {
+    // Every task blocks until the scheduler has been cancelled.
+    MorselScheduler scheduler(2, 10000, [&](size_t /* morsel */) {
+      started++;
+      while (!release) {
+        std::this_thread::yield();
+      }
+    });
+    scheduler.Cancel();
+    release = true;
+  }
+  // Whatever was running when the scheduler was cancelled finishes, the rest never starts.
+  EXPECT_LE(started, 2U);
+}
+
+/** @return the rows of sql, run at the given degree of parallelism */
+static auto RunAt(BustubInstance *bustub, size_t degree, const std::string &sql) -> std::string {
+  std::stringstream set_out;
+  SimpleStreamWriter set_writer(set_out);
+  bustub->ExecuteSql("SET degree_of_parallelism = " + std::to_string(degree), set_writer);
+  std::stringstream out;
+  SimpleStreamWriter writer(out, true, ",");
+  bustub->ExecuteSql(sql, writer);
+  return out.str();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, SeqScanTest) {
+  BustubInstance bustub;
+  // Enough rows for a few hundred pages, so the scan is cut into many morsels.
+  auto *txn = bustub.txn_manager_->Begin();
+  auto *table_info =
+      bustub.catalog_->CreateTable(txn, "t", Schema{{Column{"x", TypeId::INTEGER}, Column{"y", TypeId::INTEGER}}});
+  for (int i = 0; i < 50000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 7)};
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+  }
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+
+  for (const auto *sql : {"SELECT x, y FROM t", "SELECT x + y FROM t WHERE y = 3", "SELECT x FROM t WHERE x > 49990"}) {
+    auto serial = RunAt(&bustub, 1, sql);
+    EXPECT_FALSE(serial.empty()) << sql;
+    for (size_t degree : {2, 4, 16}) {
+      // The gather hands the morsels on in order, so even the order of the rows matches.
+      EXPECT_EQ(serial, RunAt(&bustub, degree, sql)) << sql << " at degree " << degree;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, MockScanTest) {
+  BustubInstance bustub;
+  bustub.GenerateMockTable();
+  // The smaller leaderboard tables are shuffled, which keeps them in one morsel.
+  const std::string sql = "SELECT x, y FROM __mock_t4_1m WHERE x > 499900";
+  auto serial = RunAt(&bustub, 1, sql);
+  EXPECT_FALSE(serial.empty());
+  EXPECT_EQ(serial, RunAt(&bustub, 4, sql));
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, GatherStopsWaitingWorkersTest) {
+  ExecutorContext exec_ctx(nullptr, nullptr, nullptr, nullptr, nullptr);
+  exec_ctx.SetDegreeOfParallelism(2);
+  auto schema = std::make_shared<Schema>(std::vector{Column{"x", TypeId::INTEGER}, Column{"y", TypeId::INTEGER}});
+  auto plan = std::make_shared<MockScanPlanNode>(schema, "__mock_t4_1m");
+  ASSERT_GT(MockScanExecutor::MakeMorsels(plan.get()).size(), 2 * GatherExecutor::WINDOW_PER_WORKER);
+
+  GatherExecutor gather(&exec_ctx, plan);
+  gather.Init();
+  TupleBatch batch;
+  ASSERT_TRUE(gather.NextBatch(&batch));
+  EXPECT_EQ(0, batch.TupleAt(0).GetValue(schema.get(), 0).GetAs<int32_t>());
+  // Give the workers time to fill the window and wait for the consumer, then start over.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  gather.Init();
+  size_t rows = 0;
+  while (gather.NextBatch(&batch)) {
+    rows += batch.Size();
+  }
+  EXPECT_EQ(1000000, rows);
+
+  // Leaving a run half way through stops the workers that wait for the window.
+  gather.Init();
+  ASSERT_TRUE(gather.NextBatch(&batch));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelScanTest, WorkerIoStatsTest) {
+  BustubInstance bustub;
+  auto *txn = bustub.txn_manager_->Begin();
+  auto *table_info =
+      bustub.catalog_->CreateTable(txn, "t", Schema{{Column{"x", TypeId::INTEGER}, Column{"y", TypeId::INTEGER}}});
+  for (int i = 0; i < 50000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 7)};
+    Tuple tuple(values, &table_info->schema_);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+  }
+  auto num_pages = table_info->table_->GetPageIds().size();
+  ASSERT_GT(num_pages, SeqScanExecutor::MORSEL_PAGES);
+
+  ExecutorContext exec_ctx(txn, bustub.catalog_, bustub.buffer_pool_manager_, bustub.txn_manager_,
+                           bustub.lock_manager_);
+  exec_ctx.SetDegreeOfParallelism(4);
+  auto schema = std::make_shared<Schema>(table_info->schema_);
+  auto plan = std::make_shared<SeqScanPlanNode>(schema, table_info->oid_, "t");
+
+  // The pages the workers fetch are counted to the scope of the thread that runs the gather.
+  IoStats stats;
+  size_t rows = 0;
+  {
+    IoStatsScope scope(&stats);
+    GatherExecutor gather(&exec_ctx, plan);
+    gather.Init();
+    TupleBatch batch;
+    while (gather.NextBatch(&batch)) {
+      rows += batch.Size();
+    }
+  }
+  EXPECT_EQ(50000, rows);
+  EXPECT_GE(stats.hits_ + stats.misses_, num_pages);
+
+  // So is the work of the morsels the consumer never got to.
+  IoStats stopped;
+  {
+    IoStatsScope scope(&stopped);
+    GatherExecutor gather(&exec_ctx, plan);
+    gather.Init();
+    TupleBatch batch;
+    ASSERT_TRUE(gather.NextBatch(&batch));
+  }
+  EXPECT_GE(stopped.hits_ + stopped.misses_, SeqScanExecutor::MORSEL_PAGES);
+
+  bustub.txn_manager_->Commit(txn);
+  delete txn;
+}
+
+}  // namespace bustub
@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch_test.cpp
+//
+// Identification: test/execution/tuple_batch_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** An executor that only implements Next, so that NextBatch is the default adapter. */
+class CountingExecutor : public AbstractExecutor {
+ public:
+  CountingExecutor(const Schema *schema, int count) : AbstractExecutor(nullptr), schema_(schema), count_(count) {}
+
+  void Init() override { next_ = 0; }
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override {
+    if (next_ == count_) {
+      return false;
+    }
+    // Assign onto the tuple the caller passes in, which the adapter has moved out of.
+    *tuple = MakeTuple(schema_, next_);
+    *rid = RID(next_ / 10, next_ % 10);
+    next_++;
+    return true;
+  }
+
+  auto GetOutputSchema() const -> const Schema & override { return *schema_; }
+
+  static auto MakeTuple(const Schema *schema, int i) -> Tuple {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(i % 5, 'a'))};
+    return {values, schema};
+  }
+
+ private:
+  const Schema *schema_;
+  int count_;
+  int next_{0};
+};
+
+auto TestSchema() -> Schema { return Schema{{Column{"a", TypeId::INTEGER}, Column{"s", TypeId::VARCHAR, 8}}}; }
+
+auto FirstColumn(const Tuple &tuple, const Schema &schema) -> int {
+  return tuple.GetValue(&schema, 0).GetAs<int32_t>();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, RetainTest) {
+  auto schema = TestSchema();
+  TupleBatch batch(16);
+  for (int i = 0; i < 10; i++) {
+    batch.Append(CountingExecutor::MakeTuple(&schema, i), RID(i, i));
+  }
+  ASSERT_FALSE(batch.IsFull());
+  ASSERT_EQ(10, batch.Size());
+
+  // Keep the rows at odd indexes: the tuples and their RIDs move down together, in order.
+  batch.Retain([](size_t index) { return index % 2 == 1; });
+  ASSERT_EQ(5, batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    auto expected = static_cast<int>(2 * i + 1);
+    EXPECT_EQ(expected, FirstColumn(batch.TupleAt(i), schema));
+    EXPECT_EQ(RID(expected, expected), batch.RidAt(i));
+    EXPECT_EQ(std::string(expected % 5, 'a'), batch.TupleAt(i).GetValue(&schema, 1).ToString());
+  }
+
+  batch.Retain([](size_t) { return true; });
+  EXPECT_EQ(5, batch.Size());
+  EXPECT_EQ(1, FirstColumn(batch.TupleAt(0), schema));
+
+  batch.Retain([](size_t) { return false; });
+  EXPECT_TRUE(batch.IsEmpty());
+
+  // The batch is reusable once emptied.
+  batch.Append(CountingExecutor::MakeTuple(&schema, 42), RID(4, 2));
+  ASSERT_EQ(1, batch.Size());
+  EXPECT_EQ(42, FirstColumn(batch.TupleAt(0), schema));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, MoveTuplesToTest) {
+  auto schema = TestSchema();
+  std::vector<Tuple> out;
+  out.push_back(CountingExecutor::MakeTuple(&schema, 100));
+
+  TupleBatch batch(4);
+  for (int i = 0; i < 4; i++) {
+    batch.Append(CountingExecutor::MakeTuple(&schema, i), RID(0, i));
+  }
+  ASSERT_TRUE(batch.IsFull());
+  batch.MoveTuplesTo(&out);
+  EXPECT_TRUE(batch.IsEmpty());
+  EXPECT_FALSE(batch.IsFull());
+
+  // The tuples go after what is already there.
+  ASSERT_EQ(5, out.size());
+  EXPECT_EQ(100, FirstColumn(out[0], schema));
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(i, FirstColumn(out[i + 1], schema));
+  }
+
+  batch.Append(CountingExecutor::MakeTuple(&schema, 4), RID(0, 4));
+  batch.MoveTuplesTo(&out);
+  ASSERT_EQ(6, out.size());
+  EXPECT_EQ(4, FirstColumn(out[5], schema));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, NextBatchAdapterTest) {
+  auto schema = TestSchema();
+  for (int count : {0, 1, 7, 8, 9, 50}) {
+    CountingExecutor executor(&schema, count);
+    executor.Init();
+    TupleBatch batch(8);
+    int seen = 0;
+    while (executor.NextBatch(&batch)) {
+      ASSERT_LE(batch.Size(), 8);
+      // Every batch but the last is full.
+      if (seen + static_cast<int>(batch.Size()) < count) {
+        EXPECT_TRUE(batch.IsFull());
+      }
+      for (size_t i = 0; i < batch.Size(); i++) {
+        EXPECT_EQ(seen, FirstColumn(batch.TupleAt(i), schema));
+        EXPECT_EQ(std::string(seen % 5, 'a'), batch.TupleAt(i).GetValue(&schema, 1).ToString());
+        EXPECT_EQ(RID(seen / 10, seen % 10), batch.RidAt(i));
+        seen++;
+      }
+    }
+    EXPECT_EQ(count, seen);
+    EXPECT_TRUE(batch.IsEmpty());
+    // An exhausted executor stays exhausted.
+    EXPECT_FALSE(executor.NextBatch(&batch));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, BatchMatchesTupleModeTest) {
+  BustubInstance bustub;
+  bustub.GenerateMockTable();
+  auto run = [&](bool batch, const std::string &sql) {
+    enable_batch_execution = batch;
+    std::stringstream out;
+    SimpleStreamWriter writer(out, true, ",");
+    bustub.ExecuteSql(sql, writer);
+    enable_batch_execution = true;
+    // Some mock tables come out in a different order on every scan.
+    std::vector<std::string> rows;
+    for (std::string row; std::getline(out, row);) {
+      rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  for (const auto *sql : {
+           "SELECT * FROM __mock_table_1",
+           "SELECT colA + colB, colA FROM __mock_table_1 WHERE colA > 50",
+           "SELECT colF, colE FROM __mock_table_3 WHERE colE < 30",
+           "SELECT * FROM __mock_table_123",
+           // More rows than a batch holds.
+           "SELECT x, y FROM __mock_t1_50k WHERE x < y",
+           "SELECT x + 1 FROM __mock_t3_1k",
+       }) {
+    auto expected = run(false, sql);
+    auto actual = run(true, sql);
+    EXPECT_FALSE(expected.empty()) << sql;
+    EXPECT_EQ(expected, actual) << sql;
+  }
+}
+
+}  // namespace bustub
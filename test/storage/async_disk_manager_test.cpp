@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager_test.cpp
+//
+// Identification: test/storage/async_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
+
+namespace bustub {
+
+/** Parameterized over the engine and whether to use direct I/O. */
+class AsyncDiskManagerTest : public ::testing::TestWithParam<std::tuple<AsyncIoBackend, bool>> {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test.crc");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test.crc");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, ReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto [backend, direct_io] = GetParam();
+  AsyncDiskManager dm("test.db", 8, backend, direct_io);
+  if (backend == AsyncIoBackend::ThreadPool) {
+    EXPECT_EQ(AsyncIoBackend::ThreadPool, dm.GetBackend());
+  }
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Reading past the end of the file reads zeroes.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(buf, sizeof(buf)));
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  std::memset(buf, 0, sizeof(buf));
+  dm.WritePage(5, data);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_EQ(2, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, ManyInFlightTest) {
+  const int num_pages = 256;
+  AsyncDiskManager dm("test.db", 16, std::get<0>(GetParam()), std::get<1>(GetParam()));
+
+  // Queue far more writes than the queue depth, then read everything back the same way.
+  std::vector<std::unique_ptr<char[]>> pages;
+  std::vector<std::future<bool>> writes;
+  std::atomic<int> callbacks{0};
+  for (int i = 0; i < num_pages; i++) {
+    pages.emplace_back(new char[BUSTUB_PAGE_SIZE]);
+    std::memset(pages.back().get(), i, BUSTUB_PAGE_SIZE);
+    writes.push_back(dm.WritePageAsync(i, pages.back().get(), [&](bool ok) { callbacks += ok ? 1 : 0; }));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+  EXPECT_EQ(num_pages, callbacks);
+
+  std::vector<std::unique_ptr<char[]>> reads;
+  std::vector<std::future<bool>> done;
+  for (int i = num_pages - 1; i >= 0; i--) {
+    reads.emplace_back(new char[BUSTUB_PAGE_SIZE]);
+    done.push_back(dm.ReadPageAsync(i, reads.back().get(), nullptr));
+  }
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_TRUE(done[i].get());
+    EXPECT_EQ(std::memcmp(reads[i].get(), pages[num_pages - 1 - i].get(), BUSTUB_PAGE_SIZE), 0);
+  }
+
+  // Synchronous callers on several threads share the queue.
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = t; i < num_pages; i += 4) {
+        dm.ReadPage(i, buf);
+        mismatches += std::memcmp(buf, pages[i].get(), BUSTUB_PAGE_SIZE) == 0 ? 0 : 1;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, UnalignedBufferTest) {
+  AsyncDiskManager dm("test.db", 8, std::get<0>(GetParam()), std::get<1>(GetParam()));
+
+  // Direct I/O copies buffers that are not page-aligned through an aligned one.
+  std::vector<char> data(BUSTUB_PAGE_SIZE + 1);
+  std::vector<char> buf(BUSTUB_PAGE_SIZE + 1);
+  for (int i = 0; i < BUSTUB_PAGE_SIZE; i++) {
+    data[i + 1] = static_cast<char>(i * 7);
+  }
+  EXPECT_TRUE(dm.WritePageAsync(3, data.data() + 1, nullptr).get());
+  EXPECT_TRUE(dm.ReadPageAsync(3, buf.data() + 1, nullptr).get());
+  EXPECT_EQ(std::memcmp(buf.data() + 1, data.data() + 1, BUSTUB_PAGE_SIZE), 0);
+
+  // Pages that were preallocated but never written read as zeroes.
+  dm.ReadPage(4, buf.data() + 1);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(buf.data() + 1, BUSTUB_PAGE_SIZE));
+
+  // The file grew by a whole extent, unless the file system can't preallocate.
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat("test.db", &stat_buf));
+  EXPECT_TRUE(stat_buf.st_size == DB_FILE_EXTENT_PAGES * BUSTUB_PAGE_SIZE || stat_buf.st_size == 4 * BUSTUB_PAGE_SIZE);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, ChecksumTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  AsyncDiskManager dm("test.db", 8, std::get<0>(GetParam()), std::get<1>(GetParam()));
+  std::strncpy(data, "A test string.", sizeof(data));
+  EXPECT_TRUE(dm.WritePageAsync(0, data, nullptr).get());
+  EXPECT_TRUE(dm.WritePageAsync(1, data, nullptr).get());
+
+  FILE *file = fopen("test.db", "r+b");
+  ASSERT_NE(nullptr, file);
+  fseek(file, BUSTUB_PAGE_SIZE + 100, SEEK_SET);
+  fputs("bit rot", file);
+  fclose(file);
+
+  // A page that fails its checksum is a failed read, asynchronously, and an exception, synchronously.
+  std::atomic<bool> callback_ok{true};
+  EXPECT_FALSE(dm.ReadPageAsync(1, buf, [&](bool ok) { callback_ok = ok; }).get());
+  EXPECT_FALSE(callback_ok);
+  EXPECT_THROW(dm.ReadPage(1, buf), Exception);
+  EXPECT_EQ(2U, dm.GetNumChecksumFailures());
+  EXPECT_TRUE(dm.ReadPageAsync(0, buf, nullptr).get());
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, FailedReadTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  AsyncDiskManager dm("test.db", 8, std::get<0>(GetParam()), std::get<1>(GetParam()));
+
+  // The offset of a negative page id is invalid, so the read fails: a failed future, or an exception.
+  EXPECT_FALSE(dm.ReadPageAsync(-2, buf, nullptr).get());
+  EXPECT_THROW(dm.ReadPage(-2, buf), Exception);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_P(AsyncDiskManagerTest, CompactTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  const off_t extent = static_cast<off_t>(DB_FILE_EXTENT_PAGES) * BUSTUB_PAGE_SIZE;
+  auto file_size = [] {
+    struct stat stat_buf;
+    return stat("test.db", &stat_buf) == 0 ? stat_buf.st_size : -1;
+  };
+  AsyncDiskManager dm("test.db", 8, std::get<0>(GetParam()), std::get<1>(GetParam()));
+  for (int i = 0; i < 16; i++) {
+    dm.WritePage(dm.AllocatePage(1, 0), data);
+  }
+  if (file_size() != extent) {
+    dm.ShutDown();
+    GTEST_SKIP() << "the file system does not preallocate";
+  }
+  for (page_id_t page_id = 8; page_id < 16; page_id++) {
+    dm.DeallocatePage(page_id);
+  }
+
+  // Compaction cuts off the preallocated extent along with the free pages, so growing the file again preallocates anew.
+  dm.Compact();
+  EXPECT_EQ(8 * BUSTUB_PAGE_SIZE, file_size());
+  page_id_t page_id = dm.AllocatePage(1, 0);
+  EXPECT_EQ(8, page_id);
+  dm.WritePage(page_id, data);
+  EXPECT_EQ(extent, file_size());
+
+  dm.ShutDown();
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncDiskManagerTest,
+                         ::testing::Combine(::testing::Values(AsyncIoBackend::Auto, AsyncIoBackend::ThreadPool),
+                                            ::testing::Bool()));
+
+}  // namespace bustub
@@ -12,6 +12,9 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <numeric>
+#include <random>
+#include <set>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -20,7 +23,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -92,7 +95,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -163,4 +166,71 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+/*
+ * Small pages and random order exercise every split, borrow and merge case. Once all keys are gone, every page of
+ * the tree has been given back to the disk manager.
+ */
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, DeleteRandomTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  std::vector<int64_t> keys(2000);
+  std::iota(keys.begin(), keys.end(), 1);
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  std::set<int64_t> expected;
+  auto check = [&]() {
+    std::vector<int64_t> found;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      found.push_back((*iterator).first.ToString());
+    }
+    ASSERT_EQ(found, std::vector<int64_t>(expected.begin(), expected.end()));
+  };
+
+  for (auto key : keys) {
+    rid.Set(0, static_cast<uint32_t>(key));
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+    expected.insert(key);
+  }
+  check();
+
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_key.SetFromInteger(keys[i]);
+    tree.Remove(index_key);
+    expected.erase(keys[i]);
+    if (i % 500 == 0) {
+      check();
+      for (size_t j = i + 1; j < keys.size(); j += 97) {
+        std::vector<RID> rids;
+        index_key.SetFromInteger(keys[j]);
+        ASSERT_TRUE(tree.GetValue(index_key, &rids));
+        ASSERT_EQ(rids[0].GetSlotNum(), keys[j]);
+      }
+    }
+  }
+  check();
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_EQ(disk_manager->GetNumPages() - disk_manager->GetNumFreePages(), 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -12,6 +12,10 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -20,7 +24,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -64,7 +68,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -127,7 +131,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -195,4 +199,281 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  GenericKey<8> index_key;
+  RID rid;
+
+  const int saved_fill_percent = bulk_load_fill_percent;
+  for (int fill_percent : {1, 70, 100}) {
+    bulk_load_fill_percent = fill_percent;
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+    // Shuffled keys with one duplicate, which the bulk load has to sort and drop.
+    std::vector<int64_t> keys(1000);
+    std::iota(keys.begin(), keys.end(), 1);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(fill_percent));
+    keys.push_back(keys.front());
+    std::vector<std::pair<GenericKey<8>, RID>> entries;
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      entries.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+    }
+    ASSERT_TRUE(tree.BulkLoad(&entries));
+    EXPECT_EQ(entries.size(), keys.size() - 1);
+    EXPECT_FALSE(tree.BulkLoad(&entries));
+
+    int64_t current_key = 1;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key = current_key + 1;
+    }
+    EXPECT_EQ(current_key, 1001);
+
+    // The loaded tree has to take inserts and removes like any other.
+    for (int64_t key = 1001; key <= 1200; key++) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+    }
+    for (int64_t key = 1; key <= 1200; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    std::vector<RID> rids;
+    for (int64_t key = 1; key <= 1200; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+    }
+    for (int64_t key = 2; key <= 1200; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+  bulk_load_fill_percent = saved_fill_percent;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, PackedKeysTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  GenericKey<64> index_key;
+  std::vector<RID> rids;
+
+  {
+    // Whole 64 byte keys would need three levels for this many entries. Small integers take two bytes of each.
+    BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+    std::vector<int64_t> keys(20000);
+    std::iota(keys.begin(), keys.end(), 1);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+    }
+    auto *root_page = bpm->FetchPage(tree.GetRootPageId());
+    auto *root = reinterpret_cast<BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>> *>(
+        root_page->GetData());
+    ASSERT_FALSE(root->IsLeafPage());
+    auto *child_page = bpm->FetchPage(root->ValueAt(0));
+    EXPECT_TRUE(reinterpret_cast<BPlusTreePage *>(child_page->GetData())->IsLeafPage());
+    bpm->UnpinPage(child_page->GetPageId(), false);
+    bpm->UnpinPage(root_page->GetPageId(), false);
+
+    for (int64_t key = 1; key <= 20000; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+  }
+
+  {
+    // Keys of every width: the comparator only reads the integer, the pages have to keep every byte.
+    BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+    std::mt19937 rng(1);
+    std::vector<GenericKey<64>> index_keys(5000);
+    for (int64_t key = 1; key <= 5000; key++) {
+      auto &tailed_key = index_keys[key - 1];
+      tailed_key.SetFromInteger(key);
+      int width = static_cast<int>(rng() % 57);
+      for (int i = 0; i < width; i++) {
+        tailed_key.data_[8 + i] = static_cast<char>(rng() % 255 + 1);
+      }
+    }
+    std::vector<int64_t> keys(5000);
+    std::iota(keys.begin(), keys.end(), 1);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto key : keys) {
+      EXPECT_TRUE(tree.Insert(index_keys[key - 1], RID(0, key)));
+    }
+    int64_t current_key = 1;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      EXPECT_EQ(memcmp((*iterator).first.data_, index_keys[current_key - 1].data_, 64), 0);
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key = current_key + 1;
+    }
+    EXPECT_EQ(current_key, 5001);
+
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < keys.size(); i++) {
+      tree.Remove(index_keys[keys[i] - 1]);
+      if (i % 500 == 0) {
+        for (size_t j = 0; j < keys.size(); j++) {
+          rids.clear();
+          EXPECT_EQ(tree.GetValue(index_keys[keys[j] - 1], &rids), j > i);
+        }
+      }
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, VarcharKeyTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a varchar(500)");
+  VarlenComparator<512> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<VarlenKey<512>, RID, VarlenComparator<512>> tree("foo_pk", bpm, comparator);
+  auto make_key = [&](const std::string &str) {
+    VarlenKey<512> index_key;
+    index_key.SetFromKey(Tuple({Value(TypeId::VARCHAR, str)}, key_schema.get()));
+    return index_key;
+  };
+
+  // Strings of 1 to 400 characters, so that a page holds anywhere from a handful of entries to hundreds.
+  std::mt19937 rng(0);
+  std::vector<std::string> strings;
+  for (int i = 0; i < 3000; i++) {
+    int length = rng() % 10 == 0 ? static_cast<int>(rng() % 400) : static_cast<int>(rng() % 20);
+    std::string str = std::to_string(i);
+    for (int j = 0; j < length; j++) {
+      str += static_cast<char>('a' + rng() % 26);
+    }
+    strings.push_back(str);
+  }
+  std::sort(strings.begin(), strings.end());
+  std::vector<int64_t> order(strings.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), rng);
+  for (auto i : order) {
+    EXPECT_TRUE(tree.Insert(make_key(strings[i]), RID(0, i)));
+  }
+  EXPECT_FALSE(tree.Insert(make_key(strings[0]), RID(0, 0)));
+
+  std::vector<RID> rids;
+  for (size_t i = 0; i < strings.size(); i++) {
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(make_key(strings[i]), &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), i);
+  }
+  size_t current = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToValue(key_schema.get(), 0).ToString(), strings[current]);
+    current++;
+  }
+  EXPECT_EQ(current, strings.size());
+
+  // Keys that do not fit are rejected rather than cut short.
+  EXPECT_THROW(make_key(std::string(600, 'a')), Exception);
+
+  std::shuffle(order.begin(), order.end(), rng);
+  for (auto i : order) {
+    tree.Remove(make_key(strings[i]));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // An empty tree finds nothing.
+  std::vector<GenericKey<8>> probes(3);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(1);
+  }
+  std::vector<std::vector<RID>> results;
+  EXPECT_EQ(0, tree.GetValues(probes, &results));
+  EXPECT_EQ(3, results.size());
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+
+  // Probes in any order, with duplicates and keys that are not there.
+  std::mt19937_64 rng(0);
+  probes.clear();
+  for (int i = 0; i < 300; i++) {
+    probes.emplace_back();
+    probes.back().SetFromInteger(static_cast<int64_t>(rng() % 1100) - 50);
+  }
+  results.clear();
+  size_t found = tree.GetValues(probes, &results);
+  ASSERT_EQ(probes.size(), results.size());
+  size_t expected_found = 0;
+  for (size_t i = 0; i < probes.size(); i++) {
+    std::vector<RID> expected;
+    tree.GetValue(probes[i], &expected);
+    expected_found += expected.size();
+    EXPECT_EQ(expected, results[i]) << probes[i];
+  }
+  EXPECT_EQ(expected_found, found);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
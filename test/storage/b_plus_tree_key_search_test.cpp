@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, VectorMatchesScalarTest) {
+  std::mt19937_64 rng(0);
+  std::vector<int64_t> interesting = {INT64_MIN, INT64_MIN + 1, -1, 0, 1, INT64_MAX - 1, INT64_MAX};
+  int64_t block[KeySearch::BLOCK_SIZE];
+  for (int round = 0; round < 10000; round++) {
+    for (auto &key : block) {
+      key = round % 2 == 0 ? static_cast<int64_t>(rng()) : interesting[rng() % interesting.size()];
+    }
+    std::sort(block, block + KeySearch::BLOCK_SIZE);
+    int64_t bound = round % 3 == 0 ? block[rng() % KeySearch::BLOCK_SIZE] : static_cast<int64_t>(rng());
+    EXPECT_EQ(KeySearch::CountBelowScalar(block, bound), KeySearch::CountBelow(block, bound));
+  }
+}
+
+/** Fill a leaf and an internal page with keys of type column_type, then search them with and without integer keys. */
+template <size_t KeySize>
+void CheckPageSearch(const std::string &column_type, int64_t min, int64_t max) {
+  using KeyType = GenericKey<KeySize>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, RID, GenericComparator<KeySize>>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, GenericComparator<KeySize>>;
+
+  auto key_schema = ParseCreateStatement("a " + column_type);
+  GenericComparator<KeySize> integer_comparator(key_schema.get());
+  GenericComparator<KeySize> value_comparator(key_schema.get(), false);
+  ASSERT_NE(0, integer_comparator.IntegerKeySize());
+  ASSERT_EQ(0, value_comparator.IntegerKeySize());
+
+  auto make_key = [&](int64_t integer) {
+    std::vector<Value> values;
+    if (column_type == "smallint") {
+      values.emplace_back(TypeId::SMALLINT, static_cast<int16_t>(integer));
+    } else if (column_type == "integer") {
+      values.emplace_back(TypeId::INTEGER, static_cast<int32_t>(integer));
+    } else {
+      values.emplace_back(TypeId::BIGINT, integer);
+    }
+    KeyType key;
+    key.SetFromKey(Tuple(values, key_schema.get()));
+    return key;
+  };
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  for (int count : {0, 1, 2, 7, 8, 9, 100, 300}) {
+    std::vector<int64_t> integers;
+    for (int i = 0; i < count; i++) {
+      integers.push_back(dist(rng));
+    }
+    std::sort(integers.begin(), integers.end());
+    integers.erase(std::unique(integers.begin(), integers.end()), integers.end());
+
+    std::vector<std::pair<KeyType, RID>> leaf_items;
+    std::vector<std::pair<KeyType, page_id_t>> internal_items;
+    for (auto integer : integers) {
+      leaf_items.emplace_back(make_key(integer), RID(0, 0));
+      internal_items.emplace_back(make_key(integer), 0);
+    }
+    alignas(8) char leaf_data[BUSTUB_PAGE_SIZE] = {};
+    alignas(8) char internal_data[BUSTUB_PAGE_SIZE] = {};
+    auto *leaf = reinterpret_cast<LeafPage *>(leaf_data);
+    auto *internal = reinterpret_cast<InternalPage *>(internal_data);
+    leaf->Init(1);
+    internal->Init(2);
+    leaf->SetItems(leaf_items.data(), static_cast<int>(leaf_items.size()));
+    internal->SetItems(internal_items.data(), static_cast<int>(internal_items.size()));
+
+    std::vector<int64_t> probes = {min, max};
+    for (auto integer : integers) {
+      probes.push_back(integer);
+      probes.push_back(std::max(integer - 1, min));
+      probes.push_back(std::min(integer + 1, max));
+    }
+    for (auto probe : probes) {
+      KeyType key = make_key(probe);
+      EXPECT_EQ(leaf->KeyIndex(key, value_comparator), leaf->KeyIndex(key, integer_comparator)) << probe;
+      EXPECT_EQ(internal->Lookup(key, value_comparator), internal->Lookup(key, integer_comparator)) << probe;
+      EXPECT_EQ(value_comparator(key, make_key(0)), integer_comparator(key, make_key(0))) << probe;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, IntegerKeysMatchValueKeysTest) {
+  // NULL is the minimum of each type, which the two comparators order differently, so the ranges leave it out.
+  CheckPageSearch<4>("smallint", INT16_MIN + 1, INT16_MAX);
+  CheckPageSearch<4>("integer", INT32_MIN + 1, INT32_MAX);
+  CheckPageSearch<8>("bigint", INT64_MIN + 1, INT64_MAX);
+  CheckPageSearch<8>("bigint", -100, 100);
+}
+
+}  // namespace bustub
@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
+#include <cstdio>
 #include <cstring>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
@@ -24,12 +27,16 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.crc");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.crc");
   };
 };
 
@@ -72,6 +79,257 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePagesAreReusedTest) {
+  auto dm = DiskManager("test.db");
+  for (page_id_t i = 0; i < 4; i++) {
+    EXPECT_EQ(i, dm.AllocatePage(1, 0));
+  }
+  dm.DeallocatePage(1);
+  dm.DeallocatePage(1);    // already free
+  dm.DeallocatePage(100);  // never allocated
+  EXPECT_EQ(1U, dm.GetNumFreePages());
+  EXPECT_FALSE(dm.IsAllocated(1));
+  EXPECT_TRUE(dm.IsAllocated(2));
+  EXPECT_EQ(1, dm.AllocatePage(1, 0));
+  EXPECT_EQ(4, dm.AllocatePage(1, 0));
+  EXPECT_EQ(0U, dm.GetNumFreePages());
+
+  // With several buffer pool instances, a freed page only goes to the instance its id maps to.
+  auto mem = DiskManager();
+  EXPECT_EQ(0, mem.AllocatePage(2, 0));
+  EXPECT_EQ(2, mem.AllocatePage(2, 0));
+  EXPECT_EQ(1, mem.AllocatePage(2, 1));
+  EXPECT_FALSE(mem.IsAllocated(3));
+  mem.DeallocatePage(2);
+  EXPECT_EQ(3, mem.AllocatePage(2, 1));
+  EXPECT_EQ(2, mem.AllocatePage(2, 0));
+  EXPECT_EQ(4, mem.GetNumPages());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePagesByInstanceTest) {
+  auto dm = DiskManager();
+  for (page_id_t i = 0; i < 300; i++) {
+    EXPECT_EQ(i, dm.AllocatePage(3, i % 3));
+  }
+  // Free every page of instance 1 and the upper half of instance 2, highest first.
+  for (page_id_t i = 299; i >= 0; i--) {
+    if (i % 3 == 1 || (i % 3 == 2 && i >= 150)) {
+      dm.DeallocatePage(i);
+    }
+  }
+  EXPECT_EQ(150U, dm.GetNumFreePages());
+
+  // Each instance gets the lowest free page that maps to it, or a fresh one.
+  EXPECT_EQ(300, dm.AllocatePage(3, 0));
+  EXPECT_EQ(1, dm.AllocatePage(3, 1));
+  EXPECT_EQ(4, dm.AllocatePage(3, 1));
+  EXPECT_EQ(152, dm.AllocatePage(3, 2));
+  EXPECT_EQ(147U, dm.GetNumFreePages());
+
+  // With another number of instances, the free pages are sorted by the instance they map to now.
+  EXPECT_EQ(7, dm.AllocatePage(2, 1));
+  EXPECT_EQ(10, dm.AllocatePage(2, 0));
+  EXPECT_EQ(145U, dm.GetNumFreePages());
+  EXPECT_FALSE(dm.IsAllocated(13));
+  EXPECT_TRUE(dm.IsAllocated(152));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreeSpaceMapPersistsTest) {
+  {
+    auto dm = DiskManager("test.db");
+    for (int i = 0; i < 8; i++) {
+      dm.AllocatePage(1, 0);
+    }
+    dm.DeallocatePage(2);
+    dm.DeallocatePage(5);
+    dm.ShutDown();
+  }
+  {
+    auto dm = DiskManager("test.db");
+    EXPECT_EQ(8, dm.GetNumPages());
+    EXPECT_EQ(2U, dm.GetNumFreePages());
+    EXPECT_EQ(2, dm.AllocatePage(1, 0));
+    // Not shut down: the page might still be handed out after a crash, so the map is not trusted any more.
+  }
+  {
+    auto dm = DiskManager("test.db");
+    EXPECT_EQ(0U, dm.GetNumFreePages());
+    EXPECT_LE(8, dm.AllocatePage(1, 0));
+    dm.ShutDown();
+  }
+
+  // A map that outlived its db file is ignored.
+  remove("test.db");
+  auto dm = DiskManager("test.db");
+  EXPECT_EQ(0, dm.GetNumPages());
+  EXPECT_EQ(0, dm.AllocatePage(1, 0));
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompactTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto dm = DiskManager("test.db");
+  for (int i = 0; i < 16; i++) {
+    dm.WritePage(dm.AllocatePage(1, 0), data);
+  }
+  dm.DeallocatePage(3);
+  for (page_id_t page_id = 12; page_id < 16; page_id++) {
+    dm.DeallocatePage(page_id);
+  }
+
+  // The free pages at the end are cut off; page 3 keeps its id.
+  EXPECT_LE(4U, dm.Compact());
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat("test.db", &stat_buf));
+  EXPECT_EQ(12 * BUSTUB_PAGE_SIZE, stat_buf.st_size);
+  EXPECT_EQ(12, dm.GetNumPages());
+  EXPECT_EQ(1U, dm.GetNumFreePages());
+  EXPECT_EQ(3, dm.AllocatePage(1, 0));
+  EXPECT_EQ(12, dm.AllocatePage(1, 0));
+
+  dm.ShutDown();
+}
+
+/** Overwrite bytes of a page in the db file behind the disk manager's back, as a torn write or bad device would. */
+static void OverwritePage(page_id_t page_id, size_t offset, const char *bytes, size_t size) {
+  FILE *file = fopen("test.db", "r+b");
+  ASSERT_NE(nullptr, file);
+  fseek(file, static_cast<long>(page_id) * BUSTUB_PAGE_SIZE + static_cast<long>(offset), SEEK_SET);  // NOLINT
+  fwrite(bytes, 1, size, file);
+  fclose(file);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ChecksumTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto dm = DiskManager("test.db");
+  ASSERT_TRUE(dm.HasChecksums());
+  for (int i = 0; i < 4; i++) {
+    snprintf(data, sizeof(data), "page %d", i);
+    dm.WritePage(dm.AllocatePage(1, 0), data);
+  }
+
+  // The second half of a page never made it to disk.
+  OverwritePage(1, BUSTUB_PAGE_SIZE / 2, "torn", 4);
+  EXPECT_THROW(dm.ReadPage(1, buf), Exception);
+  EXPECT_EQ(1U, dm.GetNumChecksumFailures());
+  dm.ReadPage(0, buf);
+  EXPECT_STREQ("page 0", buf);
+
+  // A crash after the checksum of a new version was recorded leaves the previous version, which is still accepted.
+  char old_version[BUSTUB_PAGE_SIZE] = {0};
+  snprintf(old_version, sizeof(old_version), "page 2");
+  snprintf(data, sizeof(data), "page 2, version 2");
+  dm.WritePage(2, data);
+  OverwritePage(2, 0, old_version, BUSTUB_PAGE_SIZE);
+  dm.ReadPage(2, buf);
+  EXPECT_STREQ("page 2", buf);
+  EXPECT_EQ(1U, dm.GetNumChecksumFailures());
+
+  // A freed page has nothing to verify: its next owner may read it before writing it.
+  dm.DeallocatePage(1);
+  EXPECT_EQ(1, dm.AllocatePage(1, 0));
+  dm.ReadPage(1, buf);
+
+  // The buffer pool does not keep a frame for a page it could not read.
+  OverwritePage(3, 100, "bit rot", 7);
+  auto *bpm = new BufferPoolManagerInstance(2, &dm);
+  EXPECT_THROW(bpm->FetchPage(3), Exception);
+  for (page_id_t page_id : {0, 2}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_TRUE(bpm->UnpinPage(2, false));
+  delete bpm;
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ChecksumPersistsTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  snprintf(data, sizeof(data), "A test string.");
+  {
+    auto dm = DiskManager("test.db");
+    dm.WritePage(0, data);
+    dm.ShutDown();
+  }
+  // The checksums outlive the disk manager, and the database keeps them when the setting changes.
+  OverwritePage(0, 0, "a", 1);
+  enable_page_checksums = false;
+  {
+    auto dm = DiskManager("test.db");
+    EXPECT_TRUE(dm.HasChecksums());
+    EXPECT_THROW(dm.ReadPage(0, buf), Exception);
+    dm.ShutDown();
+  }
+
+  // A new database without checksums ignores a checksum file left behind, and reads the page as it is.
+  remove("test.db");
+  {
+    auto dm = DiskManager("test.db");
+    EXPECT_FALSE(dm.HasChecksums());
+    dm.WritePage(0, data);
+    dm.ShutDown();
+  }
+  OverwritePage(0, 0, "a", 1);
+  enable_page_checksums = true;
+  auto dm = DiskManager("test.db");
+  EXPECT_FALSE(dm.HasChecksums());
+  dm.ReadPage(0, buf);
+  EXPECT_STREQ("a test string.", buf);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, TornPageAfterCrashTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  // Both halves of a page differ from one version to the next.
+  auto make_version = [](page_id_t page_id, int version, char *data) {
+    memset(data, 0, BUSTUB_PAGE_SIZE);
+    snprintf(data, BUSTUB_PAGE_SIZE, "page %d, version %d", page_id, version);
+    snprintf(data + BUSTUB_PAGE_SIZE / 2, BUSTUB_PAGE_SIZE / 2, "half of version %d", version);
+  };
+  char versions[4][BUSTUB_PAGE_SIZE];
+  {
+    auto dm = DiskManager("test.db");
+    for (int version = 1; version <= 3; version++) {
+      make_version(0, version, versions[version]);
+      dm.WritePage(0, versions[version]);
+    }
+    make_version(1, 1, buf);
+    dm.WritePage(1, buf);
+    make_version(1, 2, buf);
+    dm.WritePage(1, buf);
+    // Not shut down: the machine crashed.
+  }
+  // The last write of page 0 never reached the disk, and the last write of page 1 was torn halfway.
+  OverwritePage(0, 0, versions[2], BUSTUB_PAGE_SIZE);
+  make_version(1, 1, buf);
+  OverwritePage(1, BUSTUB_PAGE_SIZE / 2, buf + BUSTUB_PAGE_SIZE / 2, BUSTUB_PAGE_SIZE / 2);
+
+  auto dm = DiskManager("test.db");
+  dm.ReadPage(0, buf);
+  EXPECT_STREQ("page 0, version 2", buf);
+  EXPECT_EQ(0U, dm.GetNumChecksumFailures());
+  EXPECT_THROW(dm.ReadPage(1, buf), Exception);
+  EXPECT_EQ(1U, dm.GetNumChecksumFailures());
+
+  // Page 0 was synced before its checksum of version 1 was dropped, so it can't be that old.
+  OverwritePage(0, 0, versions[1], BUSTUB_PAGE_SIZE);
+  EXPECT_THROW(dm.ReadPage(0, buf), Exception);
+  EXPECT_EQ(2U, dm.GetNumChecksumFailures());
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
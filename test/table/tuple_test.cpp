@@ -14,13 +14,16 @@
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +74,90 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, MoveTest) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"s", TypeId::VARCHAR, 16}}};
+  auto make = [&](int i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))};
+    return Tuple(values, &schema);
+  };
+
+  Tuple first = make(1);
+  Tuple moved(std::move(first));
+  ASSERT_TRUE(moved.IsAllocated());
+  EXPECT_EQ(1, moved.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(nullptr, first.GetData());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(0, first.GetLength());
+
+  // Moving onto an owning tuple frees what it owned and takes over the other's data.
+  Tuple second = make(22);
+  auto *data = second.GetData();
+  moved = std::move(second);
+  EXPECT_EQ(data, moved.GetData());
+  EXPECT_EQ(22, moved.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ("22", moved.GetValue(&schema, 1).ToString());
+  EXPECT_FALSE(second.IsAllocated());  // NOLINT(bugprone-use-after-move)
+
+  // A moved-from tuple can be assigned again, by move or by copy.
+  second = make(333);
+  EXPECT_EQ(333, second.GetValue(&schema, 0).GetAs<int32_t>());
+  first = second;
+  EXPECT_NE(second.GetData(), first.GetData());
+  EXPECT_EQ("333", first.GetValue(&schema, 1).ToString());
+
+  // Moving a tuple onto itself leaves it as it was.
+  auto &self = moved;
+  moved = std::move(self);
+  EXPECT_EQ(22, moved.GetValue(&schema, 0).GetAs<int32_t>());
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, PageIdsTest) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"s", TypeId::VARCHAR, 512}}};
+  auto make = [&](int i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(500, 'x'))};
+    return Tuple(values, &schema);
+  };
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(16, disk_manager);
+  Transaction txn(0);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, &txn);
+  for (int i = 0; i < 500; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(make(i), &rid, &txn));
+  }
+
+  // The pages in the order a scan visits them.
+  std::vector<page_id_t> scanned;
+  for (auto it = table->Begin(&txn); it != table->End(); ++it) {
+    if (scanned.empty() || scanned.back() != it->GetRid().GetPageId()) {
+      scanned.push_back(it->GetRid().GetPageId());
+    }
+  }
+  ASSERT_GT(scanned.size(), 16);
+
+  // The ids come from the pages the inserts linked, without fetching any.
+  auto before = buffer_pool_manager->GetStats();
+  EXPECT_EQ(scanned, table->GetPageIds());
+  auto after = buffer_pool_manager->GetStats();
+  EXPECT_EQ(before.hits_ + before.misses_, after.hits_ + after.misses_);
+
+  // An opened table walks its pages once, and then keeps up with its inserts.
+  auto *opened = new TableHeap(buffer_pool_manager, nullptr, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(scanned, opened->GetPageIds());
+  for (int i = 0; i < 100; i++) {
+    RID rid;
+    ASSERT_TRUE(opened->InsertTuple(make(i), &rid, &txn));
+  }
+  auto page_ids = opened->GetPageIds();
+  ASSERT_GT(page_ids.size(), scanned.size());
+  EXPECT_TRUE(std::equal(scanned.begin(), scanned.end(), page_ids.begin()));
+
+  delete opened;
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "execution/tuple_batch.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-batch-bench");
+  program.add_argument("--rounds").help("number of times each query runs in each mode");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rounds = 3;
+  if (program.present("--rounds")) {
+    rounds = std::stoul(program.get("--rounds"));
+  }
+
+  // Scans, filters and projections over the 1M-row leaderboard table. The selective queries keep the cost of
+  // writing out the results from drowning the executors.
+  const std::vector<std::string> queries = {
+      "SELECT x FROM __mock_t4_1m WHERE x > 490000",
+      "SELECT x + y FROM __mock_t4_1m WHERE y < 10000",
+      "SELECT x, y FROM __mock_t4_1m WHERE x = 7 AND y = 70",
+  };
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub->GenerateMockTable();
+  fmt::print(stderr, "x: {} rounds, batches of {} rows\n", rounds, bustub::TupleBatch::DEFAULT_CAPACITY);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>6} {:>10} {:>10} {:>8}\n", "query", "tuple_ms", "batch_ms", "speedup");
+  for (size_t q = 0; q < queries.size(); q++) {
+    uint64_t elapsed[2];
+    for (bool batched : {false, true}) {
+      bustub::enable_batch_execution = batched;
+      uint64_t start = ClockMs();
+      for (size_t r = 0; r < rounds; r++) {
+        bustub::NoopWriter writer;
+        bustub->ExecuteSql(queries[q], writer);
+      }
+      elapsed[batched ? 1 : 0] = std::max<uint64_t>(ClockMs() - start, 1);
+    }
+    fmt::print("{:>6} {:>10} {:>10} {:>8.2f}\n", q + 1, elapsed[0], elapsed[1],
+               static_cast<double>(elapsed[0]) / static_cast<double>(elapsed[1]));
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
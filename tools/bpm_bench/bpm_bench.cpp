@@ -0,0 +1,140 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/**
+ * Run `num_threads` threads that repeatedly fetch and unpin a random page out of `num_pages` for `duration_ms`.
+ * @return the number of completed fetch/unpin pairs per second
+ */
+auto RunFetchUnpin(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids, size_t num_threads,
+                   uint64_t duration_ms) -> double {
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> total_ops{0};
+  std::vector<std::thread> threads;
+
+  uint64_t start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937_64 rng(tid);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      uint64_t ops = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto page_id = page_ids[dist(rng)];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        bpm->UnpinPage(page_id, false);
+        ops++;
+      }
+      total_ops += ops;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  uint64_t elapsed = ClockMs() - start;
+  return static_cast<double>(total_ops) / static_cast<double>(elapsed) * 1000;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-bpm-bench");
+  program.add_argument("--duration").help("run each configuration for n milliseconds");
+  program.add_argument("--frames").help("total number of frames in the buffer pool");
+  program.add_argument("--pages").help("number of distinct pages the workers touch");
+  program.add_argument("--instances").help("number of instances of the parallel buffer pool");
+  program.add_argument("--threads").help("maximum number of worker threads");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 1000;
+  size_t frames = 1024;
+  size_t pages = 512;
+  size_t instances = 8;
+  size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  if (program.present("--duration")) {
+    duration_ms = std::stoul(program.get("--duration"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--pages")) {
+    pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--instances")) {
+    instances = std::stoul(program.get("--instances"));
+  }
+  if (program.present("--threads")) {
+    max_threads = std::stoul(program.get("--threads"));
+  }
+  frames = std::max(frames / instances * instances, instances);
+
+  fmt::print(stderr, "x: {} frames, {} pages, {} instances, {}ms per run\n", frames, pages, instances, duration_ms);
+
+  struct Config {
+    std::string name_;
+    size_t num_instances_;
+  };
+  std::vector<Config> configs{{"instance", 1}, {"parallel", instances}};
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>10} {:>8} {:>16}\n", "bpm", "threads", "fetch+unpin/s");
+  for (const auto &config : configs) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+    std::unique_ptr<bustub::BufferPoolManager> bpm;
+    if (config.num_instances_ == 1) {
+      bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+    } else {
+      bpm = std::make_unique<bustub::ParallelBufferPoolManager>(config.num_instances_, frames / config.num_instances_,
+                                                                disk_manager.get());
+    }
+
+    std::vector<bustub::page_id_t> page_ids;
+    for (size_t i = 0; i < pages; i++) {
+      bustub::page_id_t page_id;
+      if (bpm->NewPage(&page_id) == nullptr) {
+        std::cerr << "failed to create page " << i << ", the pool is too small" << std::endl;
+        return 1;
+      }
+      bpm->UnpinPage(page_id, true);
+      page_ids.push_back(page_id);
+    }
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+      double throughput = RunFetchUnpin(bpm.get(), page_ids, threads, duration_ms);
+      fmt::print("{:>10} {:>8} {:>16.0f}\n", config.name_, threads, throughput);
+    }
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+using Tree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+struct RunResult {
+  uint64_t lookups_;
+  uint64_t inserts_;
+  uint64_t elapsed_ms_;
+};
+
+/**
+ * Let `threads` threads look up random existing keys, with `insert_percent` of the operations inserting a new key
+ * instead, for `duration_ms`. With a global latch every operation holds one mutex, which is what a tree that latches
+ * its root for every operation comes down to under contention.
+ */
+auto Run(Tree *tree, size_t threads, int64_t keys, std::atomic<int64_t> *next_key, int insert_percent,
+         uint64_t duration_ms, bool global_latch) -> RunResult {
+  std::atomic<bool> stop = false;
+  std::atomic<uint64_t> lookups = 0;
+  std::atomic<uint64_t> inserts = 0;
+  std::mutex latch;
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      bustub::GenericKey<8> index_key;
+      std::vector<bustub::RID> result;
+      uint64_t my_lookups = 0;
+      uint64_t my_inserts = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        bool insert = static_cast<int>(rng() % 100) < insert_percent;
+        int64_t key = insert ? next_key->fetch_add(1) : static_cast<int64_t>(rng() % keys);
+        index_key.SetFromInteger(key);
+        std::unique_lock lock(latch, std::defer_lock);
+        if (global_latch) {
+          lock.lock();
+        }
+        if (insert) {
+          tree->Insert(index_key, bustub::RID(0, static_cast<uint32_t>(key)));
+          my_inserts++;
+        } else {
+          result.clear();
+          if (!tree->GetValue(index_key, &result)) {
+            fmt::print(stderr, "x: key {} not found\n", key);
+          }
+          my_lookups++;
+        }
+      }
+      lookups += my_lookups;
+      inserts += my_inserts;
+    });
+  }
+  uint64_t start = ClockMs();
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  stop = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return {lookups, inserts, std::max<uint64_t>(ClockMs() - start, 1)};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--keys").help("number of keys loaded before the runs");
+  program.add_argument("--max-threads").help("largest thread count; runs double the count from 1");
+  program.add_argument("--insert-percent").help("share of operations that insert a new key");
+  program.add_argument("--duration").help("length of each run in milliseconds");
+  program.add_argument("--frames").help("buffer pool size in pages");
+  program.add_argument("--batch").help("number of keys per GetValues call in the batched lookup run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  int64_t keys = 100000;
+  size_t max_threads = 64;
+  int insert_percent = 5;
+  uint64_t duration_ms = 1000;
+  size_t frames = 8192;
+  size_t batch = 1024;
+  if (program.present("--keys")) {
+    keys = std::stol(program.get("--keys"));
+  }
+  if (program.present("--max-threads")) {
+    max_threads = std::stoul(program.get("--max-threads"));
+  }
+  if (program.present("--insert-percent")) {
+    insert_percent = std::stoi(program.get("--insert-percent"));
+  }
+  if (program.present("--duration")) {
+    duration_ms = std::stoul(program.get("--duration"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--batch")) {
+    batch = std::stoul(program.get("--batch"));
+  }
+
+  bustub::Schema key_schema({bustub::Column("a", bustub::TypeId::BIGINT)});
+  bustub::GenericComparator<8> comparator(&key_schema);
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  Tree tree("btree_bench", bpm.get(), comparator);
+
+  bustub::GenericKey<8> index_key;
+  for (int64_t key = 0; key < keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, bustub::RID(0, static_cast<uint32_t>(key)));
+  }
+  std::atomic<int64_t> next_key = keys;
+  fmt::print(stderr, "x: {} keys, {}% inserts, {} ms per run, {} frames\n", keys, insert_percent, duration_ms, frames);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>8} {:>16} {:>16} {:>8}\n", "threads", "olc_lookups_s", "mutex_lookups_s", "speedup");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    RunResult olc = Run(&tree, threads, keys, &next_key, insert_percent, duration_ms, false);
+    RunResult mutex = Run(&tree, threads, keys, &next_key, insert_percent, duration_ms, true);
+    double olc_rate = static_cast<double>(olc.lookups_) * 1000 / olc.elapsed_ms_;
+    double mutex_rate = static_cast<double>(mutex.lookups_) * 1000 / mutex.elapsed_ms_;
+    fmt::print("{:>8} {:>16.0f} {:>16.0f} {:>8.2f}\n", threads, olc_rate, mutex_rate,
+               olc_rate / std::max(mutex_rate, 1.0));
+  }
+
+  // One thread looking up random keys one at a time, and then in batches, like the outer side of an index join.
+  fmt::print("{:>8} {:>16} {:>16} {:>8}\n", "batch", "single_keys_s", "batched_keys_s", "speedup");
+  std::mt19937_64 rng(0);
+  std::vector<bustub::GenericKey<8>> probes(batch);
+  std::vector<std::vector<bustub::RID>> results;
+  std::vector<bustub::RID> result;
+  uint64_t rates[2];
+  for (bool batched : {false, true}) {
+    uint64_t looked_up = 0;
+    uint64_t start = ClockMs();
+    while (ClockMs() - start < duration_ms) {
+      for (auto &probe : probes) {
+        probe.SetFromInteger(static_cast<int64_t>(rng() % keys));
+      }
+      if (batched) {
+        results.clear();
+        looked_up += tree.GetValues(probes, &results);
+        continue;
+      }
+      for (const auto &probe : probes) {
+        result.clear();
+        looked_up += tree.GetValue(probe, &result) ? 1 : 0;
+      }
+    }
+    rates[batched ? 1 : 0] = looked_up * 1000 / std::max<uint64_t>(ClockMs() - start, 1);
+  }
+  fmt::print("{:>8} {:>16} {:>16} {:>8.2f}\n", batch, rates[0], rates[1],
+             static_cast<double>(rates[1]) / static_cast<double>(std::max<uint64_t>(rates[0], 1)));
+  fmt::print(">>> END\n");
+  bpm->UnpinPage(header_page_id, true);
+  return 0;
+}
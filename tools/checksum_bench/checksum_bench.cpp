@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/config.h"
+#include "common/util/crc32c.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/** Remove a database file and the files that go with it. */
+void RemoveDb(const std::string &file) {
+  std::string base = file.substr(0, file.rfind('.'));
+  for (const auto &name : {file, base + ".log", base + ".fsm", base + ".crc"}) {
+    std::remove(name.c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-checksum-bench");
+  program.add_argument("--pages").help("number of pages written and read per run");
+  program.add_argument("--rounds").help("number of times the pages are checksummed in memory");
+  program.add_argument("--file").help("database file to use");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pages = 4096;
+  size_t rounds = 16;
+  std::string file = "checksum_bench.db";
+  if (program.present("--pages")) {
+    pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--rounds")) {
+    rounds = std::stoul(program.get("--rounds"));
+  }
+  if (program.present("--file")) {
+    file = program.get("--file");
+  }
+
+  std::mt19937_64 rng(0);
+  std::vector<char> data(pages * bustub::BUSTUB_PAGE_SIZE);
+  for (auto &c : data) {
+    c = static_cast<char>(rng());
+  }
+  fmt::print(stderr, "x: {} pages, {} rounds, file {}, crc32 instruction {}\n", pages, rounds, file,
+             bustub::Crc32c::IsHardwareAccelerated() ? "used" : "not available");
+
+  fmt::print("<<< BEGIN\n");
+  // The checksum on its own, with and without the crc32 instruction.
+  fmt::print("{:>10} {:>10} {:>10}\n", "crc32c", "time_ms", "mb_per_s");
+  uint32_t sink = 0;
+  for (bool hardware : {false, true}) {
+    uint64_t start = ClockMs();
+    for (size_t r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < pages; i++) {
+        const char *page = data.data() + i * bustub::BUSTUB_PAGE_SIZE;
+        sink += hardware ? bustub::Crc32c::Compute(page, bustub::BUSTUB_PAGE_SIZE)
+                         : bustub::Crc32c::ComputeSoftware(page, bustub::BUSTUB_PAGE_SIZE);
+      }
+    }
+    uint64_t elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+    double megabytes = static_cast<double>(rounds * data.size()) / (1024 * 1024);
+    fmt::print("{:>10} {:>10} {:>10.0f}\n", hardware ? "hardware" : "software", elapsed, megabytes * 1000 / elapsed);
+  }
+
+  // What the checksums add to the disk manager's write and read paths. Each write syncs the checksum file, and
+  // writing the pages again syncs the db file too. The reads mostly hit the page cache, which makes the checksum as
+  // large a share of their cost as it gets.
+  fmt::print("{:>10} {:>10} {:>10} {:>10}\n", "checksums", "write_ms", "rewrite_ms", "read_ms");
+  std::vector<char> buf(bustub::BUSTUB_PAGE_SIZE);
+  for (bool checksums : {false, true}) {
+    bustub::enable_page_checksums = checksums;
+    RemoveDb(file);
+    bustub::DiskManager disk_manager(file);
+    uint64_t start = ClockMs();
+    for (size_t i = 0; i < pages; i++) {
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), data.data() + i * bustub::BUSTUB_PAGE_SIZE);
+    }
+    uint64_t write_ms = ClockMs() - start;
+    start = ClockMs();
+    for (size_t i = 0; i < pages; i++) {
+      // Other contents than the first time, so the checksums change.
+      const char *page = data.data() + (pages - 1 - i) * bustub::BUSTUB_PAGE_SIZE;
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), page);
+    }
+    uint64_t rewrite_ms = ClockMs() - start;
+    start = ClockMs();
+    for (size_t r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < pages; i++) {
+        disk_manager.ReadPage(static_cast<bustub::page_id_t>(rng() % pages), buf.data());
+      }
+    }
+    uint64_t read_ms = ClockMs() - start;
+    disk_manager.ShutDown();
+    fmt::print("{:>10} {:>10} {:>10} {:>10}\n", checksums ? "on" : "off", write_ms, rewrite_ms, read_ms);
+  }
+  fmt::print(">>> END\n");
+  fmt::print(stderr, "x: {:08x}\n", sink);
+  RemoveDb(file);
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/** An in-memory disk whose writes take as long as a write to a real device. */
+class SlowWriteDiskManager : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  explicit SlowWriteDiskManager(std::chrono::microseconds write_latency) : write_latency_(write_latency) {}
+
+  void WritePage(bustub::page_id_t page_id, const char *page_data) override {
+    std::this_thread::sleep_for(write_latency_);
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+ private:
+  std::chrono::microseconds write_latency_;
+};
+
+struct RunResult {
+  uint64_t ops_;
+  uint64_t p50_us_;
+  uint64_t p99_us_;
+  uint64_t max_us_;
+};
+
+/**
+ * Run `num_threads` threads that fetch a random page out of `page_ids`, change it and unpin it dirty, for
+ * `duration_ms`, and collect the latency of every fetch.
+ */
+auto RunUpdates(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids, size_t num_threads,
+                uint64_t duration_ms) -> RunResult {
+  std::atomic<bool> stop{false};
+  std::mutex latencies_latch;
+  std::vector<uint64_t> latencies;
+  std::vector<std::thread> threads;
+
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937_64 rng(tid);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      std::vector<uint64_t> local;
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto page_id = page_ids[dist(rng)];
+        auto start = std::chrono::steady_clock::now();
+        auto *page = bpm->FetchPage(page_id);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (page == nullptr) {
+          continue;
+        }
+        local.push_back(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        page->WLatch();
+        page->GetData()[local.size() % bustub::BUSTUB_PAGE_SIZE]++;
+        page->WUnlatch();
+        bpm->UnpinPage(page_id, true);
+      }
+      std::scoped_lock<std::mutex> lock(latencies_latch);
+      latencies.insert(latencies.end(), local.begin(), local.end());
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (latencies.empty()) {
+    return {0, 0, 0, 0};
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return {latencies.size(), latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back()};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-cleaner-bench");
+  program.add_argument("--duration").help("run each configuration for n milliseconds");
+  program.add_argument("--frames").help("number of frames in the buffer pool");
+  program.add_argument("--pages").help("number of distinct pages the workers update");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--write-us").help("simulated latency of a page write in microseconds");
+  program.add_argument("--clean-target").help("frames closest to eviction the cleaner keeps clean");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 2000;
+  size_t frames = 256;
+  size_t pages = 1024;
+  size_t threads = 4;
+  uint64_t write_us = 100;
+  size_t clean_target = bustub::CLEANER_CLEAN_TARGET;
+  if (program.present("--duration")) {
+    duration_ms = std::stoul(program.get("--duration"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--pages")) {
+    pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--threads")) {
+    threads = std::stoul(program.get("--threads"));
+  }
+  if (program.present("--write-us")) {
+    write_us = std::stoul(program.get("--write-us"));
+  }
+  if (program.present("--clean-target")) {
+    clean_target = std::stoul(program.get("--clean-target"));
+  }
+
+  fmt::print(stderr, "x: {} frames, {} pages, {} threads, {}us per write, {}ms per run\n", frames, pages, threads,
+             write_us, duration_ms);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>16} {:>12} {:>10} {:>10} {:>10}\n", "cleaner threads", "fetches/s", "p50 us", "p99 us", "max us");
+  for (size_t cleaner_threads : {0, 1, 2}) {
+    auto disk_manager = std::make_unique<SlowWriteDiskManager>(std::chrono::microseconds(write_us));
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+
+    std::vector<bustub::page_id_t> page_ids;
+    for (size_t i = 0; i < pages; i++) {
+      bustub::page_id_t page_id;
+      bpm->NewPage(&page_id);
+      bpm->UnpinPage(page_id, true);
+      page_ids.push_back(page_id);
+    }
+
+    if (cleaner_threads > 0) {
+      bpm->StartCleaner(cleaner_threads, clean_target);
+    }
+    auto result = RunUpdates(bpm.get(), page_ids, threads, duration_ms);
+    bpm->StopCleaner();
+    fmt::print("{:>16} {:>12.0f} {:>10} {:>10} {:>10}\n", cleaner_threads,
+               static_cast<double>(result.ops_) / static_cast<double>(duration_ms) * 1000, result.p50_us_,
+               result.p99_us_, result.max_us_);
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
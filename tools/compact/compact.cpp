@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+
+#include "argparse/argparse.hpp"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+
+#include <sys/stat.h>
+
+/** Print the size of the database file and the space it takes on disk. */
+void PrintFileSize(const std::string &label, const std::string &file) {
+  struct stat stat_buf;
+  if (stat(file.c_str(), &stat_buf) != 0) {
+    return;
+  }
+  fmt::print("{:>8}: {:>12} bytes, {:>12} bytes on disk\n", label, stat_buf.st_size,
+             static_cast<uint64_t>(stat_buf.st_blocks) * 512);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-compact");
+  program.add_argument("file").help("database file to compact; no buffer pool may have it open");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto file = program.get<std::string>("file");
+  struct stat stat_buf;
+  if (stat(file.c_str(), &stat_buf) != 0) {
+    std::cerr << "no such database file: " << file << std::endl;
+    return 1;
+  }
+
+  bustub::DiskManager disk_manager(file);
+  fmt::print("{} pages, {} of them free\n", disk_manager.GetNumPages(), disk_manager.GetNumFreePages());
+  PrintFileSize("before", file);
+  size_t released = disk_manager.Compact();
+  PrintFileSize("after", file);
+  fmt::print("{} free pages take up no space, the file now ends after page {}\n", released, disk_manager.GetNumPages());
+  disk_manager.ShutDown();
+  return 0;
+}
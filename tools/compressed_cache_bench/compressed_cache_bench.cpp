@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/** An in-memory disk whose reads take as long as a read from an SSD, and which counts them. */
+class SlowReadDiskManager : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  explicit SlowReadDiskManager(std::chrono::microseconds read_latency) : read_latency_(read_latency) {}
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    reads_++;
+    std::this_thread::sleep_for(read_latency_);
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<size_t> reads_{0};
+
+ private:
+  std::chrono::microseconds read_latency_;
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-compressed-cache-bench");
+  program.add_argument("--rows").help("number of rows in the table");
+  program.add_argument("--frames").help("number of frames in the buffer pool");
+  program.add_argument("--lookups").help("number of random page fetches per configuration");
+  program.add_argument("--read-us").help("read latency of the simulated device");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rows = 40000;
+  size_t frames = 256;
+  size_t lookups = 20000;
+  uint64_t read_us = 100;
+  if (program.present("--rows")) {
+    rows = std::stoul(program.get("--rows"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--lookups")) {
+    lookups = std::stoul(program.get("--lookups"));
+  }
+  if (program.present("--read-us")) {
+    read_us = std::stoul(program.get("--read-us"));
+  }
+
+  SlowReadDiskManager disk_manager{std::chrono::microseconds(read_us)};
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, &disk_manager);
+  // Rows like those of an orders table: integer keys, a small set of statuses and a comment with repeated words.
+  bustub::Schema schema({bustub::Column("id", bustub::TypeId::INTEGER),
+                         bustub::Column("customer", bustub::TypeId::INTEGER),
+                         bustub::Column("status", bustub::TypeId::VARCHAR, 16),
+                         bustub::Column("comment", bustub::TypeId::VARCHAR, 64)});
+  const std::vector<std::string> statuses{"OPEN", "SHIPPED", "DELIVERED", "RETURNED"};
+  const std::vector<std::string> words{"quickly", "carefully", "final", "pending", "deposits", "requests", "ironic"};
+  std::mt19937_64 rng(0);
+  bustub::Transaction txn(0);
+  bustub::TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+  std::vector<bustub::page_id_t> pages;
+  for (size_t i = 0; i < rows; i++) {
+    std::string comment;
+    for (int w = 0; w < 4; w++) {
+      comment += words[rng() % words.size()] + " ";
+    }
+    bustub::Tuple tuple({bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                         bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(rng() % 1000)),
+                         bustub::ValueFactory::GetVarcharValue(statuses[rng() % statuses.size()]),
+                         bustub::ValueFactory::GetVarcharValue(comment)},
+                        &schema);
+    bustub::RID rid;
+    table.InsertTuple(tuple, &rid, &txn);
+    if (pages.empty() || pages.back() != rid.GetPageId()) {
+      pages.push_back(rid.GetPageId());
+    }
+  }
+  bpm->FlushAllPages();
+  fmt::print(stderr, "x: {} rows in {} pages, {} frames, {}us per read\n", rows, pages.size(), frames, read_us);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>12} {:>10} {:>10} {:>10} {:>12} {:>8}\n", "cache_pages", "time_ms", "disk_reads", "mem_hits",
+             "cache_hits", "compress");
+  // The compressed cache gets as much memory as some number of extra frames would take.
+  for (size_t cache_pages : {size_t{0}, frames / 4, frames / 2, frames}) {
+    bpm->EnableCompressedCache(cache_pages * bustub::BUSTUB_PAGE_SIZE);
+    std::mt19937_64 lookup_rng(1);
+    // Warm up the pool and the cache on the same distribution, then measure.
+    for (size_t i = 0; i < lookups / 4; i++) {
+      auto page_id = pages[lookup_rng() % pages.size()];
+      bpm->FetchPage(page_id);
+      bpm->UnpinPage(page_id, false);
+    }
+    size_t reads = disk_manager.reads_;
+    uint64_t start = ClockMs();
+    for (size_t i = 0; i < lookups; i++) {
+      auto page_id = pages[lookup_rng() % pages.size()];
+      bpm->FetchPage(page_id);
+      bpm->UnpinPage(page_id, false);
+    }
+    uint64_t elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+    auto stats = bpm->GetCompressedCacheStats();
+    fmt::print("{:>12} {:>10} {:>10} {:>10.3f} {:>12.3f} {:>8.2f}\n", cache_pages, elapsed,
+               disk_manager.reads_ - reads, static_cast<double>(lookups - (disk_manager.reads_ - reads)) / lookups,
+               stats.HitRatio(), stats.CompressionRatio());
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
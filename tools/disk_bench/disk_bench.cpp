@@ -0,0 +1,211 @@
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/core.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/** Write the file back and evict it from the page cache, so that reads have to go to the device. */
+void DropCache(const std::string &file) {
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+/** @return the megabytes of the file that are in the page cache */
+auto CachedMegabytes(const std::string &file) -> double {
+  int fd = open(file.c_str(), O_RDONLY);
+  struct stat stat_buf;
+  if (fd < 0 || fstat(fd, &stat_buf) != 0 || stat_buf.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+  size_t os_page = sysconf(_SC_PAGESIZE);
+  void *addr = mmap(nullptr, stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return 0;
+  }
+  std::vector<unsigned char> resident((stat_buf.st_size + os_page - 1) / os_page);
+  size_t cached = 0;
+  if (mincore(addr, stat_buf.st_size, resident.data()) == 0) {
+    for (auto r : resident) {
+      cached += r & 1;
+    }
+  }
+  munmap(addr, stat_buf.st_size);
+  return static_cast<double>(cached * os_page) / (1 << 20);
+}
+
+/** Read `targets` with `queue_depth` threads calling the synchronous ReadPage. @return reads per second */
+auto RunSync(bustub::DiskManager *disk_manager, const std::vector<bustub::page_id_t> &targets, size_t queue_depth)
+    -> double {
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> threads;
+  uint64_t start = ClockMs();
+  for (size_t t = 0; t < queue_depth; t++) {
+    threads.emplace_back([&]() {
+      bustub::Page buf;
+      for (size_t i = next++; i < targets.size(); i = next++) {
+        disk_manager->ReadPage(targets[i], buf.GetData());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(targets.size()) / static_cast<double>(std::max<uint64_t>(ClockMs() - start, 1)) * 1000;
+}
+
+/**
+ * Read `targets` from a single thread that keeps `queue_depth` asynchronous reads in flight: each completion starts
+ * the next read into the same buffer. @return reads per second
+ */
+auto RunAsync(bustub::DiskManager *disk_manager, const std::vector<bustub::page_id_t> &targets, size_t queue_depth)
+    -> double {
+  std::atomic<size_t> next{0};
+  std::mutex latch;
+  std::condition_variable all_done;
+  size_t completed = 0;
+  // Pages have page-aligned data, like buffer pool frames, so direct I/O reads into them in place.
+  auto buffers = std::make_unique<bustub::Page[]>(queue_depth);
+  std::function<void(size_t)> issue = [&](size_t slot) {
+    size_t i = next++;
+    if (i >= targets.size()) {
+      return;
+    }
+    disk_manager->ReadPageAsync(targets[i], buffers[slot].GetData(), [&, slot](bool ok) {
+      issue(slot);
+      // Nothing on this stack may be touched once the last completion is counted.
+      std::scoped_lock<std::mutex> lock(latch);
+      if (++completed == targets.size()) {
+        all_done.notify_all();
+      }
+    });
+  };
+  uint64_t start = ClockMs();
+  for (size_t slot = 0; slot < queue_depth; slot++) {
+    issue(slot);
+  }
+  {
+    std::unique_lock<std::mutex> lock(latch);
+    all_done.wait(lock, [&] { return completed == targets.size(); });
+  }
+  return static_cast<double>(targets.size()) / static_cast<double>(std::max<uint64_t>(ClockMs() - start, 1)) * 1000;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-disk-bench");
+  program.add_argument("--pages").help("size of the database file in pages");
+  program.add_argument("--reads").help("number of random page reads per configuration");
+  program.add_argument("--file").help("database file to create for the benchmark");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pages = 65536;
+  size_t reads = 20000;
+  std::string file = "disk_bench.db";
+  if (program.present("--pages")) {
+    pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--reads")) {
+    reads = std::stoul(program.get("--reads"));
+  }
+  if (program.present("--file")) {
+    file = program.get("--file");
+  }
+  std::string log_file = file.substr(0, file.rfind('.')) + ".log";
+  std::string fsm_file = file.substr(0, file.rfind('.')) + ".fsm";
+  std::string crc_file = file.substr(0, file.rfind('.')) + ".crc";
+
+  fmt::print(stderr, "x: {} pages, {} random reads per run, file {}\n", pages, reads, file);
+  std::remove(file.c_str());
+  std::remove(log_file.c_str());
+  std::remove(fsm_file.c_str());
+  std::remove(crc_file.c_str());
+  {
+    bustub::DiskManager disk_manager(file);
+    std::vector<char> page(bustub::BUSTUB_PAGE_SIZE, 'x');
+    for (size_t i = 0; i < pages; i++) {
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), page.data());
+    }
+    disk_manager.ShutDown();
+  }
+
+  std::vector<bustub::page_id_t> targets(reads);
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<bustub::page_id_t> dist(0, static_cast<bustub::page_id_t>(pages - 1));
+  for (auto &target : targets) {
+    target = dist(rng);
+  }
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>16} {:>12} {:>12} {:>16}\n", "backend", "queue depth", "reads/s", "page cache MB");
+  for (size_t queue_depth : {1, 8, 64}) {
+    {
+      DropCache(file);
+      bustub::DiskManager disk_manager(file);
+      double reads_per_sec = RunSync(&disk_manager, targets, queue_depth);
+      fmt::print("{:>16} {:>12} {:>12.0f} {:>16.1f}\n", "fstream", queue_depth, reads_per_sec, CachedMegabytes(file));
+      disk_manager.ShutDown();
+    }
+    for (auto backend : {bustub::AsyncIoBackend::IoUring, bustub::AsyncIoBackend::ThreadPool}) {
+      for (bool direct_io : {false, true}) {
+        DropCache(file);
+        bustub::AsyncDiskManager disk_manager(file, queue_depth, backend, direct_io);
+        std::string name = disk_manager.GetBackend() == bustub::AsyncIoBackend::IoUring ? "io_uring" : "threads";
+        if (backend == bustub::AsyncIoBackend::IoUring && disk_manager.GetBackend() != backend) {
+          name = "(threads)";
+        }
+        if (disk_manager.IsDirectIo()) {
+          name += "+direct";
+        }
+        double reads_per_sec = RunAsync(&disk_manager, targets, queue_depth);
+        fmt::print("{:>16} {:>12} {:>12.0f} {:>16.1f}\n", name, queue_depth, reads_per_sec, CachedMegabytes(file));
+        disk_manager.ShutDown();
+      }
+    }
+  }
+  fmt::print(">>> END\n");
+
+  std::remove(file.c_str());
+  std::remove(log_file.c_str());
+  std::remove(fsm_file.c_str());
+  std::remove(crc_file.c_str());
+  return 0;
+}
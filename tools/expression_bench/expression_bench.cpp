@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/compiled_expression.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/page_predicate.h"
+#include "fmt/core.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-expression-bench");
+  program.add_argument("--rounds").help("number of times each query runs in each mode");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rounds = 10;
+  if (program.present("--rounds")) {
+    rounds = std::stoul(program.get("--rounds"));
+  }
+
+  // Numeric filters and projections over a table heap with the rows of __mock_t4_1m, so that the scan hands out tuples
+  // at the speed of the buffer pool rather than of the mock table generator. Appending to a table heap walks all of
+  // its pages, so the table holds the first 100k rows only. The BIGINT, DECIMAL and SMALLINT columns b, d and s are
+  // derived from x for the comparisons on the other numeric types.
+  const std::vector<std::string> queries = {
+      "SELECT x FROM t4 WHERE x > 90000",
+      "SELECT x + y, x - y FROM t4 WHERE y < 500000",
+      "SELECT x, y FROM t4 WHERE x = 7 AND y = 70",
+      "SELECT x FROM t4 WHERE (x > 1000 AND y < 400000) OR x = 3",
+      "SELECT x FROM t4 WHERE b > 90000000",
+      "SELECT x, d FROM t4 WHERE d < 2500 AND s > 500",
+      "SELECT b FROM t4 WHERE (b < 1000000 OR d > 20000) AND s <> 7",
+  };
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  {
+    // Fill the table through the heap: INSERT needs the insert executor.
+    auto *txn = bustub->txn_manager_->Begin();
+    bustub::Schema schema{{bustub::Column{"x", bustub::TypeId::INTEGER}, bustub::Column{"y", bustub::TypeId::INTEGER},
+                           bustub::Column{"b", bustub::TypeId::BIGINT}, bustub::Column{"d", bustub::TypeId::DECIMAL},
+                           bustub::Column{"s", bustub::TypeId::SMALLINT}}};
+    auto *table_info = bustub->catalog_->CreateTable(txn, "t4", schema);
+    for (int x = 0; x < 100000; x++) {
+      std::vector<bustub::Value> values{bustub::ValueFactory::GetIntegerValue(x),
+                                        bustub::ValueFactory::GetIntegerValue(x * 10),
+                                        bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(x) * 1000),
+                                        bustub::ValueFactory::GetDecimalValue(x / 4.0),
+                                        bustub::ValueFactory::GetSmallIntValue(static_cast<int16_t>(x % 1000))};
+      bustub::RID rid;
+      table_info->table_->InsertTuple(bustub::Tuple{values, &schema}, &rid, txn);
+    }
+    bustub->txn_manager_->Commit(txn);
+    delete txn;
+  }
+  fmt::print(stderr, "x: {} rounds, avx2 page filters: {}\n", rounds, bustub::PagePredicate::IsVectorized());
+
+  fmt::print("<<< BEGIN\n");
+  // Run every query with the filters evaluated on the expression trees, as compiled programs, and on the table pages
+  // where they are conjunctions of INTEGER comparisons (queries 1 to 3).
+  fmt::print("{:>6} {:>10} {:>11} {:>8} {:>8} {:>8}\n", "query", "tree_ms", "compiled_ms", "speedup", "page_ms",
+             "speedup");
+  for (size_t q = 0; q < queries.size(); q++) {
+    uint64_t elapsed[3];
+    for (int mode = 0; mode < 3; mode++) {
+      bustub::enable_expression_compilation = mode >= 1;
+      bustub::enable_page_predicates = mode == 2;
+      uint64_t start = ClockMs();
+      for (size_t r = 0; r < rounds; r++) {
+        bustub::NoopWriter writer;
+        bustub->ExecuteSql(queries[q], writer);
+      }
+      elapsed[mode] = std::max<uint64_t>(ClockMs() - start, 1);
+    }
+    fmt::print("{:>6} {:>10} {:>11} {:>8.2f} {:>8} {:>8.2f}\n", q + 1, elapsed[0], elapsed[1],
+               static_cast<double>(elapsed[0]) / static_cast<double>(elapsed[1]), elapsed[2],
+               static_cast<double>(elapsed[1]) / static_cast<double>(elapsed[2]));
+  }
+
+  // The expressions of the queries by themselves, over a batch of tuples in memory.
+  bustub::Schema schema{{bustub::Column{"x", bustub::TypeId::INTEGER}, bustub::Column{"y", bustub::TypeId::INTEGER},
+                         bustub::Column{"b", bustub::TypeId::BIGINT}, bustub::Column{"d", bustub::TypeId::DECIMAL},
+                         bustub::Column{"s", bustub::TypeId::SMALLINT}}};
+  auto x = std::make_shared<bustub::ColumnValueExpression>(0, 0, bustub::TypeId::INTEGER);
+  auto y = std::make_shared<bustub::ColumnValueExpression>(0, 1, bustub::TypeId::INTEGER);
+  auto b = std::make_shared<bustub::ColumnValueExpression>(0, 2, bustub::TypeId::BIGINT);
+  auto d = std::make_shared<bustub::ColumnValueExpression>(0, 3, bustub::TypeId::DECIMAL);
+  auto s = std::make_shared<bustub::ColumnValueExpression>(0, 4, bustub::TypeId::SMALLINT);
+  auto constant = [](int value) {
+    return std::make_shared<bustub::ConstantValueExpression>(bustub::ValueFactory::GetIntegerValue(value));
+  };
+  auto compare = [](bustub::AbstractExpressionRef lhs, bustub::AbstractExpressionRef rhs, bustub::ComparisonType type) {
+    return std::make_shared<bustub::ComparisonExpression>(std::move(lhs), std::move(rhs), type);
+  };
+  const std::vector<bustub::AbstractExpressionRef> exprs = {
+      compare(x, constant(90000), bustub::ComparisonType::GreaterThan),
+      std::make_shared<bustub::ArithmeticExpression>(x, y, bustub::ArithmeticType::Plus),
+      std::make_shared<bustub::LogicExpression>(compare(x, constant(7), bustub::ComparisonType::Equal),
+                                                compare(y, constant(70), bustub::ComparisonType::Equal),
+                                                bustub::LogicType::And),
+      std::make_shared<bustub::LogicExpression>(
+          std::make_shared<bustub::LogicExpression>(compare(x, constant(1000), bustub::ComparisonType::GreaterThan),
+                                                    compare(y, constant(400000), bustub::ComparisonType::LessThan),
+                                                    bustub::LogicType::And),
+          compare(x, constant(3), bustub::ComparisonType::Equal), bustub::LogicType::Or),
+      compare(b, constant(90000000), bustub::ComparisonType::GreaterThan),
+      std::make_shared<bustub::LogicExpression>(compare(d, constant(2500), bustub::ComparisonType::LessThan),
+                                                compare(s, constant(500), bustub::ComparisonType::GreaterThan),
+                                                bustub::LogicType::And),
+      std::make_shared<bustub::LogicExpression>(
+          std::make_shared<bustub::LogicExpression>(compare(b, constant(1000000), bustub::ComparisonType::LessThan),
+                                                    compare(d, constant(20000), bustub::ComparisonType::GreaterThan),
+                                                    bustub::LogicType::Or),
+          compare(s, constant(7), bustub::ComparisonType::NotEqual), bustub::LogicType::And),
+  };
+  bustub::TupleBatch batch;
+  for (int i = 0; !batch.IsFull(); i++) {
+    std::vector<bustub::Value> values{bustub::ValueFactory::GetIntegerValue(i * 97),
+                                      bustub::ValueFactory::GetIntegerValue(i * 970),
+                                      bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 97000),
+                                      bustub::ValueFactory::GetDecimalValue(i * 97 / 4.0),
+                                      bustub::ValueFactory::GetSmallIntValue(static_cast<int16_t>(i * 97 % 1000))};
+    batch.Append(bustub::Tuple{values, &schema}, bustub::RID());
+  }
+  const size_t evaluations = 1000;
+  // Keeps the compiler from dropping the evaluations whose results go unused.
+  int64_t checksum = 0;
+  fmt::print("{:>6} {:>10} {:>11} {:>8}\n", "expr", "tree_ms", "compiled_ms", "speedup");
+  for (size_t e = 0; e < exprs.size(); e++) {
+    uint64_t start = ClockMs();
+    for (size_t r = 0; r < rounds * evaluations; r++) {
+      for (size_t i = 0; i < batch.Size(); i++) {
+        checksum += exprs[e]->Evaluate(&batch.TupleAt(i), schema).IsNull() ? 0 : 1;
+      }
+    }
+    uint64_t tree_ms = std::max<uint64_t>(ClockMs() - start, 1);
+    auto compiled = bustub::CompiledExpression::Compile(*exprs[e], schema);
+    start = ClockMs();
+    for (size_t r = 0; r < rounds * evaluations; r++) {
+      compiled->Run(batch);
+      checksum -= compiled->GetValue(batch.Size() - 1).IsNull() ? 0 : 1;
+    }
+    uint64_t compiled_ms = std::max<uint64_t>(ClockMs() - start, 1);
+    fmt::print("{:>6} {:>10} {:>11} {:>8.2f}\n", e + 1, tree_ms, compiled_ms,
+               static_cast<double>(tree_ms) / static_cast<double>(compiled_ms));
+  }
+  fmt::print(stderr, "checksum: {}\n", checksum);
+  fmt::print(">>> END\n");
+  return 0;
+}
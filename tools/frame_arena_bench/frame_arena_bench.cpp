@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/frame_arena.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/** @return the kilobytes of this process's memory that are backed by transparent huge pages */
+auto AnonHugePagesKb() -> uint64_t {
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string key;
+  uint64_t kb;
+  while (smaps >> key) {
+    if (key == "AnonHugePages:" && smaps >> kb) {
+      return kb;
+    }
+  }
+  return 0;
+}
+
+auto BackingName(bustub::FrameArenaBacking backing) -> std::string {
+  switch (backing) {
+    case bustub::FrameArenaBacking::HugeTlbPages:
+      return "hugetlb";
+    case bustub::FrameArenaBacking::TransparentHugePages:
+      return "thp";
+    default:
+      return "4k";
+  }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-frame-arena-bench");
+  program.add_argument("--frames").help("number of frames in the arena");
+  program.add_argument("--accesses").help("number of dependent random frame accesses per run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t frames = 131072;
+  size_t accesses = 4000000;
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--accesses")) {
+    accesses = std::stoul(program.get("--accesses"));
+  }
+  fmt::print(stderr, "x: {} frames ({} MB), {} random accesses per run\n", frames,
+             frames * bustub::BUSTUB_PAGE_SIZE >> 20, accesses);
+
+  // Each frame stores the index of the next frame to visit, so every access waits for the one before: the time per
+  // access is the latency of a cache miss plus, when its translation is not cached, a page walk.
+  std::vector<uint32_t> order(frames);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937_64(0));
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>10} {:>12} {:>14} {:>16}\n", "backing", "time_ms", "ns/access", "huge pages MB");
+  for (bool huge_pages : {false, true}) {
+    uint64_t huge_before = AnonHugePagesKb();
+    bustub::FrameArena arena(frames, huge_pages, -1);
+    for (size_t i = 0; i < frames; i++) {
+      uint32_t next = order[(i + 1) % frames];
+      memcpy(arena.GetFrame(order[i]) + (order[i] % 64) * 64, &next, sizeof(next));
+    }
+    uint64_t huge_mb = (AnonHugePagesKb() - std::min(huge_before, AnonHugePagesKb())) >> 10;
+
+    uint32_t frame = order[0];
+    uint64_t start = ClockMs();
+    for (size_t i = 0; i < accesses; i++) {
+      memcpy(&frame, arena.GetFrame(frame) + (frame % 64) * 64, sizeof(frame));
+    }
+    uint64_t elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+    fmt::print("{:>10} {:>12} {:>14.1f} {:>16}\n", BackingName(arena.GetBacking()), elapsed,
+               static_cast<double>(elapsed) * 1e6 / static_cast<double>(accesses),
+               arena.GetBacking() == bustub::FrameArenaBacking::HugeTlbPages ? frames * bustub::BUSTUB_PAGE_SIZE >> 20
+                                                                             : huge_mb);
+    if (frame == frames) {
+      std::cerr << "unreachable" << std::endl;
+    }
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "fmt/core.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+using KeyType = bustub::GenericKey<8>;
+using Comparator = bustub::GenericComparator<8>;
+using LeafPage = bustub::BPlusTreeLeafPage<KeyType, bustub::RID, Comparator>;
+using InternalPage = bustub::BPlusTreeInternalPage<KeyType, bustub::page_id_t, Comparator>;
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+auto MakeKey(int64_t integer) -> KeyType {
+  KeyType key;
+  key.SetFromInteger(integer);
+  return key;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-key-search-bench");
+  program.add_argument("--lookups").help("number of searches per page and comparator");
+  program.add_argument("--stride").help("distance between neighbouring keys on a page");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t lookups = 4000000;
+  int64_t stride = 1000003;
+  if (program.present("--lookups")) {
+    lookups = std::stoul(program.get("--lookups"));
+  }
+  if (program.present("--stride")) {
+    stride = std::stoll(program.get("--stride"));
+  }
+
+  // Full pages of BIGINT keys, spread out so that the pages cannot drop much of them as a shared prefix.
+  bustub::Schema key_schema(std::vector<bustub::Column>{bustub::Column("a", bustub::TypeId::BIGINT)});
+  alignas(8) static char leaf_data[bustub::BUSTUB_PAGE_SIZE];
+  alignas(8) static char internal_data[bustub::BUSTUB_PAGE_SIZE];
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_data);
+  auto *internal = reinterpret_cast<InternalPage *>(internal_data);
+  leaf->Init(1);
+  internal->Init(2);
+  while (leaf->GetSize() < leaf->GetMaxSize() && leaf->HasRoomFor({MakeKey(leaf->GetSize() * stride)})) {
+    leaf->InsertAt(leaf->GetSize(), MakeKey(leaf->GetSize() * stride), bustub::RID());
+  }
+  while (internal->GetSize() < internal->GetMaxSize() &&
+         internal->HasRoomFor({MakeKey(internal->GetSize() * stride)})) {
+    internal->InsertAt(internal->GetSize(), MakeKey(internal->GetSize() * stride), 0);
+  }
+
+  std::mt19937_64 rng(0);
+  std::vector<KeyType> probes;
+  probes.reserve(lookups);
+  int64_t range = leaf->GetSize() * stride;
+  for (size_t i = 0; i < lookups; i++) {
+    probes.push_back(MakeKey(static_cast<int64_t>(rng() % static_cast<uint64_t>(range))));
+  }
+  fmt::print(stderr, "x: {} lookups, {} leaf keys, {} internal keys, avx2 {}\n", lookups, leaf->GetSize(),
+             internal->GetSize(), bustub::KeySearch::IsVectorized() ? "used" : "not available");
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>10} {:>10} {:>12}\n", "page", "compare", "ns_per_key");
+  int64_t sink = 0;
+  for (bool is_leaf : {true, false}) {
+    for (bool integer_keys : {false, true}) {
+      Comparator comparator(&key_schema, integer_keys);
+      uint64_t start = ClockNs();
+      for (const auto &probe : probes) {
+        sink += is_leaf ? leaf->KeyIndex(probe, comparator) : internal->Lookup(probe, comparator);
+      }
+      double elapsed = static_cast<double>(ClockNs() - start);
+      fmt::print("{:>10} {:>10} {:>12.1f}\n", is_leaf ? "leaf" : "internal", integer_keys ? "integer" : "value",
+                 elapsed / static_cast<double>(lookups));
+    }
+  }
+  fmt::print(">>> END\n");
+  fmt::print(stderr, "x: {}\n", sink);
+  return 0;
+}
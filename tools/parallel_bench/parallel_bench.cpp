@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-parallel-bench");
+  program.add_argument("--rounds").help("number of times each query runs at each degree of parallelism");
+  program.add_argument("--threads").help("the degree of parallelism to compare against 1");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rounds = 3;
+  if (program.present("--rounds")) {
+    rounds = std::stoul(program.get("--rounds"));
+  }
+  size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+  if (program.present("--threads")) {
+    threads = std::stoul(program.get("--threads"));
+  }
+
+  // Scans, filters and projections over the 1M-row leaderboard table, the pipelines that run in parallel.
+  const std::vector<std::string> queries = {
+      "SELECT x FROM __mock_t4_1m WHERE x > 490000",
+      "SELECT x + y FROM __mock_t4_1m WHERE y < 10000",
+      "SELECT x, y FROM __mock_t4_1m WHERE x = 7 AND y = 70",
+      "SELECT x - y, y + 1 FROM __mock_t4_1m WHERE x > 100 AND y > 100",
+  };
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub->GenerateMockTable();
+  fmt::print(stderr, "x: {} rounds, {} threads against 1\n", rounds, threads);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>6} {:>10} {:>11} {:>8}\n", "query", "serial_ms", "parallel_ms", "speedup");
+  for (size_t q = 0; q < queries.size(); q++) {
+    uint64_t elapsed[2];
+    for (size_t degree : {static_cast<size_t>(1), threads}) {
+      bustub::NoopWriter set_writer;
+      bustub->ExecuteSql(fmt::format("SET degree_of_parallelism = {}", degree), set_writer);
+      uint64_t start = ClockMs();
+      for (size_t r = 0; r < rounds; r++) {
+        bustub::NoopWriter writer;
+        bustub->ExecuteSql(queries[q], writer);
+      }
+      elapsed[degree == 1 ? 0 : 1] = std::max<uint64_t>(ClockMs() - start, 1);
+    }
+    fmt::print("{:>6} {:>10} {:>11} {:>8.2f}\n", q + 1, elapsed[0], elapsed[1],
+               static_cast<double>(elapsed[0]) / static_cast<double>(elapsed[1]));
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
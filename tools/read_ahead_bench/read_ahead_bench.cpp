@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/**
+ * An in-memory disk whose reads take as long as a read from a slower device, like network attached storage. It serves
+ * up to `queue_depth` asynchronous reads at the same time.
+ */
+class SlowReadDiskManager : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  SlowReadDiskManager(std::chrono::microseconds read_latency, size_t queue_depth) : read_latency_(read_latency) {
+    for (size_t i = 0; i < queue_depth; i++) {
+      workers_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~SlowReadDiskManager() override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    std::this_thread::sleep_for(read_latency_);
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  auto ReadPageAsync(bustub::page_id_t page_id, char *page_data, bustub::disk_callback_fn callback)
+      -> std::future<bool> override {
+    auto done = std::make_shared<std::promise<bool>>();
+    auto future = done->get_future();
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      queue_.emplace_back([this, page_id, page_data, callback = std::move(callback), done] {
+        ReadPage(page_id, page_data);
+        if (callback != nullptr) {
+          callback(true);
+        }
+        done->set_value(true);
+      });
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      auto read = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      read();
+      lock.lock();
+    }
+  }
+
+  std::chrono::microseconds read_latency_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-read-ahead-bench");
+  program.add_argument("--rows").help("number of rows in the table");
+  program.add_argument("--frames").help("number of frames in the buffer pool");
+  program.add_argument("--file").help("database file to create for the benchmark");
+  program.add_argument("--read-us").help("simulate a device with this read latency instead of using the file");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rows = 40000;
+  size_t frames = 256;
+  std::string file = "read_ahead_bench.db";
+  if (program.present("--rows")) {
+    rows = std::stoul(program.get("--rows"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--file")) {
+    file = program.get("--file");
+  }
+  uint64_t read_us = 0;
+  if (program.present("--read-us")) {
+    read_us = std::stoul(program.get("--read-us"));
+  }
+  std::string log_file = file.substr(0, file.rfind('.')) + ".log";
+  std::string fsm_file = file.substr(0, file.rfind('.')) + ".fsm";
+  std::string crc_file = file.substr(0, file.rfind('.')) + ".crc";
+  std::remove(file.c_str());
+  std::remove(log_file.c_str());
+  std::remove(fsm_file.c_str());
+  std::remove(crc_file.c_str());
+
+  {
+    // Direct I/O keeps the table out of the page cache, so every miss goes to the device.
+    std::unique_ptr<bustub::DiskManager> disk_manager;
+    if (read_us > 0) {
+      disk_manager = std::make_unique<SlowReadDiskManager>(std::chrono::microseconds(read_us),
+                                                           bustub::ASYNC_IO_QUEUE_DEPTH);
+    } else {
+      auto direct = std::make_unique<bustub::AsyncDiskManager>(file, bustub::ASYNC_IO_QUEUE_DEPTH,
+                                                               bustub::AsyncIoBackend::Auto, true);
+      if (!direct->IsDirectIo()) {
+        fmt::print(stderr, "x: direct I/O is not available, the page cache serves some reads\n");
+      }
+      disk_manager = std::move(direct);
+    }
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+    bustub::Schema schema({bustub::Column("id", bustub::TypeId::INTEGER),
+                           bustub::Column("payload", bustub::TypeId::VARCHAR, 400)});
+    bustub::Transaction txn(0);
+    bustub::TableHeap table(bpm.get(), nullptr, nullptr, &txn);
+    std::string payload(400, 'x');
+    size_t table_pages = 0;
+    bustub::page_id_t last_page = bustub::INVALID_PAGE_ID;
+    for (size_t i = 0; i < rows; i++) {
+      bustub::Tuple tuple({bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                           bustub::ValueFactory::GetVarcharValue(payload)},
+                          &schema);
+      bustub::RID rid;
+      table.InsertTuple(tuple, &rid, &txn);
+      if (rid.GetPageId() != last_page) {
+        last_page = rid.GetPageId();
+        table_pages++;
+      }
+    }
+    // Push the table out of the pool. Scans go through the scan ring, so it stays out between runs.
+    for (size_t i = 0; i < frames; i++) {
+      bustub::page_id_t page_id;
+      bpm->NewPage(&page_id);
+      bpm->UnpinPage(page_id, true);
+    }
+    bpm->FlushAllPages();
+    fmt::print(stderr, "x: {} rows in {} pages, {} frames, {}\n", rows, table_pages, frames,
+               read_us > 0 ? fmt::format("{}us per read", read_us) : "file " + file);
+
+    fmt::print("<<< BEGIN\n");
+    fmt::print("{:>12} {:>10} {:>12} {:>12}\n", "read-ahead", "time_ms", "rows/s", "pages/s");
+    for (int depth : {0, 2, 8, 16}) {
+      bustub::read_ahead_pages = depth;
+      uint64_t start = ClockMs();
+      size_t count = 0;
+      for (auto it = table.Begin(&txn, bustub::AccessType::Scan); it != table.End(); ++it) {
+        count++;
+      }
+      uint64_t elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+      if (count != rows) {
+        std::cerr << "scan returned " << count << " rows instead of " << rows << std::endl;
+      }
+      fmt::print("{:>12} {:>10} {:>12.0f} {:>12.0f}\n", depth, elapsed,
+                 static_cast<double>(rows) / static_cast<double>(elapsed) * 1000,
+                 static_cast<double>(table_pages) / static_cast<double>(elapsed) * 1000);
+    }
+    fmt::print(">>> END\n");
+    bustub::read_ahead_pages = 8;
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  std::remove(file.c_str());
+  std::remove(log_file.c_str());
+  std::remove(fsm_file.c_str());
+  std::remove(crc_file.c_str());
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "argparse/argparse.hpp"
+#include "buffer/lru_k_replacer.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/**
+ * The LRU-K replacer as it was before the heap-based rewrite: a list of timestamps per frame, and a scan of every
+ * frame on each eviction. Kept here as the baseline to compare against.
+ */
+class ScanLRUKReplacer {
+ public:
+  ScanLRUKReplacer(size_t num_frames, size_t k) : k_(k) { (void)num_frames; }
+
+  auto Evict(bustub::frame_id_t *frame_id) -> bool {
+    std::scoped_lock<std::mutex> lock(latch_);
+    bool found = false;
+    bool found_inf = false;
+    size_t earliest = 0;
+    bustub::frame_id_t victim = -1;
+    for (const auto &[fid, history] : hist_timestamp_) {
+      if (!frame_evict_[fid]) {
+        continue;
+      }
+      bool is_inf = history.size() < k_;
+      if (!found || (is_inf && !found_inf) || (is_inf == found_inf && history.front() < earliest)) {
+        found = true;
+        found_inf = is_inf;
+        earliest = history.front();
+        victim = fid;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+    hist_timestamp_.erase(victim);
+    frame_evict_.erase(victim);
+    *frame_id = victim;
+    return true;
+  }
+
+  void RecordAccess(bustub::frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto &history = hist_timestamp_[frame_id];
+    if (history.empty()) {
+      frame_evict_[frame_id] = false;
+    }
+    history.push_back(current_timestamp_++);
+    if (history.size() > k_) {
+      history.pop_front();
+    }
+  }
+
+  void SetEvictable(bustub::frame_id_t frame_id, bool set_evictable) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto it = frame_evict_.find(frame_id);
+    if (it != frame_evict_.end()) {
+      it->second = set_evictable;
+    }
+  }
+
+ private:
+  size_t current_timestamp_{0};
+  size_t k_;
+  std::mutex latch_;
+  std::unordered_map<bustub::frame_id_t, bool> frame_evict_;
+  std::unordered_map<bustub::frame_id_t, std::list<size_t>> hist_timestamp_;
+};
+
+/**
+ * Drive a full replacer the way a buffer pool under a miss-heavy workload does: every iteration evicts a frame and
+ * brings it back in, and touches a few random resident frames as hits in between.
+ * @return the number of evictions per second and the number of evictions run
+ */
+template <typename Replacer>
+auto RunReplacer(size_t num_frames, size_t k, uint64_t duration_ms) -> std::pair<double, uint64_t> {
+  auto replacer = std::make_unique<Replacer>(num_frames, k);
+  for (size_t i = 0; i < num_frames; i++) {
+    auto fid = static_cast<bustub::frame_id_t>(i);
+    replacer->RecordAccess(fid);
+    replacer->SetEvictable(fid, true);
+  }
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<bustub::frame_id_t> dist(0, num_frames - 1);
+  uint64_t evictions = 0;
+  uint64_t start = ClockMs();
+  uint64_t elapsed = 0;
+  while (elapsed < duration_ms) {
+    for (int hit = 0; hit < 4; hit++) {
+      replacer->RecordAccess(dist(rng));
+    }
+    bustub::frame_id_t victim;
+    if (!replacer->Evict(&victim)) {
+      break;
+    }
+    replacer->RecordAccess(victim);
+    replacer->SetEvictable(victim, true);
+    evictions++;
+    elapsed = ClockMs() - start;
+  }
+  elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+  return {static_cast<double>(evictions) / static_cast<double>(elapsed) * 1000, evictions};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--duration").help("run each configuration for n milliseconds");
+  program.add_argument("--k").help("lookback window of the replacer");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 1000;
+  size_t k = bustub::LRUK_REPLACER_K;
+  if (program.present("--duration")) {
+    duration_ms = std::stoul(program.get("--duration"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+
+  fmt::print(stderr, "x: k={}, {}ms per run\n", k, duration_ms);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>10} {:>10} {:>14} {:>12}\n", "replacer", "frames", "evictions/s", "evictions");
+  for (size_t frames : {1000, 100000, 1000000}) {
+    auto [heap_rate, heap_evictions] = RunReplacer<bustub::LRUKReplacer>(frames, k, duration_ms);
+    fmt::print("{:>10} {:>10} {:>14.0f} {:>12}\n", "heap", frames, heap_rate, heap_evictions);
+    auto [scan_rate, scan_evictions] = RunReplacer<ScanLRUKReplacer>(frames, k, duration_ms);
+    fmt::print("{:>10} {:>10} {:>14.0f} {:>12}\n", "scan", frames, scan_rate, scan_evictions);
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
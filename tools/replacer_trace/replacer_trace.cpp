@@ -0,0 +1,178 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+/**
+ * Replay a page access trace against a replacer the way the buffer pool drives it: a hit records an access, a miss
+ * takes a free frame or evicts one, then assigns the page to the frame. Pages are unpinned right after each access.
+ */
+class TraceSimulator {
+ public:
+  TraceSimulator(bustub::ReplacerPolicy policy, size_t num_frames, size_t k)
+      : replacer_(bustub::MakeReplacer(policy, num_frames, k)),
+        num_frames_(num_frames),
+        frame_to_page_(num_frames, bustub::INVALID_PAGE_ID) {}
+
+  /** @return true if the page was resident */
+  auto Access(bustub::page_id_t page_id) -> bool {
+    auto it = page_to_frame_.find(page_id);
+    if (it != page_to_frame_.end()) {
+      replacer_->RecordAccess(it->second);
+      return true;
+    }
+    bustub::frame_id_t frame_id;
+    if (next_free_ < num_frames_) {
+      frame_id = static_cast<bustub::frame_id_t>(next_free_++);
+    } else {
+      if (!replacer_->Evict(&frame_id)) {
+        throw std::runtime_error("replacer has no victim although no page is pinned");
+      }
+      page_to_frame_.erase(frame_to_page_[frame_id]);
+    }
+    frame_to_page_[frame_id] = page_id;
+    page_to_frame_[page_id] = frame_id;
+    replacer_->AssignPage(frame_id, page_id);
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, true);
+    return false;
+  }
+
+ private:
+  std::unique_ptr<bustub::Replacer> replacer_;
+  size_t num_frames_;
+  size_t next_free_{0};
+  std::vector<bustub::page_id_t> frame_to_page_;
+  std::unordered_map<bustub::page_id_t, bustub::frame_id_t> page_to_frame_;
+};
+
+/**
+ * A mixed OLTP and reporting workload: point accesses to a hot set of `hot` pages, interrupted by sequential scans of
+ * `scan` cold pages. A few hot accesses keep going while each scan runs.
+ */
+auto MakeSyntheticTrace(size_t hot, size_t scan, size_t rounds) -> std::vector<bustub::page_id_t> {
+  std::vector<bustub::page_id_t> trace;
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<bustub::page_id_t> hot_dist(0, hot - 1);
+  for (size_t round = 0; round < rounds; round++) {
+    for (size_t i = 0; i < 10 * hot; i++) {
+      trace.push_back(hot_dist(rng));
+    }
+    for (size_t i = 0; i < scan; i++) {
+      trace.push_back(static_cast<bustub::page_id_t>(hot + i));
+      if (i % 4 == 0) {
+        trace.push_back(hot_dist(rng));
+      }
+    }
+  }
+  return trace;
+}
+
+/** Read a trace file with one page id per line. Blank lines and lines starting with '#' are skipped. */
+auto ReadTrace(const std::string &path, std::vector<bustub::page_id_t> *trace) -> bool {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    trace->push_back(static_cast<bustub::page_id_t>(std::stol(line)));
+  }
+  return true;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-trace");
+  program.add_argument("--trace").help("trace file with one page id per line; a synthetic trace is used if absent");
+  program.add_argument("--frames").help("number of frames in the simulated buffer pool");
+  program.add_argument("--policies").help("comma-separated policies: lru,lru-k,clock,clock-pro,2q,arc");
+  program.add_argument("--k").help("lookback window of the LRU-K replacer");
+  program.add_argument("--hot").help("synthetic trace: number of hot pages");
+  program.add_argument("--scan").help("synthetic trace: number of pages read by each scan");
+  program.add_argument("--rounds").help("synthetic trace: number of OLTP phases, each followed by a scan");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t frames = 1024;
+  size_t k = bustub::LRUK_REPLACER_K;
+  std::string policy_names = "lru,lru-k,clock,clock-pro,2q,arc";
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+  if (program.present("--policies")) {
+    policy_names = program.get("--policies");
+  }
+
+  std::vector<bustub::ReplacerPolicy> policies;
+  std::stringstream names(policy_names);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    bustub::ReplacerPolicy policy;
+    if (!bustub::ParseReplacerPolicy(name, &policy)) {
+      std::cerr << "unknown replacer policy: " << name << std::endl;
+      return 1;
+    }
+    policies.push_back(policy);
+  }
+
+  std::vector<bustub::page_id_t> trace;
+  if (program.present("--trace")) {
+    if (!ReadTrace(program.get("--trace"), &trace)) {
+      std::cerr << "cannot read trace " << program.get("--trace") << std::endl;
+      return 1;
+    }
+  } else {
+    size_t hot = frames / 2;
+    size_t scan = frames * 4;
+    size_t rounds = 10;
+    if (program.present("--hot")) {
+      hot = std::stoul(program.get("--hot"));
+    }
+    if (program.present("--scan")) {
+      scan = std::stoul(program.get("--scan"));
+    }
+    if (program.present("--rounds")) {
+      rounds = std::stoul(program.get("--rounds"));
+    }
+    trace = MakeSyntheticTrace(hot, scan, rounds);
+  }
+
+  fmt::print(stderr, "x: {} frames, {} accesses\n", frames, trace.size());
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>10} {:>12} {:>10}\n", "policy", "hits", "hit rate");
+  for (auto policy : policies) {
+    TraceSimulator simulator(policy, frames, k);
+    size_t hits = 0;
+    for (auto page_id : trace) {
+      hits += simulator.Access(page_id) ? 1 : 0;
+    }
+    double hit_rate = trace.empty() ? 0 : static_cast<double>(hits) / static_cast<double>(trace.size());
+    fmt::print("{:>10} {:>12} {:>9.2f}%\n", bustub::ReplacerPolicyToString(policy), hits, hit_rate * 100);
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+/** Counts the reads of the pages that point lookups touch, so that their misses can be told apart from the scan's. */
+class LookupMissCounter : public bustub::DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    if (page_id <= last_hot_page_) {
+      misses_++;
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<bustub::page_id_t> last_hot_page_{-1};
+  std::atomic<uint64_t> misses_{0};
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-bench");
+  program.add_argument("--rows").help("number of rows in the scanned table");
+  program.add_argument("--frames").help("number of frames in the buffer pool");
+  program.add_argument("--hot").help("number of pages the point lookups touch");
+  program.add_argument("--interval").help("report the lookup hit rate every n milliseconds");
+  program.add_argument("--replacer").help("replacement policy of the measured pool: lru,lru-k,clock,clock-pro,2q,arc");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t rows = 1000000;
+  size_t frames = 1024;
+  size_t hot = 512;
+  uint64_t interval_ms = 200;
+  if (program.present("--rows")) {
+    rows = std::stoul(program.get("--rows"));
+  }
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--hot")) {
+    hot = std::stoul(program.get("--hot"));
+  }
+  if (program.present("--interval")) {
+    interval_ms = std::stoul(program.get("--interval"));
+  }
+  // Plain LRU is the policy a scan flushes most readily, so it shows the effect of the ring most clearly.
+  auto policy = bustub::ReplacerPolicy::LRU;
+  if (program.present("--replacer") && !bustub::ParseReplacerPolicy(program.get("--replacer"), &policy)) {
+    std::cerr << "unknown replacer policy: " << program.get("--replacer") << std::endl;
+    return 1;
+  }
+
+  fmt::print(stderr, "scan-bench: {} rows, {} frames, {} hot pages, {}ms interval, {} replacer\n", rows, frames, hot,
+             interval_ms, bustub::ReplacerPolicyToString(policy));
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>8} {:>8} {:>10} {:>12} {:>14}\n", "hint", "time_ms", "phase", "lookups", "hit rate");
+  for (auto access_type : {bustub::AccessType::Unknown, bustub::AccessType::Scan}) {
+    std::string hint = access_type == bustub::AccessType::Scan ? "scan" : "none";
+    auto disk_manager = std::make_unique<LookupMissCounter>();
+    bustub::Schema schema({bustub::Column("id", bustub::TypeId::INTEGER),
+                           bustub::Column("payload", bustub::TypeId::VARCHAR, 32)});
+    bustub::Transaction txn(0);
+
+    // Write the hot pages and the table through a separate pool, so that the measured pool starts cold and the load
+    // does not leave access history behind. The hot pages come first, so that every page id up to the last hot one
+    // belongs to the lookup workload.
+    std::vector<bustub::page_id_t> hot_pages;
+    bustub::page_id_t first_table_page;
+    {
+      auto loader = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+      for (size_t i = 0; i < hot; i++) {
+        bustub::page_id_t page_id;
+        loader->NewPage(&page_id);
+        loader->UnpinPage(page_id, true);
+        hot_pages.push_back(page_id);
+      }
+      bustub::TableHeap table(loader.get(), nullptr, nullptr, &txn);
+      first_table_page = table.GetFirstPageId();
+      std::string payload(32, 'x');
+      for (size_t i = 0; i < rows; i++) {
+        bustub::Tuple tuple({bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                             bustub::ValueFactory::GetVarcharValue(payload)},
+                            &schema);
+        bustub::RID rid;
+        table.InsertTuple(tuple, &rid, &txn);
+      }
+      loader->FlushAllPages();
+    }
+    disk_manager->last_hot_page_ = hot_pages.back();
+
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get(), bustub::LRUK_REPLACER_K,
+                                                                   nullptr, policy);
+    bustub::TableHeap table(bpm.get(), nullptr, nullptr, first_table_page);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> lookups{0};
+    std::thread lookup_thread([&]() {
+      std::mt19937_64 rng(0);
+      std::uniform_int_distribution<size_t> dist(0, hot_pages.size() - 1);
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto page_id = hot_pages[dist(rng)];
+        if (bpm->FetchPage(page_id, bustub::AccessType::Lookup) != nullptr) {
+          bpm->UnpinPage(page_id, false);
+          lookups++;
+        }
+      }
+    });
+
+    std::atomic<bool> scanning{false};
+    std::atomic<bool> scan_done{false};
+    std::thread scan_thread([&]() {
+      // Let the lookups warm up and settle first.
+      std::this_thread::sleep_for(std::chrono::milliseconds(3 * interval_ms));
+      scanning = true;
+      size_t count = 0;
+      for (auto it = table.Begin(&txn, access_type); it != table.End(); ++it) {
+        count++;
+      }
+      scanning = false;
+      scan_done = true;
+      if (count != rows) {
+        std::cerr << "scan returned " << count << " rows instead of " << rows << std::endl;
+      }
+    });
+
+    uint64_t start = ClockMs();
+    uint64_t after_scan = 0;
+    while (after_scan < 3) {
+      uint64_t lookups_before = lookups;
+      uint64_t misses_before = disk_manager->misses_;
+      bool scanned = scanning;
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      scanned = scanned || scanning;
+      uint64_t window_lookups = lookups - lookups_before;
+      uint64_t window_misses = disk_manager->misses_ - misses_before;
+      double hit_rate = window_lookups == 0 ? 0
+                                            : 1.0 - static_cast<double>(window_misses) /
+                                                        static_cast<double>(window_lookups);
+      std::string phase = scanned ? "scan" : (scan_done ? "after" : "before");
+      fmt::print("{:>8} {:>8} {:>10} {:>12} {:>13.2f}%\n", hint, ClockMs() - start, phase, window_lookups,
+                 hit_rate * 100);
+      if (scan_done && !scanned) {
+        after_scan++;
+      }
+    }
+    stop = true;
+    lookup_thread.join();
+    scan_thread.join();
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
@@ -27,7 +27,16 @@ auto GetWidthOfUtf8(const void *beg, const void *end, size_t *width) -> int {
 auto main(int argc, char **argv) -> int {
   ft_set_u8strwid_func(&GetWidthOfUtf8);
 
-  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
+  auto replacer_policy = bustub::ReplacerPolicy::LRUK;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--replacer=", 0) == 0 && !bustub::ParseReplacerPolicy(arg.substr(11), &replacer_policy)) {
+      std::cerr << "unknown replacer policy: " << arg.substr(11) << std::endl;
+      return 1;
+    }
+  }
+
+  auto bustub = std::make_unique<bustub::BustubInstance>("test.db", replacer_policy);
 
   auto default_prompt = "bustub> ";
   auto emoji_prompt = "\U0001f6c1> ";  // the bathtub emoji